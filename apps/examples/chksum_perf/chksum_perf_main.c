@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/chksum_perf/chksum_perf_main.c
+ *
+ * Throughput of the lwIP software checksum routines.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/inet_chksum.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_CHKSUM_PERF_LOOPS
+#define CONFIG_EXAMPLES_CHKSUM_PERF_LOOPS 10000
+#endif
+
+#ifdef CLOCK_MONOTONIC
+#define CHKSUM_PERF_CLOCK CLOCK_MONOTONIC
+#else
+#define CHKSUM_PERF_CLOCK CLOCK_REALTIME
+#endif
+
+/* One full TCP segment on Ethernet */
+#define CHKSUM_PERF_LEN  1460
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Room for an odd source offset */
+static u8_t g_src[CHKSUM_PERF_LEN + 4];
+static u8_t g_dst[CHKSUM_PERF_LEN + 4];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t chksum_perf_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CHKSUM_PERF_CLOCK, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void chksum_perf_report(const char *name, int offset, uint64_t usec)
+{
+	uint64_t kbytes = (uint64_t)CHKSUM_PERF_LEN * CONFIG_EXAMPLES_CHKSUM_PERF_LOOPS / 1000;
+
+	if (usec == 0) {
+		usec = 1;
+	}
+	printf("  %-14s offset %d: %llu usec, %llu KB/s\n", name, offset, (unsigned long long)usec, (unsigned long long)(kbytes * 1000000 / usec));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int chksum_perf_main(int argc, char *argv[])
+#endif
+{
+	volatile u16_t sink = 0;
+	uint64_t start;
+	int offset;
+	int i;
+
+	for (i = 0; i < (int)sizeof(g_src); i++) {
+		g_src[i] = (u8_t)(i * 7 + 3);
+	}
+
+	printf("chksum_perf: %d x %d bytes\n", CONFIG_EXAMPLES_CHKSUM_PERF_LOOPS, CHKSUM_PERF_LEN);
+
+	/* Aligned and odd-aligned source, the latter is the worst case of
+	 * the word-at-a-time algorithms.
+	 */
+
+	for (offset = 0; offset < 2; offset++) {
+		start = chksum_perf_usec();
+		for (i = 0; i < CONFIG_EXAMPLES_CHKSUM_PERF_LOOPS; i++) {
+			sink += inet_chksum(g_src + offset, CHKSUM_PERF_LEN);
+		}
+		chksum_perf_report("inet_chksum", offset, chksum_perf_usec() - start);
+
+#if LWIP_CHKSUM_COPY_ALGORITHM
+		start = chksum_perf_usec();
+		for (i = 0; i < CONFIG_EXAMPLES_CHKSUM_PERF_LOOPS; i++) {
+			sink += lwip_chksum_copy(g_dst, g_src + offset, CHKSUM_PERF_LEN);
+		}
+		chksum_perf_report("chksum_copy", offset, chksum_perf_usec() - start);
+#endif
+	}
+
+	(void)sink;
+	return 0;
+}
@@ -0,0 +1,304 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/fragperf/fragperf_main.c
+ *
+ * Throughput of lwIP IPv4 fragmentation and reassembly of 8 KB UDP
+ * datagrams.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <semaphore.h>
+#include <time.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/ip4.h>
+#include <net/lwip/netif.h>
+#include <net/lwip/pbuf.h>
+#include <net/lwip/tcpip.h>
+#include <net/lwip/udp.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_FRAGPERF_LOOPS
+#define CONFIG_EXAMPLES_FRAGPERF_LOOPS 1000
+#endif
+
+#ifdef CLOCK_MONOTONIC
+#define FRAGPERF_CLOCK CLOCK_MONOTONIC
+#else
+#define FRAGPERF_CLOCK CLOCK_REALTIME
+#endif
+
+#define FRAGPERF_MTU     1500
+#define FRAGPERF_DGRAM   8192
+#define FRAGPERF_PORT    7000
+
+/* Fragments of one datagram: UDP header and payload in 1480-byte pieces */
+#define FRAGPERF_NFRAGS  ((8 + FRAGPERF_DGRAM + FRAGPERF_MTU - 20 - 1) / (FRAGPERF_MTU - 20))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct fragperf_result_s {
+	int ready;                     /* The netif and the pcb were set up */
+	int nframes;                   /* Frames sent for the last datagram */
+	uint64_t txusec;               /* Fragmenting the datagrams */
+	uint64_t rxusec[2];            /* Reassembling, in order and reversed */
+	int received[2];               /* Datagrams delivered intact */
+	int bad;                       /* Datagrams delivered damaged */
+	int dropped;                   /* Frames without a receive buffer */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct netif g_netif;
+static struct udp_pcb *g_pcb;
+static sem_t g_done;
+static struct fragperf_result_s g_result;
+
+/* The datagram sent, and the frames of the last one "transmitted" */
+static u8_t g_payload[FRAGPERF_DGRAM];
+static u8_t g_frames[FRAGPERF_NFRAGS][FRAGPERF_MTU];
+static u16_t g_framelen[FRAGPERF_NFRAGS];
+static int g_nframes;
+static int g_received;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t fragperf_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(FRAGPERF_CLOCK, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void fragperf_report(const char *name, uint64_t usec)
+{
+	uint64_t kbytes = (uint64_t)FRAGPERF_DGRAM * CONFIG_EXAMPLES_FRAGPERF_LOOPS / 1000;
+
+	if (usec == 0) {
+		usec = 1;
+	}
+	printf("  %-16s %llu usec, %llu datagrams/s, %llu KB/s\n", name, (unsigned long long)usec, (unsigned long long)((uint64_t)CONFIG_EXAMPLES_FRAGPERF_LOOPS * 1000000 / usec), (unsigned long long)(kbytes * 1000000 / usec));
+}
+
+/* The netif "transmits" by keeping a copy of each frame */
+
+static err_t fragperf_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+	if (g_nframes < FRAGPERF_NFRAGS) {
+		g_framelen[g_nframes] = pbuf_copy_partial(p, g_frames[g_nframes], FRAGPERF_MTU, 0);
+	}
+
+	g_nframes++;
+	return ERR_OK;
+}
+
+static err_t fragperf_netif_init(struct netif *netif)
+{
+	netif->name[0] = 'f';
+	netif->name[1] = 'p';
+	netif->output = fragperf_output;
+	netif->mtu = FRAGPERF_MTU;
+	netif->flags = NETIF_FLAG_LINK_UP;
+	return ERR_OK;
+}
+
+static void fragperf_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+	if (p->tot_len == FRAGPERF_DGRAM && pbuf_memcmp(p, 0, g_payload, FRAGPERF_DGRAM) == 0) {
+		g_received++;
+	} else {
+		g_result.bad++;
+	}
+
+	pbuf_free(p);
+}
+
+/* Send one datagram; its payload is referenced by the fragments, not copied */
+
+static void fragperf_send(const ip_addr_t *peer)
+{
+	struct pbuf *p;
+
+	p = pbuf_alloc(PBUF_TRANSPORT, FRAGPERF_DGRAM, PBUF_REF);
+	if (p != NULL) {
+		p->payload = g_payload;
+		(void)udp_sendto(g_pcb, p, peer, FRAGPERF_PORT);
+		pbuf_free(p);
+	}
+}
+
+/* Receive a frame the way a driver does: copy it into a pool buffer */
+
+static void fragperf_input(int frame)
+{
+	struct pbuf *p;
+
+	p = pbuf_alloc(PBUF_RAW, g_framelen[frame], PBUF_POOL);
+	if (p == NULL) {
+		g_result.dropped++;
+		return;
+	}
+
+	(void)pbuf_take(p, g_frames[frame], g_framelen[frame]);
+	(void)ip4_input(p, &g_netif);
+}
+
+/* Runs in the tcpip thread, so that the raw API may be used */
+
+static void fragperf_run(void *arg)
+{
+	ip4_addr_t ipaddr;
+	ip4_addr_t netmask;
+	ip_addr_t peer;
+	uint64_t start;
+	int pass;
+	int i;
+	int j;
+
+	IP4_ADDR(&ipaddr, 10, 255, 0, 1);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	IP_ADDR4(&peer, 10, 255, 0, 2);
+
+	if (netif_add(&g_netif, &ipaddr, &netmask, IP4_ADDR_ANY4, NULL, fragperf_netif_init, NULL) == NULL) {
+		goto done;
+	}
+
+	netif_set_up(&g_netif);
+
+	g_pcb = udp_new();
+	if (g_pcb == NULL || udp_bind(g_pcb, IP_ADDR_ANY, FRAGPERF_PORT) != ERR_OK) {
+		goto errout_with_netif;
+	}
+
+	udp_recv(g_pcb, fragperf_recv, NULL);
+	g_result.ready = 1;
+
+	/* Sending: the datagram is cut into fragments */
+
+	start = fragperf_usec();
+	for (i = 0; i < CONFIG_EXAMPLES_FRAGPERF_LOOPS; i++) {
+		g_nframes = 0;
+		fragperf_send(&peer);
+	}
+
+	g_result.txusec = fragperf_usec() - start;
+	g_result.nframes = g_nframes;
+
+	/* Receiving: become the peer and reassemble the last datagram sent,
+	 * with the fragments in order and then reversed.
+	 */
+
+	if (g_nframes == FRAGPERF_NFRAGS) {
+		netif_set_ipaddr(&g_netif, ip_2_ip4(&peer));
+		for (pass = 0; pass < 2; pass++) {
+			g_received = 0;
+			start = fragperf_usec();
+			for (i = 0; i < CONFIG_EXAMPLES_FRAGPERF_LOOPS; i++) {
+				for (j = 0; j < FRAGPERF_NFRAGS; j++) {
+					fragperf_input(pass == 0 ? j : FRAGPERF_NFRAGS - 1 - j);
+				}
+			}
+
+			g_result.rxusec[pass] = fragperf_usec() - start;
+			g_result.received[pass] = g_received;
+		}
+	}
+
+errout_with_netif:
+	if (g_pcb != NULL) {
+		udp_remove(g_pcb);
+		g_pcb = NULL;
+	}
+
+	netif_remove(&g_netif);
+
+done:
+	sem_post(&g_done);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int fragperf_main(int argc, char *argv[])
+#endif
+{
+	int i;
+
+	for (i = 0; i < FRAGPERF_DGRAM; i++) {
+		g_payload[i] = (u8_t)(i * 7 + 3);
+	}
+
+	memset(&g_result, 0, sizeof(g_result));
+	sem_init(&g_done, 0, 0);
+
+	printf("fragperf: %d x %d byte datagrams, MTU %d\n", CONFIG_EXAMPLES_FRAGPERF_LOOPS, FRAGPERF_DGRAM, FRAGPERF_MTU);
+
+	if (tcpip_callback(fragperf_run, NULL) != ERR_OK) {
+		printf("fragperf: tcpip_callback failed\n");
+		sem_destroy(&g_done);
+		return -1;
+	}
+
+	while (sem_wait(&g_done) != 0) {
+	}
+
+	sem_destroy(&g_done);
+
+	if (!g_result.ready) {
+		printf("fragperf: cannot set up the netif\n");
+		return -1;
+	}
+
+	fragperf_report("fragment", g_result.txusec);
+	if (g_result.nframes != FRAGPERF_NFRAGS) {
+		printf("fragperf: %d frames per datagram, expected %d\n", g_result.nframes, FRAGPERF_NFRAGS);
+		return -1;
+	}
+
+	fragperf_report("reassemble", g_result.rxusec[0]);
+	fragperf_report("reassemble rev", g_result.rxusec[1]);
+
+	if (g_result.received[0] != CONFIG_EXAMPLES_FRAGPERF_LOOPS || g_result.received[1] != CONFIG_EXAMPLES_FRAGPERF_LOOPS || g_result.bad > 0) {
+		printf("fragperf: delivered %d and %d, %d damaged, %d frames dropped\n", g_result.received[0], g_result.received[1], g_result.bad, g_result.dropped);
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,184 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/**************************************************************************
+ * Included Files
+ **************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <aio.h>
+#include <errno.h>
+
+#include "kernel_sample.h"
+
+/**************************************************************************
+ * Private Definitions
+ **************************************************************************/
+
+#define AIOPERF_NFILES      2
+#define AIOPERF_NREQS       8			/* Adjacent requests per file in a batch */
+#define AIOPERF_NBYTES      (16 * 1024)	/* Written to and read from each file */
+#define AIOPERF_MAXXFER     512
+#define AIOPERF_NLIST       (AIOPERF_NFILES * AIOPERF_NREQS)
+
+/**************************************************************************
+ * Private Variables
+ **************************************************************************/
+
+/* One file on the flash file system and one on the RAM disk */
+
+static FAR const char *const g_paths[AIOPERF_NFILES] = {
+	CONFIG_EXAMPLES_KERNEL_SAMPLE_AIOPATH "/aioperf0.dat",
+	CONFIG_EXAMPLES_KERNEL_SAMPLE_AIO_RAMPATH "/aioperf1.dat",
+};
+
+static const size_t g_xfersizes[] = { 32, 128, 512 };
+
+static struct aiocb g_aiocbs[AIOPERF_NLIST];
+static struct aiocb *g_list[AIOPERF_NLIST];
+static uint8_t g_buffer[AIOPERF_NLIST][AIOPERF_MAXXFER];
+
+/**************************************************************************
+ * Private Functions
+ **************************************************************************/
+
+static uint8_t aioperf_byte(int file, off_t pos)
+{
+	return (uint8_t)(pos + file * 101);
+}
+
+/* Transfer AIOPERF_NBYTES to or from every file in lio_listio() batches of
+ * adjacent requests, interleaving the files within each batch, and return
+ * the throughput in KB/s, or a negative value on failure.
+ */
+
+static long aioperf_run(FAR const int *fd, size_t xfersize, int opcode)
+{
+	FAR struct aiocb *aiocbp;
+	struct timespec start;
+	unsigned long usec = 0;
+	off_t offset;
+	size_t n;
+	int nerrors = 0;
+	int file;
+	int i;
+
+	for (offset = 0; offset < AIOPERF_NBYTES; offset += AIOPERF_NREQS * xfersize) {
+		for (i = 0; i < AIOPERF_NLIST; i++) {
+			file = i % AIOPERF_NFILES;
+			aiocbp = &g_aiocbs[i];
+			memset(aiocbp, 0, sizeof(struct aiocb));
+
+			aiocbp->aio_sigevent.sigev_notify = SIGEV_NONE;
+			aiocbp->aio_buf = g_buffer[i];
+			aiocbp->aio_offset = offset + (i / AIOPERF_NFILES) * xfersize;
+			aiocbp->aio_nbytes = xfersize;
+			aiocbp->aio_fildes = fd[file];
+			aiocbp->aio_lio_opcode = opcode;
+			g_list[i] = aiocbp;
+
+			for (n = 0; n < xfersize; n++) {
+				g_buffer[i][n] = opcode == LIO_WRITE ? aioperf_byte(file, aiocbp->aio_offset + n) : 0;
+			}
+		}
+
+		kernel_sample_gettime(&start);
+		if (lio_listio(LIO_WAIT, g_list, AIOPERF_NLIST, NULL) < 0) {
+			printf("aioperf_test: ERROR lio_listio failed, errno=%d\n", errno);
+			return -1;
+		}
+
+		usec += kernel_sample_elapsed_usec(&start);
+
+		for (i = 0; i < AIOPERF_NLIST; i++) {
+			file = i % AIOPERF_NFILES;
+			aiocbp = &g_aiocbs[i];
+			if (aio_error(aiocbp) != 0 || aio_return(aiocbp) != (ssize_t)xfersize) {
+				nerrors++;
+				continue;
+			}
+
+			if (opcode == LIO_READ) {
+				for (n = 0; n < xfersize; n++) {
+					if (g_buffer[i][n] != aioperf_byte(file, aiocbp->aio_offset + n)) {
+						nerrors++;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	if (nerrors > 0) {
+		printf("aioperf_test: ERROR %d requests failed\n", nerrors);
+		return -1;
+	}
+
+	if (usec == 0) {
+		usec = 1;
+	}
+
+	return (long)((unsigned long long)AIOPERF_NFILES * AIOPERF_NBYTES * 1000000 / 1024 / usec);
+}
+
+/**************************************************************************
+ * Public Functions
+ **************************************************************************/
+
+/* Measure asynchronous I/O throughput to a flash file and a RAM disk file
+ * at once for several request sizes.
+ */
+
+void aioperf_test(void)
+{
+	int fd[AIOPERF_NFILES];
+	int i;
+	int j;
+
+	for (i = 0; i < AIOPERF_NFILES; i++) {
+		fd[i] = open(g_paths[i], O_RDWR | O_CREAT | O_TRUNC, 0666);
+		if (fd[i] < 0) {
+			printf("aioperf_test: ERROR failed to open %s, errno=%d\n", g_paths[i], errno);
+			goto errout;
+		}
+	}
+
+	printf("aioperf_test: %d bytes to each of %s and %s, %d requests per file per batch\n", AIOPERF_NBYTES, g_paths[0], g_paths[1], AIOPERF_NREQS);
+	printf("aioperf_test: %8s %12s %12s\n", "size", "write KB/s", "read KB/s");
+
+	for (j = 0; j < sizeof(g_xfersizes) / sizeof(g_xfersizes[0]); j++) {
+		long wrspeed = aioperf_run(fd, g_xfersizes[j], LIO_WRITE);
+		long rdspeed = aioperf_run(fd, g_xfersizes[j], LIO_READ);
+
+		printf("aioperf_test: %8lu %12ld %12ld\n", (unsigned long)g_xfersizes[j], wrspeed, rdspeed);
+	}
+
+errout:
+	while (--i >= 0) {
+		close(fd[i]);
+		unlink(g_paths[i]);
+	}
+}
@@ -59,6 +59,8 @@
 
 #include <tinyara/config.h>
 
+#include <time.h>
+
 /****************************************************************************
  * Definitions
  ****************************************************************************/
@@ -108,6 +110,16 @@
 #  define FFLUSH()
 #endif
 
+/* The performance tests time themselves on the monotonic clock when there is
+ * one, so that a clock_settime() during a run does not skew the result.
+ */
+
+#ifdef CLOCK_MONOTONIC
+#  define KERNEL_SAMPLE_CLOCK CLOCK_MONOTONIC
+#else
+#  define KERNEL_SAMPLE_CLOCK CLOCK_REALTIME
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -116,6 +128,27 @@
  * Public Variables
  ****************************************************************************/
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* Start a measurement */
+
+static inline void kernel_sample_gettime(FAR struct timespec *start)
+{
+	clock_gettime(KERNEL_SAMPLE_CLOCK, start);
+}
+
+/* Microseconds elapsed since kernel_sample_gettime(start) */
+
+static inline unsigned long kernel_sample_elapsed_usec(FAR const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(KERNEL_SAMPLE_CLOCK, &now);
+	return (unsigned long)((now.tv_sec - start->tv_sec) * 1000000L + (now.tv_nsec - start->tv_nsec) / 1000);
+}
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -134,6 +167,18 @@ void fpu_test(void);
 void aio_test(void);
 #endif
 
+/* aioperf.c ****************************************************************/
+
+#ifdef CONFIG_EXAMPLES_KERNEL_SAMPLE_AIO
+void aioperf_test(void);
+#endif
+
+/* mmap.c *******************************************************************/
+
+#ifdef CONFIG_FS_ROMFS
+void mmap_test(void);
+#endif
+
 /* restart.c ****************************************************************/
 
 void restart_test(void);
@@ -176,6 +221,26 @@ void mqueue_test(void);
 
 void timedmqueue_test(void);
 
+/* mqperf.c *****************************************************************/
+
+void mqperf_test(void);
+
+/* spawnperf.c **************************************************************/
+
+void spawnperf_test(void);
+
+/* mutexperf.c **************************************************************/
+
+void mutexperf_test(void);
+
+/* wakeperf.c ***************************************************************/
+
+void wakeperf_test(void);
+
+/* pipeperf.c ***************************************************************/
+
+void pipeperf_test(void);
+
 /* cancel.c *****************************************************************/
 
 void cancel_test(void);
@@ -331,6 +331,22 @@ static int user_main(int argc, char *argv[])
 		check_test_memory_usage();
 #endif
 
+#ifdef CONFIG_EXAMPLES_KERNEL_SAMPLE_AIO
+		/* Measure asynchronous I/O throughput to two file systems at once */
+
+		printf("\nuser_main: AIO throughput test\n");
+		aioperf_test();
+		check_test_memory_usage();
+#endif
+
+#ifdef CONFIG_FS_ROMFS
+		/* Check that mmap() of a ROMFS file on XIP media is done in place */
+
+		printf("\nuser_main: mmap test\n");
+		mmap_test();
+		check_test_memory_usage();
+#endif
+
 		/* Checkout task_restart() */
 
 		printf("\nuser_main: task_restart test\n");
@@ -369,6 +385,38 @@ static int user_main(int argc, char *argv[])
 		check_test_memory_usage();
 #endif
 
+#ifndef CONFIG_DISABLE_PTHREAD
+		/* Measure the cost of short-lived pthreads */
+
+		printf("\nuser_main: thread spawn test\n");
+		spawnperf_test();
+		check_test_memory_usage();
+#endif
+
+#ifndef CONFIG_DISABLE_PTHREAD
+		/* Measure the cost of mutex lock/unlock */
+
+		printf("\nuser_main: mutex performance test\n");
+		mutexperf_test();
+		check_test_memory_usage();
+#endif
+
+#ifndef CONFIG_DISABLE_PTHREAD
+		/* Compare the cost of waking another thread */
+
+		printf("\nuser_main: wakeup performance test\n");
+		wakeperf_test();
+		check_test_memory_usage();
+#endif
+
+#if !defined(CONFIG_DISABLE_PTHREAD) && defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+		/* Measure pipe throughput for several transfer sizes */
+
+		printf("\nuser_main: pipe throughput test\n");
+		pipeperf_test();
+		check_test_memory_usage();
+#endif
+
 #ifndef CONFIG_DISABLE_PTHREAD
 		/* Verify pthreads and semaphores */
 
@@ -424,6 +472,14 @@ static int user_main(int argc, char *argv[])
 		check_test_memory_usage();
 #endif
 
+#if !defined(CONFIG_DISABLE_MQUEUE) && !defined(CONFIG_DISABLE_PTHREAD)
+		/* Compare copied and by-reference message throughput */
+
+		printf("\nuser_main: message queue throughput test\n");
+		mqperf_test();
+		check_test_memory_usage();
+#endif
+
 #ifndef CONFIG_DISABLE_SIGNALS
 		/* Verify signal handlers */
 
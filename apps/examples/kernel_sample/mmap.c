@@ -0,0 +1,209 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**************************************************************************
+ * Included Files
+ **************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/mount.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ramdisk.h>
+
+#include "kernel_sample.h"
+
+/**************************************************************************
+ * Private Definitions
+ **************************************************************************/
+
+#define MMAP_MINOR          7
+#define MMAP_DEVNAME        "/dev/ram7"
+#define MMAP_MOUNTPT        "/mnt/mmap"
+#define MMAP_FILENAME       MMAP_MOUNTPT "/mmap.txt"
+#define MMAP_SECTORSIZE     512
+
+/**************************************************************************
+ * Private Variables
+ **************************************************************************/
+
+/* The contents of mmap.txt */
+
+static const char g_mmap_text[] = "This file is mapped in place by mmap().\nIts bytes live in the ROMFS image.\n";
+
+/* A ROMFS image holding only mmap.txt.  The file data starts at offset 64.
+ * The rest of the sector is zero.
+ */
+
+#define MMAP_DATAOFFSET     64
+
+static uint8_t g_mmap_image[MMAP_SECTORSIZE] = {
+	0x2d, 0x72, 0x6f, 0x6d, 0x31, 0x66, 0x73, 0x2d, 0x00, 0x00, 0x00, 0x90,
+	0x44, 0x33, 0xc0, 0x0c, 0x6d, 0x6d, 0x61, 0x70, 0x74, 0x65, 0x73, 0x74,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4b, 0x64, 0x1e, 0x25, 0xcf,
+	0x6d, 0x6d, 0x61, 0x70, 0x2e, 0x74, 0x78, 0x74, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x54, 0x68, 0x69, 0x73, 0x20, 0x66, 0x69, 0x6c,
+	0x65, 0x20, 0x69, 0x73, 0x20, 0x6d, 0x61, 0x70, 0x70, 0x65, 0x64, 0x20,
+	0x69, 0x6e, 0x20, 0x70, 0x6c, 0x61, 0x63, 0x65, 0x20, 0x62, 0x79, 0x20,
+	0x6d, 0x6d, 0x61, 0x70, 0x28, 0x29, 0x2e, 0x0a, 0x49, 0x74, 0x73, 0x20,
+	0x62, 0x79, 0x74, 0x65, 0x73, 0x20, 0x6c, 0x69, 0x76, 0x65, 0x20, 0x69,
+	0x6e, 0x20, 0x74, 0x68, 0x65, 0x20, 0x52, 0x4f, 0x4d, 0x46, 0x53, 0x20,
+	0x69, 0x6d, 0x61, 0x67, 0x65, 0x2e, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+/**************************************************************************
+ * Private Functions
+ **************************************************************************/
+
+/* Map mmap.txt at 'offset' and check that the mapping is the image itself */
+
+static int mmap_check(int fd, off_t offset)
+{
+	size_t length = sizeof(g_mmap_text) - 1 - offset;
+	FAR char *addr;
+
+	addr = (FAR char *)mmap(NULL, length, PROT_READ, MAP_SHARED, fd, offset);
+	if (addr == MAP_FAILED) {
+		printf("mmap_test: ERROR mmap at offset %d failed, errno=%d\n", (int)offset, errno);
+		return ERROR;
+	}
+
+	if (addr != (FAR char *)&g_mmap_image[MMAP_DATAOFFSET + offset]) {
+		printf("mmap_test: ERROR offset %d mapped at %p, not in place at %p\n", (int)offset, addr, &g_mmap_image[MMAP_DATAOFFSET + offset]);
+		(void)munmap(addr, length);
+		return ERROR;
+	}
+
+	if (memcmp(addr, &g_mmap_text[offset], length) != 0) {
+		printf("mmap_test: ERROR contents at offset %d differ\n", (int)offset);
+		(void)munmap(addr, length);
+		return ERROR;
+	}
+
+	if (munmap(addr, length) != 0) {
+		printf("mmap_test: ERROR munmap failed, errno=%d\n", errno);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/* mmap() must fail with 'expected' */
+
+static int mmap_reject(int fd, size_t length, int prot, int flags, off_t offset, int expected)
+{
+	FAR void *addr;
+
+	addr = mmap(NULL, length, prot, flags, fd, offset);
+	if (addr != MAP_FAILED) {
+		printf("mmap_test: ERROR mapping %u bytes at %d succeeded\n", (unsigned int)length, (int)offset);
+		(void)munmap(addr, length);
+		return ERROR;
+	}
+
+	if (errno != expected) {
+		printf("mmap_test: ERROR errno=%d, expected %d\n", errno, expected);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/**************************************************************************
+ * Public Functions
+ **************************************************************************/
+
+/* Mount a ROMFS image on a RAM disk, which reports its buffer as XIP
+ * media, and check that mmap() of a file in it is used in place.  This
+ * path needs no heap and does not depend on CONFIG_FS_RAMMAP.
+ */
+
+void mmap_test(void)
+{
+	off_t pos;
+	int nerrors = 0;
+	int ret;
+	int fd;
+
+	ret = romdisk_register(MMAP_MINOR, g_mmap_image, 1, MMAP_SECTORSIZE);
+	if (ret < 0) {
+		printf("mmap_test: ERROR romdisk_register failed: %d\n", ret);
+		return;
+	}
+
+	ret = mount(MMAP_DEVNAME, MMAP_MOUNTPT, "romfs", MS_RDONLY, NULL);
+	if (ret < 0) {
+		printf("mmap_test: ERROR mount failed, errno=%d\n", errno);
+		goto errout_with_disk;
+	}
+
+	fd = open(MMAP_FILENAME, O_RDONLY);
+	if (fd < 0) {
+		printf("mmap_test: ERROR open failed, errno=%d\n", errno);
+		goto errout_with_mount;
+	}
+
+	/* Whole file, then a region that starts inside it */
+
+	if (mmap_check(fd, 0) < 0) {
+		nerrors++;
+	}
+
+	if (mmap_check(fd, 5) < 0) {
+		nerrors++;
+	}
+
+	/* Past the end of the file, and writable in place */
+
+	if (mmap_reject(fd, sizeof(g_mmap_text), PROT_READ, MAP_SHARED, 0, ENXIO) < 0) {
+		nerrors++;
+	}
+
+	if (mmap_reject(fd, 16, PROT_READ | PROT_WRITE, MAP_SHARED, 0, EACCES) < 0) {
+		nerrors++;
+	}
+
+	/* None of that may move the file position */
+
+	pos = lseek(fd, 0, SEEK_CUR);
+	if (pos != 0) {
+		printf("mmap_test: ERROR file position moved to %d\n", (int)pos);
+		nerrors++;
+	}
+
+	close(fd);
+
+	if (nerrors == 0) {
+		printf("mmap_test: in-place mapping of a ROMFS file OK\n");
+	}
+
+errout_with_mount:
+	(void)umount(MMAP_MOUNTPT);
+
+errout_with_disk:
+	(void)unregister_blockdriver(MMAP_DEVNAME);
+}
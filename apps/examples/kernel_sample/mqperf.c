@@ -0,0 +1,246 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/**************************************************************************
+ * Included Files
+ **************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+#include <mqueue.h>
+#include <sched.h>
+#include <errno.h>
+
+#include "kernel_sample.h"
+
+/**************************************************************************
+ * Private Definitions
+ **************************************************************************/
+
+#define TEST_NMSGS          (256)
+#define TEST_QDEPTH         (8)
+
+#ifdef CONFIG_MQ_QUEUE_MAXMSGSIZE
+#  define TEST_MAXMSGSIZE   CONFIG_MQ_QUEUE_MAXMSGSIZE
+#else
+#  define TEST_MAXMSGSIZE   CONFIG_MQ_MAXMSGSIZE
+#endif
+
+/**************************************************************************
+ * Private Types
+ **************************************************************************/
+
+struct mqperf_s {
+	size_t msgsize;				/* Size of every message */
+	bool byref;					/* Use mq_sendref()/mq_receiveref() */
+	int nerrors;				/* Messages lost or corrupted */
+};
+
+/**************************************************************************
+ * Private Variables
+ **************************************************************************/
+
+static const size_t g_msgsizes[] = { 16, 32, 128, 512, 1024 };
+
+/**************************************************************************
+ * Private Functions
+ **************************************************************************/
+
+static void *mqperf_receiver(void *arg)
+{
+	FAR struct mqperf_s *perf = (FAR struct mqperf_s *)arg;
+	FAR char *buffer = NULL;
+	FAR void *ref;
+	mqd_t mqfd;
+	ssize_t nbytes;
+	int i;
+
+	mqfd = mq_open("mqperf", O_RDONLY);
+	if (mqfd == (mqd_t)-1) {
+		perf->nerrors = TEST_NMSGS;
+		return NULL;
+	}
+
+	if (!perf->byref) {
+		buffer = (FAR char *)malloc(perf->msgsize);
+	}
+
+	for (i = 0; i < TEST_NMSGS; i++) {
+		if (perf->byref) {
+			nbytes = mq_receiveref(mqfd, &ref, NULL);
+			if (nbytes >= 0) {
+				if (((FAR char *)ref)[0] != (char)i) {
+					nbytes = -1;
+				}
+
+				free(ref);
+			}
+		} else if (buffer) {
+			nbytes = mq_receive(mqfd, buffer, perf->msgsize, NULL);
+			if (nbytes >= 0 && buffer[0] != (char)i) {
+				nbytes = -1;
+			}
+		} else {
+			nbytes = -1;
+		}
+
+		if (nbytes != (ssize_t)perf->msgsize) {
+			perf->nerrors++;
+		}
+	}
+
+	free(buffer);
+	mq_close(mqfd);
+	return NULL;
+}
+
+/* Send TEST_NMSGS messages of one size to a receiver thread and return the
+ * throughput in KB/s, or a negative value on failure.
+ */
+
+static long mqperf_run(size_t msgsize, bool byref)
+{
+	struct mqperf_s perf;
+	struct mq_attr attr;
+	struct timespec start;
+	pthread_attr_t pattr;
+	pthread_t receiver;
+	unsigned long usec;
+	FAR char *msg = NULL;
+	mqd_t mqfd;
+	int status;
+	int i;
+
+	attr.mq_maxmsg  = TEST_QDEPTH;
+	attr.mq_msgsize = msgsize;
+	attr.mq_flags   = 0;
+
+	mqfd = mq_open("mqperf", O_WRONLY | O_CREAT, 0666, &attr);
+	if (mqfd == (mqd_t)-1) {
+		printf("mqperf_test: ERROR mq_open failed, errno=%d\n", errno);
+		return -1;
+	}
+
+	perf.msgsize = msgsize;
+	perf.byref = byref;
+	perf.nerrors = 0;
+
+	pthread_attr_init(&pattr);
+	pthread_attr_setstacksize(&pattr, STACKSIZE);
+	status = pthread_create(&receiver, &pattr, mqperf_receiver, &perf);
+	if (status != 0) {
+		printf("mqperf_test: ERROR pthread_create failed, status=%d\n", status);
+		mq_close(mqfd);
+		mq_unlink("mqperf");
+		return -1;
+	}
+
+	if (!byref) {
+		msg = (FAR char *)zalloc(msgsize);
+	}
+
+	kernel_sample_gettime(&start);
+	for (i = 0; i < TEST_NMSGS; i++) {
+		if (byref) {
+			/* The receiver frees it */
+
+			msg = (FAR char *)malloc(msgsize);
+			if (!msg) {
+				break;
+			}
+
+			msg[0] = (char)i;
+			if (mq_sendref(mqfd, msg, msgsize, 42) < 0) {
+				free(msg);
+				break;
+			}
+		} else {
+			if (!msg) {
+				break;
+			}
+
+			msg[0] = (char)i;
+			if (mq_send(mqfd, msg, msgsize, 42) < 0) {
+				break;
+			}
+		}
+	}
+
+	if (i < TEST_NMSGS) {
+		/* The receiver would wait forever for the rest */
+
+		printf("mqperf_test: ERROR send %d of %lu bytes failed, errno=%d\n", i, (unsigned long)msgsize, errno);
+		pthread_cancel(receiver);
+	}
+
+	pthread_join(receiver, NULL);
+	usec = kernel_sample_elapsed_usec(&start);
+
+	if (!byref) {
+		free(msg);
+	}
+
+	mq_close(mqfd);
+	mq_unlink("mqperf");
+
+	if (i < TEST_NMSGS) {
+		return -1;
+	}
+
+	if (perf.nerrors > 0) {
+		printf("mqperf_test: ERROR %d of %d messages of %lu bytes lost\n", perf.nerrors, TEST_NMSGS, (unsigned long)msgsize);
+		return -1;
+	}
+
+	if (usec == 0) {
+		usec = 1;
+	}
+
+	return (long)((unsigned long long)msgsize * TEST_NMSGS * 1000000 / 1024 / usec);
+}
+
+/**************************************************************************
+ * Public Functions
+ **************************************************************************/
+
+void mqperf_test(void)
+{
+	long copy;
+	long ref;
+	int i;
+
+	printf("mqperf_test: %d messages, queue depth %d\n", TEST_NMSGS, TEST_QDEPTH);
+	printf("mqperf_test: %8s %12s %12s\n", "size", "copy KB/s", "by-ref KB/s");
+
+	for (i = 0; i < sizeof(g_msgsizes) / sizeof(g_msgsizes[0]); i++) {
+		if (g_msgsizes[i] > TEST_MAXMSGSIZE) {
+			break;
+		}
+
+		copy = mqperf_run(g_msgsizes[i], false);
+		ref = mqperf_run(g_msgsizes[i], true);
+		printf("mqperf_test: %8lu %12ld %12ld\n", (unsigned long)g_msgsizes[i], copy, ref);
+	}
+}
@@ -0,0 +1,225 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**************************************************************************
+ * Included Files
+ **************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "kernel_sample.h"
+
+/**************************************************************************
+ * Private Definitions
+ **************************************************************************/
+
+#define TEST_NLOOPS         (100000)
+#define TEST_NSHARED        (10000)
+#define TEST_NWAKES         (500)
+
+/**************************************************************************
+ * Private Variables
+ **************************************************************************/
+
+static pthread_mutex_t g_mutex;
+static volatile int g_counter;
+static volatile bool g_stop;
+static volatile int g_errors;
+
+/**************************************************************************
+ * Private Functions
+ **************************************************************************/
+
+/* Increment the shared counter under the mutex, yielding while holding it
+ * now and then so that the other thread has to wait for it.
+ */
+
+static void *mutexperf_thread(void *arg)
+{
+	int i;
+
+	for (i = 0; i < TEST_NSHARED; i++) {
+		pthread_mutex_lock(&g_mutex);
+		g_counter++;
+		if ((i & 15) == 0) {
+			sched_yield();
+		}
+		pthread_mutex_unlock(&g_mutex);
+	}
+
+	return NULL;
+}
+
+/* Lock and unlock as fast as possible until told to stop.  The timer
+ * interrupt that wakes the stealer preempts this thread at any point of
+ * the lock, including inside the fast path.
+ */
+
+static void *mutexperf_locker(void *arg)
+{
+	int ret;
+
+	while (!g_stop) {
+		ret = pthread_mutex_lock(&g_mutex);
+		if (ret != 0) {
+			printf("mutexperf_test: ERROR lock failed: %d\n", ret);
+			g_errors++;
+			break;
+		}
+
+		g_counter++;
+
+		ret = pthread_mutex_unlock(&g_mutex);
+		if (ret != 0) {
+			/* The mutex is lost for good: nobody may unlock it now */
+
+			printf("mutexperf_test: ERROR unlock failed: %d\n", ret);
+			g_errors++;
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/* Wake up once a tick at a higher priority and take the mutex from under
+ * the locker whenever it is free.  trylock never blocks, so a mutex that
+ * the locker can no longer release does not hang the test.
+ */
+
+static void *mutexperf_stealer(void *arg)
+{
+	int ret;
+	int i;
+
+	for (i = 0; i < TEST_NWAKES && g_errors == 0; i++) {
+		usleep(1);
+		if (pthread_mutex_trylock(&g_mutex) == 0) {
+			ret = pthread_mutex_unlock(&g_mutex);
+			if (ret != 0) {
+				printf("mutexperf_test: ERROR stealer unlock failed: %d\n", ret);
+				g_errors++;
+			}
+		}
+	}
+
+	g_stop = true;
+	return NULL;
+}
+
+/**************************************************************************
+ * Public Functions
+ **************************************************************************/
+
+/* Measure the cost of an uncontended lock/unlock pair, then let two
+ * threads of equal priority fight over the mutex and verify that no
+ * update was lost.  Compare the figures with and without
+ * CONFIG_PTHREAD_MUTEX_FASTPATH.  Last, let a higher priority thread
+ * preempt a thread that locks and unlocks in a tight loop and take the
+ * mutex on the slow path, and check that every unlock still succeeds.
+ */
+
+void mutexperf_test(void)
+{
+	struct sched_param param;
+	pthread_attr_t attr;
+	struct timespec start;
+	unsigned long usec;
+	pthread_t thread1;
+	pthread_t thread2;
+	int status;
+	int i;
+
+	pthread_mutex_init(&g_mutex, NULL);
+
+	kernel_sample_gettime(&start);
+	for (i = 0; i < TEST_NLOOPS; i++) {
+		pthread_mutex_lock(&g_mutex);
+		pthread_mutex_unlock(&g_mutex);
+	}
+
+	usec = kernel_sample_elapsed_usec(&start);
+	printf("mutexperf_test: %d uncontended lock/unlock pairs in %lu usec (%lu nsec each)\n", TEST_NLOOPS, usec, (unsigned long)((unsigned long long)usec * 1000 / TEST_NLOOPS));
+
+	g_counter = 0;
+	kernel_sample_gettime(&start);
+
+	status = pthread_create(&thread1, NULL, mutexperf_thread, NULL);
+	if (status != 0) {
+		printf("mutexperf_test: ERROR pthread_create failed, status=%d\n", status);
+		goto errout;
+	}
+
+	status = pthread_create(&thread2, NULL, mutexperf_thread, NULL);
+	if (status != 0) {
+		printf("mutexperf_test: ERROR pthread_create failed, status=%d\n", status);
+		pthread_join(thread1, NULL);
+		goto errout;
+	}
+
+	pthread_join(thread1, NULL);
+	pthread_join(thread2, NULL);
+
+	usec = kernel_sample_elapsed_usec(&start);
+	printf("mutexperf_test: %d contended increments in %lu usec\n", 2 * TEST_NSHARED, usec);
+	if (g_counter != 2 * TEST_NSHARED) {
+		printf("mutexperf_test: ERROR counter=%d, expected %d\n", g_counter, 2 * TEST_NSHARED);
+	}
+
+	g_counter = 0;
+	g_errors = 0;
+	g_stop = false;
+
+	status = pthread_create(&thread1, NULL, mutexperf_locker, NULL);
+	if (status != 0) {
+		printf("mutexperf_test: ERROR pthread_create failed, status=%d\n", status);
+		goto errout;
+	}
+
+	/* One above the locker, which has the default priority */
+
+	pthread_attr_init(&attr);
+	pthread_attr_getschedparam(&attr, &param);
+	param.sched_priority++;
+	pthread_attr_setschedparam(&attr, &param);
+
+	status = pthread_create(&thread2, &attr, mutexperf_stealer, NULL);
+	pthread_attr_destroy(&attr);
+	if (status != 0) {
+		printf("mutexperf_test: ERROR pthread_create failed, status=%d\n", status);
+		g_stop = true;
+		pthread_join(thread1, NULL);
+		goto errout;
+	}
+
+	pthread_join(thread2, NULL);
+	pthread_join(thread1, NULL);
+
+	if (g_errors == 0) {
+		printf("mutexperf_test: %d preemptions of %d lock/unlock pairs OK\n", TEST_NWAKES, g_counter);
+	}
+
+errout:
+	pthread_mutex_destroy(&g_mutex);
+}
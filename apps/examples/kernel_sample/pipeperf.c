@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**************************************************************************
+ * Included Files
+ **************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <errno.h>
+
+#include "kernel_sample.h"
+
+/**************************************************************************
+ * Private Definitions
+ **************************************************************************/
+
+#define TEST_NBYTES         (64 * 1024)
+#define TEST_MAXXFER        (1024)
+
+/**************************************************************************
+ * Private Types
+ **************************************************************************/
+
+struct pipeperf_s {
+	int fd;						/* Read end of the pipe */
+	size_t xfersize;			/* Size of every read() */
+	size_t nread;				/* Bytes received */
+	int nerrors;				/* Bytes out of sequence */
+};
+
+/**************************************************************************
+ * Private Variables
+ **************************************************************************/
+
+static const size_t g_xfersizes[] = { 1, 16, 64, 256, 1024 };
+
+/**************************************************************************
+ * Private Functions
+ **************************************************************************/
+
+static void *pipeperf_reader(void *arg)
+{
+	FAR struct pipeperf_s *perf = (FAR struct pipeperf_s *)arg;
+	char buffer[TEST_MAXXFER];
+	ssize_t nbytes;
+	ssize_t i;
+
+	while (perf->nread < TEST_NBYTES) {
+		nbytes = read(perf->fd, buffer, perf->xfersize);
+		if (nbytes <= 0) {
+			perf->nerrors++;
+			break;
+		}
+
+		for (i = 0; i < nbytes; i++) {
+			if (buffer[i] != (char)(perf->nread + i)) {
+				perf->nerrors++;
+			}
+		}
+
+		perf->nread += nbytes;
+	}
+
+	return NULL;
+}
+
+/* Push TEST_NBYTES through a pipe in transfers of one size and return the
+ * throughput in KB/s, or a negative value on failure.
+ */
+
+static long pipeperf_run(size_t xfersize)
+{
+	struct pipeperf_s perf;
+	struct timespec start;
+	char buffer[TEST_MAXXFER];
+	pthread_attr_t attr;
+	pthread_t reader;
+	unsigned long usec;
+	size_t nwritten;
+	size_t i;
+	int fd[2];
+	int status;
+
+	if (pipe(fd) < 0) {
+		printf("pipeperf_test: ERROR pipe failed, errno=%d\n", errno);
+		return -1;
+	}
+
+	perf.fd = fd[0];
+	perf.xfersize = xfersize;
+	perf.nread = 0;
+	perf.nerrors = 0;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, STACKSIZE);
+	status = pthread_create(&reader, &attr, pipeperf_reader, &perf);
+	if (status != 0) {
+		printf("pipeperf_test: ERROR pthread_create failed, status=%d\n", status);
+		close(fd[0]);
+		close(fd[1]);
+		return -1;
+	}
+
+	kernel_sample_gettime(&start);
+	for (nwritten = 0; nwritten < TEST_NBYTES; nwritten += xfersize) {
+		for (i = 0; i < xfersize; i++) {
+			buffer[i] = (char)(nwritten + i);
+		}
+
+		if (write(fd[1], buffer, xfersize) != (ssize_t)xfersize) {
+			perf.nerrors++;
+			break;
+		}
+	}
+
+	close(fd[1]);
+	pthread_join(reader, NULL);
+	usec = kernel_sample_elapsed_usec(&start);
+	close(fd[0]);
+
+	if (perf.nerrors > 0 || perf.nread != TEST_NBYTES) {
+		printf("pipeperf_test: ERROR %d errors, %d of %d bytes received\n", perf.nerrors, perf.nread, TEST_NBYTES);
+		return -1;
+	}
+
+	if (usec == 0) {
+		usec = 1;
+	}
+
+	return (long)((unsigned long long)TEST_NBYTES * 1000000 / 1024 / usec);
+}
+
+/**************************************************************************
+ * Public Functions
+ **************************************************************************/
+
+/* Measure pipe throughput for transfer sizes from one byte up to the size
+ * of the pipe buffer.
+ */
+
+void pipeperf_test(void)
+{
+	int i;
+
+	printf("pipeperf_test: %d bytes, pipe size %d\n", TEST_NBYTES, CONFIG_DEV_PIPE_SIZE);
+	printf("pipeperf_test: %8s %12s\n", "size", "KB/s");
+
+	for (i = 0; i < sizeof(g_xfersizes) / sizeof(g_xfersizes[0]); i++) {
+		printf("pipeperf_test: %8lu %12ld\n", (unsigned long)g_xfersizes[i], pipeperf_run(g_xfersizes[i]));
+	}
+}
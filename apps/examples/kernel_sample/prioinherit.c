@@ -59,6 +59,10 @@
 #include <semaphore.h>
 #include <pthread.h>
 #include <errno.h>
+#include <sched.h>
+#include <time.h>
+
+#include <tinyara/semaphore.h>
 
 #ifdef CONFIG_ARCH_SIM
 #  include <tinyara/arch.h>
@@ -100,6 +104,11 @@
 #  define NHIGHPRI_THREADS 1
 #endif
 
+/* The stress test nests more mutexes than there are pre-allocated holders */
+
+#define STRESS_NLOCKS    (CONFIG_SEM_PREALLOCHOLDERS + 16)
+#define STRESS_NROUNDS   100
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -123,6 +132,12 @@ static int g_highpri;
 static int g_medpri;
 static int g_lowpri;
 
+static pthread_mutex_t g_stressmutex[STRESS_NLOCKS];
+static sem_t g_stressready;
+static sem_t g_stressgo;
+static sem_t g_stresshigh;
+static sem_t g_stressdone;
+
 /****************************************************************************
  * Name: nhighpri_waiting
  ****************************************************************************/
@@ -368,6 +383,174 @@ static void *lowpri_thread(void *parameter)
 	g_lowstate[threadno - 1] = DONE;
 	return retval;
 }
+
+/****************************************************************************
+ * Name: stress_lockchain
+ *
+ * Description:
+ *   Take STRESS_NLOCKS mutexes one per call level, as a deep call chain
+ *   would, and hold them all until the main thread says go.
+ *
+ ****************************************************************************/
+
+static void stress_lockchain(int depth)
+{
+	if (depth < STRESS_NLOCKS) {
+		pthread_mutex_lock(&g_stressmutex[depth]);
+		stress_lockchain(depth + 1);
+		pthread_mutex_unlock(&g_stressmutex[depth]);
+	} else {
+		sem_post(&g_stressready);
+		sem_wait(&g_stressgo);
+	}
+}
+
+/****************************************************************************
+ * Name: stress_lowthread / stress_highthread
+ ****************************************************************************/
+
+static void *stress_lowthread(void *parameter)
+{
+	int i;
+
+	for (i = 0; i < STRESS_NROUNDS; i++) {
+		stress_lockchain(0);
+	}
+	return NULL;
+}
+
+static void *stress_highthread(void *parameter)
+{
+	int i;
+
+	for (i = 0; i < STRESS_NROUNDS; i++) {
+		sem_wait(&g_stresshigh);
+
+		/* Blocks until the low priority thread has unwound its chain */
+
+		pthread_mutex_lock(&g_stressmutex[STRESS_NLOCKS - 1]);
+		pthread_mutex_unlock(&g_stressmutex[STRESS_NLOCKS - 1]);
+		sem_post(&g_stressdone);
+	}
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: stress_getprio
+ ****************************************************************************/
+
+static int stress_getprio(pthread_t thread)
+{
+	struct sched_param sparam;
+
+	if (sched_getparam((pid_t)thread, &sparam) != 0) {
+		return -1;
+	}
+	return sparam.sched_priority;
+}
+
+/****************************************************************************
+ * Name: priority_inheritance_stress
+ *
+ * Description:
+ *   A low priority thread holds STRESS_NLOCKS mutexes at once, more than
+ *   there are pre-allocated holders, while a high priority thread waits
+ *   for the innermost one.  Every round checks that the low priority
+ *   thread was boosted and that it is back at its own priority after
+ *   releasing, and the average round time is reported.
+ *
+ ****************************************************************************/
+
+static void priority_inheritance_stress(void)
+{
+	struct sched_param sparam;
+	struct timespec start;
+	pthread_attr_t attr;
+	pthread_t lowthread;
+	pthread_t highthread;
+	unsigned long usec;
+	int nboosted = 0;
+	int nrestored = 0;
+	int status;
+	int i;
+
+	printf("priority_inheritance: Stress with %d nested mutexes, %d rounds\n", STRESS_NLOCKS, STRESS_NROUNDS);
+
+	for (i = 0; i < STRESS_NLOCKS; i++) {
+		pthread_mutex_init(&g_stressmutex[i], NULL);
+	}
+
+	/* These only signal, so they must not take part in inheritance */
+
+	sem_init(&g_stressready, 0, 0);
+	sem_init(&g_stressgo, 0, 0);
+	sem_init(&g_stresshigh, 0, 0);
+	sem_init(&g_stressdone, 0, 0);
+	sem_setprotocol(&g_stressready, SEM_PRIO_NONE);
+	sem_setprotocol(&g_stressgo, SEM_PRIO_NONE);
+	sem_setprotocol(&g_stresshigh, SEM_PRIO_NONE);
+	sem_setprotocol(&g_stressdone, SEM_PRIO_NONE);
+
+	pthread_attr_init(&attr);
+	sparam.sched_priority = g_lowpri;
+	pthread_attr_setschedparam(&attr, &sparam);
+	status = pthread_create(&lowthread, &attr, stress_lowthread, NULL);
+	if (status != 0) {
+		printf("priority_inheritance: pthread_create failed, status=%d\n", status);
+		goto errout;
+	}
+
+	sparam.sched_priority = g_highpri;
+	pthread_attr_setschedparam(&attr, &sparam);
+	status = pthread_create(&highthread, &attr, stress_highthread, NULL);
+	if (status != 0) {
+		printf("priority_inheritance: pthread_create failed, status=%d\n", status);
+		sem_post(&g_stressgo);
+		(void)pthread_join(lowthread, NULL);
+		goto errout;
+	}
+
+	kernel_sample_gettime(&start);
+	for (i = 0; i < STRESS_NROUNDS; i++) {
+		/* The low priority thread holds the whole chain.  Let the high
+		 * priority thread block on it, which must boost the holder.
+		 */
+
+		sem_wait(&g_stressready);
+		sem_post(&g_stresshigh);
+		if (stress_getprio(lowthread) == g_highpri) {
+			nboosted++;
+		}
+
+		sem_post(&g_stressgo);
+		sem_wait(&g_stressdone);
+		if (stress_getprio(lowthread) == g_lowpri) {
+			nrestored++;
+		}
+	}
+	usec = kernel_sample_elapsed_usec(&start);
+
+	(void)pthread_join(highthread, NULL);
+	(void)pthread_join(lowthread, NULL);
+
+	printf("priority_inheritance: %lu usec per round\n", usec / STRESS_NROUNDS);
+	if (nboosted != STRESS_NROUNDS || nrestored != STRESS_NROUNDS) {
+		printf("priority_inheritance: ERROR boosted %d, restored %d of %d rounds\n", nboosted, nrestored, STRESS_NROUNDS);
+	} else {
+		printf("priority_inheritance: SUCCESS boosted and restored in every round\n");
+	}
+
+errout:
+	sem_destroy(&g_stressready);
+	sem_destroy(&g_stressgo);
+	sem_destroy(&g_stresshigh);
+	sem_destroy(&g_stressdone);
+	for (i = 0; i < STRESS_NLOCKS; i++) {
+		pthread_mutex_destroy(&g_stressmutex[i]);
+	}
+	dump_nfreeholders("priority_inheritance:");
+}
+
 #endif /* CONFIG_PRIORITY_INHERITANCE && !CONFIG_DISABLE_SIGNALS && !CONFIG_DISABLE_PTHREAD */
 
 /****************************************************************************
@@ -516,9 +699,12 @@ void priority_inheritance(void)
 		dump_nfreeholders("priority_inheritance:");
 	}
 
-	printf("priority_inheritance: Finished\n");
 	sem_destroy(&g_sem);
 	dump_nfreeholders("priority_inheritance:");
+
+	priority_inheritance_stress();
+
+	printf("priority_inheritance: Finished\n");
 	FFLUSH();
 #endif /* CONFIG_PRIORITY_INHERITANCE && !CONFIG_DISABLE_SIGNALS && !CONFIG_DISABLE_PTHREAD */
 }
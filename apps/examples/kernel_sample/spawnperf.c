@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/**************************************************************************
+ * Included Files
+ **************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "kernel_sample.h"
+
+/**************************************************************************
+ * Private Definitions
+ **************************************************************************/
+
+#define TEST_NTHREADS       (32)
+#define TEST_STACKSIZE      (2048)
+#define TEST_BLOCKSIZE      (64)
+
+/**************************************************************************
+ * Private Variables
+ **************************************************************************/
+
+static FAR void *g_blocks[TEST_NTHREADS];
+
+/**************************************************************************
+ * Private Functions
+ **************************************************************************/
+
+/* Like a short-lived request handler: leave an allocation behind */
+
+static void *spawnperf_thread(void *arg)
+{
+	return malloc(TEST_BLOCKSIZE);
+}
+
+/**************************************************************************
+ * Public Functions
+ **************************************************************************/
+
+/* Create and join short-lived pthreads one after the other and report the
+ * average cost of a spawn and how fragmented the heap is afterwards.
+ * Compare the figures with and without CONFIG_SCHED_TCBCACHE.
+ */
+
+void spawnperf_test(void)
+{
+	struct mallinfo before;
+	struct mallinfo after;
+	struct timespec start;
+	pthread_attr_t attr;
+	pthread_t thread;
+	unsigned long usec;
+	int status;
+	int i;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, TEST_STACKSIZE);
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+	before = mallinfo();
+#else
+	(void)mallinfo(&before);
+#endif
+	kernel_sample_gettime(&start);
+
+	for (i = 0; i < TEST_NTHREADS; i++) {
+		g_blocks[i] = NULL;
+		status = pthread_create(&thread, &attr, spawnperf_thread, NULL);
+		if (status != 0) {
+			printf("spawnperf_test: ERROR pthread_create failed, status=%d\n", status);
+			break;
+		}
+
+		pthread_join(thread, &g_blocks[i]);
+	}
+
+	usec = kernel_sample_elapsed_usec(&start);
+#ifdef CONFIG_CAN_PASS_STRUCTS
+	after = mallinfo();
+#else
+	(void)mallinfo(&after);
+#endif
+
+	printf("spawnperf_test: %d threads, %lu usec per create/join\n", i, i > 0 ? usec / i : 0);
+	printf("spawnperf_test:          free chunks  largest free\n");
+	printf("spawnperf_test: before   %11d  %12d\n", before.ordblks, before.mxordblk);
+	printf("spawnperf_test: after    %11d  %12d\n", after.ordblks, after.mxordblk);
+
+	for (i = 0; i < TEST_NTHREADS; i++) {
+		free(g_blocks[i]);
+	}
+}
@@ -0,0 +1,307 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**************************************************************************
+ * Included Files
+ **************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <errno.h>
+#ifdef CONFIG_EVENT_FD
+#include <sys/eventfd.h>
+#endif
+#ifdef CONFIG_EVTGROUP
+#include <tinyara/evtgroup.h>
+#endif
+
+#include "kernel_sample.h"
+
+/**************************************************************************
+ * Private Definitions
+ **************************************************************************/
+
+#define TEST_NLOOPS         (2000)
+
+/* The two directions of a round trip */
+
+#define PING                0
+#define PONG                1
+
+/**************************************************************************
+ * Private Types
+ **************************************************************************/
+
+/* One wakeup mechanism: post() wakes whoever waits in wait() for the same
+ * direction.
+ */
+
+struct wakeperf_ops_s {
+	FAR const char *name;
+	int (*setup)(void);
+	void (*teardown)(void);
+	int (*post)(int dir);
+	int (*wait)(int dir);
+};
+
+/**************************************************************************
+ * Private Variables
+ **************************************************************************/
+
+static sem_t g_sem[2];
+static pthread_t g_thread[2];
+#ifdef CONFIG_EVENT_FD
+static int g_efd[2];
+#endif
+#ifdef CONFIG_EVTGROUP
+static struct evtgroup_s g_evtgroup;
+#endif
+static volatile int g_nerrors;
+
+/**************************************************************************
+ * Private Functions
+ **************************************************************************/
+
+/* Semaphores */
+
+static int sem_setup(void)
+{
+	sem_init(&g_sem[PING], 0, 0);
+	sem_init(&g_sem[PONG], 0, 0);
+	return OK;
+}
+
+static void sem_teardown(void)
+{
+	sem_destroy(&g_sem[PING]);
+	sem_destroy(&g_sem[PONG]);
+}
+
+static int sem_postdir(int dir)
+{
+	return sem_post(&g_sem[dir]);
+}
+
+static int sem_waitdir(int dir)
+{
+	return sem_wait(&g_sem[dir]);
+}
+
+/* Signals: SIGUSR1 pings the peer thread, SIGUSR2 pongs the main thread */
+
+#ifndef CONFIG_DISABLE_SIGNALS
+static int sig_setup(void)
+{
+	sigset_t set;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGUSR1);
+	sigaddset(&set, SIGUSR2);
+	return pthread_sigmask(SIG_BLOCK, &set, NULL);
+}
+
+static void sig_teardown(void)
+{
+	sigset_t set;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGUSR1);
+	sigaddset(&set, SIGUSR2);
+	pthread_sigmask(SIG_UNBLOCK, &set, NULL);
+}
+
+static int sig_postdir(int dir)
+{
+	return pthread_kill(g_thread[dir], dir == PING ? SIGUSR1 : SIGUSR2) == 0 ? OK : ERROR;
+}
+
+static int sig_waitdir(int dir)
+{
+	sigset_t set;
+
+	sigemptyset(&set);
+	sigaddset(&set, dir == PING ? SIGUSR1 : SIGUSR2);
+	return sigwaitinfo(&set, NULL) < 0 ? ERROR : OK;
+}
+#endif
+
+/* eventfd descriptors, one per direction */
+
+#ifdef CONFIG_EVENT_FD
+static int efd_setup(void)
+{
+	g_efd[PING] = eventfd(0, 0);
+	g_efd[PONG] = eventfd(0, 0);
+	return (g_efd[PING] < 0 || g_efd[PONG] < 0) ? ERROR : OK;
+}
+
+static void efd_teardown(void)
+{
+	if (g_efd[PING] >= 0) {
+		close(g_efd[PING]);
+	}
+
+	if (g_efd[PONG] >= 0) {
+		close(g_efd[PONG]);
+	}
+}
+
+static int efd_postdir(int dir)
+{
+	return eventfd_write(g_efd[dir], 1);
+}
+
+static int efd_waitdir(int dir)
+{
+	eventfd_t value;
+
+	return eventfd_read(g_efd[dir], &value);
+}
+#endif
+
+/* One event flag group, one event per direction */
+
+#ifdef CONFIG_EVTGROUP
+static int evt_setup(void)
+{
+	evtgroup_init(&g_evtgroup, 0);
+	return OK;
+}
+
+static void evt_teardown(void)
+{
+	evtgroup_destroy(&g_evtgroup);
+}
+
+static int evt_postdir(int dir)
+{
+	evtgroup_post(&g_evtgroup, 1 << dir);
+	return OK;
+}
+
+static int evt_waitdir(int dir)
+{
+	return evtgroup_wait(&g_evtgroup, 1 << dir, EVTGROUP_CONSUME, NULL);
+}
+#endif
+
+static const struct wakeperf_ops_s g_wakeperf_ops[] = {
+	{"semaphore", sem_setup, sem_teardown, sem_postdir, sem_waitdir},
+#ifndef CONFIG_DISABLE_SIGNALS
+	{"signal", sig_setup, sig_teardown, sig_postdir, sig_waitdir},
+#endif
+#ifdef CONFIG_EVENT_FD
+	{"eventfd", efd_setup, efd_teardown, efd_postdir, efd_waitdir},
+#endif
+#ifdef CONFIG_EVTGROUP
+	{"evtgroup", evt_setup, evt_teardown, evt_postdir, evt_waitdir},
+#endif
+};
+
+/* The peer answers every ping with a pong */
+
+static void *wakeperf_peer(void *arg)
+{
+	FAR const struct wakeperf_ops_s *ops = (FAR const struct wakeperf_ops_s *)arg;
+	int i;
+
+	for (i = 0; i < TEST_NLOOPS; i++) {
+		if (ops->wait(PING) < 0 || ops->post(PONG) < 0) {
+			g_nerrors++;
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/* Bounce TEST_NLOOPS wakeups between this thread and a peer of the same
+ * priority; every round trip is two wakeups and two context switches.
+ */
+
+static void wakeperf_run(FAR const struct wakeperf_ops_s *ops)
+{
+	struct timespec start;
+	pthread_attr_t attr;
+	unsigned long usec;
+	int status;
+	int i;
+
+	g_nerrors = 0;
+	if (ops->setup() < 0) {
+		printf("wakeperf_test: ERROR %s setup failed, errno=%d\n", ops->name, errno);
+		ops->teardown();
+		return;
+	}
+
+	g_thread[PONG] = pthread_self();
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, STACKSIZE);
+	status = pthread_create(&g_thread[PING], &attr, wakeperf_peer, (pthread_addr_t)ops);
+	if (status != 0) {
+		printf("wakeperf_test: ERROR pthread_create failed, status=%d\n", status);
+		ops->teardown();
+		return;
+	}
+
+	kernel_sample_gettime(&start);
+	for (i = 0; i < TEST_NLOOPS && g_nerrors == 0; i++) {
+		if (ops->post(PING) < 0 || ops->wait(PONG) < 0) {
+			g_nerrors++;
+		}
+	}
+
+	usec = kernel_sample_elapsed_usec(&start);
+	if (g_nerrors > 0) {
+		pthread_cancel(g_thread[PING]);
+	}
+
+	pthread_join(g_thread[PING], NULL);
+	ops->teardown();
+
+	if (g_nerrors > 0) {
+		printf("wakeperf_test: ERROR %s failed after %d round trips\n", ops->name, i);
+		return;
+	}
+
+	printf("wakeperf_test: %-10s %8lu usec %8lu nsec per round trip\n", ops->name, usec, (unsigned long)((unsigned long long)usec * 1000 / TEST_NLOOPS));
+}
+
+/**************************************************************************
+ * Public Functions
+ **************************************************************************/
+
+/* Compare the cost of waking another thread through the wakeup mechanisms
+ * that are configured.
+ */
+
+void wakeperf_test(void)
+{
+	int i;
+
+	printf("wakeperf_test: %d round trips each\n", TEST_NLOOPS);
+	for (i = 0; i < sizeof(g_wakeperf_ops) / sizeof(g_wakeperf_ops[0]); i++) {
+		wakeperf_run(&g_wakeperf_ops[i]);
+	}
+}
@@ -58,13 +58,20 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <time.h>
+#include <semaphore.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <tinyara/fs/fs.h>
 #include <tinyara/fs/mtd.h>
 #include <tinyara/fs/ioctl.h>
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+#include <tinyara/rwbuffer.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -115,6 +122,15 @@
 #define CONFIG_EXAMPLES_MTDPART_NPARTITIONS 3
 #endif
 
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+#ifndef CONFIG_MTD_PARTITION_RHBLOCKS
+#define CONFIG_MTD_PARTITION_RHBLOCKS 0
+#endif
+#ifndef CONFIG_MTD_PARTITION_WRBLOCKS
+#define CONFIG_MTD_PARTITION_WRBLOCKS 0
+#endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -143,6 +159,643 @@ static uint8_t *g_simflash;
 extern FAR struct mtd_dev_s *mtdpart_archinitialize(void);
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if ((defined(CONFIG_MTD_QUEUE) || defined(CONFIG_FTL_LOG)) && CONFIG_EXAMPLES_MTDPART_NPARTITIONS > 1) || \
+	(defined(CONFIG_MTD_PARTITION_RWBUFFER) && defined(CONFIG_DRVR_READAHEAD))
+static unsigned long mtdpart_msec(void)
+{
+	struct timespec ts;
+
+	/* Setting the time of day must not show up in the measurements */
+
+#ifdef CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+#endif
+
+#if defined(CONFIG_MTD_QUEUE) && CONFIG_EXAMPLES_MTDPART_NPARTITIONS > 1
+static int g_qerrors;
+
+static void mtdpart_complete(FAR struct mtd_req_s *req)
+{
+	if (req->result < 0) {
+		g_qerrors++;
+	}
+
+	sem_post((FAR sem_t *)req->priv);
+}
+
+static void mtdpart_wait(FAR sem_t *sem, int count)
+{
+	while (count > 0) {
+		if (sem_wait(sem) == OK) {
+			count--;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: mtdpart_queue_test
+ *
+ * Description:
+ *   Erase one partition while programming another, first one after the
+ *   other with the MTD methods and then with both queued at once.  Then
+ *   measure how long a read waits behind a long erase on the same queue.
+ *   The times mean something with the program and erase delays of the RAM
+ *   MTD device (RAMMTD_WRITE_DELAY and RAMMTD_ERASE_DELAY) set.
+ *
+ ****************************************************************************/
+
+static int mtdpart_queue_test(FAR struct mtd_dev_s *erasepart, FAR struct mtd_dev_s *writepart, off_t neraseblocks, unsigned int blkpererase, size_t blocksize)
+{
+	FAR struct mtd_queue_s *equeue;
+	FAR struct mtd_queue_s *wqueue;
+	FAR struct mtd_req_s *reqs;
+	FAR uint8_t *data;
+	unsigned long start;
+	unsigned long synctime;
+	unsigned long queuetime;
+	unsigned long readtime;
+	unsigned long erasetime;
+	sem_t donesem;
+	off_t i;
+	int ret = ERROR;
+
+	printf("Queued requests:\n");
+
+	data = (FAR uint8_t *)malloc(blkpererase * blocksize);
+	reqs = (FAR struct mtd_req_s *)calloc(neraseblocks + 2, sizeof(struct mtd_req_s));
+	if (data == NULL || reqs == NULL) {
+		printf("ERROR: failed to allocate the requests\n");
+		goto errout_with_alloc;
+	}
+
+	memset(data, 0x5a, blkpererase * blocksize);
+	sem_init(&donesem, 0, 0);
+	g_qerrors = 0;
+
+	/* One after the other */
+
+	start = mtdpart_msec();
+	MTD_ERASE(erasepart, 0, neraseblocks);
+	for (i = 0; i < neraseblocks; i++) {
+		MTD_BWRITE(writepart, i * blkpererase, blkpererase, data);
+	}
+
+	synctime = mtdpart_msec() - start;
+
+	/* The same work with both devices busy at once */
+
+	equeue = mtd_queue_initialize(erasepart);
+	wqueue = mtd_queue_initialize(writepart);
+	if (equeue == NULL || wqueue == NULL) {
+		printf("ERROR: mtd_queue_initialize failed\n");
+		goto errout_with_queues;
+	}
+
+	start = mtdpart_msec();
+	reqs[0].op = MTDREQ_ERASE;
+	reqs[0].startblock = 0;
+	reqs[0].nblocks = neraseblocks;
+	reqs[0].complete = mtdpart_complete;
+	reqs[0].priv = &donesem;
+	mtd_submit(equeue, &reqs[0]);
+
+	for (i = 0; i < neraseblocks; i++) {
+		reqs[i + 1].op = MTDREQ_WRITE;
+		reqs[i + 1].startblock = i * blkpererase;
+		reqs[i + 1].nblocks = blkpererase;
+		reqs[i + 1].buffer = data;
+		reqs[i + 1].complete = mtdpart_complete;
+		reqs[i + 1].priv = &donesem;
+		mtd_submit(wqueue, &reqs[i + 1]);
+	}
+
+	mtdpart_wait(&donesem, neraseblocks + 1);
+	queuetime = mtdpart_msec() - start;
+
+	/* A read of the last erase block queued behind an erase of the others */
+
+	start = mtdpart_msec();
+	reqs[0].op = MTDREQ_ERASE;
+	reqs[0].startblock = 0;
+	reqs[0].nblocks = neraseblocks - 1;
+	mtd_submit(equeue, &reqs[0]);
+
+	usleep(1000);
+	reqs[1].op = MTDREQ_READ;
+	reqs[1].startblock = (neraseblocks - 1) * blkpererase;
+	reqs[1].nblocks = 1;
+	reqs[1].buffer = data;
+	mtd_submit(equeue, &reqs[1]);
+
+	mtdpart_wait(&donesem, 1);
+	readtime = mtdpart_msec() - start;
+	mtdpart_wait(&donesem, 1);
+	erasetime = mtdpart_msec() - start;
+
+	printf("  Erase %lu blocks and program %lu blocks: %lu msec, queued %lu msec\n", (unsigned long)neraseblocks, (unsigned long)neraseblocks * blkpererase, synctime, queuetime);
+	printf("  Read behind a %lu block erase: %lu msec (erase %lu msec)\n", (unsigned long)neraseblocks - 1, readtime, erasetime);
+
+	if (g_qerrors > 0) {
+		printf("ERROR: %d queued requests failed\n", g_qerrors);
+	} else {
+		ret = OK;
+	}
+
+errout_with_queues:
+	if (equeue != NULL) {
+		mtd_queue_uninitialize(equeue);
+	}
+
+	if (wqueue != NULL) {
+		mtd_queue_uninitialize(wqueue);
+	}
+
+	sem_destroy(&donesem);
+
+errout_with_alloc:
+	free(reqs);
+	free(data);
+	return ret;
+}
+#endif
+
+#if defined(CONFIG_FTL_LOG) && CONFIG_EXAMPLES_MTDPART_NPARTITIONS > 1
+/****************************************************************************
+ * Name: mtdpart_random_writes
+ *
+ * Description:
+ *   Write MTDPART_NRANDOM randomly chosen sectors among the first nsectors
+ *   of a character device, each tagged with its write number, and return
+ *   the time taken in msec.  'last' records which write each sector got
+ *   last.
+ *
+ ****************************************************************************/
+
+#define MTDPART_NRANDOM 256
+
+static long mtdpart_random_writes(FAR const char *charname, FAR uint32_t *buffer, size_t blocksize, off_t nsectors, FAR int16_t *last)
+{
+	unsigned long start;
+	off_t sector;
+	int fd;
+	int i;
+
+	fd = open(charname, O_WRONLY);
+	if (fd < 0) {
+		printf("ERROR: open %s failed: %d\n", charname, errno);
+		return ERROR;
+	}
+
+	srand(1);
+	start = mtdpart_msec();
+	for (i = 0; i < MTDPART_NRANDOM; i++) {
+		sector = rand() % nsectors;
+		memset(buffer, i, blocksize);
+		buffer[0] = i;
+		if (lseek(fd, sector * blocksize, SEEK_SET) < 0 || write(fd, buffer, blocksize) != blocksize) {
+			printf("ERROR: write to %s failed: %d\n", charname, errno);
+			close(fd);
+			return ERROR;
+		}
+
+		last[sector] = i;
+	}
+
+	close(fd);
+	return mtdpart_msec() - start;
+}
+
+/****************************************************************************
+ * Name: mtdpart_log_test
+ *
+ * Description:
+ *   Compare random sector writes through the FTL of one partition with
+ *   the same writes through a log-structured FTL on another, and check
+ *   that the log-structured one reads back what was written last.
+ *
+ ****************************************************************************/
+
+static int mtdpart_log_test(FAR const char *ftlname, FAR struct mtd_dev_s *logpart, FAR uint32_t *buffer, size_t blocksize)
+{
+	struct geometry geo;
+	FAR struct inode *inode;
+	FAR int16_t *last;
+	char blockname[32];
+	char charname[32];
+	long ftltime;
+	long logtime;
+	off_t nsectors;
+	off_t sector;
+	int minor;
+	int fd;
+	int ret;
+
+	printf("Log-structured FTL:\n");
+
+	minor = CONFIG_EXAMPLES_MTDPART_NPARTITIONS + 3;
+	snprintf(blockname, 32, "/dev/mtdblock%d", minor);
+	snprintf(charname, 32, "/dev/mtd%d", minor);
+
+	ret = ftl_log_initialize(minor, logpart);
+	if (ret < 0) {
+		printf("ERROR: ftl_log_initialize %s failed: %d\n", blockname, ret);
+		return ret;
+	}
+
+	ret = bchdev_register(blockname, charname, false);
+	if (ret < 0) {
+		printf("ERROR: bchdev_register %s failed: %d\n", charname, ret);
+		goto errout_with_blockdriver;
+	}
+
+	/* The log-structured device is the smaller one */
+
+	ret = open_blockdriver(blockname, 0, &inode);
+	if (ret < 0) {
+		printf("ERROR: open_blockdriver %s failed: %d\n", blockname, ret);
+		goto errout_with_chardev;
+	}
+
+	ret = inode->u.i_bops->geometry(inode, &geo);
+	close_blockdriver(inode);
+	if (ret < 0) {
+		goto errout_with_chardev;
+	}
+
+	nsectors = geo.geo_nsectors;
+	last = (FAR int16_t *)malloc(nsectors * sizeof(int16_t));
+	if (last == NULL) {
+		ret = -ENOMEM;
+		goto errout_with_chardev;
+	}
+
+	ftltime = mtdpart_random_writes(ftlname, buffer, blocksize, nsectors, last);
+	memset(last, 0xff, nsectors * sizeof(int16_t));
+	logtime = mtdpart_random_writes(charname, buffer, blocksize, nsectors, last);
+	if (ftltime < 0 || logtime < 0) {
+		ret = ERROR;
+		goto errout_with_last;
+	}
+
+	printf("  %d random %lu byte writes: %ld msec, log-structured %ld msec\n", MTDPART_NRANDOM, (unsigned long)blocksize, ftltime, logtime);
+
+	/* Read back what was written last */
+
+	fd = open(charname, O_RDONLY);
+	if (fd < 0) {
+		printf("ERROR: open %s failed: %d\n", charname, errno);
+		ret = ERROR;
+		goto errout_with_last;
+	}
+
+	for (sector = 0; sector < nsectors; sector++) {
+		if (last[sector] < 0) {
+			continue;
+		}
+
+		if (lseek(fd, sector * blocksize, SEEK_SET) < 0 || read(fd, buffer, blocksize) != blocksize || buffer[0] != last[sector]) {
+			printf("ERROR: sector %ld of %s does not hold write %d\n", (long)sector, charname, last[sector]);
+			ret = ERROR;
+			break;
+		}
+	}
+
+	close(fd);
+
+errout_with_last:
+	free(last);
+errout_with_chardev:
+	bchdev_unregister(charname);
+errout_with_blockdriver:
+	unregister_blockdriver(blockname);
+	return ret;
+}
+#endif
+
+#if defined(CONFIG_MTD_PARTITION_RWBUFFER) && defined(CONFIG_DRVR_READAHEAD)
+/****************************************************************************
+ * Name: mtdpart_rwb_reads
+ *
+ * Description:
+ *   Perform MTDPART_NREADS reads of a partition: blocks in order, blocks at
+ *   random, or 16 bytes out of every quarter block in order.  Returns the
+ *   time taken in msec and a checksum of the data read.
+ *
+ ****************************************************************************/
+
+#define MTDPART_NREADS 256
+#define MTDPART_SEQUENTIAL 0
+#define MTDPART_RANDOM 1
+#define MTDPART_BYTES 2
+
+static long mtdpart_rwb_reads(FAR struct mtd_dev_s *mtd, off_t firstblock, FAR const off_t *blocks, int mode, FAR uint8_t *buffer, size_t blocksize, FAR uint32_t *sum)
+{
+	unsigned long start;
+	size_t nbytes;
+	ssize_t ret;
+	int i;
+	int j;
+
+	*sum = 0;
+	nbytes = mode == MTDPART_BYTES ? 16 : blocksize;
+
+	start = mtdpart_msec();
+	for (i = 0; i < MTDPART_NREADS; i++) {
+		if (mode == MTDPART_BYTES) {
+			ret = MTD_READ(mtd, (firstblock + blocks[i]) * blocksize + (i & 3) * (blocksize / 4), nbytes, buffer);
+			ret = ret == nbytes ? 1 : ret;
+		} else {
+			ret = MTD_BREAD(mtd, firstblock + blocks[i], 1, buffer);
+		}
+
+		if (ret != 1) {
+			printf("ERROR: read of block %ld failed: %ld\n", (long)blocks[i], (long)ret);
+			return ERROR;
+		}
+
+		for (j = 0; j < nbytes; j++) {
+			*sum = (*sum << 1 | *sum >> 31) + buffer[j];
+		}
+	}
+
+	return mtdpart_msec() - start;
+}
+
+/****************************************************************************
+ * Name: mtdpart_rwb_test
+ *
+ * Description:
+ *   Time sequential, random and byte reads of a partition without and with
+ *   read-ahead, and check that the data is that of the master device.  The
+ *   times mean something with the read delay of the RAM MTD device
+ *   (RAMMTD_READ_DELAY) set.
+ *
+ ****************************************************************************/
+
+static int mtdpart_rwb_test(FAR struct mtd_dev_s *master, FAR struct mtd_dev_s *rwbpart, off_t nblocks, size_t blocksize)
+{
+	static FAR const char *names[3] = { "Sequential", "Random", "Byte" };
+	struct rwb_stats_s stats;
+	FAR uint8_t *buffer;
+	FAR off_t *blocks;
+	uint32_t partsum;
+	uint32_t rwbsum;
+	uint32_t mastersum;
+	long parttime;
+	long rwbtime;
+	int mode;
+	int i;
+	int ret = OK;
+
+	printf("Read-ahead:\n");
+
+	buffer = (FAR uint8_t *)malloc(blocksize);
+	blocks = (FAR off_t *)malloc(MTDPART_NREADS * sizeof(off_t));
+	if (buffer == NULL || blocks == NULL) {
+		printf("ERROR: failed to allocate the read buffers\n");
+		ret = ERROR;
+		goto errout;
+	}
+
+	for (mode = MTDPART_SEQUENTIAL; mode <= MTDPART_BYTES && ret == OK; mode++) {
+		for (i = 0; i < MTDPART_NREADS; i++) {
+			if (mode == MTDPART_RANDOM) {
+				blocks[i] = rand() % nblocks;
+			} else if (mode == MTDPART_BYTES) {
+				blocks[i] = (i / 4) % nblocks;
+			} else {
+				blocks[i] = i % nblocks;
+			}
+		}
+
+		if (mode == MTDPART_BYTES && rwbpart->read == NULL) {
+			break;
+		}
+
+		mtd_setpartitionrwb(rwbpart, 0, 0);
+		parttime = mtdpart_rwb_reads(rwbpart, 0, blocks, mode, buffer, blocksize, &partsum);
+
+		/* A fresh buffer, so the statistics are those of this run */
+
+		mtd_setpartitionrwb(rwbpart, CONFIG_MTD_PARTITION_RHBLOCKS > 0 ? CONFIG_MTD_PARTITION_RHBLOCKS : 8, 0);
+		rwbtime = mtdpart_rwb_reads(rwbpart, 0, blocks, mode, buffer, blocksize, &rwbsum);
+		if (parttime < 0 || rwbtime < 0 || MTD_IOCTL(rwbpart, MTDIOC_RWBSTATS, (unsigned long)((uintptr_t)&stats)) < 0) {
+			ret = ERROR;
+			break;
+		}
+
+		/* The partition starts at the beginning of the master device */
+
+		if (mtdpart_rwb_reads(master, 0, blocks, mode, buffer, blocksize, &mastersum) < 0) {
+			ret = ERROR;
+			break;
+		}
+
+		printf("  %s reads: %ld msec, with read-ahead %ld msec (hit %lu, miss %lu, %lu reloads)\n", names[mode], parttime, rwbtime, (unsigned long)stats.rdhits, (unsigned long)stats.rdmisses, (unsigned long)stats.rhreloads);
+
+		if (partsum != mastersum || rwbsum != mastersum) {
+			printf("ERROR: %s reads do not match the master device\n", names[mode]);
+			ret = ERROR;
+		}
+	}
+
+	mtd_setpartitionrwb(rwbpart, CONFIG_MTD_PARTITION_RHBLOCKS, CONFIG_MTD_PARTITION_WRBLOCKS);
+
+errout:
+	free(blocks);
+	free(buffer);
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: mtdpart_rwb_check
+ *
+ * Description:
+ *   Read a block through the buffered partition and from the master device
+ *   and check that both hold 'expect', or just agree if 'expect' is NULL.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MTD_PARTITION_RWBUFFER) && defined(CONFIG_DRVR_WRITEBUFFER) && CONFIG_MTD_PARTITION_WRBLOCKS > 0
+static int mtdpart_rwb_check(FAR struct mtd_dev_s *master, FAR struct mtd_dev_s *rwbpart, off_t block, FAR const uint8_t *expect, FAR uint8_t *buffer, size_t blocksize, FAR const char *what)
+{
+	FAR uint8_t *mbuffer = buffer + blocksize;
+
+	if (MTD_BREAD(rwbpart, block, 1, buffer) != 1 || MTD_BREAD(master, block, 1, mbuffer) != 1) {
+		printf("ERROR: %s: read of block %ld failed\n", what, (long)block);
+		return ERROR;
+	}
+
+	if (memcmp(buffer, mbuffer, blocksize) != 0 || (expect != NULL && memcmp(buffer, expect, blocksize) != 0)) {
+		printf("ERROR: %s: block %ld is stale\n", what, (long)block);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mtdpart_rwb_writes
+ *
+ * Description:
+ *   Write through a partition with write buffering and check that no
+ *   buffer returns stale data: byte reads without read-ahead, then with
+ *   read-ahead after buffered writes, after an erase and after a byte
+ *   write.  The partition starts at the beginning of the master device.
+ *
+ ****************************************************************************/
+
+static int mtdpart_rwb_writes(FAR struct mtd_dev_s *master, FAR struct mtd_dev_s *rwbpart, size_t blocksize)
+{
+	struct mtd_geometry_s geo;
+	FAR uint8_t *pattern;
+	FAR uint8_t *buffer;
+	off_t block;
+	int ret = ERROR;
+
+	printf("Write buffer:\n");
+
+	if (MTD_IOCTL(rwbpart, MTDIOC_GEOMETRY, (unsigned long)((uintptr_t)&geo)) < 0) {
+		printf("ERROR: MTDIOC_GEOMETRY failed\n");
+		return ERROR;
+	}
+
+	/* Two erase blocks worth of patterns, a block to read into and one for
+	 * the master device.
+	 */
+
+	pattern = (FAR uint8_t *)malloc(2 * geo.erasesize);
+	buffer = (FAR uint8_t *)malloc(2 * blocksize);
+	if (pattern == NULL || buffer == NULL) {
+		printf("ERROR: failed to allocate the write buffers\n");
+		goto errout;
+	}
+
+	/* Without read-ahead, byte reads go to the media.  A block still in
+	 * the write buffer must be written out first.
+	 */
+
+	mtd_setpartitionrwb(rwbpart, 0, CONFIG_MTD_PARTITION_WRBLOCKS);
+
+	if (MTD_ERASE(rwbpart, 0, 1) != 1) {
+		printf("ERROR: erase failed\n");
+		goto errout;
+	}
+
+	memset(pattern, 0x69, blocksize);
+	if (MTD_BWRITE(rwbpart, 0, 1, pattern) != 1) {
+		printf("ERROR: write of block 0 failed\n");
+		goto errout;
+	}
+
+	if (rwbpart->read != NULL && (MTD_READ(rwbpart, blocksize / 4, 16, buffer) != 16 || memcmp(buffer, pattern + blocksize / 4, 16) != 0)) {
+		printf("ERROR: byte read: block 0 is stale\n");
+		goto errout;
+	}
+
+	/* Now with read-ahead, if there is any */
+
+	mtd_setpartitionrwb(rwbpart, CONFIG_MTD_PARTITION_RHBLOCKS > 0 ? CONFIG_MTD_PARTITION_RHBLOCKS : 8, CONFIG_MTD_PARTITION_WRBLOCKS);
+
+	if (MTD_ERASE(rwbpart, 0, 1) != 1) {
+		printf("ERROR: erase failed\n");
+		goto errout;
+	}
+
+	/* Read the erased blocks ahead, then write them block by block.  Each
+	 * write must replace what was read ahead; the read of the block after
+	 * it flushes the write buffer when they overlap.
+	 */
+
+	if (MTD_BREAD(rwbpart, 0, 1, buffer) != 1) {
+		printf("ERROR: read of block 0 failed\n");
+		goto errout;
+	}
+
+	for (block = 0; block < geo.erasesize / blocksize; block++) {
+		memset(pattern + block * blocksize, (int)(0x5a ^ block), blocksize);
+		if (MTD_BWRITE(rwbpart, block, 1, pattern + block * blocksize) != 1) {
+			printf("ERROR: write of block %ld failed\n", (long)block);
+			goto errout;
+		}
+	}
+
+	for (block = 0; block < geo.erasesize / blocksize; block++) {
+		if (mtdpart_rwb_check(master, rwbpart, block, pattern + block * blocksize, buffer, blocksize, "buffered write") < 0) {
+			goto errout;
+		}
+	}
+
+	/* Erase what is now read ahead: the partition must see the erased
+	 * media, not the old data.
+	 */
+
+	if (MTD_ERASE(rwbpart, 0, 1) != 1) {
+		printf("ERROR: erase failed\n");
+		goto errout;
+	}
+
+	if (mtdpart_rwb_check(master, rwbpart, 0, NULL, buffer, blocksize, "erase") < 0) {
+		goto errout;
+	}
+
+	if (buffer[0] == pattern[0]) {
+		printf("ERROR: erase: block 0 still holds the written data\n");
+		goto errout;
+	}
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+	if (rwbpart->write != NULL) {
+		/* Leave a block in the write buffer and block 0 read ahead, then
+		 * write bytes into block 0.  The byte write must push the buffered
+		 * block out and replace the read-ahead.
+		 */
+
+		memset(pattern + blocksize, 0x3c, blocksize);
+		if (MTD_BREAD(rwbpart, 0, 1, buffer) != 1 || MTD_BWRITE(rwbpart, 1, 1, pattern + blocksize) != 1) {
+			printf("ERROR: byte write: block access failed\n");
+			goto errout;
+		}
+
+		memcpy(pattern, buffer, blocksize);
+		memset(pattern + blocksize / 4, 0xa5, 16);
+		if (MTD_WRITE(rwbpart, blocksize / 4, 16, pattern + blocksize / 4) != 16) {
+			printf("ERROR: byte write failed\n");
+			goto errout;
+		}
+
+		if (MTD_BREAD(master, 1, 1, buffer) != 1 || memcmp(buffer, pattern + blocksize, blocksize) != 0) {
+			printf("ERROR: byte write: buffered block 1 was not written out\n");
+			goto errout;
+		}
+
+		if (mtdpart_rwb_check(master, rwbpart, 0, pattern, buffer, blocksize, "byte write") < 0) {
+			goto errout;
+		}
+	}
+#endif
+
+	printf("  Byte reads, buffered writes, erase and byte write invalidation OK\n");
+	ret = OK;
+
+errout:
+	mtd_setpartitionrwb(rwbpart, CONFIG_MTD_PARTITION_RHBLOCKS, CONFIG_MTD_PARTITION_WRBLOCKS);
+	free(buffer);
+	free(pattern);
+	return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -516,6 +1169,36 @@ int mtdpart_main(int argc, char *argv[])
 
 	close(fd);
 
+#if defined(CONFIG_MTD_QUEUE) && CONFIG_EXAMPLES_MTDPART_NPARTITIONS > 1
+	if (mtdpart_queue_test(part[1], part[2], nblocks / blkpererase, blkpererase, blocksize) != OK) {
+		fflush(stdout);
+		goto out_free_buffer;
+	}
+#endif
+
+#if defined(CONFIG_FTL_LOG) && CONFIG_EXAMPLES_MTDPART_NPARTITIONS > 1
+	/* This rewrites partitions 1 and 2 */
+
+	if (mtdpart_log_test("/dev/mtd3", part[2], buffer, blocksize) < 0) {
+		fflush(stdout);
+		goto out_free_buffer;
+	}
+#endif
+
+#if defined(CONFIG_MTD_PARTITION_RWBUFFER) && defined(CONFIG_DRVR_READAHEAD)
+	if (mtdpart_rwb_test(master, part[1], nblocks, blocksize) < 0) {
+		fflush(stdout);
+		goto out_free_buffer;
+	}
+#endif
+
+#if defined(CONFIG_MTD_PARTITION_RWBUFFER) && defined(CONFIG_DRVR_WRITEBUFFER) && CONFIG_MTD_PARTITION_WRBLOCKS > 0
+	if (mtdpart_rwb_writes(master, part[1], blocksize) < 0) {
+		fflush(stdout);
+		goto out_free_buffer;
+	}
+#endif
+
 	/* And exit without bothering to clean up */
 
 	printf("PASS: Everything looks good\n");
@@ -0,0 +1,147 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/examples/ota/ota.h
+ *
+ * Shared definitions of the OTA downloader: the HTTP client, the pipeline
+ * that streams the image into the partition and the loopback self test.
+ ****************************************************************************/
+
+#ifndef __APPS_EXAMPLES_OTA_OTA_H
+#define __APPS_EXAMPLES_OTA_OTA_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include <tls/sha256.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_OTA_NBUFFERS
+#define CONFIG_EXAMPLES_OTA_NBUFFERS 3
+#endif
+
+#ifndef CONFIG_EXAMPLES_OTA_ERASEAHEAD
+#define CONFIG_EXAMPLES_OTA_ERASEAHEAD 2
+#endif
+
+#ifndef CONFIG_EXAMPLES_OTA_CHECKPOINT
+#define CONFIG_EXAMPLES_OTA_CHECKPOINT "/mnt/ota.ckpt"
+#endif
+
+#ifndef CONFIG_EXAMPLES_OTA_CHECKPOINT_INTERVAL
+#define CONFIG_EXAMPLES_OTA_CHECKPOINT_INTERVAL 4
+#endif
+
+#ifndef CONFIG_EXAMPLES_OTA_RETRIES
+#define CONFIG_EXAMPLES_OTA_RETRIES 3
+#endif
+
+#define OTA_MAXURL      128
+#define OTA_DIGESTLEN   32
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* What the server said about the response body.  Complete before the
+ * first data callback.
+ */
+
+struct ota_http_s {
+	off_t   range;         /* IN:  First byte asked for, 0 for all of it */
+	bool    partial;       /* OUT: 206, the body starts at range */
+	int32_t length;        /* OUT: Content-Length, or -1 if not sent */
+	int32_t received;      /* OUT: Bytes of the body passed on so far */
+};
+
+/* Written to the checkpoint file every CONFIG_EXAMPLES_OTA_CHECKPOINT_INTERVAL
+ * erase blocks.  offset is always at an erase block boundary, and sha is
+ * the hash of the image up to there.
+ */
+
+struct ota_ckpt_s {
+	uint32_t magic;
+	uint32_t offset;       /* Bytes of the image in the partition */
+	uint32_t total;        /* Size of the image, 0 if not known yet */
+	char     url[OTA_MAXURL];
+	char     dev[32];
+	mbedtls_sha256_context sha;
+};
+
+struct ota_buf_s {
+	FAR uint8_t *data;     /* One erase block */
+	size_t       len;      /* Bytes in it */
+};
+
+/* The pipeline.  The downloader fills erase block sized buffers and queues
+ * them to the writer thread, which programs and hashes them in order and
+ * erases the blocks ahead while it waits for the next one.
+ */
+
+struct ota_stream_s {
+	int             fd;        /* The partition */
+	size_t          erasesize; /* Its erase block size */
+	size_t          neraseblocks;
+	bool            eraseahead; /* The partition supports MTDIOC_ERASESECTORS */
+
+	pthread_t       writer;
+	pthread_mutex_t lock;      /* Protects everything below */
+	pthread_cond_t  cond;
+	struct ota_buf_s bufs[CONFIG_EXAMPLES_OTA_NBUFFERS];
+	int             head;      /* Next buffer to fill */
+	int             nqueued;   /* Buffers queued, the oldest being written */
+	bool            stop;
+	int             error;     /* First error of the writer, negated errno */
+	size_t          nexterase; /* Next erase block to erase ahead */
+
+	struct ota_ckpt_s ckpt;    /* State of what the writer completed */
+	uint32_t        queued;    /* Bytes of the image queued or written */
+	unsigned int    nblocks;   /* Blocks written since the last checkpoint */
+
+	uint32_t        nbytes;    /* Throughput: bytes in this session */
+	struct timespec start;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+int ota_stream_open(FAR struct ota_stream_s *st, FAR const char *url, FAR const char *dev, bool resume);
+int ota_stream_begin(FAR struct ota_stream_s *st, FAR const struct ota_http_s *http);
+int ota_stream_write(FAR struct ota_stream_s *st, FAR const uint8_t *data, size_t len);
+int ota_stream_sync(FAR struct ota_stream_s *st);
+int ota_stream_close(FAR struct ota_stream_s *st, bool complete, FAR uint8_t *digest);
+
+int ota_download(FAR const char *url, FAR const char *dev, bool resume, FAR uint8_t *digest);
+
+#ifdef CONFIG_EXAMPLES_OTA_TEST
+int ota_test(FAR const char *dev);
+#endif
+
+#endif							/* __APPS_EXAMPLES_OTA_OTA_H */
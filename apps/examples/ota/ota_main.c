@@ -59,6 +59,7 @@
 #include <sys/time.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <unistd.h>
 #include <string.h>
@@ -72,6 +73,8 @@
 #include <tinyara/version.h>
 #include <apps/netutils/netlib.h>
 
+#include "ota.h"
+
 #ifndef CONFIG_WGET_USERAGENT
 #define CONFIG_WGET_USERAGENT "TizenRT"
 #endif
@@ -119,8 +122,8 @@
 /****************************************************************************
  * Private Types
  ****************************************************************************/
-typedef void (*wget_callback_t)(FAR char **buffer, int offset,
-				int datend, FAR int *buflen, FAR void *arg);
+typedef int (*wget_callback_t)(FAR struct ota_http_s *http,
+				FAR const char *data, int len, FAR void *arg);
 
 struct wget_s {
 	/* Internal status */
@@ -145,6 +148,8 @@ struct wget_s {
 #endif
 	char hostname[CONFIG_WEBCLIENT_MAXHOSTNAME];
 	char filename[CONFIG_WEBCLIENT_MAXFILENAME];
+
+	FAR struct ota_http_s *http; /* Range asked for, and the response body */
 };
 
 /****************************************************************************
@@ -158,6 +163,8 @@ static const char g_httpcontenttype[] = "content-type: ";
 #endif
 static const char g_httphost[]        = "host: ";
 static const char g_httplocation[]    = "location: ";
+static const char g_httpcontentlen[]  = "content-length: ";
+static const char g_httprange[]       = "Range: bytes=";
 static const char g_httpget[]         = "GET ";
 static const char g_httppost[]        = "POST ";
 
@@ -168,6 +175,7 @@ static const char g_httpuseragentfields[] =
 	"\r\n\r\n";
 
 static const char g_http200[]         = "200 ";
+static const char g_http206[]         = "206 ";
 static const char g_http301[]         = "301 ";
 static const char g_http302[]         = "302 ";
 
@@ -234,6 +242,12 @@ static inline int wget_parsestatus(struct wget_s *ws)
 					ws->httpstatus = HTTPSTATUS_OK;
 				}
 
+				/* Check for 206 Partial Content, the answer to a Range request */
+				else if (strncmp(dest, g_http206, strlen(g_http206)) == 0) {
+					ws->httpstatus = HTTPSTATUS_OK;
+					ws->http->partial = true;
+				}
+
 				/* Check for 301 Moved permanently or 302 Found. Location: header line
 				 * will contain the new location.
 				 */
@@ -303,7 +317,12 @@ static inline int wget_parseheaders(struct wget_s *ws)
 					strncpy(ws->mimetype, ws->line + strlen(g_httpcontenttype), sizeof(ws->mimetype));
 				} else
 #endif
-				if (strncasecmp(ws->line, g_httplocation, strlen(g_httplocation)) == 0) {
+				if (strncasecmp(ws->line, g_httpcontentlen, strlen(g_httpcontentlen)) == 0) {
+					/* Found Content-Length field: the body ends early if the
+					 * connection is lost.
+					 */
+					ws->http->length = (int32_t)strtol(ws->line + strlen(g_httpcontentlen), NULL, 10);
+				} else if (strncasecmp(ws->line, g_httplocation, strlen(g_httplocation)) == 0) {
 					/*
 					 * Parse the new HTTP host and filename from the URL.  Note that
 					 * the return value is ignored.  In the event of failure, we
@@ -387,15 +406,18 @@ static int wget_gethostip(FAR char *hostname, in_addr_t *ipv4addr)
  *   buflen   - The size of the user provided buffer
  *   callback - As data is obtained from the host, this function is
  *              to dispose of each block of file data as it is received.
+ *   http     - The first byte to ask for; returns what the server said
+ *              about the body
  *   mode     - Indicates GET or POST modes
  *
  * Returned Value:
  *   0: if the GET operation completed successfully;
- *  -1: On a failure with errno set appropriately
+ *  -1: On a failure with errno set appropriately, ECONNRESET if the
+ *      connection was lost before the end of the body
  *
  ****************************************************************************/
 static int wget_base(FAR const char *url, FAR char *buffer, int buflen,
-		wget_callback_t callback, FAR void *arg,
+		wget_callback_t callback, FAR void *arg, FAR struct ota_http_s *http,
 		FAR const char *posts, uint8_t mode)
 {
 	struct sockaddr_in server;
@@ -412,6 +434,7 @@ static int wget_base(FAR const char *url, FAR char *buffer, int buflen,
 	ws.buffer = buffer;
 	ws.buflen = buflen;
 	ws.port   = 80;
+	ws.http   = http;
 
 	/* Parse the hostname (with optional port number) and filename from the URL */
 	ret = netlib_parsehttpurl(url, &ws.port,
@@ -435,6 +458,9 @@ static int wget_base(FAR const char *url, FAR char *buffer, int buflen,
 		ws.offset     = 0;
 		ws.datend     = 0;
 		ws.ndx        = 0;
+		http->partial  = false;
+		http->length   = -1;
+		http->received = 0;
 
 		/* Create a socket */
 		sockfd = socket(AF_INET, SOCK_STREAM, 0);
@@ -497,6 +523,12 @@ static int wget_base(FAR const char *url, FAR char *buffer, int buflen,
 		dest = wget_strcpy(dest, ws.hostname);
 		dest = wget_strcpy(dest, g_httpcrnl);
 
+		if (http->range > 0) {
+			dest = wget_strcpy(dest, g_httprange);
+			dest += sprintf(dest, "%ld-", (long)http->range);
+			dest = wget_strcpy(dest, g_httpcrnl);
+		}
+
 		if (mode == WGET_MODE_POST) {
 			dest = wget_strcpy(dest, g_httpform);
 			dest = wget_strcpy(dest, g_httpcrnl);
@@ -538,6 +570,13 @@ static int wget_base(FAR const char *url, FAR char *buffer, int buflen,
 			} else if (ws.datend == 0) {
 				lldbg("Connection lost\n");
 				close(sockfd);
+
+				/* Before the end of the body? */
+				if (ws.state != WEBCLIENT_STATE_DATA ||
+						(http->length >= 0 && http->received < http->length)) {
+					set_errno(ECONNRESET);
+					return ERROR;
+				}
 				break;
 			}
 
@@ -560,9 +599,19 @@ static int wget_base(FAR const char *url, FAR char *buffer, int buflen,
 
 			/* Dispose of the data payload */
 			if (ws.state == WEBCLIENT_STATE_DATA) {
-				if (ws.httpstatus != HTTPSTATUS_MOVED) {
+				if (ws.httpstatus == HTTPSTATUS_NONE) {
+					lldbg("ERROR: request refused by the server\n");
+					ret = -ENOENT;
+					goto errout_with_errno;
+				} else if (ws.httpstatus != HTTPSTATUS_MOVED) {
 					/* Let the client decide what to do with the received file */
-					callback(&ws.buffer, ws.offset, ws.datend, &buflen, arg);
+					if (ws.datend > ws.offset) {
+						ret = callback(http, ws.buffer + ws.offset, ws.datend - ws.offset, arg);
+						if (ret < 0) {
+							goto errout_with_errno;
+						}
+						http->received += ws.datend - ws.offset;
+					}
 				} else {
 					redirected = true;
 					close(sockfd);
@@ -676,6 +725,8 @@ static int web_posts_strlen(FAR char **name, FAR char **value, int len)
  *   buflen   - The size of the user provided buffer
  *   callback - As data is obtained from the host, this function is
  *              to dispose of each block of file data as it is received.
+ *   http     - The first byte to ask for; returns what the server said
+ *              about the body
  *
  * Returned Value:
  *   0: if the GET operation completed successfully;
@@ -683,66 +734,204 @@ static int web_posts_strlen(FAR char **name, FAR char **value, int len)
  *
  ****************************************************************************/
 static int wget(FAR const char *url, FAR char *buffer, int buflen,
-		wget_callback_t callback, FAR void *arg)
+		wget_callback_t callback, FAR void *arg, FAR struct ota_http_s *http)
 {
-	return wget_base(url, buffer, buflen, callback, arg, NULL, WGET_MODE_GET);
+	return wget_base(url, buffer, buflen, callback, arg, http, NULL, WGET_MODE_GET);
 }
 
 /****************************************************************************
  * Name: wget_post
  ****************************************************************************/
 static int wget_post(FAR const char *url, FAR const char *posts, FAR char *buffer,
-		int buflen, wget_callback_t callback, FAR void *arg)
+		int buflen, wget_callback_t callback, FAR void *arg, FAR struct ota_http_s *http)
 {
-	return wget_base(url, buffer, buflen, callback, arg, posts, WGET_MODE_POST);
+	return wget_base(url, buffer, buflen, callback, arg, http, posts, WGET_MODE_POST);
 }
 
 static void print_usage(char *progname)
 {
-	printf("Usage: %s URL DEV\n", progname);
+	printf("Usage: %s [-n] [-s SHA256] URL DEV\n", progname);
 	printf("    Download the OTA binary from URL and store it to DEV\n");
+	printf("    -n         Start over instead of resuming an interrupted download\n");
+	printf("    -s SHA256  Verify the image against this digest (64 hex digits)\n");
+#ifdef CONFIG_EXAMPLES_OTA_TEST
+	printf("Usage: %s -t DEV\n", progname);
+	printf("    Test the download of an image from a local server into DEV\n");
+#endif
 	printf("\n");
 	printf("    Example)\n");
 	printf("        %s http://192.168.1.10/ota.bin /dev/mtdblock7\n", progname);
 }
 
-static void store_file(FAR char **buffer, int offset,
-		int dataend, FAR int *buflen, FAR void *arg)
+static int store_stream(FAR struct ota_http_s *http, FAR const char *data,
+		int len, FAR void *arg)
+{
+	FAR struct ota_stream_s *st = (FAR struct ota_stream_s *)arg;
+	int ret;
+
+	if (http->received == 0) {
+		ret = ota_stream_begin(st, http);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return ota_stream_write(st, (FAR const uint8_t *)data, len);
+}
+
+static int parse_digest(FAR const char *hex, FAR uint8_t *digest)
 {
-	int fd = (int)arg;
+	unsigned int byte;
+	int i;
+
+	if (strlen(hex) != 2 * OTA_DIGESTLEN) {
+		return -EINVAL;
+	}
 
-	printf(".");
-	write(fd, *buffer + offset, dataend - offset);
+	for (i = 0; i < OTA_DIGESTLEN; i++) {
+		if (sscanf(hex + 2 * i, "%2x", &byte) != 1) {
+			return -EINVAL;
+		}
+		digest[i] = (uint8_t)byte;
+	}
+
+	return OK;
 }
 
 #define BUF_SIZE 4096
 
+/****************************************************************************
+ * Name: ota_download
+ *
+ * Description:
+ *   Download URL into the partition DEV through the pipeline, asking for
+ *   the rest of the image when the connection is lost.  With resume, an
+ *   earlier download interrupted at a checkpoint is continued.
+ *
+ * Returned Value:
+ *   Zero (OK) with the SHA-256 of the image in digest, or a negated errno.
+ *
+ ****************************************************************************/
+int ota_download(FAR const char *url, FAR const char *dev, bool resume, FAR uint8_t *digest)
+{
+	struct ota_stream_s st;
+	struct ota_http_s http;
+	FAR char *buffer;
+	uint32_t offset;
+	int retries = 0;
+	int ret;
+
+	buffer = (char *)malloc(BUF_SIZE);
+	if (buffer == NULL) {
+		return -ENOMEM;
+	}
+
+	ret = ota_stream_open(&st, url, dev, resume);
+	if (ret < 0) {
+		free(buffer);
+		return ret;
+	}
+
+	for (;;) {
+		offset = st.ckpt.offset;
+		if (offset > 0) {
+			printf("ota: resuming at %u\n", offset);
+		}
+
+		memset(&http, 0, sizeof(struct ota_http_s));
+		http.range = offset;
+		ret = wget(url, buffer, BUF_SIZE, store_stream, &st, &http);
+		if (ret == OK) {
+			break;
+		}
+
+		ret = -errno;
+		printf("ota: download failed: %d\n", ret);
+
+		/* Go on from what the writer programmed, unless it failed itself */
+
+		if (ota_stream_sync(&st) < 0) {
+			break;
+		}
+
+		if (st.ckpt.offset > offset) {
+			retries = 0;
+		} else if (++retries > CONFIG_EXAMPLES_OTA_RETRIES) {
+			break;
+		}
+	}
+
+	if (ret == OK) {
+		ret = ota_stream_close(&st, true, digest);
+	} else {
+		(void)ota_stream_close(&st, false, NULL);
+	}
+
+	free(buffer);
+	return ret;
+}
+
 #ifdef CONFIG_BUILD_KERNEL
 int main(int argc, FAR char *argv[])
 #else
 int ota_main(int argc, FAR char *argv[])
 #endif
 {
-	int fd;
-	char *buffer;
+	uint8_t expected[OTA_DIGESTLEN];
+	uint8_t digest[OTA_DIGESTLEN];
+	bool verify = false;
+	bool resume = true;
+	int option;
+	int ret;
+	int i;
 
-	if (argc < 3) {
-		print_usage(argv[0]);
-		return 0;
+	optind = 1;
+	while ((option = getopt(argc, argv, "ns:t:")) != ERROR) {
+		switch (option) {
+		case 'n':
+			resume = false;
+			break;
+
+		case 's':
+			if (parse_digest(optarg, expected) < 0) {
+				print_usage(argv[0]);
+				return 0;
+			}
+			verify = true;
+			break;
+
+#ifdef CONFIG_EXAMPLES_OTA_TEST
+		case 't':
+			return ota_test(optarg) < 0 ? 1 : 0;
+#endif
+
+		default:
+			print_usage(argv[0]);
+			return 0;
+		}
 	}
 
-	fd = open(argv[2], O_RDWR);
-	if (fd < 0) {
-		printf("Failed to open %s.\n", argv[2]);
+	if (argc - optind < 2) {
+		print_usage(argv[0]);
 		return 0;
 	}
 
-	buffer = (char *)malloc(BUF_SIZE);
+	ret = ota_download(argv[optind], argv[optind + 1], resume, digest);
+	if (ret < 0) {
+		printf("OTA failed: %d\n", ret);
+		return 1;
+	}
 
-	wget(argv[1], buffer, BUF_SIZE, store_file, (void *)fd);
+	printf("SHA-256: ");
+	for (i = 0; i < OTA_DIGESTLEN; i++) {
+		printf("%02x", digest[i]);
+	}
+	printf("\n");
 
-	close(fd);
-	free(buffer);
+	if (verify && memcmp(digest, expected, OTA_DIGESTLEN) != 0) {
+		printf("OTA failed: the image does not match the digest\n");
+		return 1;
+	}
 
 	printf("OTA Done\n");
 
@@ -0,0 +1,531 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/examples/ota/ota_stream.c
+ *
+ * Streams an image into an MTD partition.  The download, programming and
+ * erasing overlap: the downloader fills erase block sized buffers while a
+ * writer thread programs the previous ones and, whenever it has nothing to
+ * program, erases the next blocks of the image ahead of time.  The image
+ * is hashed by the writer as it is programmed, so there is no pass reading
+ * the partition back, and the hash state is saved with the progress to a
+ * checkpoint file so that an interrupted download can be resumed.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/ioctl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/fs/mtd.h>
+
+#include "ota.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define OTA_CKPT_MAGIC 0x4f544131	/* "OTA1" */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void ota_ckpt_save(FAR const struct ota_ckpt_s *ckpt)
+{
+	int fd;
+
+	fd = open(CONFIG_EXAMPLES_OTA_CHECKPOINT, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		return;
+	}
+
+	if (write(fd, ckpt, sizeof(struct ota_ckpt_s)) != sizeof(struct ota_ckpt_s)) {
+		/* A short checkpoint is not used, the next attempt starts over */
+
+		printf("ota: failed to save the checkpoint: %d\n", errno);
+	}
+
+	close(fd);
+}
+
+static bool ota_ckpt_load(FAR struct ota_stream_s *st, FAR const char *url, FAR const char *dev)
+{
+	FAR struct ota_ckpt_s *ckpt = &st->ckpt;
+	ssize_t nread;
+	int fd;
+
+	fd = open(CONFIG_EXAMPLES_OTA_CHECKPOINT, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	nread = read(fd, ckpt, sizeof(struct ota_ckpt_s));
+	close(fd);
+
+	/* Only a download of the same image into the same partition goes on */
+
+	return nread == sizeof(struct ota_ckpt_s) && ckpt->magic == OTA_CKPT_MAGIC &&
+		   strcmp(ckpt->url, url) == 0 && strcmp(ckpt->dev, dev) == 0 &&
+		   ckpt->offset % st->erasesize == 0 &&
+		   ckpt->offset <= st->erasesize * st->neraseblocks;
+}
+
+static void ota_ckpt_reset(FAR struct ota_ckpt_s *ckpt)
+{
+	ckpt->offset = 0;
+	ckpt->total  = 0;
+	mbedtls_sha256_init(&ckpt->sha);
+	mbedtls_sha256_starts(&ckpt->sha, 0);
+}
+
+/* Write one buffer at the given offset of the partition */
+
+static int ota_program(FAR struct ota_stream_s *st, FAR const struct ota_buf_s *buf, off_t offset)
+{
+	size_t nwritten = 0;
+	ssize_t ret;
+
+	if (lseek(st->fd, offset, SEEK_SET) != offset) {
+		return -errno;
+	}
+
+	while (nwritten < buf->len) {
+		ret = write(st->fd, buf->data + nwritten, buf->len - nwritten);
+		if (ret <= 0) {
+			return ret < 0 ? -errno : -ENOSPC;
+		}
+
+		nwritten += ret;
+	}
+
+	return OK;
+}
+
+/* Called with the lock held when there is nothing to program.  Erases the
+ * next block of the image if it is not too far ahead of the writer, and
+ * returns true if it did.
+ */
+
+static bool ota_erase_ahead(FAR struct ota_stream_s *st)
+{
+	struct mtd_erase_s erase;
+	size_t first;
+	size_t limit;
+	int ret;
+
+	if (!st->eraseahead || st->error < 0) {
+		return false;
+	}
+
+	first = st->ckpt.offset / st->erasesize;
+	limit = st->neraseblocks;
+	if (st->ckpt.total > 0) {
+		limit = (st->ckpt.total + st->erasesize - 1) / st->erasesize;
+	}
+
+	if (st->nexterase < first) {
+		st->nexterase = first;
+	}
+
+	if (st->nexterase >= limit || st->nexterase >= first + CONFIG_EXAMPLES_OTA_ERASEAHEAD) {
+		return false;
+	}
+
+	erase.startblock = st->nexterase;
+	erase.nblocks    = 1;
+
+	pthread_mutex_unlock(&st->lock);
+	ret = ioctl(st->fd, MTDIOC_ERASESECTORS, (unsigned long)&erase);
+	pthread_mutex_lock(&st->lock);
+
+	if (ret < 0) {
+		/* Not supported; every block is erased as it is written */
+
+		st->eraseahead = false;
+		return false;
+	}
+
+	/* Unless the download started over meanwhile */
+
+	if (st->nexterase == (size_t)erase.startblock) {
+		st->nexterase++;
+	}
+
+	return true;
+}
+
+static FAR void *ota_writer(FAR void *arg)
+{
+	FAR struct ota_stream_s *st = (FAR struct ota_stream_s *)arg;
+	FAR struct ota_buf_s *buf;
+	struct ota_ckpt_s ckpt;
+	bool save;
+	int ret;
+
+	pthread_mutex_lock(&st->lock);
+	for (;;) {
+		if (st->nqueued == 0) {
+			if (st->stop) {
+				break;
+			}
+
+			if (!ota_erase_ahead(st)) {
+				pthread_cond_wait(&st->cond, &st->lock);
+			}
+
+			continue;
+		}
+
+		/* The oldest queued buffer stays queued until it is written */
+
+		buf = &st->bufs[(st->head + CONFIG_EXAMPLES_OTA_NBUFFERS - st->nqueued) % CONFIG_EXAMPLES_OTA_NBUFFERS];
+		ret = st->error;
+		if (ret == OK) {
+			pthread_mutex_unlock(&st->lock);
+
+			ret = ota_program(st, buf, st->ckpt.offset);
+			if (ret == OK) {
+				mbedtls_sha256_update(&st->ckpt.sha, buf->data, buf->len);
+			}
+
+			pthread_mutex_lock(&st->lock);
+		}
+
+		save = false;
+		if (ret < 0) {
+			st->error = ret;
+		} else {
+			st->ckpt.offset += buf->len;
+			st->nbytes      += buf->len;
+
+			/* Only full blocks leave the image at a block boundary */
+
+			if (buf->len == st->erasesize && ++st->nblocks >= CONFIG_EXAMPLES_OTA_CHECKPOINT_INTERVAL) {
+				st->nblocks = 0;
+				ckpt = st->ckpt;
+				save = true;
+			}
+		}
+
+		buf->len = 0;
+		st->nqueued--;
+		pthread_cond_broadcast(&st->cond);
+
+		if (save) {
+			pthread_mutex_unlock(&st->lock);
+
+			/* The checkpoint may not get ahead of what is on the flash */
+
+			ret = fsync(st->fd);
+			if (ret < 0) {
+				ret = -errno;
+			} else {
+				ota_ckpt_save(&ckpt);
+			}
+
+			pthread_mutex_lock(&st->lock);
+			if (ret < 0 && st->error == OK) {
+				st->error = ret;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&st->lock);
+	return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ota_stream_open
+ *
+ * Description:
+ *   Open the partition and start the writer.  With resume, a checkpoint of
+ *   the same URL and partition is picked up: ckpt.offset is then where the
+ *   download goes on from.
+ *
+ ****************************************************************************/
+
+int ota_stream_open(FAR struct ota_stream_s *st, FAR const char *url, FAR const char *dev, bool resume)
+{
+	struct mtd_geometry_s geo;
+	int ret;
+	int i;
+
+	memset(st, 0, sizeof(struct ota_stream_s));
+	if (strlen(url) >= OTA_MAXURL || strlen(dev) >= sizeof(st->ckpt.dev)) {
+		return -ENAMETOOLONG;
+	}
+
+	st->fd = open(dev, O_RDWR);
+	if (st->fd < 0) {
+		return -errno;
+	}
+
+	/* Passed down to the MTD driver of the partition */
+
+	ret = ioctl(st->fd, MTDIOC_GEOMETRY, (unsigned long)&geo);
+	if (ret < 0) {
+		ret = -errno;
+		goto errout_with_fd;
+	}
+
+	st->erasesize    = geo.erasesize;
+	st->neraseblocks = geo.neraseblocks;
+	st->eraseahead   = true;
+
+	if (!resume || !ota_ckpt_load(st, url, dev)) {
+		memset(&st->ckpt, 0, sizeof(struct ota_ckpt_s));
+		st->ckpt.magic = OTA_CKPT_MAGIC;
+		strcpy(st->ckpt.url, url);
+		strcpy(st->ckpt.dev, dev);
+		ota_ckpt_reset(&st->ckpt);
+	}
+
+	st->queued    = st->ckpt.offset;
+	st->nexterase = st->ckpt.offset / st->erasesize;
+
+	for (i = 0; i < CONFIG_EXAMPLES_OTA_NBUFFERS; i++) {
+		st->bufs[i].data = (FAR uint8_t *)malloc(st->erasesize);
+		if (st->bufs[i].data == NULL) {
+			ret = -ENOMEM;
+			goto errout_with_bufs;
+		}
+	}
+
+	pthread_mutex_init(&st->lock, NULL);
+	pthread_cond_init(&st->cond, NULL);
+
+	ret = pthread_create(&st->writer, NULL, ota_writer, st);
+	if (ret != 0) {
+		ret = -ret;
+		pthread_cond_destroy(&st->cond);
+		pthread_mutex_destroy(&st->lock);
+		goto errout_with_bufs;
+	}
+
+	pthread_setname_np(st->writer, "ota_writer");
+	clock_gettime(CLOCK_REALTIME, &st->start);
+	return OK;
+
+errout_with_bufs:
+	for (i = 0; i < CONFIG_EXAMPLES_OTA_NBUFFERS; i++) {
+		free(st->bufs[i].data);
+	}
+
+errout_with_fd:
+	close(st->fd);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: ota_stream_begin
+ *
+ * Description:
+ *   Called with the first data of each response, after ota_stream_sync()
+ *   if it is not the first response.  A server that ignored the Range
+ *   request sends the whole image again, so the download starts over.
+ *
+ ****************************************************************************/
+
+int ota_stream_begin(FAR struct ota_stream_s *st, FAR const struct ota_http_s *http)
+{
+	int ret = OK;
+
+	pthread_mutex_lock(&st->lock);
+	DEBUGASSERT(st->nqueued == 0 && st->bufs[st->head].len == 0);
+
+	if (!http->partial && st->ckpt.offset > 0) {
+		printf("ota: the server does not resume, starting over\n");
+		ota_ckpt_reset(&st->ckpt);
+		st->queued    = 0;
+		st->nblocks   = 0;
+		st->nexterase = 0;
+	} else if (http->partial && http->range != st->ckpt.offset) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	if (http->length >= 0) {
+		st->ckpt.total = st->ckpt.offset + http->length;
+		if (st->ckpt.total > st->erasesize * st->neraseblocks) {
+			ret = -EFBIG;
+		}
+	}
+
+errout:
+	pthread_mutex_unlock(&st->lock);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: ota_stream_write
+ *
+ * Description:
+ *   Pass on the next data of the image.  Only waits for the writer when
+ *   all of the buffers are queued.  bufs[head] is always the one being
+ *   filled.
+ *
+ ****************************************************************************/
+
+int ota_stream_write(FAR struct ota_stream_s *st, FAR const uint8_t *data, size_t len)
+{
+	FAR struct ota_buf_s *buf;
+	size_t nbytes;
+	int ret = OK;
+
+	while (len > 0) {
+		buf = &st->bufs[st->head];
+		nbytes = st->erasesize - buf->len;
+		if (nbytes > len) {
+			nbytes = len;
+		}
+
+		memcpy(buf->data + buf->len, data, nbytes);
+		buf->len += nbytes;
+		data     += nbytes;
+		len      -= nbytes;
+
+		if (buf->len == st->erasesize) {
+			pthread_mutex_lock(&st->lock);
+			st->head = (st->head + 1) % CONFIG_EXAMPLES_OTA_NBUFFERS;
+			st->nqueued++;
+			st->queued += buf->len;
+			pthread_cond_broadcast(&st->cond);
+
+			/* The next buffer is free once the writer is done with it */
+
+			while (st->nqueued == CONFIG_EXAMPLES_OTA_NBUFFERS && st->error == OK) {
+				pthread_cond_wait(&st->cond, &st->lock);
+			}
+
+			ret = st->error;
+			pthread_mutex_unlock(&st->lock);
+			if (ret < 0) {
+				break;
+			}
+		}
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: ota_stream_sync
+ *
+ * Description:
+ *   The connection was lost: program what is queued and drop the partial
+ *   block.  The download goes on from ckpt.offset.
+ *
+ ****************************************************************************/
+
+int ota_stream_sync(FAR struct ota_stream_s *st)
+{
+	int ret;
+
+	pthread_mutex_lock(&st->lock);
+	while (st->nqueued > 0) {
+		pthread_cond_wait(&st->cond, &st->lock);
+	}
+
+	st->bufs[st->head].len = 0;
+	st->queued = st->ckpt.offset;
+	ret = st->error;
+	pthread_mutex_unlock(&st->lock);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: ota_stream_close
+ *
+ * Description:
+ *   Stop the writer and close the partition.  When the download is
+ *   complete the rest of the image is programmed, its SHA-256 returned in
+ *   digest and the checkpoint removed; otherwise the checkpoint is kept
+ *   for the next attempt.  Reports the throughput.
+ *
+ ****************************************************************************/
+
+int ota_stream_close(FAR struct ota_stream_s *st, bool complete, FAR uint8_t *digest)
+{
+	struct timespec now;
+	unsigned long msec;
+	int ret;
+	int i;
+
+	pthread_mutex_lock(&st->lock);
+	if (complete && st->bufs[st->head].len > 0) {
+		st->queued += st->bufs[st->head].len;
+		st->head = (st->head + 1) % CONFIG_EXAMPLES_OTA_NBUFFERS;
+		st->nqueued++;
+	}
+
+	st->stop = true;
+	pthread_cond_broadcast(&st->cond);
+	pthread_mutex_unlock(&st->lock);
+
+	pthread_join(st->writer, NULL);
+	pthread_cond_destroy(&st->cond);
+	pthread_mutex_destroy(&st->lock);
+
+	ret = st->error;
+	if (ret == OK && complete && st->ckpt.total > 0 && st->ckpt.offset != st->ckpt.total) {
+		ret = -EIO;
+	}
+
+	if (ret == OK && complete) {
+		mbedtls_sha256_finish(&st->ckpt.sha, digest);
+		unlink(CONFIG_EXAMPLES_OTA_CHECKPOINT);
+	} else if (st->ckpt.offset > 0 && st->ckpt.offset % st->erasesize == 0) {
+		if (fsync(st->fd) == OK) {
+			ota_ckpt_save(&st->ckpt);
+		}
+	}
+
+	/* Also flushes what the block driver proxy holds */
+
+	if (close(st->fd) < 0 && ret == OK) {
+		ret = -errno;
+	}
+
+	for (i = 0; i < CONFIG_EXAMPLES_OTA_NBUFFERS; i++) {
+		free(st->bufs[i].data);
+	}
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	msec = (now.tv_sec - st->start.tv_sec) * 1000 + (now.tv_nsec - st->start.tv_nsec) / 1000000;
+	printf("ota: %u bytes in %lu ms (%lu KB/s), image at %u of %u\n",
+		   st->nbytes, msec, msec > 0 ? (unsigned long)((uint64_t)st->nbytes * 1000 / 1024 / msec) : 0UL,
+		   st->ckpt.offset, st->ckpt.total);
+
+	return ret;
+}
@@ -0,0 +1,406 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * apps/examples/ota/ota_test.c
+ *
+ * Downloads an image from a stand-in HTTP server on 127.0.0.1 that drops
+ * the connection part way, and goes away for a while, to exercise the
+ * resume paths of the pipeline.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/fs/mtd.h>
+
+#include "ota.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_OTA_TEST_PORT
+#define CONFIG_EXAMPLES_OTA_TEST_PORT 8080
+#endif
+
+#ifndef CONFIG_EXAMPLES_OTA_TEST_SIZE
+#define CONFIG_EXAMPLES_OTA_TEST_SIZE 65536
+#endif
+
+#define OTA_TEST_CHUNK 512
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ota_server_s {
+	int          listenfd;
+	volatile bool stop;
+	uint32_t     size;        /* Of the image */
+	uint32_t     dropat;      /* Close the next response here, 0 for never */
+	int          refuse;      /* Then close this many without answering */
+	bool         dropped;
+	int          nrequests;
+	uint32_t     range;       /* Asked for by the last request */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ota_server_s g_server;
+static char g_chunk[OTA_TEST_CHUNK];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint8_t ota_test_byte(uint32_t pos)
+{
+	return (uint8_t)(pos * 31 + (pos >> 11));
+}
+
+static void ota_test_fill(FAR uint8_t *buf, uint32_t pos, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		buf[i] = ota_test_byte(pos + i);
+	}
+}
+
+static int ota_test_send(int fd, FAR const char *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = send(fd, buf, len, 0);
+		if (ret <= 0) {
+			return ERROR;
+		}
+
+		buf += ret;
+		len -= ret;
+	}
+
+	return OK;
+}
+
+/* Answer one GET, with 206 and the rest of the image to a Range request */
+
+static void ota_serve(int fd)
+{
+	char req[256];
+	FAR char *range;
+	uint32_t start = 0;
+	uint32_t end;
+	uint32_t pos;
+	size_t len = 0;
+	ssize_t ret;
+
+	do {
+		ret = recv(fd, req + len, sizeof(req) - 1 - len, 0);
+		if (ret <= 0) {
+			return;
+		}
+
+		len += ret;
+		req[len] = '\0';
+	} while (strstr(req, "\r\n\r\n") == NULL && len < sizeof(req) - 1);
+
+	range = strstr(req, "Range: bytes=");
+	if (range != NULL) {
+		start = strtoul(range + strlen("Range: bytes="), NULL, 10);
+	}
+
+	g_server.nrequests++;
+	g_server.range = start;
+	if (g_server.dropped && g_server.refuse > 0) {
+		g_server.refuse--;
+		return;
+	}
+
+	if (start >= g_server.size) {
+		len = sprintf(g_chunk, "HTTP/1.0 416 Range Not Satisfiable\r\n\r\n");
+		(void)ota_test_send(fd, g_chunk, len);
+		return;
+	}
+
+	if (start > 0) {
+		len = sprintf(g_chunk, "HTTP/1.0 206 Partial Content\r\nContent-Length: %u\r\n"
+					  "Content-Range: bytes %u-%u/%u\r\n\r\n",
+					  g_server.size - start, start, g_server.size - 1, g_server.size);
+	} else {
+		len = sprintf(g_chunk, "HTTP/1.0 200 OK\r\nContent-Length: %u\r\n\r\n", g_server.size);
+	}
+
+	if (ota_test_send(fd, g_chunk, len) < 0) {
+		return;
+	}
+
+	end = g_server.size;
+	if (g_server.dropat > start && g_server.dropat < end) {
+		end = g_server.dropat;
+		g_server.dropat  = 0;
+		g_server.dropped = true;
+	}
+
+	for (pos = start; pos < end; pos += len) {
+		len = end - pos < OTA_TEST_CHUNK ? end - pos : OTA_TEST_CHUNK;
+		ota_test_fill((FAR uint8_t *)g_chunk, pos, len);
+		if (ota_test_send(fd, g_chunk, len) < 0) {
+			return;
+		}
+	}
+}
+
+static FAR void *ota_server(FAR void *arg)
+{
+	struct sockaddr_in addr;
+	socklen_t addrlen;
+	int fd;
+
+	while (!g_server.stop) {
+		addrlen = sizeof(struct sockaddr_in);
+		fd = accept(g_server.listenfd, (struct sockaddr *)&addr, &addrlen);
+		if (fd < 0) {
+			break;
+		}
+
+		if (!g_server.stop) {
+			ota_serve(fd);
+		}
+
+		close(fd);
+	}
+
+	return NULL;
+}
+
+static int ota_server_start(FAR pthread_t *thread)
+{
+	struct sockaddr_in addr;
+	int optval = 1;
+	int ret;
+
+	g_server.listenfd = socket(AF_INET, SOCK_STREAM, 0);
+	if (g_server.listenfd < 0) {
+		return -errno;
+	}
+
+	(void)setsockopt(g_server.listenfd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+
+	memset(&addr, 0, sizeof(struct sockaddr_in));
+	addr.sin_family      = AF_INET;
+	addr.sin_port        = htons(CONFIG_EXAMPLES_OTA_TEST_PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(g_server.listenfd, (struct sockaddr *)&addr, sizeof(struct sockaddr_in)) < 0 ||
+		listen(g_server.listenfd, 2) < 0) {
+		ret = -errno;
+		goto errout;
+	}
+
+	g_server.stop = false;
+	ret = pthread_create(thread, NULL, ota_server, NULL);
+	if (ret != 0) {
+		ret = -ret;
+		goto errout;
+	}
+
+	return OK;
+
+errout:
+	close(g_server.listenfd);
+	return ret;
+}
+
+static void ota_server_stop(pthread_t thread)
+{
+	struct sockaddr_in addr;
+	int fd;
+
+	/* Wake it up from accept() */
+
+	g_server.stop = true;
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd >= 0) {
+		memset(&addr, 0, sizeof(struct sockaddr_in));
+		addr.sin_family      = AF_INET;
+		addr.sin_port        = htons(CONFIG_EXAMPLES_OTA_TEST_PORT);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		(void)connect(fd, (struct sockaddr *)&addr, sizeof(struct sockaddr_in));
+		close(fd);
+	}
+
+	pthread_join(thread, NULL);
+	close(g_server.listenfd);
+}
+
+/* The partition holds the image, read back here only to check the test */
+
+static int ota_test_readback(FAR const char *dev, uint32_t size)
+{
+	uint8_t expect[OTA_TEST_CHUNK];
+	uint8_t buf[OTA_TEST_CHUNK];
+	uint32_t pos;
+	size_t len;
+	int ret = OK;
+	int fd;
+
+	fd = open(dev, O_RDONLY);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	for (pos = 0; pos < size && ret == OK; pos += len) {
+		len = size - pos < OTA_TEST_CHUNK ? size - pos : OTA_TEST_CHUNK;
+		ota_test_fill(expect, pos, len);
+		if (read(fd, buf, len) != (ssize_t)len || memcmp(buf, expect, len) != 0) {
+			printf("ota_test: partition differs around %u\n", pos);
+			ret = -EIO;
+		}
+	}
+
+	close(fd);
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int ota_test(FAR const char *dev)
+{
+	mbedtls_sha256_context sha;
+	struct mtd_geometry_s geo;
+	uint8_t expected[OTA_DIGESTLEN];
+	uint8_t digest[OTA_DIGESTLEN];
+	char url[40];
+	pthread_t server;
+	uint32_t nblocks;
+	uint32_t pos;
+	size_t len;
+	int fails = 0;
+	int ret;
+	int fd;
+
+	/* An image that ends in the middle of an erase block */
+
+	fd = open(dev, O_RDONLY);
+	if (fd < 0) {
+		printf("ota_test: failed to open %s: %d\n", dev, errno);
+		return -ENODEV;
+	}
+
+	ret = ioctl(fd, MTDIOC_GEOMETRY, (unsigned long)&geo);
+	close(fd);
+	if (ret < 0) {
+		printf("ota_test: %s is not an MTD partition\n", dev);
+		return -ENODEV;
+	}
+
+	nblocks = CONFIG_EXAMPLES_OTA_TEST_SIZE / geo.erasesize;
+	if (nblocks < 4) {
+		nblocks = 4;
+	}
+
+	if (nblocks > geo.neraseblocks) {
+		nblocks = geo.neraseblocks;
+	}
+
+	g_server.size = nblocks * geo.erasesize - geo.erasesize / 3;
+
+	mbedtls_sha256_init(&sha);
+	mbedtls_sha256_starts(&sha, 0);
+	for (pos = 0; pos < g_server.size; pos += len) {
+		len = g_server.size - pos < OTA_TEST_CHUNK ? g_server.size - pos : OTA_TEST_CHUNK;
+		ota_test_fill((FAR uint8_t *)g_chunk, pos, len);
+		mbedtls_sha256_update(&sha, (FAR const unsigned char *)g_chunk, len);
+	}
+	mbedtls_sha256_finish(&sha, expected);
+	mbedtls_sha256_free(&sha);
+
+	ret = ota_server_start(&server);
+	if (ret < 0) {
+		printf("ota_test: failed to start the server: %d\n", ret);
+		return ret;
+	}
+
+	snprintf(url, sizeof(url), "http://127.0.0.1:%d/ota.bin", CONFIG_EXAMPLES_OTA_TEST_PORT);
+	printf("ota_test: %u byte image, %u byte erase blocks\n", g_server.size, geo.erasesize);
+
+	/* The connection drops within a block: the rest is asked for */
+
+	g_server.dropat    = g_server.size / 2 + 100;
+	g_server.refuse    = 0;
+	g_server.dropped   = false;
+	g_server.nrequests = 0;
+	ret = ota_download(url, dev, false, digest);
+	if (ret < 0 || memcmp(digest, expected, OTA_DIGESTLEN) != 0 ||
+		g_server.nrequests != 2 || g_server.range == 0 || g_server.range > g_server.size / 2 + 100 ||
+		ota_test_readback(dev, g_server.size) < 0) {
+		printf("ota_test: FAIL: dropped connection (%d, %d requests)\n", ret, g_server.nrequests);
+		fails++;
+	} else {
+		printf("ota_test: PASS: dropped connection, resumed at %u\n", g_server.range);
+	}
+
+	/* The server goes away: the next download goes on from the checkpoint */
+
+	g_server.dropat    = g_server.size * 3 / 4 + 100;
+	g_server.refuse    = CONFIG_EXAMPLES_OTA_RETRIES + 1;
+	g_server.dropped   = false;
+	g_server.nrequests = 0;
+	ret = ota_download(url, dev, false, digest);
+	if (ret >= 0) {
+		printf("ota_test: FAIL: download without a server succeeded\n");
+		fails++;
+	}
+
+	g_server.refuse    = 0;
+	g_server.nrequests = 0;
+	ret = ota_download(url, dev, true, digest);
+	if (ret < 0 || memcmp(digest, expected, OTA_DIGESTLEN) != 0 ||
+		g_server.nrequests != 1 || g_server.range == 0 ||
+		ota_test_readback(dev, g_server.size) < 0) {
+		printf("ota_test: FAIL: resume from checkpoint (%d, %d requests)\n", ret, g_server.nrequests);
+		fails++;
+	} else {
+		printf("ota_test: PASS: resumed from checkpoint at %u\n", g_server.range);
+	}
+
+	ota_server_stop(server);
+	printf("ota_test: %s\n", fails == 0 ? "PASS" : "FAIL");
+	return fails == 0 ? OK : -EIO;
+}
@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 #include <tinyara/progmem.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 
 #include <unistd.h>
 #include <stdio.h>
@@ -64,6 +65,7 @@
 #include <string.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <time.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -79,6 +81,14 @@ static int g_seekCount;
 static int g_writeCount;
 static int g_circCount;
 static int g_appendCount;
+static int g_latencyCount;
+static int g_latencyIdle;
+static int g_lookupCount;
+static int g_loggerCount;
+#ifdef CONFIG_FS_RAMMAP
+static int g_mmapCount;
+#endif
+static char *g_statusPath;
 
 static int g_lineCount = 2000;
 static int g_recordLen = 64;
@@ -214,6 +224,67 @@ static int smart_seek_test(char *filename)
 	return ret;
 }
 
+#ifdef CONFIG_FS_RAMMAP
+/****************************************************************************
+ * Name: smart_mmap_test
+ *
+ * Description: Maps the test file with mmap() and checks random lines
+ *              through the mapping.
+ *
+ ****************************************************************************/
+
+static int smart_mmap_test(char *filename)
+{
+	struct stat st;
+	char cmpstring[80];
+	FAR char *map;
+	int index;
+	int fd;
+	int x;
+	int ret = OK;
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0 || stat(filename, &st) < 0) {
+		printf("Unable to open file %s\n", filename);
+		if (fd >= 0) {
+			close(fd);
+		}
+		return -ENOENT;
+	}
+
+	map = (FAR char *)mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		printf("Unable to map file %s: %d\n", filename, errno);
+		return -errno;
+	}
+
+	printf("Checking %d random lines through the mapping\n", g_mmapCount);
+
+	srand(29);
+	for (x = 0; x < g_mmapCount; x++) {
+		index = rand() % g_lineCount;
+		sprintf(cmpstring, "This is line %d at offset %d\n", index, g_linePos[index]);
+
+		if (strncmp(map + g_linePos[index], cmpstring, g_lineLen[index]) != 0) {
+			printf("\nMapping error on line %d\n", index);
+			printf("\t Expected \"%s\"\n", cmpstring);
+			ret = -1;
+		}
+	}
+
+	munmap(map, st.st_size);
+
+	if (ret < 0) {
+		printf("\nmmap test failed\n");
+	} else {
+		printf("\nmmap test passed\n");
+	}
+
+	return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_append_test
  *
@@ -528,6 +599,345 @@ static int smart_circular_log_test(char *filename)
 	return OK;
 }
 
+/****************************************************************************
+ * Name: smart_latency_compare
+ ****************************************************************************/
+
+static int smart_latency_compare(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: smart_latency_test
+ *
+ * Description: Performs a data logger style write test, overwriting the
+ *              records of a circular log one at a time, and reports the
+ *              distribution of the write times.  With -i, the logger
+ *              sleeps between records, which gives a background garbage
+ *              collector the idle time it needs.
+ *
+ ****************************************************************************/
+
+static int smart_latency_test(char *filename)
+{
+	struct timespec start;
+	struct timespec end;
+	uint32_t *latency;
+	uint64_t total;
+	char *buffer;
+	int recordNo;
+	int fd;
+	int x;
+
+	latency = malloc(g_latencyCount * sizeof(uint32_t));
+	if (latency == NULL) {
+		printf("Unable to allocate memory for latency samples\n");
+		return -ENOMEM;
+	}
+
+	buffer = malloc(g_recordLen);
+	if (buffer == NULL) {
+		printf("Unable to allocate memory for record storage\n");
+		free(latency);
+		return -ENOMEM;
+	}
+
+	fd = open(filename, O_RDWR | O_CREAT | O_TRUNC);
+	if (fd == -1) {
+		printf("Unable to create file %s\n", filename);
+		free(buffer);
+		free(latency);
+		return -ENOENT;
+	}
+
+	printf("Writing %d records of %d bytes to a log of %d records\n", g_latencyCount, g_recordLen, g_totalRecords);
+
+	recordNo = 0;
+	for (x = 0; x < g_latencyCount; x++) {
+		memset(buffer, x & 0xFF, g_recordLen);
+
+		clock_gettime(CLOCK_REALTIME, &start);
+		lseek(fd, g_recordLen * recordNo, SEEK_SET);
+		if (write(fd, buffer, g_recordLen) != g_recordLen) {
+			printf("\nWrite of record %d failed: %d\n", recordNo, errno);
+			break;
+		}
+
+		fsync(fd);
+		clock_gettime(CLOCK_REALTIME, &end);
+
+		latency[x] = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+
+		if (++recordNo >= g_totalRecords) {
+			recordNo = 0;
+		}
+
+		if (g_latencyIdle > 0) {
+			usleep(g_latencyIdle);
+		}
+	}
+
+	close(fd);
+
+	if (x > 0) {
+		total = 0;
+		for (recordNo = 0; recordNo < x; recordNo++) {
+			total += latency[recordNo];
+		}
+
+		qsort(latency, x, sizeof(uint32_t), smart_latency_compare);
+
+		printf("Write latency (usec) over %d writes:\n", x);
+		printf("  avg %u  p50 %u  p90 %u  p99 %u  p99.9 %u  max %u\n", (unsigned int)(total / x), (unsigned int)latency[x / 2], (unsigned int)latency[(x * 9) / 10], (unsigned int)latency[(x * 99) / 100], (unsigned int)latency[(x * 999) / 1000], (unsigned int)latency[x - 1]);
+		if (total > 0) {
+			printf("  %u writes/sec\n", (unsigned int)((uint64_t)x * 1000000 / total));
+		}
+	}
+
+	free(buffer);
+	free(latency);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smart_elapsed
+ *
+ * Description: Returns the microseconds since start.
+ *
+ ****************************************************************************/
+
+static uint32_t smart_elapsed(struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_REALTIME, &end);
+	return (end.tv_sec - start->tv_sec) * 1000000 + (end.tv_nsec - start->tv_nsec) / 1000;
+}
+
+/****************************************************************************
+ * Name: smart_lookup_test
+ *
+ * Description: Fills a directory with g_lookupCount files and reports the
+ *              average time to stat() and open() names in it: a few names
+ *              used over and over, every name once, and a name that does
+ *              not exist.
+ *
+ ****************************************************************************/
+
+#define SMART_LOOKUP_HOT    8
+#define SMART_LOOKUP_ROUNDS 50
+
+static int smart_lookup_test(char *filename)
+{
+	struct timespec start;
+	struct stat st;
+	char *path;
+	int len;
+	int fd;
+	int ret;
+	int x;
+	int y;
+
+	len = strlen(filename) + 16;
+	path = malloc(len);
+	if (path == NULL) {
+		printf("Unable to allocate memory for path names\n");
+		return -ENOMEM;
+	}
+
+	snprintf(path, len, "%s.d", filename);
+	if (mkdir(path, 0777) < 0 && errno != EEXIST) {
+		printf("Unable to create directory %s: %d\n", path, errno);
+		free(path);
+		return -errno;
+	}
+
+	printf("Creating %d files in %s\n", g_lookupCount, path);
+	for (x = 0; x < g_lookupCount; x++) {
+		snprintf(path, len, "%s.d/f%d", filename, x);
+		fd = open(path, O_WRONLY | O_CREAT | O_TRUNC);
+		if (fd < 0) {
+			printf("Unable to create file %s: %d\n", path, errno);
+			g_lookupCount = x;
+			break;
+		}
+
+		close(fd);
+	}
+
+	ret = OK;
+	if (g_lookupCount < SMART_LOOKUP_HOT) {
+		printf("Need at least %d files\n", SMART_LOOKUP_HOT);
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	printf("Lookup time (usec) in a directory of %d files:\n", g_lookupCount);
+
+	/* The same few names, as an application reopening its files would */
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (y = 0; y < SMART_LOOKUP_ROUNDS; y++) {
+		for (x = g_lookupCount - SMART_LOOKUP_HOT; x < g_lookupCount; x++) {
+			snprintf(path, len, "%s.d/f%d", filename, x);
+			stat(path, &st);
+		}
+	}
+
+	printf("  stat, %d names reused   %u\n", SMART_LOOKUP_HOT, (unsigned int)(smart_elapsed(&start) / (SMART_LOOKUP_ROUNDS * SMART_LOOKUP_HOT)));
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (y = 0; y < SMART_LOOKUP_ROUNDS; y++) {
+		for (x = g_lookupCount - SMART_LOOKUP_HOT; x < g_lookupCount; x++) {
+			snprintf(path, len, "%s.d/f%d", filename, x);
+			fd = open(path, O_RDONLY);
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+	}
+
+	printf("  open, %d names reused   %u\n", SMART_LOOKUP_HOT, (unsigned int)(smart_elapsed(&start) / (SMART_LOOKUP_ROUNDS * SMART_LOOKUP_HOT)));
+
+	/* Every name once */
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (x = 0; x < g_lookupCount; x++) {
+		snprintf(path, len, "%s.d/f%d", filename, x);
+		stat(path, &st);
+	}
+
+	printf("  stat, every name once   %u\n", (unsigned int)(smart_elapsed(&start) / g_lookupCount));
+
+	/* A name that isn't there, as when probing for an optional file */
+
+	snprintf(path, len, "%s.d/missing", filename);
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (y = 0; y < SMART_LOOKUP_ROUNDS; y++) {
+		stat(path, &st);
+	}
+
+	printf("  stat, missing name      %u\n", (unsigned int)(smart_elapsed(&start) / SMART_LOOKUP_ROUNDS));
+
+errout:
+	for (x = 0; x < g_lookupCount; x++) {
+		snprintf(path, len, "%s.d/f%d", filename, x);
+		unlink(path);
+	}
+
+	snprintf(path, len, "%s.d", filename);
+	rmdir(path);
+	free(path);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: smart_block_erases
+ *
+ * Description: Returns the "Block Erases" count from the procfs status file
+ *              given with -m, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int smart_block_erases(void)
+{
+	char line[48];
+	FILE *fp;
+	int erases;
+
+	if (g_statusPath == NULL) {
+		return -1;
+	}
+
+	fp = fopen(g_statusPath, "r");
+	if (fp == NULL) {
+		return -1;
+	}
+
+	erases = -1;
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		if (strncmp(line, "Block Erases", 12) == 0) {
+			erases = atoi(&line[12]);
+			break;
+		}
+	}
+
+	fclose(fp);
+	return erases;
+}
+
+/****************************************************************************
+ * Name: smart_logger_test
+ *
+ * Description: Appends g_loggerCount records to a file the way a sensor
+ *              logger does, one write() per record and a single fsync()
+ *              at the end, and reports the records written per second and
+ *              the erase blocks the volume erased per MB of records.
+ *
+ ****************************************************************************/
+
+static int smart_logger_test(char *filename)
+{
+	struct timespec start;
+	uint32_t elapsed;
+	uint32_t bytes;
+	char *buffer;
+	int erases;
+	int fd;
+	int x;
+
+	buffer = malloc(g_recordLen);
+	if (buffer == NULL) {
+		printf("Unable to allocate memory for record storage\n");
+		return -ENOMEM;
+	}
+
+	fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC);
+	if (fd == -1) {
+		printf("Unable to create file %s\n", filename);
+		free(buffer);
+		return -ENOENT;
+	}
+
+	printf("Appending %d records of %d bytes\n", g_loggerCount, g_recordLen);
+
+	erases = smart_block_erases();
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (x = 0; x < g_loggerCount; x++) {
+		memset(buffer, x & 0xFF, g_recordLen);
+		if (write(fd, buffer, g_recordLen) != g_recordLen) {
+			printf("\nWrite of record %d failed: %d\n", x, errno);
+			break;
+		}
+
+		if (g_latencyIdle > 0) {
+			usleep(g_latencyIdle);
+		}
+	}
+
+	fsync(fd);
+	elapsed = smart_elapsed(&start);
+	close(fd);
+
+	bytes = x * g_recordLen;
+	if (elapsed > 0) {
+		printf("  %u records/sec\n", (unsigned int)((uint64_t)x * 1000000 / elapsed));
+	}
+
+	if (erases >= 0 && bytes > 0) {
+		erases = smart_block_erases() - erases;
+		printf("  %d block erases, %u per MB written\n", erases, (unsigned int)((uint64_t)erases * 1024 * 1024 / bytes));
+	}
+
+	unlink(filename);
+	free(buffer);
+	return OK;
+}
+
 /****************************************************************************
  * Name: smart_usage
  *
@@ -536,11 +946,11 @@ static int smart_circular_log_test(char *filename)
  ****************************************************************************/
 static void smart_usage(void)
 {
-	fprintf(stderr, "usage: smart_test [-c COUNT] [-s SEEKCOUNT] [-w WRITECOUNT] smart_mounted_filename\n\n");
+	fprintf(stderr, "usage: smart_test [-c COUNT] [-d NFILES] [-j COUNT] [-p COUNT] [-s SEEKCOUNT] [-w WRITECOUNT] [-x COUNT] smart_mounted_filename\n\n");
 
 	fprintf(stderr, "DESCRIPTION\n");
 	fprintf(stderr, "    Conducts various stress tests to validate SMARTFS operation.\n");
-	fprintf(stderr, "    Please choose one or more of -c, -s, or -w to conduct tests.\n\n");
+	fprintf(stderr, "    Please choose one or more of -c, -d, -j, -p, -s, -w, or -x to conduct tests.\n\n");
 
 	fprintf(stderr, "OPTIONS\n");
 	fprintf(stderr, "    -c COUNT\n");
@@ -562,6 +972,34 @@ static void smart_usage(void)
 	fprintf(stderr, "          test lines to write to the test file.  The WRITECOUNT parameter sets\n");
 	fprintf(stderr, "          the number of seek/write operations to perform.\n\n");
 
+	fprintf(stderr, "    -p COUNT\n");
+	fprintf(stderr, "          Performs a data logger style test that overwrites COUNT records\n");
+	fprintf(stderr, "          of a circular log, syncing after each, and reports write latency\n");
+	fprintf(stderr, "          percentiles.  Uses the -r and -t options for the record geometry.\n\n");
+
+#ifdef CONFIG_FS_RAMMAP
+	fprintf(stderr, "    -x COUNT\n");
+	fprintf(stderr, "          Maps the test file with mmap() and checks COUNT random lines of\n");
+	fprintf(stderr, "          it through the mapping.  Uses the -l option like -s.\n\n");
+#endif
+
+	fprintf(stderr, "    -d NFILES\n");
+	fprintf(stderr, "          Creates NFILES files in a directory next to the test file and\n");
+	fprintf(stderr, "          reports the average time to stat and open names in it.\n\n");
+
+	fprintf(stderr, "    -j COUNT\n");
+	fprintf(stderr, "          Appends COUNT records to the test file with one write each and\n");
+	fprintf(stderr, "          a single fsync at the end, and reports records per second and,\n");
+	fprintf(stderr, "          with -m, block erases per MB written.  Uses the -r option for\n");
+	fprintf(stderr, "          the record length.\n\n");
+
+	fprintf(stderr, "    -m STATUSFILE\n");
+	fprintf(stderr, "          The procfs status file of the volume, such as\n");
+	fprintf(stderr, "          /proc/fs/smartfs/smart0/status, to count block erases from.\n\n");
+
+	fprintf(stderr, "    -i USEC\n");
+	fprintf(stderr, "          Sets the idle time between records of the -j and -p tests.\n\n");
+
 	fprintf(stderr, "    -l LINECOUNT\n");
 	fprintf(stderr, "          Sets the number of lines of test data to write to the test file\n");
 	fprintf(stderr, "          during seek and seek/write tests.\n\n");
@@ -595,20 +1033,40 @@ int smart_test_main(int argc, char *argv[])
 	/* Argument given? */
 
 	optind = -1;
-	while ((opt = getopt(argc, argv, "c:e:l:r:s:a:t:w:")) != -1) {
+	while ((opt = getopt(argc, argv, "c:d:e:i:j:l:m:p:r:s:a:t:w:x:")) != -1) {
 		switch (opt) {
 		case 'c':
 			g_circCount = atoi(optarg);
 			break;
 
+		case 'd':
+			g_lookupCount = atoi(optarg);
+			break;
+
 		case 'e':
 			g_eraseCount = atoi(optarg);
 			break;
 
+		case 'i':
+			g_latencyIdle = atoi(optarg);
+			break;
+
+		case 'j':
+			g_loggerCount = atoi(optarg);
+			break;
+
 		case 'l':
 			g_lineCount = atoi(optarg);
 			break;
 
+		case 'm':
+			g_statusPath = optarg;
+			break;
+
+		case 'p':
+			g_latencyCount = atoi(optarg);
+			break;
+
 		case 'r':
 			g_recordLen = atoi(optarg);
 			break;
@@ -629,6 +1087,15 @@ int smart_test_main(int argc, char *argv[])
 			g_appendCount = atoi(optarg);
 			break;
 
+		case 'x':
+#ifdef CONFIG_FS_RAMMAP
+			g_mmapCount = atoi(optarg);
+			break;
+#else
+			fprintf(stderr, "The -x test needs CONFIG_FS_RAMMAP: SmartFS files can only be mapped by copying\n");
+			exit(EXIT_FAILURE);
+#endif
+
 		default:				/* '?' */
 			smart_usage();
 			exit(EXIT_FAILURE);
@@ -692,6 +1159,17 @@ int smart_test_main(int argc, char *argv[])
 		}
 	}
 
+#ifdef CONFIG_FS_RAMMAP
+	/* Read the test file through a mapping */
+
+	if (g_mmapCount > 0) {
+		ret = smart_mmap_test(argv[optind]);
+		if (ret < 0) {
+			goto err_out_with_mem;
+		}
+	}
+#endif
+
 	/* Perform a "circular log" test */
 
 	if (g_circCount > 0) {
@@ -701,6 +1179,33 @@ int smart_test_main(int argc, char *argv[])
 		}
 	}
 
+	/* Perform a write latency test */
+
+	if (g_latencyCount > 0) {
+		ret = smart_latency_test(argv[optind]);
+		if (ret < 0) {
+			goto err_out_with_mem;
+		}
+	}
+
+	/* Perform a path lookup test */
+
+	if (g_lookupCount > 0) {
+		ret = smart_lookup_test(argv[optind]);
+		if (ret < 0) {
+			goto err_out_with_mem;
+		}
+	}
+
+	/* Perform a record logger test */
+
+	if (g_loggerCount > 0) {
+		ret = smart_logger_test(argv[optind]);
+		if (ret < 0) {
+			goto err_out_with_mem;
+		}
+	}
+
 err_out_with_mem:
 
 	/* Free the memory */
@@ -21,6 +21,7 @@
 
 #include <tinyara/config.h>
 #include <stdio.h>
+#include <semaphore.h>
 #include <tinyara/clock.h>
 #include <tinyara/wqueue.h>
 
@@ -28,10 +29,25 @@
  * Definitions
  ****************************************************************************/
 
+#define WQ_NSAMPLES	32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct wq_sample_s {
+	struct work_s work;
+	systime_t due;				/* Tick the work should run at */
+	systime_t late;				/* Ticks it actually ran after that */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+static struct wq_sample_s g_samples[WQ_NSAMPLES];
+static sem_t g_samples_done;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -67,6 +83,48 @@ static void wq_test4(FAR void *arg)
 	printf("test4 is excuted at (%d) ticks\n", cur_time);
 }
 
+static void wq_sample(FAR void *arg)
+{
+	FAR struct wq_sample_s *sample = (FAR struct wq_sample_s *)arg;
+
+	sample->late = clock_systimer() - sample->due;
+	sem_post(&g_samples_done);
+}
+
+/* Queue works with scrambled delays and report how late they ran */
+
+static void wq_deadline(void)
+{
+	FAR struct wq_sample_s *sample;
+	uint32_t delay;
+	uint32_t total = 0;
+	uint32_t max = 0;
+	int i;
+
+	sem_init(&g_samples_done, 0, 0);
+
+	for (i = 0; i < WQ_NSAMPLES; i++) {
+		sample = &g_samples[i];
+		delay = (i * 37) % 100 + 1;
+		sample->due = clock_systimer() + delay;
+		work_queue(HPWORK, &sample->work, wq_sample, sample, delay);
+	}
+
+	for (i = 0; i < WQ_NSAMPLES; i++) {
+		while (sem_wait(&g_samples_done) < 0) ;
+	}
+
+	for (i = 0; i < WQ_NSAMPLES; i++) {
+		total += g_samples[i].late;
+		if (g_samples[i].late > max) {
+			max = g_samples[i].late;
+		}
+	}
+
+	printf("%d works ran late by avg (%d) max (%d) ticks\n", WQ_NSAMPLES, total / WQ_NSAMPLES, max);
+	sem_destroy(&g_samples_done);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -106,5 +164,7 @@ int workqueue_main(int argc, char *argv[])
 
 	printf("test4 is queued and will excute it after 90 ticks\n");
 	work_queue(HPWORK, test_wq4, wq_test4, NULL, 90);
+
+	wq_deadline();
 	return 0;
 }
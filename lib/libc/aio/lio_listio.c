@@ -555,7 +555,8 @@ int lio_listio(int mode, FAR struct aiocb *const list[], int nent, FAR struct si
 	sched_lock();
 
 	/* Submit each asynchronous I/O operation in the list, skipping over NULL
-	 * entries.
+	 * entries.  The AIO threads cannot run before sched_unlock(), so they
+	 * see the whole list and may merge adjacent transfers on a file.
 	 */
 
 	for (i = 0; i < nent; i++) {
@@ -0,0 +1,64 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/misc/lib_eventfd.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+
+#ifdef CONFIG_EVENT_FD
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: eventfd_read
+ *
+ * Description:
+ *   Read the counter of an eventfd descriptor into 'value'.
+ *
+ ****************************************************************************/
+
+int eventfd_read(int fd, FAR eventfd_t *value)
+{
+	return read(fd, value, sizeof(eventfd_t)) == sizeof(eventfd_t) ? OK : ERROR;
+}
+
+/****************************************************************************
+ * Name: eventfd_write
+ *
+ * Description:
+ *   Add 'value' to the counter of an eventfd descriptor.
+ *
+ ****************************************************************************/
+
+int eventfd_write(int fd, eventfd_t value)
+{
+	return write(fd, &value, sizeof(eventfd_t)) == sizeof(eventfd_t) ? OK : ERROR;
+}
+
+#endif							/* CONFIG_EVENT_FD */
@@ -107,11 +107,13 @@ int sem_init(FAR sem_t *sem, int pshared, unsigned int value)
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 		sem->flags = 0;
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-		sem->hhead = NULL;
-#else
+		sem->holder.tlink = NULL;
+		sem->holder.sem = NULL;
 		sem->holder.htcb = NULL;
 		sem->holder.counts = 0;
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+		sem->holder.flink = NULL;
+		sem->hhead = NULL;
 #endif
 #endif
 #ifdef CONFIG_SEM_SUPPORT_TRACE
@@ -57,7 +57,6 @@
 #include <tinyara/config.h>
 
 #include <stdint.h>
-#include <signal.h>
 #include <assert.h>
 #include <queue.h>
 #include <errno.h>
@@ -89,6 +88,23 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+/****************************************************************************
+ * Name: work_remaining
+ *
+ * Description:
+ *   Ticks from 'now' until queued work is due, zero if it is already due.
+ *
+ ****************************************************************************/
+
+static inline systime_t work_remaining(FAR struct work_s *work, systime_t now)
+{
+	systime_t elapsed = now - work->qtime;
+
+	return (elapsed >= work->delay) ? 0 : work->delay - elapsed;
+}
+#endif
+
 /****************************************************************************
  * Name: work_qqueue
  *
@@ -120,6 +136,10 @@
 
 static int work_qqueue(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay)
 {
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	FAR struct work_s *cur_work;
+	systime_t now;
+#endif
 	DEBUGASSERT(work != NULL);
 
 	/* First, initialize the work structure */
@@ -136,8 +156,28 @@ static int work_qqueue(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work,
 
 	work->qtime = clock_systimer();	/* Time work queued */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	/* Keep the queue ordered by due time so that the worker only has to
+	 * look at its head.  Work with the same due time stays in FIFO order.
+	 */
+
+	now = work->qtime;
+	cur_work = (FAR struct work_s *)wqueue->q.tail;
+	if (cur_work != NULL && work_remaining(cur_work, now) > delay) {
+		cur_work = (FAR struct work_s *)wqueue->q.head;
+		while (work_remaining(cur_work, now) <= delay) {
+			cur_work = (FAR struct work_s *)cur_work->dq.flink;
+		}
+
+		dq_addbefore((FAR dq_entry_t *)cur_work, (FAR dq_entry_t *)work, &wqueue->q);
+	} else {
+		dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+	}
+#else
 	dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
-	kill(wqueue->pid, SIGWORK);	/* Wake up the worker thread */
+#endif
+
+	(void)work_wakeup(wqueue);	/* Wake up the worker thread */
 
 	work_unlock();
 	return OK;
@@ -56,7 +56,7 @@
 
 #include <tinyara/config.h>
 
-#include <signal.h>
+#include <semaphore.h>
 #include <errno.h>
 
 #include <tinyara/wqueue.h>
@@ -88,6 +88,32 @@
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+/****************************************************************************
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Wake up the user-mode worker thread by posting its semaphore.
+ *
+ ****************************************************************************/
+
+int work_wakeup(FAR struct usr_wqueue_s *wqueue)
+{
+	int semcount;
+
+	if (sem_getvalue(&wqueue->sem, &semcount) == OK && semcount > 0) {
+		/* A wake-up is already pending */
+
+		return OK;
+	}
+
+	if (sem_post(&wqueue->sem) < 0) {
+		int errcode = errno;
+		return -errcode;
+	}
+
+	return OK;
+}
+
 /****************************************************************************
  * Name: work_signal
  *
@@ -109,13 +135,9 @@ int work_signal(int qid)
 	int ret;
 
 	if (qid == USRWORK) {
-		/* Signal the worker thread */
+		/* Wake up the worker thread, unless a wake-up is already pending */
 
-		ret = kill(g_usrwork.pid, SIGWORK);
-		if (ret < 0) {
-			int errcode = errno;
-			ret = -errcode;
-		}
+		ret = work_wakeup(&g_usrwork);
 	} else {
 		ret = -EINVAL;
 	}
@@ -57,13 +57,14 @@
 #include <tinyara/config.h>
 
 #include <stdint.h>
-#include <unistd.h>
+#include <semaphore.h>
 #include <pthread.h>
 #include <sched.h>
 #include <errno.h>
 #include <assert.h>
 #include <queue.h>
 
+#include <tinyara/semaphore.h>
 #include <tinyara/wqueue.h>
 #include <tinyara/clock.h>
 
@@ -75,16 +76,6 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* Use CLOCK_MONOTONIC if it is available.  CLOCK_REALTIME can cause bad
- * delays if the time is changed.
- */
-
-#ifdef CONFIG_CLOCK_MONOTONIC
-#define WORK_CLOCK CLOCK_MONOTONIC
-#else
-#define WORK_CLOCK CLOCK_REALTIME
-#endif
-
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
@@ -117,6 +108,22 @@ pthread_mutex_t g_usrmutex;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_wait
+ *
+ * Description:
+ *   Wait until the semaphore of the work queue is posted, or at most the
+ *   given number of clock ticks after start.  Like the kernel work queues
+ *   this counts system ticks, so setting the time of day does not change
+ *   the delay.
+ *
+ ****************************************************************************/
+
+static void work_wait(FAR struct usr_wqueue_s *wqueue, systime_t start, uint32_t ticks)
+{
+	(void)sem_tickwait(&wqueue->sem, start, ticks);
+}
+
 /****************************************************************************
  * Name: work_process
  *
@@ -140,8 +147,10 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
 	worker_t worker;
 	FAR void *arg;
 	systime_t elapsed;
+#ifndef CONFIG_SCHED_WORKQUEUE_SORTING
 	uint32_t remaining;
 	systime_t stick;
+#endif
 	systime_t ctick;
 	uint32_t next;
 	int ret;
@@ -158,9 +167,12 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
 		return;
 	}
 
-	/* Get the time that we started this polling cycle in clock ticks. */
+	/* Get the time that we started this polling cycle in clock ticks */
 
-	stick = clock_systimer();
+	ctick = clock_systimer();
+#ifndef CONFIG_SCHED_WORKQUEUE_SORTING
+	stick = ctick;
+#endif
 
 	/* And check each entry in the work queue.  Since we have locked the
 	 * work queue we know:  (1) we will not be suspended unless we do
@@ -230,6 +242,15 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
 			}
 		} else {				/* elapsed < work->delay */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+			/* This one is not ready.  The queue is ordered by due time, so
+			 * nothing behind it is ready either: sleep until exactly this
+			 * one is due.
+			 */
+
+			next = work->delay - elapsed;
+			break;
+#else
 			/* This one is not ready.
 			 *
 			 * NOTE that elapsed is relative to the the current time,
@@ -256,31 +277,48 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
 			/* Then try the next in the list. */
 
 			work = (FAR struct work_s *)work->dq.flink;
+#endif
 		}
 	}
 
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	if (wqueue->q.head == NULL) {
+		/* Nothing queued: wait indefinitely until work_wakeup() posts the
+		 * semaphore.  The queue is unlocked first so that producers are
+		 * never blocked by the sleeping worker.
+		 */
+
+		work_unlock();
+		(void)sem_wait(&wqueue->sem);
+		return;
+	}
+#else
 	/* Get the delay (in clock ticks) since we started the sampling */
 
-	elapsed = clock_systimer() - stick;
-	if (elapsed < wqueue->delay && next > 0) {
-		/* How must time would we need to delay to get to the end of the
-		 * sampling period?  The amount of time we delay should be the smaller
-		 * of the time to the end of the sampling period and the time to the
-		 * next work expiry.
-		 */
+	ctick = clock_systimer();
+	elapsed = ctick - stick;
+	if (elapsed >= wqueue->delay || next == 0) {
+		work_unlock();
+		return;
+	}
 
-		remaining = wqueue->delay - elapsed;
-		next = MIN(next, remaining);
+	/* How must time would we need to delay to get to the end of the
+	 * sampling period?  The amount of time we delay should be the smaller
+	 * of the time to the end of the sampling period and the time to the
+	 * next work expiry.
+	 */
 
-		/* Wait awhile to check the work list.  We will wait here until
-		 * either the time elapses or until we are awakened by a signal.
-		 * Interrupts will be re-enabled while we wait.
-		 */
+	remaining = wqueue->delay - elapsed;
+	next = MIN(next, remaining);
+#endif
 
-		usleep(next * USEC_PER_TICK);
-	}
+	/* Wait awhile to check the work list.  We will wait here until either
+	 * the time elapses or until work_wakeup() posts the semaphore.  The
+	 * queue is unlocked while we wait.
+	 */
 
 	work_unlock();
+	work_wait(wqueue, ctick, next);
 }
 
 /****************************************************************************
@@ -351,6 +389,13 @@ int work_usrstart(void)
 	g_usrwork.delay = CONFIG_LIB_USRWORKPERIOD / USEC_PER_TICK;
 	dq_init(&g_usrwork.q);
 
+	/* The semaphore is used for signaling and, hence, should not have
+	 * priority inheritance enabled.
+	 */
+
+	(void)sem_init(&g_usrwork.sem, 0, 0);
+	sem_setprotocol(&g_usrwork.sem, SEM_PRIO_NONE);
+
 #ifdef CONFIG_BUILD_PROTECTED
 	{
 		/* Set up the work queue lock */
@@ -79,6 +79,7 @@
 struct usr_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+	sem_t sem;					/* Posted to wake up the worker thread */
 	pid_t pid;					/* The task ID of the worker thread(s) */
 };
 
@@ -137,5 +138,23 @@ int work_lock(void);
 
 void work_unlock(void);
 
+/****************************************************************************
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Wake up the user-mode worker thread by posting its semaphore.  Nothing
+ *   is posted if a wake-up is already pending: one is enough to make the
+ *   worker re-assess the queue.
+ *
+ * Input parameters:
+ *   wqueue - The work queue whose worker should be woken up
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno on failure.
+ *
+ ****************************************************************************/
+
+int work_wakeup(FAR struct usr_wqueue_s *wqueue);
+
 #endif							/* CONFIG_LIB_USRWORK && !__KERNEL__ */
 #endif							/* __LIBC_WQUEUE_WQUEUE_H */
@@ -191,6 +191,22 @@ struct xcptcontext {
 
 #ifndef __ASSEMBLY__
 
+#ifdef CONFIG_SCHED_LATENCY
+/* Hooks timing the sections with interrupts masked, see
+ * kernel/sched/sched_latency.c
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void sched_latency_irqoff(void);
+void sched_latency_irqon(void);
+extern volatile uint8_t g_latency_unmask;
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 /* Get/set the PRIMASK register */
 
 static inline uint8_t getprimask(void) inline_function;
@@ -275,6 +291,11 @@ static inline irqstate_t irqsave(void)
 
 	uint8_t basepri = getbasepri();
 	setbasepri(NVIC_SYSH_DISABLE_PRIORITY);
+#ifdef CONFIG_SCHED_LATENCY
+	if (basepri == 0) {
+		sched_latency_irqoff();
+	}
+#endif
 	return (irqstate_t)basepri;
 
 #else
@@ -294,6 +315,12 @@ static inline irqstate_t irqsave(void)
 		: "memory"
 	);
 
+#ifdef CONFIG_SCHED_LATENCY
+	if ((primask & 1) == 0) {
+		sched_latency_irqoff();
+	}
+#endif
+
 	return primask;
 #endif
 }
@@ -312,6 +339,16 @@ static inline void irqenable(void)
 static inline void irqrestore(irqstate_t flags) inline_function;
 static inline void irqrestore(irqstate_t flags)
 {
+#ifdef CONFIG_SCHED_LATENCY
+#ifdef CONFIG_ARMV7M_USEBASEPRI
+	if (flags == 0) {
+#else
+	if ((flags & 1) == 0) {
+#endif
+		sched_latency_irqon();
+	}
+#endif
+
 #ifdef CONFIG_ARMV7M_USEBASEPRI
 	setbasepri((uint32_t)flags);
 #else
@@ -330,6 +367,12 @@ static inline void irqrestore(irqstate_t flags)
 		: "memory"
 	);
 #endif
+
+#ifdef CONFIG_SCHED_LATENCY
+	/* An interrupt that was pending has been taken by now */
+
+	g_latency_unmask = 0;
+#endif
 }
 
 /* Get/set IPSR */
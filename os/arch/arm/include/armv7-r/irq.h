@@ -373,6 +373,22 @@ struct xcptcontext {
 
 #ifndef __ASSEMBLY__
 
+#ifdef CONFIG_SCHED_LATENCY
+/* Hooks timing the sections with interrupts masked, see
+ * kernel/sched/sched_latency.c
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void sched_latency_irqoff(void);
+void sched_latency_irqon(void);
+extern volatile uint8_t g_latency_unmask;
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 /* Return the current IRQ state */
 
 static inline irqstate_t irqstate(void)
@@ -408,6 +424,12 @@ static inline irqstate_t irqsave(void)
 		: "memory"
 	);
 
+#ifdef CONFIG_SCHED_LATENCY
+	if ((cpsr & (1 << 7)) == 0) {	/* CPSR I bit clear: IRQs were enabled */
+		sched_latency_irqoff();
+	}
+#endif
+
 	return cpsr;
 }
 
@@ -436,6 +458,12 @@ static inline irqstate_t irqenable(void)
 
 static inline void irqrestore(irqstate_t flags)
 {
+#ifdef CONFIG_SCHED_LATENCY
+	if ((flags & (1 << 7)) == 0) {
+		sched_latency_irqon();
+	}
+#endif
+
 	__asm__ __volatile__
 	(
 		"msr    cpsr_c, %0"
@@ -443,6 +471,12 @@ static inline void irqrestore(irqstate_t flags)
 		: "r"(flags)
 		: "memory"
 	);
+
+#ifdef CONFIG_SCHED_LATENCY
+	/* An interrupt that was pending has been taken by now */
+
+	g_latency_unmask = 0;
+#endif
 }
 
 #endif							/* __ASSEMBLY__ */
@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_cyclecount.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <tinyara/arch.h>
+
+#include "up_arch.h"
+#include "nvic.h"
+#include "dwt.h"
+
+/* A Cortex-M chip that selects ARCH_HAVE_CYCLECOUNT must also add this file
+ * to CMN_CSRCS in its Make.defs.
+ */
+
+#ifdef CONFIG_ARCH_HAVE_CYCLECOUNT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_cyclecount_initialize
+ *
+ * Description:
+ *   Start the DWT cycle counter.  The trace block must be enabled in DEMCR
+ *   before the DWT registers can be written.
+ *
+ ****************************************************************************/
+
+void up_cyclecount_initialize(void)
+{
+	modifyreg32(NVIC_DEMCR, 0, NVIC_DEMCR_TRCENA);
+	putreg32(0, DWT_CYCCNT);
+	modifyreg32(DWT_CTRL, 0, DWT_CTRL_CYCCNTENA_Msk);
+}
+
+/****************************************************************************
+ * Name: up_cyclecount
+ *
+ * Description:
+ *   Return the free running 32-bit CPU cycle count.
+ *
+ ****************************************************************************/
+
+uint32_t up_cyclecount(void)
+{
+	return getreg32(DWT_CYCCNT);
+}
+
+#endif							/* CONFIG_ARCH_HAVE_CYCLECOUNT */
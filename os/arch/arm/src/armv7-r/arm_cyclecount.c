@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/armv7-r/arm_cyclecount.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <tinyara/arch.h>
+
+
+#ifdef CONFIG_ARCH_HAVE_CYCLECOUNT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* PMCR bits */
+
+#define PMCR_E          (1 << 0)	/* Enable all counters */
+#define PMCR_C          (1 << 2)	/* Cycle counter reset */
+#define PMCR_D          (1 << 3)	/* Count every 64th cycle */
+
+/* PMCNTENSET bits */
+
+#define PMCNTENSET_C    (1 << 31)	/* Cycle counter enable */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_cyclecount_initialize
+ *
+ * Description:
+ *   Start the PMU cycle counter, counting every cycle from zero.
+ *
+ ****************************************************************************/
+
+void up_cyclecount_initialize(void)
+{
+	uint32_t pmcr;
+
+	__asm__ __volatile__
+	(
+		"\tmrc p15, 0, %0, c9, c12, 0"
+		: "=r"(pmcr)
+		:
+		: "memory"
+	);
+
+	pmcr &= ~PMCR_D;
+	pmcr |= PMCR_E | PMCR_C;
+
+	__asm__ __volatile__
+	(
+		"\tmcr p15, 0, %0, c9, c12, 0\n"
+		"\tmcr p15, 0, %1, c9, c12, 1"
+		:
+		: "r"(pmcr), "r"(PMCNTENSET_C)
+		: "memory"
+	);
+}
+
+/****************************************************************************
+ * Name: up_cyclecount
+ *
+ * Description:
+ *   Return the free running 32-bit CPU cycle count.
+ *
+ ****************************************************************************/
+
+uint32_t up_cyclecount(void)
+{
+	uint32_t count;
+
+	__asm__ __volatile__
+	(
+		"\tmrc p15, 0, %0, c9, c13, 0"
+		: "=r"(count)
+	);
+
+	return count;
+}
+
+#endif							/* CONFIG_ARCH_HAVE_CYCLECOUNT */
@@ -74,6 +74,7 @@
 #include <tinyara/kmalloc.h>
 #include <tinyara/wdog.h>
 #include <tinyara/wqueue.h>
+#include <tinyara/defer.h>
 #include <tinyara/audio/audio.h>
 #include <tinyara/audio/i2s.h>
 
@@ -92,8 +93,8 @@
  ****************************************************************************/
 /* Configuration ************************************************************/
 
-#ifndef CONFIG_SCHED_WORKQUEUE
-#error Work queue support is required (CONFIG_SCHED_WORKQUEUE)
+#if !defined(CONFIG_SCHED_WORKQUEUE) && !defined(CONFIG_SCHED_DEFER)
+#error Work queue support is required (CONFIG_SCHED_WORKQUEUE or CONFIG_SCHED_DEFER)
 #endif
 
 #ifndef CONFIG_AUDIO
@@ -872,6 +873,17 @@ static void i2s_rx_schedule(struct s5j_i2s_s *priv, int result)
 		sq_addlast((sq_entry_t *) bfcontainer, &priv->rx.done);
 	}
 
+#ifdef CONFIG_SCHED_DEFER
+	/* Schedule the DMA done processing on the deferred call thread.  The
+	 * worker drains the whole done queue, so a call queued while the
+	 * previous one is still running only finds less to do.
+	 */
+
+	ret = defer_call(DEFER_HIPRI, i2s_rx_worker, priv);
+	if (ret != 0) {
+		lldbg("ERROR: Failed to defer RX work: %d\n", ret);
+	}
+#else
 	/* If the worker has completed running, then reschedule the working thread.
 	 * REVISIT:  There may be a race condition here.  So we do nothing is the
 	 * worker is not available.
@@ -885,6 +897,7 @@ static void i2s_rx_schedule(struct s5j_i2s_s *priv, int result)
 			lldbg("ERROR: Failed to queue RX work: %d\n", ret);
 		}
 	}
+#endif
 }
 #endif
 
@@ -1216,6 +1229,17 @@ static void i2s_txp_schedule(struct s5j_i2s_s *priv, int result)
 		sq_addlast((sq_entry_t *) bfcontainer, &priv->txp.done);
 	}
 
+#ifdef CONFIG_SCHED_DEFER
+	/* Schedule the DMA done processing on the deferred call thread.  The
+	 * worker drains the whole done queue, so a call queued while the
+	 * previous one is still running only finds less to do.
+	 */
+
+	ret = defer_call(DEFER_HIPRI, i2s_txp_worker, priv);
+	if (ret != 0) {
+		lldbg("ERROR: Failed to defer TX primary work: %d\n", ret);
+	}
+#else
 	/* If the worker has completed running, then reschedule the working thread.
 	 * REVISIT:  There may be a race condition here.  So we do nothing is the
 	 * worker is not available.
@@ -1229,6 +1253,7 @@ static void i2s_txp_schedule(struct s5j_i2s_s *priv, int result)
 			lldbg("ERROR: Failed to queue TX primary work: %d\n", ret);
 		}
 	}
+#endif
 }
 #endif
 
@@ -332,6 +332,23 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 		bchlib_semgive(bch);
 	}
+	/* Write out the sector buffer, then whatever the block driver buffers */
+	else if (cmd == BIOC_FLUSH) {
+		FAR struct inode *bchinode = bch->inode;
+
+		bchlib_semtake(bch);
+		ret = bchlib_flushsector(bch);
+		bchlib_semgive(bch);
+
+		if (ret >= 0 && bchinode->u.i_bops->ioctl != NULL) {
+			ret = bchinode->u.i_bops->ioctl(bchinode, cmd, arg);
+			if (ret == -ENOTTY) {
+				/* A block driver that does not buffer writes */
+
+				ret = OK;
+			}
+		}
+	}
 #ifdef CONFIG_BCH_ENCRYPTION
 	/* Is this a request to set the encryption key? */
 	else if (cmd == DIOC_SETKEY) {
@@ -79,6 +79,7 @@
 #include <tinyara/wdog.h>
 #include <tinyara/spi/spi.h>
 #include <tinyara/wqueue.h>
+#include <tinyara/defer.h>
 #include <tinyara/clock.h>
 #include <tinyara/net/enc28j60.h>
 #include <tinyara/net/ethernet.h>
@@ -1773,6 +1774,16 @@ static int enc_interrupt(int irq, FAR void *context, FAR void *arg)
 	 */
 
 	priv->lower->disable(priv->lower);
+#ifdef CONFIG_SCHED_DEFER
+	if (defer_call(DEFER_HIPRI, enc_irqworker, (FAR void *)priv) == OK) {
+		return OK;
+	}
+
+	/* The ring is full.  Re-enabling the interrupt now would only bring us
+	 * straight back here, so keep it disabled and hand the work to the work
+	 * queue instead.
+	 */
+#endif
 	return work_queue(HPWORK, &priv->irqwork, enc_irqworker, (FAR void *)priv, 0);
 }
 
@@ -1961,7 +1972,18 @@ static void enc_polltimer(int argc, uint32_t arg, ...)
 	 * occur until we restart the poll timeout watchdog.
 	 */
 
+#ifdef CONFIG_SCHED_DEFER
+	ret = defer_call(DEFER_LOPRI, enc_pollworker, (FAR void *)priv);
+	if (ret == -EAGAIN) {
+		/* The ring is full, use the work queue for this poll.  Only the
+		 * poll timer, which enc_pollworker() restarts, queues pollwork.
+		 */
+
+		ret = work_queue(HPWORK, &priv->pollwork, enc_pollworker, (FAR void *)priv, 0);
+	}
+#else
 	ret = work_queue(HPWORK, &priv->pollwork, enc_pollworker, (FAR void *)priv, 0);
+#endif
 	DEBUGASSERT(ret == OK);
 }
 #endif
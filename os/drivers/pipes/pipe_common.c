@@ -387,6 +387,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 	FAR uint8_t *start = (uint8_t *)buffer;
 #endif
 	ssize_t nread = 0;
+	size_t span;
 	int sval;
 	int ret;
 
@@ -431,15 +432,32 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 		}
 	}
 
-	/* Then return whatever is available in the pipe (which is at least one byte) */
+	/* Then return whatever is available in the pipe (which is at least one
+	 * byte).  The data is in at most two contiguous spans, before and after
+	 * the end of the buffer.
+	 */
 
 	nread = 0;
 	while (nread < len && dev->d_wrndx != dev->d_rdndx) {
-		*buffer++ = dev->d_buffer[dev->d_rdndx];
-		if (++dev->d_rdndx >= CONFIG_DEV_PIPE_SIZE) {
+		if (dev->d_wrndx > dev->d_rdndx) {
+			span = dev->d_wrndx - dev->d_rdndx;
+		} else {
+			span = CONFIG_DEV_PIPE_SIZE - dev->d_rdndx;
+		}
+
+		if (span > len - nread) {
+			span = len - nread;
+		}
+
+		memcpy(buffer, &dev->d_buffer[dev->d_rdndx], span);
+		buffer += span;
+		nread += span;
+
+		if (dev->d_rdndx + span >= CONFIG_DEV_PIPE_SIZE) {
 			dev->d_rdndx = 0;
+		} else {
+			dev->d_rdndx += span;
 		}
-		nread++;
 	}
 
 	/* Notify all waiting writers that bytes have been removed from the buffer */
@@ -467,7 +485,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 	struct pipe_dev_s *dev = inode->i_private;
 	ssize_t nwritten = 0;
 	ssize_t last;
-	int nxtwrndx;
+	size_t span;
 	int sval;
 
 	DEBUGASSERT(dev);
@@ -500,31 +518,46 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 
 	last = 0;
 	for (;;) {
-		/* Calculate the write index AFTER the next byte is written */
+		/* How much can be copied in one piece?  One byte of the buffer always
+		 * stays free so that a full pipe can be told from an empty one.
+		 */
 
-		nxtwrndx = dev->d_wrndx + 1;
-		if (nxtwrndx >= CONFIG_DEV_PIPE_SIZE) {
-			nxtwrndx = 0;
+		if (dev->d_wrndx >= dev->d_rdndx) {
+			span = CONFIG_DEV_PIPE_SIZE - dev->d_wrndx;
+			if (dev->d_rdndx == 0) {
+				span--;
+			}
+		} else {
+			span = dev->d_rdndx - dev->d_wrndx - 1;
 		}
 
-		/* Would the next write overflow the circular buffer? */
+		if (span > 0) {
+			/* Copy as much of the rest as fits in this span */
+
+			if (span > len - nwritten) {
+				span = len - nwritten;
+			}
 
-		if (nxtwrndx != dev->d_rdndx) {
-			/* No... copy the byte */
+			memcpy(&dev->d_buffer[dev->d_wrndx], buffer, span);
+			buffer += span;
+			nwritten += span;
 
-			dev->d_buffer[dev->d_wrndx] = *buffer++;
-			dev->d_wrndx = nxtwrndx;
+			if (dev->d_wrndx + span >= CONFIG_DEV_PIPE_SIZE) {
+				dev->d_wrndx = 0;
+			} else {
+				dev->d_wrndx += span;
+			}
 
 			/* Is the write complete? */
 
-			if (++nwritten >= len) {
+			if (nwritten >= len) {
 				/* Yes.. Notify all of the waiting readers that more data is available */
 
 				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
 					sem_post(&dev->d_rdsem);
 				}
 
-				/* Notify all poll/select waiters that they can write to the FIFO */
+				/* Notify all poll/select waiters that they can read from the FIFO */
 
 				pipecommon_pollnotify(dev, POLLIN);
 
@@ -542,6 +575,8 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
 					sem_post(&dev->d_rdsem);
 				}
+
+				pipecommon_pollnotify(dev, POLLIN);
 			}
 			last = nwritten;
 
@@ -169,11 +169,9 @@ static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static void rwb_wrflush(struct rwbuffer_s *rwb)
+static int rwb_wrflush(struct rwbuffer_s *rwb)
 {
-	int ret;
-
-	fvdbg("Timeout!\n");
+	int ret = OK;
 
 	if (rwb->wrnblocks > 0) {
 		fvdbg("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n", (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
@@ -186,11 +184,16 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
 		ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
 		if (ret != rwb->wrnblocks) {
 			fdbg("ERROR: Error flushing write buffer: %d\n", ret);
+			ret = ret < 0 ? ret : -EIO;
+		} else {
+			ret = OK;
 		}
 
+		rwb->stats.wrflushes++;
 		rwb_resetwrbuffer(rwb);
 	}
 
+	return ret;
 }
 #endif
 
@@ -198,6 +201,7 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
  * Name: rwb_wrtimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrtimeout(FAR void *arg)
 {
 	/* The following assumes that the size of a pointer is 4-bytes or less */
@@ -210,15 +214,19 @@ static void rwb_wrtimeout(FAR void *arg)
 	 * worker thread.
 	 */
 
+	fvdbg("Timeout!\n");
+
 	rwb_semtake(&rwb->wrsem);
-	rwb_wrflush(rwb);
+	(void)rwb_wrflush(rwb);
 	rwb_semgive(&rwb->wrsem);
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_wrstarttimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
 {
 	/* CONFIG_DRVR_WRDELAY provides the delay period in milliseconds. CLK_TCK
@@ -228,18 +236,25 @@ static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
 	int ticks = (CONFIG_DRVR_WRDELAY + CLK_TCK / 2) / CLK_TCK;
 	(void)work_queue(LPWORK, &rwb->work, rwb_wrtimeout, (FAR void *)rwb, ticks);
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_wrcanceltimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static inline void rwb_wrcanceltimeout(struct rwbuffer_s *rwb)
 {
 	(void)work_cancel(LPWORK, &rwb->work);
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_writebuffer
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
@@ -261,13 +276,11 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, uin
 
 		/* Flush the write buffer */
 
-		ret = rwb->wrflush(rwb, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
+		ret = rwb_wrflush(rwb);
 		if (ret < 0) {
 			fdbg("ERROR: Error writing multiple from cache: %d\n", -ret);
 			return ret;
 		}
-
-		rwb_resetwrbuffer(rwb);
 	}
 
 	/* writebuffer is empty? Then initialize it */
@@ -284,6 +297,7 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, uin
 
 	rwb->wrnblocks += nblocks;
 	rwb->wrexpectedblock = rwb->wrblockstart + rwb->wrnblocks;
+	rwb->stats.wrblocks += nblocks;
 	rwb_wrstarttimeout(rwb);
 	return nblocks;
 }
@@ -340,11 +354,10 @@ static inline void rwb_bufferread(struct rwbuffer_s *rwb, off_t startblock, size
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
-static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
+static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock, size_t nblocks)
 {
 	off_t endblock;
-	size_t nblocks;
-	int ret;
+	ssize_t ret;
 
 	/* Check for attempts to read beyond the end of the media */
 
@@ -352,11 +365,15 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 		return -ESPIPE;
 	}
 
-	/* Get the block number +1 of the last block that will fit in the
-	 * read-ahead buffer
+	/* Get the block number +1 of the last block to load, no more than will
+	 * fit in the read-ahead buffer
 	 */
 
-	endblock = startblock + rwb->rhmaxblocks;
+	if (nblocks > rwb->rhmaxblocks) {
+		nblocks = rwb->rhmaxblocks;
+	}
+
+	endblock = startblock + nblocks;
 
 	/* Make sure that we don't read past the end of the device */
 
@@ -378,13 +395,52 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 
 		rwb->rhnblocks = nblocks;
 		rwb->rhblockstart = startblock;
+		rwb->stats.rhreloads++;
+		rwb->stats.rhblocks += nblocks;
 
 		/* The return value is not the number of blocks we asked to be loaded. */
 
 		return nblocks;
 	}
 
-	return -EIO;
+	return ret < 0 ? ret : -EIO;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_rhwindow
+ *
+ * Description:
+ *   Size the read-ahead for a read that missed the buffer.  A read that
+ *   continues where the last one ended doubles the window, up to the size
+ *   of the buffer; any other read closes it again so that random access
+ *   does not pay for blocks that will never be used.
+ *
+ * Returned Value:
+ *   The number of blocks to load, or zero if the read is not sequential
+ *   and should bypass the buffer.
+ *
+ * Assumptions:
+ *   The caller holds the rhsem semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_READAHEAD
+static size_t rwb_rhwindow(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks)
+{
+	if (startblock != rwb->rhexpectedblock) {
+		rwb->rhwindow = 0;
+		return 0;
+	}
+
+	if (rwb->rhwindow < rwb->rhmaxblocks) {
+		rwb->rhwindow = rwb->rhwindow > 0 ? 2 * rwb->rhwindow : 2;
+		if (rwb->rhwindow > rwb->rhmaxblocks) {
+			rwb->rhwindow = rwb->rhmaxblocks;
+		}
+	}
+
+	return nblocks > rwb->rhwindow ? nblocks : rwb->rhwindow;
 }
 #endif
 
@@ -399,7 +455,7 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 #if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_INVALIDATE)
 int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount)
 {
-	int ret;
+	int ret = OK;
 
 	if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0) {
 		off_t wrbend;
@@ -417,7 +473,7 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, siz
 		wrbend = rwb->wrblockstart + rwb->wrnblocks;
 		invend = startblock + blockcount;
 
-		if (rwb->wrblockstart > invend || wrbend < startblock) {
+		if (rwb->wrblockstart >= invend || wrbend <= startblock) {
 			ret = OK;
 		}
 
@@ -464,7 +520,7 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, siz
 		/* 3. We invalidate a portion at the end of the write buffer */
 
 		else if (wrbend > startblock && wrbend <= invend) {
-			rwb->wrnblocks = wrbend - startblock;
+			rwb->wrnblocks = startblock - rwb->wrblockstart;
 			ret = OK;
 		}
 
@@ -527,7 +583,7 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, siz
 #if defined(CONFIG_DRVR_READAHEAD)  && defined(CONFIG_DRVR_INVALIDATE)
 int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount)
 {
-	int ret;
+	int ret = OK;
 
 	if (rwb->rhmaxblocks > 0 && rwb->rhnblocks > 0) {
 		off_t rhbend;
@@ -574,7 +630,7 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb, off_t startblock, size_
 		/* 3. We invalidate a portion at the end of the read-ahead buffer */
 
 		else if (rhbend > startblock && rhbend <= invend) {
-			rwb->rhnblocks = rhbend - startblock;
+			rwb->rhnblocks = startblock - rwb->rhblockstart;
 			ret = OK;
 		}
 
@@ -617,6 +673,8 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 	DEBUGASSERT(rwb->nblocks > 0);
 	DEBUGASSERT(rwb->dev != NULL);
 
+	memset(&rwb->stats, 0, sizeof(struct rwb_stats_s));
+
 	/* Setup so that rwb_uninitialize can handle a failure */
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
@@ -667,6 +725,8 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 		/* Initialize read-ahead buffer parameters */
 
 		rwb_resetrhbuffer(rwb);
+		rwb->rhexpectedblock = (off_t)-1;
+		rwb->rhwindow = 0;
 
 		/* Allocate the read-ahead buffer */
 
@@ -717,10 +777,9 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
  * Name: rwb_read
  ****************************************************************************/
 
-int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR uint8_t *rdbuffer)
+ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR uint8_t *rdbuffer)
 {
-	uint32_t remaining;
-	int ret = OK;
+	ssize_t ret;
 
 	fvdbg("startblock=%ld nblocks=%ld rdbuffer=%p\n", (long)startblock, (long)nblocks, rdbuffer);
 
@@ -738,7 +797,7 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR
 
 		rwb_semtake(&rwb->wrsem);
 		if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock, nblocks)) {
-			rwb_wrflush(rwb);
+			(void)rwb_wrflush(rwb);
 		}
 
 		rwb_semgive(&rwb->wrsem);
@@ -747,74 +806,98 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR
 
 #ifdef CONFIG_DRVR_READAHEAD
 	if (rwb->rhmaxblocks > 0) {
+		size_t remaining;
+		size_t rdblocks;
+		size_t ahead;
+
 		/* Loop until we have read all of the requested blocks */
 
 		rwb_semtake(&rwb->rhsem);
 		for (remaining = nblocks; remaining > 0;) {
-			/* Is there anything in the read-ahead buffer? */
+			off_t bufferend = rwb->rhblockstart + rwb->rhnblocks;
+
+			if (rwb->rhnblocks > 0 && startblock >= rwb->rhblockstart && startblock < bufferend) {
+				/* Hit: read what we can from the read-ahead buffer */
 
-			if (rwb->rhnblocks > 0) {
-				off_t bufferend;
+				rdblocks = bufferend - startblock;
+				if (rdblocks > remaining) {
+					rdblocks = remaining;
+				}
+
+				rwb_bufferread(rwb, startblock, rdblocks, &rdbuffer);
+				rwb->stats.rdhits += rdblocks;
+			} else {
+				/* Miss.  A random read or one too large for the buffer goes
+				 * straight into the caller's buffer; a sequential one
+				 * refills the buffer with the blocks that follow.
+				 */
+
+				ahead = rwb_rhwindow(rwb, startblock, remaining);
+				if (ahead == 0 || remaining >= rwb->rhmaxblocks) {
+					rdblocks = remaining;
+					ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, rdblocks);
+					if (ret != rdblocks) {
+						ret = ret < 0 ? ret : -EIO;
+						goto errout_with_rhsem;
+					}
 
-				/* How many blocks are available in this buffer? */
+					rdbuffer += rdblocks * rwb->blocksize;
+				} else {
+					ret = rwb_rhreload(rwb, startblock, ahead);
+					if (ret < 0) {
+						goto errout_with_rhsem;
+					}
 
-				bufferend = rwb->rhblockstart + rwb->rhnblocks;
-				if (startblock >= rwb->rhblockstart && startblock < bufferend) {
-					size_t rdblocks = bufferend - startblock;
+					rdblocks = rwb->rhnblocks;
 					if (rdblocks > remaining) {
 						rdblocks = remaining;
 					}
 
-					/* Then read the data from the read-ahead buffer */
-
 					rwb_bufferread(rwb, startblock, rdblocks, &rdbuffer);
-					startblock += rdblocks;
-					remaining -= rdblocks;
 				}
-			}
 
-			/* If we did not get all of the data from the buffer, then we have
-			 * to refill the buffer and try again.
-			 */
-
-			if (remaining > 0) {
-				ret = rwb_rhreload(rwb, startblock);
-				if (ret < 0) {
-					fdbg("ERROR: Failed to fill the read-ahead buffer: %d\n", ret);
-					return ret;
-				}
+				rwb->stats.rdmisses += rdblocks;
 			}
+
+			startblock += rdblocks;
+			remaining -= rdblocks;
+			rwb->rhexpectedblock = startblock;
 		}
 
+		rwb_semgive(&rwb->rhsem);
+
 		/* On success, return the number of blocks that we were requested to
 		 * read. This is for compatibility with the normal return of a block
 		 * driver read method
 		 */
 
-		rwb_semgive(&rwb->rhsem);
-		ret = nblocks;
-	} else
-#else
-	{
-		/* No read-ahead buffering, (re)load the data directly into
-		 * the user buffer.
-		 */
+		return nblocks;
 
-		ret = rwb->rhreload(rwb->dev, startblock, nblocks, rdbuffer);
+errout_with_rhsem:
+		fdbg("ERROR: Failed to read block %ld: %d\n", (long)startblock, ret);
+		rwb_semgive(&rwb->rhsem);
+		return ret;
 	}
 #endif
 
-		return ret;
+	/* No read-ahead buffering, (re)load the data directly into the user
+	 * buffer.
+	 */
+
+	ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, nblocks);
+	if (ret > 0) {
+		rwb->stats.rdmisses += ret;
+	}
+
+	return ret;
 }
 
 /****************************************************************************
  * Name: rwb_write
  ****************************************************************************/
 
-int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR const uint8_t *wrbuffer)
+ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR const uint8_t *wrbuffer)
 {
-	int ret = OK;
-
 #ifdef CONFIG_DRVR_READAHEAD
 	if (rwb->rhmaxblocks > 0) {
 		/* If the new write data overlaps any part of the read buffer, then
@@ -834,66 +917,203 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
 	if (rwb->wrmaxblocks > 0) {
+		ssize_t ret;
+
 		fvdbg("startblock=%d wrbuffer=%p\n", startblock, wrbuffer);
 
+		rwb_semtake(&rwb->wrsem);
+
 		/* Use the block cache unless the buffer size is bigger than block cache */
 
 		if (nblocks > rwb->wrmaxblocks) {
-			/* First flush the cache */
-
-			rwb_semtake(&rwb->wrsem);
-			rwb_wrflush(rwb);
-			rwb_semgive(&rwb->wrsem);
-
-			/* Then transfer the data directly to the media */
+			/* First flush the cache, then transfer the data directly to the
+			 * media
+			 */
 
-			ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+			rwb_wrcanceltimeout(rwb);
+			ret = rwb_wrflush(rwb);
+			if (ret >= 0) {
+				ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+			}
 		} else {
 			/* Buffer the data in the write buffer */
 
 			ret = rwb_writebuffer(rwb, startblock, nblocks, wrbuffer);
 		}
 
+		rwb_semgive(&rwb->wrsem);
+
 		/* On success, return the number of blocks that we were requested to
 		 * write.  This is for compatibility with the normal return of a block
 		 * driver write method
 		 */
-	} else
-#else
-	{
-		/* No write buffer.. just pass the write operation through via the
-		 * flush callback.
-		 */
 
-		ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+		return ret;
 	}
+#endif
+
+	/* No write buffer.. just pass the write operation through via the
+	 * flush callback.
+	 */
+
+	return rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+}
+
+/****************************************************************************
+ * Name: rwb_flush
+ *
+ * Description:
+ *   Write the contents of the write buffer to the media now rather than
+ *   when the write delay expires.
+ *
+ ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
+int rwb_flush(FAR struct rwbuffer_s *rwb)
+{
+	int ret = OK;
+
+	if (rwb->wrmaxblocks > 0) {
+		rwb_semtake(&rwb->wrsem);
+		rwb_wrcanceltimeout(rwb);
+		ret = rwb_wrflush(rwb);
+		rwb_semgive(&rwb->wrsem);
+	}
+
+	return ret;
+}
 #endif
 
-		return ret;
+/****************************************************************************
+ * Name: rwb_flushblocks
+ *
+ * Description:
+ *   Write the contents of the write buffer to the media if it holds any of
+ *   the given blocks, so that they can be read from the media directly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+int rwb_flushblocks(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks)
+{
+	int ret = OK;
+
+	if (rwb->wrmaxblocks > 0) {
+		rwb_semtake(&rwb->wrsem);
+		if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock, nblocks)) {
+			ret = rwb_wrflush(rwb);
+		}
+
+		rwb_semgive(&rwb->wrsem);
+	}
+
+	return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_readbytes
  *
  * Description:
- *   Character-oriented read
+ *   Character-oriented read.  The bytes are always taken from the
+ *   read-ahead buffer, so that a file system reading a block a few bytes at
+ *   a time goes to the media once per block, or less while it walks the
+ *   blocks in order.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READBYTES
 ssize_t rwb_readbytes(FAR struct rwbuffer_s *dev, off_t offset, size_t nbytes, FAR uint8_t *buffer)
 {
+#ifdef CONFIG_DRVR_READAHEAD
+	FAR struct rwbuffer_s *rwb = dev;
+	size_t nread = 0;
+	size_t ncopy;
+	off_t block;
+	off_t blkoffset;
+	size_t ntouched;
+	size_t ahead;
+	bool hit;
+	int ret;
+
+	if (rwb->rhmaxblocks == 0) {
+		return -ENOSYS;
+	}
+
+	if (nbytes == 0) {
+		return 0;
+	}
+#ifdef CONFIG_DRVR_WRITEBUFFER
+	/* Buffered write data must reach the media before it can be read back */
+
+	if (rwb->wrmaxblocks > 0) {
+		block = offset / rwb->blocksize;
+		rwb_semtake(&rwb->wrsem);
+		if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, block, (offset + nbytes - 1) / rwb->blocksize - block + 1)) {
+			(void)rwb_wrflush(rwb);
+		}
+
+		rwb_semgive(&rwb->wrsem);
+	}
+#endif
+
 	/* Loop while there are bytes still be be read */
-	/* Make sure that the sector containing the next bytes to transfer is in
-	 * memory.
-	 */
-	/* How many bytes can be transfer from the in-memory data? */
-	/* Transfer the bytes */
-	/* Adjust counts and offsets for the next time through the loop */
 
-#warning Not Implemented
+	rwb_semtake(&rwb->rhsem);
+	while (nread < nbytes) {
+		/* Make sure that the sector containing the next bytes to transfer is
+		 * in memory.
+		 */
+
+		block = offset / rwb->blocksize;
+		blkoffset = offset - block * rwb->blocksize;
+
+		hit = rwb->rhnblocks > 0 && block >= rwb->rhblockstart && block < rwb->rhblockstart + rwb->rhnblocks;
+		if (!hit) {
+			/* Byte reads cannot bypass the buffer, so a random one loads
+			 * just the block it needs.
+			 */
+
+			ahead = rwb_rhwindow(rwb, block, 1);
+			ret = rwb_rhreload(rwb, block, ahead > 0 ? ahead : 1);
+			if (ret < 0) {
+				fdbg("ERROR: Failed to read block %ld: %d\n", (long)block, ret);
+				rwb_semgive(&rwb->rhsem);
+				return ret;
+			}
+		}
+
+		/* How many bytes can be transfer from the in-memory data? */
+
+		ncopy = (rwb->rhblockstart + rwb->rhnblocks - block) * rwb->blocksize - blkoffset;
+		if (ncopy > nbytes - nread) {
+			ncopy = nbytes - nread;
+		}
+
+		/* Transfer the bytes */
+
+		memcpy(buffer, rwb->rhbuffer + (block - rwb->rhblockstart) * rwb->blocksize + blkoffset, ncopy);
+
+		ntouched = (blkoffset + ncopy + rwb->blocksize - 1) / rwb->blocksize;
+		if (hit) {
+			rwb->stats.rdhits += ntouched;
+		} else {
+			rwb->stats.rdmisses += ntouched;
+		}
+
+		/* Adjust counts and offsets for the next time through the loop */
+
+		offset += ncopy;
+		buffer += ncopy;
+		nread += ncopy;
+		rwb->rhexpectedblock = (offset - 1) / rwb->blocksize + 1;
+	}
+
+	rwb_semgive(&rwb->rhsem);
+	return nread;
+#else
 	return -ENOSYS;
+#endif
 }
 #endif
 
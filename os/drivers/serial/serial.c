@@ -261,6 +261,9 @@ static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
 				 */
 
 				dev->xmitwaiting = true;
+#ifdef CONFIG_SERIAL_TXDMA
+				uart_dmatxavail(dev);
+#endif
 				uart_enabletxint(dev);
 				ret = uart_takesem(&dev->xmitsem, true);
 				uart_disabletxint(dev);
@@ -304,6 +307,113 @@ static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
 	return OK;
 }
 
+/************************************************************************************
+ * Name: uart_putxmitbuf
+ *
+ * Description:
+ *   Copy a run of characters that need no output processing into the TX buffer,
+ *   a contiguous span at a time.  When the buffer is full, uart_putxmitchar()
+ *   does the waiting.  Returns the number of characters buffered; *ret receives
+ *   the error that stopped a short transfer.
+ *
+ ************************************************************************************/
+
+static size_t uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer, size_t buflen, bool oktoblock, FAR int *ret)
+{
+	FAR struct uart_buffer_s *txbuf = &dev->xmit;
+	size_t nbuffered = 0;
+	int16_t head;
+	int16_t tail;
+	size_t span;
+
+	*ret = OK;
+	while (nbuffered < buflen) {
+		/* The interrupt level may move the tail but never the head */
+
+		head = txbuf->head;
+		tail = txbuf->tail;
+		if (head >= tail) {
+			span = txbuf->size - head;
+			if (tail == 0) {
+				span--;
+			}
+		} else {
+			span = tail - head - 1;
+		}
+
+		if (span > 0) {
+			if (span > buflen - nbuffered) {
+				span = buflen - nbuffered;
+			}
+
+			memcpy(&txbuf->buffer[head], buffer, span);
+			buffer += span;
+			nbuffered += span;
+
+			head += span;
+			if (head >= txbuf->size) {
+				head = 0;
+			}
+
+			txbuf->head = head;
+		} else {
+			/* Full: wait for room for the next character */
+
+			*ret = uart_putxmitchar(dev, *buffer, oktoblock);
+			if (*ret < 0) {
+				break;
+			}
+
+			buffer++;
+			nbuffered++;
+		}
+	}
+
+	return nbuffered;
+}
+
+/************************************************************************************
+ * Name: uart_rawlen
+ *
+ * Description:
+ *   Return the length of the leading run of characters that uart_write() can copy
+ *   into the TX buffer unchanged.
+ *
+ ************************************************************************************/
+
+static size_t uart_rawlen(FAR uart_dev_t *dev, FAR const char *buffer, size_t buflen)
+{
+	FAR const char *end;
+#ifdef CONFIG_SERIAL_TERMIOS
+	size_t i;
+
+	if ((dev->tc_oflag & OPOST) == 0) {
+		return buflen;
+	}
+
+	if ((dev->tc_oflag & OCRNL) != 0) {
+		for (i = 0; i < buflen; i++) {
+			if (buffer[i] == '\r' || (buffer[i] == '\n' && (dev->tc_oflag & (ONLCR | ONLRET)) != 0)) {
+				break;
+			}
+		}
+
+		return i;
+	}
+
+	if ((dev->tc_oflag & (ONLCR | ONLRET)) == 0) {
+		return buflen;
+	}
+#else
+	if (!dev->isconsole) {
+		return buflen;
+	}
+#endif
+
+	end = memchr(buffer, '\n', buflen);
+	return end ? (size_t)(end - buffer) : buflen;
+}
+
 /************************************************************************************
  * Name: uart_irqwrite
  ************************************************************************************/
@@ -340,6 +450,8 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer, size_t
 	FAR struct inode *inode = filep->f_inode;
 	FAR uart_dev_t *dev = inode->i_private;
 	ssize_t nwritten = buflen;
+	size_t ncopied;
+	size_t nraw;
 	bool oktoblock;
 	int ret;
 	char ch;
@@ -410,7 +522,24 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer, size_t
 	 */
 
 	uart_disabletxint(dev);
-	for (; buflen; buflen--) {
+	while (buflen) {
+		/* Copy whatever needs no post-processing in bulk */
+
+		nraw = uart_rawlen(dev, buffer, buflen);
+		if (nraw > 0) {
+			ncopied = uart_putxmitbuf(dev, buffer, nraw, oktoblock, &ret);
+			buffer += ncopied;
+			buflen -= ncopied;
+			if (ret < 0) {
+				/* As below: a short count, or the error if nothing was sent */
+
+				nwritten = (buflen < nwritten) ? nwritten - buflen : ret;
+				break;
+			}
+
+			continue;
+		}
+
 		ch = *buffer++;
 		ret = OK;
 
@@ -488,9 +617,16 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer, size_t
 
 			break;
 		}
+
+		buflen--;
 	}
 
 	if (dev->xmit.head != dev->xmit.tail) {
+#ifdef CONFIG_SERIAL_TXDMA
+		/* Let a DMA-capable lower half start on the new data */
+
+		uart_dmatxavail(dev);
+#endif
 		uart_enabletxint(dev);
 	}
 
@@ -513,6 +649,9 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
 	irqstate_t flags;
 	ssize_t recvd = 0;
+	bool rawread = true;
+	size_t span;
+	int16_t head;
 	int16_t tail;
 	char ch;
 	int ret;
@@ -529,6 +668,12 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 		return ret;
 	}
 
+#ifdef CONFIG_SERIAL_TERMIOS
+	/* Characters can only be copied in bulk if none need input processing */
+
+	rawread = ((dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0);
+#endif
+
 	/* Loop while we still have data to copy to the receive buffer.
 	 * we add data to the head of the buffer; uart_xmitchars takes the
 	 * data from the end of the buffer.
@@ -561,7 +706,28 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 		 */
 
 		tail = rxbuf->tail;
-		if (rxbuf->head != tail) {
+		head = rxbuf->head;
+		if (head != tail && rawread) {
+			/* Take everything up to the head or the end of the buffer at
+			 * once.
+			 */
+
+			span = (head > tail ? head : rxbuf->size) - tail;
+			if (span > buflen - recvd) {
+				span = buflen - recvd;
+			}
+
+			memcpy(buffer, &rxbuf->buffer[tail], span);
+			buffer += span;
+			recvd += span;
+
+			tail += span;
+			if (tail >= rxbuf->size) {
+				tail = 0;
+			}
+
+			rxbuf->tail = tail;
+		} else if (head != tail) {
 			/* Take the next character from the tail of the buffer */
 
 			ch = rxbuf->buffer[tail];
@@ -692,6 +858,11 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 					 */
 
 					dev->recvwaiting = true;
+#ifdef CONFIG_SERIAL_RXDMA
+					/* The whole buffer is free for the DMA now */
+
+					uart_dmarxfree(dev);
+#endif
 					ret = uart_takesem(&dev->recvsem, true);
 				}
 
@@ -771,6 +942,14 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
 #endif
 
+#ifdef CONFIG_SERIAL_RXDMA
+	/* Tell a DMA-capable lower half that there is room in the RX buffer */
+
+	flags = irqsave();
+	uart_dmarxfree(dev);
+	irqrestore(flags);
+#endif
+
 	uart_givesem(&dev->recv.sem);
 	return recvd;
 }
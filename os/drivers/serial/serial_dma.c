@@ -0,0 +1,188 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/************************************************************************************
+ * drivers/serial/serial_dma.c
+ *
+ *   Hand the upper half circular buffers to lower halves that move data with
+ *   DMA instead of one character per interrupt.
+ *
+ ************************************************************************************/
+
+/************************************************************************************
+ * Included Files
+ ************************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/serial/serial.h>
+
+#if defined(CONFIG_SERIAL_RXDMA) || defined(CONFIG_SERIAL_TXDMA)
+
+/************************************************************************************
+ * Public Functions
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_TXDMA
+/************************************************************************************
+ * Name: uart_xmitchars_dma
+ *
+ * Description:
+ *   Describe the data in the TX buffer, from the tail up to the head, and start a
+ *   DMA send of it.
+ *
+ ************************************************************************************/
+
+void uart_xmitchars_dma(FAR uart_dev_t *dev)
+{
+	FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+	FAR struct uart_buffer_s *txbuf = &dev->xmit;
+	int16_t head = txbuf->head;
+	int16_t tail = txbuf->tail;
+
+	if (head == tail) {
+		return;
+	}
+
+	xfer->buffer = &txbuf->buffer[tail];
+	if (tail < head) {
+		xfer->length = head - tail;
+		xfer->nbuffer = NULL;
+		xfer->nlength = 0;
+	} else {
+		xfer->length = txbuf->size - tail;
+		xfer->nbuffer = txbuf->buffer;
+		xfer->nlength = head;
+	}
+
+	xfer->nbytes = 0;
+	uart_dmasend(dev);
+}
+
+/************************************************************************************
+ * Name: uart_xmitchars_done
+ *
+ * Description:
+ *   Release the dev->dmatx.nbytes bytes that the DMA has sent and wake up writers
+ *   waiting for room.
+ *
+ ************************************************************************************/
+
+void uart_xmitchars_done(FAR uart_dev_t *dev)
+{
+	FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+	FAR struct uart_buffer_s *txbuf = &dev->xmit;
+	size_t nbytes = xfer->nbytes;
+
+	DEBUGASSERT(nbytes <= xfer->length + xfer->nlength);
+
+	txbuf->tail = (txbuf->tail + nbytes) % txbuf->size;
+	xfer->nbytes = 0;
+	xfer->length = 0;
+	xfer->nlength = 0;
+
+	if (nbytes > 0) {
+		uart_datasent(dev);
+	}
+}
+#endif							/* CONFIG_SERIAL_TXDMA */
+
+#ifdef CONFIG_SERIAL_RXDMA
+/************************************************************************************
+ * Name: uart_recvchars_dma
+ *
+ * Description:
+ *   Describe the free part of the RX buffer, from the head up to one byte short
+ *   of the tail, and start a DMA receive into it.
+ *
+ ************************************************************************************/
+
+void uart_recvchars_dma(FAR uart_dev_t *dev)
+{
+	FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+	FAR struct uart_buffer_s *rxbuf = &dev->recv;
+	int16_t head = rxbuf->head;
+	int16_t tail = rxbuf->tail;
+	int16_t nexthead;
+
+	nexthead = head + 1;
+	if (nexthead >= rxbuf->size) {
+		nexthead = 0;
+	}
+
+	/* Nothing can be received into a full buffer */
+
+	if (nexthead == tail) {
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+		(void)uart_rxflowcontrol(dev, rxbuf->size, true);
+#endif
+		return;
+	}
+
+	xfer->buffer = &rxbuf->buffer[head];
+	if (tail > head) {
+		xfer->length = tail - head - 1;
+		xfer->nbuffer = NULL;
+		xfer->nlength = 0;
+	} else if (tail == 0) {
+		xfer->length = rxbuf->size - head - 1;
+		xfer->nbuffer = NULL;
+		xfer->nlength = 0;
+	} else {
+		xfer->length = rxbuf->size - head;
+		xfer->nbuffer = rxbuf->buffer;
+		xfer->nlength = tail - 1;
+	}
+
+	xfer->nbytes = 0;
+	uart_dmareceive(dev);
+}
+
+/************************************************************************************
+ * Name: uart_recvchars_done
+ *
+ * Description:
+ *   Publish the dev->dmarx.nbytes bytes that the DMA has received and wake up
+ *   readers.
+ *
+ ************************************************************************************/
+
+void uart_recvchars_done(FAR uart_dev_t *dev)
+{
+	FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+	FAR struct uart_buffer_s *rxbuf = &dev->recv;
+	size_t nbytes = xfer->nbytes;
+
+	DEBUGASSERT(nbytes <= xfer->length + xfer->nlength);
+
+	rxbuf->head = (rxbuf->head + nbytes) % rxbuf->size;
+	xfer->nbytes = 0;
+	xfer->length = 0;
+	xfer->nlength = 0;
+
+	if (nbytes > 0) {
+		uart_datareceived(dev);
+	}
+}
+#endif							/* CONFIG_SERIAL_RXDMA */
+
+#endif							/* CONFIG_SERIAL_RXDMA || CONFIG_SERIAL_TXDMA */
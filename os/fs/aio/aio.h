@@ -60,6 +60,8 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <aio.h>
 #include <queue.h>
@@ -90,6 +92,26 @@
 #error AIO needs file and/or socket descriptors
 #endif
 
+/* With CONFIG_FS_AIO_NWORKERS > 0, I/O is performed by a pool of dedicated
+ * AIO threads instead of the low priority work queue.
+ */
+
+#undef AIO_ENGINE
+
+#if defined(CONFIG_FS_AIO_NWORKERS) && CONFIG_FS_AIO_NWORKERS > 0
+#define AIO_ENGINE
+#endif
+
+/* The worker restores the priority that aio_queue() boosted the low
+ * priority work queue to.  AIO threads run at a fixed priority.
+ */
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) && !defined(AIO_ENGINE)
+#define aio_restorepriority(p) lpwork_restorepriority(p)
+#else
+#define aio_restorepriority(p) ((void)(p))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -110,6 +132,12 @@ struct aio_container_s {
 	} u;
 	struct work_s aioc_work;	/* Used to defer I/O to the work thread */
 	pid_t aioc_pid;				/* ID of the waiting task */
+	uint8_t aioc_op;			/* LIO_READ, LIO_WRITE or LIO_NOP (fsync) */
+#ifdef AIO_ENGINE
+	bool aioc_queued;			/* Handed to the AIO threads by aio_queue() */
+	bool aioc_started;			/* Taken by an AIO thread; can't be cancelled */
+	worker_t aioc_worker;		/* Performs the I/O for this container */
+#endif
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	uint8_t aioc_prio;			/* Priority of the waiting task */
 #endif
@@ -250,7 +278,8 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or, if
+ *   CONFIG_FS_AIO_NWORKERS > 0, on the AIO threads
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -264,6 +293,24 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove a queued I/O before it is started.  Called with the AIO lock
+ *   held.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O will not be performed and the container may be
+ *   decanted; -ENOENT if the I/O has already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -166,21 +166,20 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
 				 * possibilities:* (1) the work has already been started and
 				 * is no longer queued, or (2) the work has not been started
 				 * and is still in the work queue.  Only the second case can
-				 * be cancelled.  work_cancel() will return -ENOENT in the
-				 * first case.
+				 * be cancelled.  aio_dequeue() will return -ENOENT in the
+				 * first case and the worker will decant the container.
 				 */
 
-				status = work_cancel(LPWORK, &aioc->aioc_work);
+				status = aio_dequeue(aioc);
 				if (status >= 0) {
+					/* Remove the container from the list of pending transfers */
+
+					(void)aioc_decant(aioc);
 					aiocbp->aio_result = -ECANCELED;
 					ret = AIO_CANCELED;
 				} else {
 					ret = AIO_NOTCANCELED;
 				}
-
-				/* Remove the container from the list of pending transfers */
-
-				(void)aioc_decant(aioc);
 			}
 		}
 	} else {
@@ -201,19 +200,18 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
 				 * possibilities:* (1) the work has already been started and
 				 * is no longer queued, or (2) the work has not been started
 				 * and is still in the work queue.  Only the second case can
-				 * be cancelled.  work_cancel() will return -ENOENT in the
-				 * first case.
+				 * be cancelled.  aio_dequeue() will return -ENOENT in the
+				 * first case and the worker will decant the container.
 				 */
 
-				status = work_cancel(LPWORK, &aioc->aioc_work);
-
-				/* Remove the container from the list of pending transfers */
-
+				status = aio_dequeue(aioc);
 				next = (FAR struct aio_container_s *)aioc->aioc_link.flink;
-				aiocbp = aioc_decant(aioc);
-				DEBUGASSERT(aiocbp);
 
 				if (status >= 0) {
+					/* Remove the container from the list of pending transfers */
+
+					aiocbp = aioc_decant(aioc);
+					DEBUGASSERT(aiocbp);
 					aiocbp->aio_result = -ECANCELED;
 					if (ret != AIO_NOTCANCELED) {
 						ret = AIO_CANCELED;
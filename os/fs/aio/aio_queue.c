@@ -57,11 +57,19 @@
 #include <tinyara/config.h>
 
 #include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <semaphore.h>
+#include <fcntl.h>
 #include <aio.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <tinyara/wqueue.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/kthread.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/fs/fs.h>
 
 #include "aio/aio.h"
 
@@ -71,6 +79,24 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef AIO_ENGINE
+#ifndef CONFIG_FS_AIO_PRIORITY
+#define CONFIG_FS_AIO_PRIORITY 100
+#endif
+
+#ifndef CONFIG_FS_AIO_STACKSIZE
+#define CONFIG_FS_AIO_STACKSIZE 2048
+#endif
+
+#ifndef CONFIG_FS_AIO_MERGE_MAX
+#define CONFIG_FS_AIO_MERGE_MAX 0
+#endif
+
+/* Most requests merged into one transfer */
+
+#define AIO_MERGE_NREQS 8
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -79,6 +105,21 @@
  * Private Data
  ****************************************************************************/
 
+#ifdef AIO_ENGINE
+/* Counts queued requests the AIO threads have not been woken for */
+
+static sem_t g_aio_worksem = SEM_INITIALIZER(0);
+
+/* The file each AIO thread is working on.  Only one thread at a time
+ * performs I/O on a file, so requests on one file complete in the order
+ * they were queued.
+ */
+
+static FAR struct file *g_aio_busy[CONFIG_FS_AIO_NWORKERS];
+
+static uint8_t g_aio_nthreads;	/* AIO threads started */
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -87,11 +128,302 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef AIO_ENGINE
+/****************************************************************************
+ * Name: aio_busy
+ *
+ * Description:
+ *   Return true if an AIO thread is performing I/O on the file.  Called
+ *   with the AIO lock held.
+ *
+ ****************************************************************************/
+
+static bool aio_busy(FAR struct file *filep)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_FS_AIO_NWORKERS; i++) {
+		if (g_aio_busy[i] == filep) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/****************************************************************************
+ * Name: aio_select
+ *
+ * Description:
+ *   Take the oldest queued request on a file that no other AIO thread is
+ *   working on, together with the requests queued behind it that continue
+ *   the same transfer.  Called with the AIO lock held.
+ *
+ * Returned Value:
+ *   The number of containers placed in batch[]; zero if there is nothing
+ *   to do.
+ *
+ ****************************************************************************/
+
+static int aio_select(int id, FAR struct aio_container_s **batch)
+{
+	FAR struct aio_container_s *aioc;
+	FAR struct file *filep;
+	int n = 0;
+
+	for (aioc = (FAR struct aio_container_s *)g_aio_pending.head; aioc; aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink) {
+		if (aioc->aioc_queued && !aioc->aioc_started && !aio_busy(aioc->u.aioc_filep)) {
+			break;
+		}
+	}
+
+	if (!aioc) {
+		return 0;
+	}
+
+	filep = aioc->u.aioc_filep;
+	g_aio_busy[id] = filep;
+	aioc->aioc_started = true;
+	batch[n++] = aioc;
+
+#if CONFIG_FS_AIO_MERGE_MAX > 0
+	if (aioc->aioc_op == LIO_READ || aioc->aioc_op == LIO_WRITE) {
+		FAR struct aio_container_s *next;
+		FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+		bool append = false;
+		size_t total;
+		off_t end;
+
+		if (aioc->aioc_op == LIO_WRITE) {
+			append = (filep->f_oflags & O_APPEND) != 0;
+		}
+
+		total = aiocbp->aio_nbytes;
+		end = aiocbp->aio_offset + aiocbp->aio_nbytes;
+
+		/* The requests on this file behind the first one must not overtake
+		 * it, so stop at the first one that can't join the transfer.
+		 */
+
+		for (next = (FAR struct aio_container_s *)aioc->aioc_link.flink; next && n < AIO_MERGE_NREQS; next = (FAR struct aio_container_s *)next->aioc_link.flink) {
+			if (next->u.aioc_filep != filep) {
+				continue;
+			}
+
+			aiocbp = next->aioc_aiocbp;
+			if (!next->aioc_queued || next->aioc_op != aioc->aioc_op || total + aiocbp->aio_nbytes > CONFIG_FS_AIO_MERGE_MAX || (!append && aiocbp->aio_offset != end)) {
+				break;
+			}
+
+			next->aioc_started = true;
+			batch[n++] = next;
+			total += aiocbp->aio_nbytes;
+			end = aiocbp->aio_offset + aiocbp->aio_nbytes;
+		}
+	}
+#endif
+
+	return n;
+}
+
+/****************************************************************************
+ * Name: aio_merged
+ *
+ * Description:
+ *   Perform a batch of adjacent reads or writes on one file as a single
+ *   transfer through a bounce buffer, then complete each request with its
+ *   share of the result.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_MERGE_MAX > 0
+static void aio_merged(FAR struct aio_container_s **batch, int n)
+{
+	FAR struct aiocb *aiocbp[AIO_MERGE_NREQS];
+	pid_t pid[AIO_MERGE_NREQS];
+	FAR struct file *filep = batch[0]->u.aioc_filep;
+	uint8_t op = batch[0]->aioc_op;
+	FAR uint8_t *buffer;
+	size_t total = 0;
+	size_t offset;
+	size_t nbytes;
+	ssize_t nxfrd;
+	int errcode = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		total += batch[i]->aioc_aiocbp->aio_nbytes;
+	}
+
+	buffer = (FAR uint8_t *)kmm_malloc(total);
+	if (!buffer) {
+		/* Fall back to performing the requests one at a time */
+
+		for (i = 0; i < n; i++) {
+			batch[i]->aioc_worker(batch[i]);
+		}
+
+		return;
+	}
+
+	/* Decant the containers before starting the I/O, as the workers do */
+
+	for (i = 0; i < n; i++) {
+		pid[i] = batch[i]->aioc_pid;
+		aiocbp[i] = aioc_decant(batch[i]);
+	}
+
+	if (op == LIO_WRITE) {
+		for (i = 0, offset = 0; i < n; offset += aiocbp[i]->aio_nbytes, i++) {
+			memcpy(buffer + offset, (FAR const void *)aiocbp[i]->aio_buf, aiocbp[i]->aio_nbytes);
+		}
+
+		if ((filep->f_oflags & O_APPEND) != 0) {
+			nxfrd = file_write(filep, buffer, total);
+		} else {
+			nxfrd = file_pwrite(filep, buffer, total, aiocbp[0]->aio_offset);
+		}
+	} else {
+		nxfrd = file_pread(filep, buffer, total, aiocbp[0]->aio_offset);
+	}
+
+	if (nxfrd < 0) {
+		errcode = get_errno();
+		fdbg("ERROR: merged transfer failed: %d\n", errcode);
+		DEBUGASSERT(errcode > 0);
+	}
+
+	/* A short transfer completes the leading requests first */
+
+	for (i = 0, offset = 0; i < n; offset += aiocbp[i]->aio_nbytes, i++) {
+		if (nxfrd < 0) {
+			aiocbp[i]->aio_result = -errcode;
+			continue;
+		}
+
+		nbytes = aiocbp[i]->aio_nbytes;
+		if (offset >= (size_t)nxfrd) {
+			nbytes = 0;
+		} else if (offset + nbytes > (size_t)nxfrd) {
+			nbytes = (size_t)nxfrd - offset;
+		}
+
+		if (op == LIO_READ && nbytes > 0) {
+			memcpy((FAR void *)aiocbp[i]->aio_buf, buffer + offset, nbytes);
+		}
+
+		aiocbp[i]->aio_result = nbytes;
+	}
+
+	kmm_free(buffer);
+
+	for (i = 0; i < n; i++) {
+		(void)aio_signal(pid[i], aiocbp[i]);
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_thread
+ *
+ * Description:
+ *   The body of an AIO thread.  argv[1] is the index of the thread.
+ *
+ ****************************************************************************/
+
+static int aio_thread(int argc, char *argv[])
+{
+	FAR struct aio_container_s *batch[AIO_MERGE_NREQS];
+	int id = atoi(argv[1]);
+	int n;
+
+	for (;;) {
+		aio_lock();
+		n = aio_select(id, batch);
+		aio_unlock();
+
+		if (n == 0) {
+			/* Nothing that can be started now; wait for more requests */
+
+			while (sem_wait(&g_aio_worksem) < 0) {
+				DEBUGASSERT(get_errno() == EINTR);
+			}
+
+			continue;
+		}
+
+#if CONFIG_FS_AIO_MERGE_MAX > 0
+		if (n > 1) {
+			aio_merged(batch, n);
+		} else
+#endif
+		{
+			batch[0]->aioc_worker(batch[0]);
+		}
+
+		/* Requests queued behind this one on the file may now start */
+
+		aio_lock();
+		g_aio_busy[id] = NULL;
+		aio_unlock();
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_start
+ *
+ * Description:
+ *   Start the AIO threads on first use; fs_initialize() runs too early to
+ *   create them.  Called with the AIO lock held.
+ *
+ * Returned Value:
+ *   Zero (OK) if at least one AIO thread is running; otherwise a negated
+ *   errno value.
+ *
+ ****************************************************************************/
+
+static int aio_start(void)
+{
+	FAR char *argv[2];
+	char arg[4];
+	int pid;
+
+	if (g_aio_nthreads == 0) {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+		sem_setprotocol(&g_aio_worksem, SEM_PRIO_NONE);
+#endif
+	}
+
+	while (g_aio_nthreads < CONFIG_FS_AIO_NWORKERS) {
+		snprintf(arg, sizeof(arg), "%d", g_aio_nthreads);
+		argv[0] = arg;
+		argv[1] = NULL;
+
+		pid = kernel_thread("aio", CONFIG_FS_AIO_PRIORITY, CONFIG_FS_AIO_STACKSIZE, (main_t)aio_thread, (FAR char *const *)argv);
+		if (pid < 0) {
+			fdbg("ERROR: Failed to start AIO thread: %d\n", pid);
+			break;
+		}
+
+		g_aio_nthreads++;
+	}
+
+	return g_aio_nthreads > 0 ? OK : -ENOMEM;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or, if
+ *   CONFIG_FS_AIO_NWORKERS > 0, on the AIO threads
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -107,6 +439,26 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
 	int ret;
 
+#ifdef AIO_ENGINE
+	aio_lock();
+	ret = aio_start();
+	if (ret < 0) {
+		FAR struct aiocb *aiocbp = aioc_decant(aioc);
+		aio_unlock();
+
+		aiocbp->aio_result = ret;
+		set_errno(-ret);
+		return ERROR;
+	}
+
+	aioc->aioc_worker = worker;
+	aioc->aioc_queued = true;
+
+	aio_unlock();
+	sem_post(&g_aio_worksem);
+	return OK;
+#else
+
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	/* Prohibit context switches until we complete the queuing */
 
@@ -123,7 +475,7 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 
 	ret = work_queue(LPWORK, &aioc->aioc_work, worker, aioc, 0);
 	if (ret < 0) {
-		FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+		FAR struct aiocb *aiocbp = aioc_decant(aioc);
 		DEBUGASSERT(aiocbp);
 
 		aiocbp->aio_result = ret;
@@ -136,6 +488,38 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 	sched_unlock();
 #endif
 	return ret;
+#endif							/* AIO_ENGINE */
+}
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove a queued I/O before it is started.  Called with the AIO lock
+ *   held.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O will not be performed and the container may be
+ *   decanted; -ENOENT if the I/O has already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+#ifdef AIO_ENGINE
+	/* The AIO threads only take containers that are still on the pending
+	 * list, so a queued container that is not yet started never will be
+	 * once it is decanted.  One that is not queued yet still belongs to
+	 * aio_queue().
+	 */
+
+	return (aioc->aioc_queued && !aioc->aioc_started) ? OK : -ENOENT;
+#else
+	return work_cancel(LPWORK, &aioc->aioc_work);
+#endif
 }
 
 #endif							/* CONFIG_FS_AIO */
@@ -201,7 +201,7 @@ errout:
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	/* Restore the low priority worker thread default priority */
 
-	lpwork_restorepriority(prio);
+	aio_restorepriority(prio);
 #endif
 }
 
@@ -333,6 +333,7 @@ int aio_write(FAR struct aiocb *aiocbp)
 
 	/* Defer the work to the worker thread */
 
+	aioc->aioc_op = LIO_WRITE;
 	ret = aio_queue(aioc, aio_write_worker);
 	if (ret < 0) {
 		/* The result and the errno have already been set */
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -54,7 +55,15 @@
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/fs/mtd.h>
 #if defined(CONFIG_FTL_READAHEAD) || defined(CONFIG_FTL_WRITEBUFFER)
-#include <tinyara/drivers/rwbuffer.h>
+#include <tinyara/rwbuffer.h>
+#endif
+#if defined(CONFIG_FTL_LOG) || defined(CONFIG_FS_WRITABLE)
+#include <semaphore.h>
+#include <assert.h>
+#endif
+#ifdef CONFIG_FTL_LOG_BGGC
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
 #endif
 
 /****************************************************************************
@@ -65,10 +74,82 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+#ifdef CONFIG_FTL_LOG
+#ifndef CONFIG_FTL_LOG_RESERVE
+#  define CONFIG_FTL_LOG_RESERVE 2
+#endif
+
+#ifdef CONFIG_FTL_LOG_BGGC
+#ifndef CONFIG_FTL_LOG_BGGC_WATERMARK
+#  define CONFIG_FTL_LOG_BGGC_WATERMARK 2
+#endif
+#ifndef CONFIG_FTL_LOG_BGGC_IDLE
+#  define CONFIG_FTL_LOG_BGGC_IDLE 100
+#endif
+#ifndef CONFIG_FTL_LOG_WEAR_THRESHOLD
+#  define CONFIG_FTL_LOG_WEAR_THRESHOLD 0
+#endif
+#  define FTL_LOG_BGGC_IDLE_TICKS MSEC2TICK(CONFIG_FTL_LOG_BGGC_IDLE)
+#endif
+
+#define FTL_LOG_MAGIC         0x4c4c5446	/* "FTLL" */
+#define FTL_LOG_NOSEQ         0xffffffff	/* Erased, not opened yet */
+#define FTL_LOG_NONE          0xffff		/* No block, or sector not mapped */
+
+/* Byte offset in the header page of the tag of data page p */
+
+#define FTL_LOG_TAGOFFSET(p)  (offsetof(struct ftl_loghdr_s, tags) + ((p) - 1) * sizeof(uint16_t))
+
+/* States of an erase block */
+
+#define FTL_BLK_FREE          0	/* Erased, header with erase count written */
+#define FTL_BLK_DIRTY         1	/* Contents unknown, erase before use */
+#define FTL_BLK_USED          2	/* Opened: holds sectors, or is the head */
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_LOG
+/* In log-structured mode the first page of each erase block is a header and
+ * the others hold sectors in the order they were written.  The header tags
+ * each page with the sector it holds; the tag is programmed after the data,
+ * into the erased bits of the header page.  This requires FLASH that erases
+ * to 0xff and allows a page to be programmed more than once (NOR).
+ */
+
+struct ftl_loghdr_s {
+	uint32_t magic;                /* FTL_LOG_MAGIC */
+	uint32_t seq;                  /* When the block was opened, or FTL_LOG_NOSEQ */
+	uint32_t erasecount;           /* Times the block was erased */
+	uint16_t tags[1];              /* Sector in page 1, 2, ..., or 0xffff */
+};
+
+struct ftl_logblk_s {
+	uint32_t erasecount;           /* Times the block was erased */
+	uint16_t nvalid;               /* Pages holding the current copy of a sector */
+	uint8_t  state;                /* FTL_BLK_* */
+};
+
+struct ftl_log_s {
+	FAR uint16_t         *map;     /* Sector -> page, or FTL_LOG_NONE */
+	FAR struct ftl_logblk_s *blk;  /* One per erase block */
+	FAR uint8_t          *hdr;     /* Header page of the head */
+	FAR uint8_t          *buf;     /* Compaction: a header page and a data page */
+	sem_t                 sem;     /* Protects all of the above */
+	uint32_t              seq;     /* Sequence of the next block opened */
+	uint16_t              nsectors; /* Sectors exported */
+	uint16_t              head;    /* Block being filled, or FTL_LOG_NONE */
+	uint16_t              headpage; /* Next page to program in it */
+	uint16_t              nfree;   /* Blocks not in use (free or dirty) */
+#ifdef CONFIG_FTL_LOG_BGGC
+	struct work_s         work;    /* Background compaction */
+	systime_t             lastio;  /* Time of the last write */
+#endif
+};
+#endif
+
 struct ftl_struct_s {
 	FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
 	struct mtd_geometry_s geo;     /* Device geometry */
@@ -78,6 +159,13 @@ struct ftl_struct_s {
 	uint16_t              blkper;  /* R/W blocks per erase block */
 #ifdef CONFIG_FS_WRITABLE
 	FAR uint8_t          *eblock;  /* One, in-memory erase block */
+	off_t                 erasefirst; /* Next block erased ahead of the writer */
+	size_t                nerased; /* Blocks erased ahead, from erasefirst on */
+	sem_t                 erasesem; /* Serializes ftl_flush() and MTDIOC_ERASESECTORS */
+#endif
+#ifdef CONFIG_FTL_LOG
+	bool                  log;     /* Log-structured (ftl_log_initialize()) */
+	struct ftl_log_s      lg;      /* Its state */
 #endif
 };
 
@@ -146,6 +234,625 @@ static int ftl_close(FAR struct inode *inode)
 	return OK;
 }
 
+/****************************************************************************
+ * Name: ftl_erase_lock / ftl_erase_unlock
+ *
+ * Description: ftl_flush() runs on the writer or, with the write buffer, on
+ *   the worker that flushes it.  Either way it must not interleave with an
+ *   erase ahead that moves erasefirst/nerased under it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static void ftl_erase_lock(FAR struct ftl_struct_s *dev)
+{
+	while (sem_wait(&dev->erasesem) != 0) {
+		/* The only case that an error should occur here is if the wait was
+		 * awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+#define ftl_erase_unlock(d) sem_post(&(d)->erasesem)
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_lock / ftl_log_unlock
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static void ftl_log_lock(FAR struct ftl_struct_s *dev)
+{
+	while (sem_wait(&dev->lg.sem) != 0) {
+		/* The only case that an error should occur here is if the wait was
+		 * awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+#define ftl_log_unlock(d) sem_post(&(d)->lg.sem)
+
+/****************************************************************************
+ * Name: ftl_log_erase
+ *
+ * Description: Erase a block and write a header recording only its erase
+ *   count, so that the count survives until the block is opened.  'buf' is
+ *   scratch space of one block.
+ *
+ ****************************************************************************/
+
+static int ftl_log_erase(FAR struct ftl_struct_s *dev, uint16_t eb, FAR uint8_t *buf)
+{
+	FAR struct ftl_logblk_s *blk = &dev->lg.blk[eb];
+	FAR struct ftl_loghdr_s *hdr = (FAR struct ftl_loghdr_s *)buf;
+	ssize_t nxfrd;
+	int ret;
+
+	ret = MTD_ERASE(dev->mtd, eb, 1);
+	if (ret < 0) {
+		dbg("ERROR: Erase block=%d failed: %d\n", eb, ret);
+		blk->state = FTL_BLK_DIRTY;
+		return ret;
+	}
+
+	blk->erasecount++;
+	blk->nvalid = 0;
+	blk->state = FTL_BLK_DIRTY;
+
+	memset(buf, 0xff, dev->geo.blocksize);
+	hdr->magic = FTL_LOG_MAGIC;
+	hdr->erasecount = blk->erasecount;
+	nxfrd = MTD_BWRITE(dev->mtd, eb * dev->blkper, 1, buf);
+	if (nxfrd != 1) {
+		dbg("ERROR: Write header of block %d failed: %d\n", eb, nxfrd);
+		return -EIO;
+	}
+
+	blk->state = FTL_BLK_FREE;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_open
+ *
+ * Description: Make the free block with the fewest erases the head, the
+ *   block new pages are appended to.
+ *
+ ****************************************************************************/
+
+static int ftl_log_open(FAR struct ftl_struct_s *dev)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+	FAR struct ftl_loghdr_s *hdr = (FAR struct ftl_loghdr_s *)lg->hdr;
+	uint16_t best = FTL_LOG_NONE;
+	uint16_t eb;
+	ssize_t nxfrd;
+	int ret;
+
+	for (eb = 0; eb < dev->geo.neraseblocks; eb++) {
+		if (lg->blk[eb].state != FTL_BLK_USED && (best == FTL_LOG_NONE || lg->blk[eb].erasecount < lg->blk[best].erasecount)) {
+			best = eb;
+		}
+	}
+
+	if (best == FTL_LOG_NONE) {
+		return -ENOSPC;
+	}
+
+	/* Blocks of unknown contents are erased only now */
+
+	if (lg->blk[best].state == FTL_BLK_DIRTY) {
+		ret = ftl_log_erase(dev, best, lg->hdr);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	memset(lg->hdr, 0xff, dev->geo.blocksize);
+	hdr->magic = FTL_LOG_MAGIC;
+	hdr->seq = lg->seq++;
+	hdr->erasecount = lg->blk[best].erasecount;
+	nxfrd = MTD_BWRITE(dev->mtd, best * dev->blkper, 1, lg->hdr);
+	if (nxfrd != 1) {
+		dbg("ERROR: Write header of block %d failed: %d\n", best, nxfrd);
+		lg->blk[best].state = FTL_BLK_DIRTY;
+		return -EIO;
+	}
+
+	lg->blk[best].state = FTL_BLK_USED;
+	lg->nfree--;
+	lg->head = best;
+	lg->headpage = 1;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_append
+ *
+ * Description: Program one sector into the next page of the head and map
+ *   it there.  Tagging the page in the head's header commits it.
+ *
+ ****************************************************************************/
+
+static int ftl_log_append(FAR struct ftl_struct_s *dev, uint16_t sector, FAR const uint8_t *buffer)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+	FAR struct ftl_loghdr_s *hdr = (FAR struct ftl_loghdr_s *)lg->hdr;
+	uint16_t page;
+	uint16_t old;
+	off_t ppn;
+	ssize_t nxfrd;
+	int ret;
+
+	if (lg->head == FTL_LOG_NONE || lg->headpage >= dev->blkper) {
+		ret = ftl_log_open(dev);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	/* A page that failed to program is skipped, not retried */
+
+	page = lg->headpage++;
+	ppn = lg->head * dev->blkper + page;
+	nxfrd = MTD_BWRITE(dev->mtd, ppn, 1, buffer);
+	if (nxfrd != 1) {
+		dbg("ERROR: Write page %d failed: %d\n", ppn, nxfrd);
+		return -EIO;
+	}
+
+	hdr->tags[page - 1] = sector;
+#ifdef CONFIG_MTD_BYTE_WRITE
+	if (dev->mtd->write != NULL) {
+		nxfrd = MTD_WRITE(dev->mtd, lg->head * dev->geo.erasesize + FTL_LOG_TAGOFFSET(page), sizeof(uint16_t), (FAR const uint8_t *)&hdr->tags[page - 1]);
+		nxfrd = nxfrd == sizeof(uint16_t) ? 1 : nxfrd;
+	} else
+#endif
+	{
+		/* Programming the header page again only clears the tag's bits */
+
+		nxfrd = MTD_BWRITE(dev->mtd, lg->head * dev->blkper, 1, lg->hdr);
+	}
+
+	if (nxfrd != 1) {
+		dbg("ERROR: Tag page %d failed: %d\n", ppn, nxfrd);
+		return -EIO;
+	}
+
+	old = lg->map[sector];
+	if (old != FTL_LOG_NONE) {
+		lg->blk[old / dev->blkper].nvalid--;
+	}
+
+	lg->map[sector] = ppn;
+	lg->blk[lg->head].nvalid++;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_victim
+ *
+ * Description: The block to compact next: the one with the fewest valid
+ *   pages, and of those the least worn.  The head qualifies once it is
+ *   full.  FTL_LOG_NONE if no block has a page to gain.
+ *
+ ****************************************************************************/
+
+static uint16_t ftl_log_victim(FAR struct ftl_struct_s *dev)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+	uint16_t best = FTL_LOG_NONE;
+	uint16_t eb;
+
+	for (eb = 0; eb < dev->geo.neraseblocks; eb++) {
+		if (lg->blk[eb].state != FTL_BLK_USED || (eb == lg->head && lg->headpage < dev->blkper) || lg->blk[eb].nvalid >= dev->blkper - 1) {
+			continue;
+		}
+
+		if (best == FTL_LOG_NONE || lg->blk[eb].nvalid < lg->blk[best].nvalid || (lg->blk[eb].nvalid == lg->blk[best].nvalid && lg->blk[eb].erasecount < lg->blk[best].erasecount)) {
+			best = eb;
+		}
+	}
+
+	return best;
+}
+
+/****************************************************************************
+ * Name: ftl_log_compact
+ *
+ * Description: Move the valid pages of a block to the head, then erase it.
+ *
+ ****************************************************************************/
+
+static int ftl_log_compact(FAR struct ftl_struct_s *dev, uint16_t victim)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+	FAR struct ftl_loghdr_s *vhdr = (FAR struct ftl_loghdr_s *)lg->buf;
+	FAR uint8_t *page = lg->buf + dev->geo.blocksize;
+	uint16_t sector;
+	uint16_t i;
+	off_t ppn;
+	ssize_t nxfrd;
+	int ret;
+
+	fvdbg("Compact block %d, %d valid pages\n", victim, lg->blk[victim].nvalid);
+
+	nxfrd = MTD_BREAD(dev->mtd, victim * dev->blkper, 1, lg->buf);
+	if (nxfrd != 1) {
+		dbg("ERROR: Read header of block %d failed: %d\n", victim, nxfrd);
+		return -EIO;
+	}
+
+	for (i = 1; i < dev->blkper && lg->blk[victim].nvalid > 0; i++) {
+		sector = vhdr->tags[i - 1];
+		ppn = victim * dev->blkper + i;
+		if (sector >= lg->nsectors || lg->map[sector] != ppn) {
+			continue;
+		}
+
+		nxfrd = MTD_BREAD(dev->mtd, ppn, 1, page);
+		if (nxfrd != 1) {
+			dbg("ERROR: Read page %d failed: %d\n", ppn, nxfrd);
+			return -EIO;
+		}
+
+		ret = ftl_log_append(dev, sector, page);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	ret = ftl_log_erase(dev, victim, lg->buf);
+	lg->nfree++;
+	return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_makeroom
+ *
+ * Description: Before a sector is appended, compact until there is room
+ *   for it while keeping one free block for compaction itself.
+ *
+ ****************************************************************************/
+
+static int ftl_log_makeroom(FAR struct ftl_struct_s *dev)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+	uint16_t victim;
+	int ret;
+
+	while ((lg->head == FTL_LOG_NONE || lg->headpage >= dev->blkper) && lg->nfree <= 1) {
+		victim = ftl_log_victim(dev);
+		if (victim == FTL_LOG_NONE) {
+			return -ENOSPC;
+		}
+
+		ret = ftl_log_compact(dev, victim);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_bgvictim
+ *
+ * Description: The block background compaction should work on, if any.
+ *   Below the free block watermark that is the best victim.  Otherwise,
+ *   with wear leveling, the least worn block in use if it has fallen too
+ *   far behind: it most likely holds data that never changes, and moving
+ *   that lets the block take its share of the writes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG_BGGC
+static uint16_t ftl_log_bgvictim(FAR struct ftl_struct_s *dev)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+#if CONFIG_FTL_LOG_WEAR_THRESHOLD > 0
+	uint32_t maxcount = 0;
+	uint16_t coldest = FTL_LOG_NONE;
+	uint16_t eb;
+#endif
+
+	if (lg->nfree <= CONFIG_FTL_LOG_BGGC_WATERMARK) {
+		return ftl_log_victim(dev);
+	}
+
+#if CONFIG_FTL_LOG_WEAR_THRESHOLD > 0
+	for (eb = 0; eb < dev->geo.neraseblocks; eb++) {
+		if (lg->blk[eb].erasecount > maxcount) {
+			maxcount = lg->blk[eb].erasecount;
+		}
+
+		if (lg->blk[eb].state == FTL_BLK_USED && (eb != lg->head || lg->headpage >= dev->blkper) && (coldest == FTL_LOG_NONE || lg->blk[eb].erasecount < lg->blk[coldest].erasecount)) {
+			coldest = eb;
+		}
+	}
+
+	if (coldest != FTL_LOG_NONE && maxcount - lg->blk[coldest].erasecount > CONFIG_FTL_LOG_WEAR_THRESHOLD) {
+		return coldest;
+	}
+#endif
+
+	return FTL_LOG_NONE;
+}
+
+/****************************************************************************
+ * Name: ftl_log_worker
+ *
+ * Description: Runs on the low priority work queue.  Compacts one block
+ *   once the device has been idle for CONFIG_FTL_LOG_BGGC_IDLE
+ *   milliseconds, and requeues itself while there is more to do.
+ *
+ ****************************************************************************/
+
+static void ftl_log_worker(FAR void *arg)
+{
+	FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)arg;
+	systime_t idle;
+	uint32_t delay;
+	uint16_t victim;
+
+	ftl_log_lock(dev);
+
+	idle = clock_systimer() - dev->lg.lastio;
+	if (idle < FTL_LOG_BGGC_IDLE_TICKS) {
+		/* Written to since we were queued; try again later */
+
+		delay = FTL_LOG_BGGC_IDLE_TICKS - idle;
+	} else {
+		/* Moving a full block needs a free block besides the reserve */
+
+		victim = ftl_log_bgvictim(dev);
+		if (victim == FTL_LOG_NONE || dev->lg.nfree < 2 || ftl_log_compact(dev, victim) < 0) {
+			ftl_log_unlock(dev);
+			return;
+		}
+
+		delay = 0;
+	}
+
+	if (work_available(&dev->lg.work)) {
+		work_queue(LPWORK, &dev->lg.work, ftl_log_worker, dev, delay);
+	}
+
+	ftl_log_unlock(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_read
+ *
+ * Description: Read sectors through the mapping table.  Sectors never
+ *   written read as erased.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_read(FAR struct ftl_struct_s *dev, FAR uint8_t *buffer, off_t startblock, size_t nblocks)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+	ssize_t nxfrd;
+	size_t i;
+
+	if (startblock >= lg->nsectors) {
+		return 0;
+	}
+
+	if (startblock + nblocks > lg->nsectors) {
+		nblocks = lg->nsectors - startblock;
+	}
+
+	ftl_log_lock(dev);
+	for (i = 0; i < nblocks; i++, buffer += dev->geo.blocksize) {
+		if (lg->map[startblock + i] == FTL_LOG_NONE) {
+			memset(buffer, 0xff, dev->geo.blocksize);
+			continue;
+		}
+
+		nxfrd = MTD_BREAD(dev->mtd, lg->map[startblock + i], 1, buffer);
+		if (nxfrd != 1) {
+			dbg("ERROR: Read sector %d failed: %d\n", startblock + i, nxfrd);
+			ftl_log_unlock(dev);
+			return -EIO;
+		}
+	}
+
+	ftl_log_unlock(dev);
+	return nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_log_write
+ *
+ * Description: Append sectors to the log; nothing is erased unless a block
+ *   has to be reclaimed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t ftl_log_write(FAR struct ftl_struct_s *dev, FAR const uint8_t *buffer, off_t startblock, size_t nblocks)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+	size_t i;
+	int ret = OK;
+
+	if (startblock >= lg->nsectors) {
+		return 0;
+	}
+
+	if (startblock + nblocks > lg->nsectors) {
+		nblocks = lg->nsectors - startblock;
+	}
+
+	ftl_log_lock(dev);
+	for (i = 0; i < nblocks; i++, buffer += dev->geo.blocksize) {
+		ret = ftl_log_makeroom(dev);
+		if (ret >= 0) {
+			ret = ftl_log_append(dev, startblock + i, buffer);
+		}
+
+		if (ret < 0) {
+			break;
+		}
+	}
+
+#ifdef CONFIG_FTL_LOG_BGGC
+	lg->lastio = clock_systimer();
+	if (work_available(&lg->work)) {
+		work_queue(LPWORK, &lg->work, ftl_log_worker, dev, FTL_LOG_BGGC_IDLE_TICKS);
+	}
+#endif
+
+	ftl_log_unlock(dev);
+	return ret < 0 ? ret : nblocks;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_reset
+ *
+ * Description: Forget all sectors, for instance after a bulk erase.  Erase
+ *   counts are kept.
+ *
+ ****************************************************************************/
+
+static void ftl_log_reset(FAR struct ftl_struct_s *dev)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+	uint16_t eb;
+
+	memset(lg->map, 0xff, lg->nsectors * sizeof(uint16_t));
+	for (eb = 0; eb < dev->geo.neraseblocks; eb++) {
+		lg->blk[eb].nvalid = 0;
+		lg->blk[eb].state = FTL_BLK_DIRTY;
+	}
+
+	lg->nfree = dev->geo.neraseblocks;
+	lg->head = FTL_LOG_NONE;
+}
+
+/****************************************************************************
+ * Name: ftl_log_mount
+ *
+ * Description: Allocate the tables and rebuild them from the block
+ *   headers.  Where a sector was written more than once, the copy in the
+ *   block opened last, and there in the last page, is the current one.
+ *   Blocks without a header are erased when first needed.
+ *
+ ****************************************************************************/
+
+static int ftl_log_mount(FAR struct ftl_struct_s *dev)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+	FAR struct ftl_loghdr_s *hdr;
+	FAR uint32_t *seqs;
+	uint16_t sector;
+	uint16_t cur;
+	uint16_t eb;
+	uint16_t i;
+	off_t ppn;
+	ssize_t nxfrd;
+
+	if (dev->blkper < 2 || FTL_LOG_TAGOFFSET(dev->blkper) > dev->geo.blocksize || dev->geo.neraseblocks <= CONFIG_FTL_LOG_RESERVE || dev->geo.neraseblocks * dev->blkper >= FTL_LOG_NONE) {
+		dbg("ERROR: Unsupported geometry\n");
+		return -EINVAL;
+	}
+
+	lg->nsectors = (dev->geo.neraseblocks - CONFIG_FTL_LOG_RESERVE) * (dev->blkper - 1);
+	lg->map = (FAR uint16_t *)kmm_malloc(lg->nsectors * sizeof(uint16_t));
+	lg->blk = (FAR struct ftl_logblk_s *)kmm_zalloc(dev->geo.neraseblocks * sizeof(struct ftl_logblk_s));
+	lg->hdr = (FAR uint8_t *)kmm_malloc(dev->geo.blocksize);
+	lg->buf = (FAR uint8_t *)kmm_malloc(2 * dev->geo.blocksize);
+	seqs = (FAR uint32_t *)kmm_malloc(dev->geo.neraseblocks * sizeof(uint32_t));
+	if (!lg->map || !lg->blk || !lg->hdr || !lg->buf || !seqs) {
+		dbg("ERROR: Failed to allocate the mapping tables\n");
+		goto errout;
+	}
+
+	sem_init(&lg->sem, 0, 1);
+	ftl_log_reset(dev);
+	lg->seq = 0;
+
+	hdr = (FAR struct ftl_loghdr_s *)lg->buf;
+	for (eb = 0; eb < dev->geo.neraseblocks; eb++) {
+		nxfrd = MTD_BREAD(dev->mtd, eb * dev->blkper, 1, lg->buf);
+		if (nxfrd != 1 || hdr->magic != FTL_LOG_MAGIC) {
+			continue;
+		}
+
+		lg->blk[eb].erasecount = hdr->erasecount;
+		if (hdr->seq == FTL_LOG_NOSEQ) {
+			lg->blk[eb].state = FTL_BLK_FREE;
+			continue;
+		}
+
+		lg->blk[eb].state = FTL_BLK_USED;
+		lg->nfree--;
+		seqs[eb] = hdr->seq;
+		if (hdr->seq >= lg->seq) {
+			lg->seq = hdr->seq + 1;
+		}
+
+		for (i = 1; i < dev->blkper; i++) {
+			sector = hdr->tags[i - 1];
+			if (sector >= lg->nsectors) {
+				continue;
+			}
+
+			ppn = eb * dev->blkper + i;
+			cur = lg->map[sector];
+			if (cur != FTL_LOG_NONE) {
+				if (cur / dev->blkper != eb && seqs[cur / dev->blkper] > hdr->seq) {
+					continue;
+				}
+
+				lg->blk[cur / dev->blkper].nvalid--;
+			}
+
+			lg->map[sector] = ppn;
+			lg->blk[eb].nvalid++;
+		}
+	}
+
+	fvdbg("%d sectors, %d free blocks, next sequence %d\n", lg->nsectors, lg->nfree, lg->seq);
+	kmm_free(seqs);
+	return OK;
+
+errout:
+	kmm_free(lg->map);
+	kmm_free(lg->blk);
+	kmm_free(lg->hdr);
+	kmm_free(lg->buf);
+	kmm_free(seqs);
+	return -ENOMEM;
+}
+
+/****************************************************************************
+ * Name: ftl_log_unmount
+ *
+ * Description: Free what ftl_log_mount() allocated.
+ *
+ ****************************************************************************/
+
+static void ftl_log_unmount(FAR struct ftl_struct_s *dev)
+{
+	FAR struct ftl_log_s *lg = &dev->lg;
+
+	sem_destroy(&lg->sem);
+	kmm_free(lg->map);
+	kmm_free(lg->blk);
+	kmm_free(lg->hdr);
+	kmm_free(lg->buf);
+}
+#endif							/* CONFIG_FTL_LOG */
+
 /****************************************************************************
  * Name: ftl_reload
  *
@@ -158,6 +865,12 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer, off_t startblock,
 	struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
 	ssize_t nread;
 
+#ifdef CONFIG_FTL_LOG
+	if (dev->log) {
+		return ftl_log_read(dev, buffer, startblock, nblocks);
+	}
+#endif
+
 	/* Read the full erase block into the buffer */
 
 	nread   = MTD_BREAD(dev->mtd, startblock, nblocks, buffer);
@@ -193,16 +906,46 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
 }
 
 /****************************************************************************
- * Name: ftl_flush
+ * Name: ftl_erase
  *
- * Description: Write the specified number of sectors
+ * Description: Erase one erase block before it is rewritten
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
-static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startblock, size_t nblocks)
+static int ftl_erase(FAR struct ftl_struct_s *dev, off_t eraseblock)
+{
+	/* A writer streaming through a range erased with MTDIOC_ERASESECTORS
+	 * finds the next block already erased.
+	 */
+
+	if (dev->nerased > 0 && eraseblock == dev->erasefirst) {
+		dev->erasefirst++;
+		dev->nerased--;
+		return OK;
+	}
+
+	/* Anything else written into the range is not that writer */
+
+	if (eraseblock > dev->erasefirst && eraseblock < dev->erasefirst + (off_t)dev->nerased) {
+		dev->nerased = 0;
+	}
+
+	return MTD_ERASE(dev->mtd, eraseblock, 1);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_rewrite
+ *
+ * Description: Write the specified number of sectors, erasing and rewriting
+ *   each erase block they touch.  The caller holds the erase lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t ftl_rewrite(FAR struct ftl_struct_s *dev, FAR const uint8_t *buffer, off_t startblock, size_t nblocks)
 {
-	struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
 	off_t  alignedblock;
 	off_t  mask;
 	off_t  rwblock;
@@ -241,7 +984,7 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 		/* Then erase the erase block */
 
 		eraseblock = rwblock / dev->blkper;
-		ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
+		ret        = ftl_erase(dev, eraseblock);
 		if (ret < 0) {
 			dbg("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
 			return ret;
@@ -286,7 +1029,7 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 		/* Erase the erase block */
 
 		eraseblock = alignedblock / dev->blkper;
-		ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
+		ret        = ftl_erase(dev, eraseblock);
 		if (ret < 0) {
 			dbg("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
 			return ret;
@@ -324,7 +1067,7 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 		/* Then erase the erase block */
 
 		eraseblock = alignedblock / dev->blkper;
-		ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
+		ret        = ftl_erase(dev, eraseblock);
 		if (ret < 0) {
 			dbg("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
 			return ret;
@@ -349,6 +1092,32 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startb
 }
 #endif
 
+/****************************************************************************
+ * Name: ftl_flush
+ *
+ * Description: Write the specified number of sectors
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer, off_t startblock, size_t nblocks)
+{
+	struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
+	ssize_t ret;
+
+#ifdef CONFIG_FTL_LOG
+	if (dev->log) {
+		return ftl_log_write(dev, buffer, startblock, nblocks);
+	}
+#endif
+
+	ftl_erase_lock(dev);
+	ret = ftl_rewrite(dev, buffer, startblock, nblocks);
+	ftl_erase_unlock(dev);
+	return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: ftl_write
  *
@@ -397,6 +1166,11 @@ static int ftl_geometry(FAR struct inode *inode, struct geometry *geometry)
 		geometry->geo_writeenabled  = false;
 #endif
 		geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
+#ifdef CONFIG_FTL_LOG
+		if (dev->log) {
+			geometry->geo_nsectors  = dev->lg.nsectors;
+		}
+#endif
 		geometry->geo_sectorsize    = dev->geo.blocksize;
 
 		fvdbg("available: true mediachanged: false writeenabled: %s\n",
@@ -446,12 +1220,95 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 		cmd = MTDIOC_XIPBASE;
 	}
 
+	dev = (struct ftl_struct_s *)inode->i_private;
+
+#ifdef CONFIG_FTL_LOG
+	/* Sectors are not where they would be in memory, and a bulk erase
+	 * takes all of them away.
+	 */
+
+	if (dev->log && cmd == MTDIOC_XIPBASE) {
+		return -ENOTTY;
+	}
+
+	if (dev->log && cmd == MTDIOC_ERASESECTORS) {
+		return -ENOTTY;
+	}
+
+	if (dev->log && cmd == MTDIOC_BULKERASE) {
+		ftl_log_lock(dev);
+		ret = MTD_IOCTL(dev->mtd, cmd, arg);
+		if (ret >= 0) {
+			ftl_log_reset(dev);
+		}
+
+		ftl_log_unlock(dev);
+		return ret;
+	}
+#endif
+
+#ifdef CONFIG_FS_WRITABLE
+	/* Write out the write buffer, then anything the MTD driver buffers */
+
+	if (cmd == BIOC_FLUSH) {
+#ifdef CONFIG_FTL_WRITEBUFFER
+		ret = rwb_flush(&dev->rwb);
+		if (ret < 0) {
+			return ret;
+		}
+#endif
+
+		ret = MTD_IOCTL(dev->mtd, MTDIOC_FLUSH, 0);
+		return ret == -ENOTTY ? OK : ret;
+	}
+
+	/* Erase ahead of a sequential writer, which then does not wait for the
+	 * erase of each block it rewrites (see ftl_erase()).
+	 */
+
+	if (cmd == MTDIOC_ERASESECTORS) {
+		FAR struct mtd_erase_s *erase = (FAR struct mtd_erase_s *)((uintptr_t)arg);
+
+		if (erase == NULL || erase->startblock < 0 || erase->startblock + erase->nblocks > dev->geo.neraseblocks) {
+			return -EINVAL;
+		}
+
+#ifdef CONFIG_FTL_WRITEBUFFER
+		/* Sectors still buffered were written before the erase was asked
+		 * for.  Flushed later, they would land in the erased range.
+		 */
+
+		ret = rwb_flush(&dev->rwb);
+		if (ret < 0) {
+			return ret;
+		}
+#endif
+
+		ftl_erase_lock(dev);
+		ret = MTD_ERASE(dev->mtd, erase->startblock, erase->nblocks);
+		if (ret < 0) {
+			dbg("ERROR: Erase block=%d failed: %d\n", erase->startblock, ret);
+			ftl_erase_unlock(dev);
+			return ret;
+		}
+
+		if (dev->nerased > 0 && erase->startblock == dev->erasefirst + (off_t)dev->nerased) {
+			dev->nerased += erase->nblocks;
+		} else {
+			dev->erasefirst = erase->startblock;
+			dev->nerased    = erase->nblocks;
+		}
+
+		ftl_erase_unlock(dev);
+		return OK;
+	}
+#endif
+
 	/* No other block driver ioctl commmands are not recognized by this
 	 * driver.  Other possible MTD driver ioctl commands are passed through
 	 * to the MTD driver (unchanged).
 	 */
 
-	dev = (struct ftl_struct_s *)inode->i_private;
 	ret = MTD_IOCTL(dev->mtd, cmd, arg);
 	if (ret < 0) {
 		dbg("ERROR: MTD ioctl(%04x) failed: %d\n", cmd, ret);
@@ -461,23 +1318,15 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: ftl_initialize
+ * Name: ftl_register
  *
  * Description:
- *   Initialize to provide a block driver wrapper around an MTD interface
- *
- * Input Parameters:
- *   minor - The minor device number.  The MTD block device will be
- *      registered as as /dev/mtdblockN where N is the minor number.
- *   mtd - The MTD device that supports the FLASH interface.
+ *   Create the FTL device in the requested mode and register it as
+ *   /dev/mtdblockN.
  *
  ****************************************************************************/
 
-int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
+static int ftl_register(int minor, FAR struct mtd_dev_s *mtd, bool log)
 {
 	struct ftl_struct_s *dev;
 	char devname[16];
@@ -491,7 +1340,7 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 
 	/* Allocate a FTL device structure */
 
-	dev = (struct ftl_struct_s *)kmm_malloc(sizeof(struct ftl_struct_s));
+	dev = (struct ftl_struct_s *)kmm_zalloc(sizeof(struct ftl_struct_s));
 	if (dev) {
 		/* Initialize the FTL device structure */
 
@@ -509,27 +1358,50 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 			return ret;
 		}
 
-		/* Allocate one, in-memory erase block buffer */
-
-#ifdef CONFIG_FS_WRITABLE
-		dev->eblock  = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
-		if (!dev->eblock) {
-			dbg("ERROR: Failed to allocate an erase block buffer\n");
-			kmm_free(dev);
-			return -ENOMEM;
-		}
-#endif
-
 		/* Get the number of R/W blocks per erase block */
 
 		dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
 		DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FTL_LOG
+		/* The log-structured mode never rewrites an erase block in place */
+
+		dev->log = log;
+		if (log) {
+			ret = ftl_log_mount(dev);
+			if (ret < 0) {
+				kmm_free(dev);
+				return ret;
+			}
+		} else
+#endif
+		{
+			/* Allocate one, in-memory erase block buffer */
+
+#ifdef CONFIG_FS_WRITABLE
+			dev->eblock  = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
+			if (!dev->eblock) {
+				dbg("ERROR: Failed to allocate an erase block buffer\n");
+				kmm_free(dev);
+				return -ENOMEM;
+			}
+#endif
+		}
+
+#ifdef CONFIG_FS_WRITABLE
+		sem_init(&dev->erasesem, 0, 1);
+#endif
+
 		/* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
 		dev->rwb.blocksize   = dev->geo.blocksize;
 		dev->rwb.nblocks     = dev->geo.neraseblocks * dev->blkper;
+#ifdef CONFIG_FTL_LOG
+		if (log) {
+			dev->rwb.nblocks = dev->lg.nsectors;
+		}
+#endif
 		dev->rwb.dev         = (FAR void *)dev;
 
 #if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FTL_WRITEBUFFER)
@@ -545,8 +1417,7 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 		ret = rwb_initialize(&dev->rwb);
 		if (ret < 0) {
 			dbg("ERROR: rwb_initialize failed: %d\n", ret);
-			kmm_free(dev);
-			return ret;
+			goto errout_with_buffers;
 		}
 #endif
 
@@ -559,9 +1430,70 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 		ret = register_blockdriver(devname, &g_bops, 0, dev);
 		if (ret < 0) {
 			dbg("ERROR: register_blockdriver failed: %d\n", -ret);
-			kmm_free(dev);
+			goto errout_with_buffers;
 		}
 	}
 
 	return ret;
+
+errout_with_buffers:
+	/* rwb_uninitialize() also frees what a failed rwb_initialize() left */
+
+#ifdef FTL_HAVE_RWBUFFER
+	rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FS_WRITABLE
+	sem_destroy(&dev->erasesem);
+	kmm_free(dev->eblock);
+#endif
+#ifdef CONFIG_FTL_LOG
+	if (log) {
+		ftl_log_unmount(dev);
+	}
+#endif
+	kmm_free(dev);
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_initialize
+ *
+ * Description:
+ *   Initialize to provide a block driver wrapper around an MTD interface
+ *
+ * Input Parameters:
+ *   minor - The minor device number.  The MTD block device will be
+ *      registered as as /dev/mtdblockN where N is the minor number.
+ *   mtd - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
+{
+	return ftl_register(minor, mtd, false);
+}
+
+/****************************************************************************
+ * Name: ftl_log_initialize
+ *
+ * Description:
+ *   Like ftl_initialize(), but the block driver is log-structured: writes
+ *   are appended to erased pages and sectors are found through a mapping
+ *   table, so that a sector write costs a page program instead of an erase
+ *   block cycle.  Reclaiming space happens when the free erase blocks run
+ *   out, or in the background with CONFIG_FTL_LOG_BGGC.  The device
+ *   exports fewer sectors than the MTD device has blocks, and its contents
+ *   are not laid out like those of ftl_initialize().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+int ftl_log_initialize(int minor, FAR struct mtd_dev_s *mtd)
+{
+	return ftl_register(minor, mtd, true);
 }
+#endif
@@ -73,11 +73,25 @@
 #ifdef CONFIG_FS_PROCFS
 #include <tinyara/fs/procfs.h>
 #endif
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+#include <tinyara/rwbuffer.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+#ifndef CONFIG_MTD_PARTITION_RHBLOCKS
+#define CONFIG_MTD_PARTITION_RHBLOCKS 0
+#endif
+#ifndef CONFIG_MTD_PARTITION_WRBLOCKS
+#define CONFIG_MTD_PARTITION_WRBLOCKS 0
+#endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -109,6 +123,14 @@ struct mtd_partition_s {
 #ifdef CONFIG_MTD_PARTITION_NAMES
 	FAR const char *name;		/* Name of the partition */
 #endif
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+	struct rwbuffer_s rwb;		/* Read-ahead/write buffer, in use if rwb.dev
+								 * is set */
+#ifdef CONFIG_MTD_REGISTRATION
+	bool registered;			/* Listed in /proc/mtd */
+	char rwbname[8];			/* Name listed in /proc/mtd, "p<tagnumber>" */
+#endif
+#endif
 };
 
 /* This structure describes one open "file" */
@@ -135,6 +157,13 @@ static ssize_t part_write(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes
 #endif
 static int part_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg);
 
+/* Read-ahead/write buffer callouts */
+
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+static ssize_t part_reload(FAR void *dev, FAR uint8_t *buffer, off_t startblock, size_t nblocks);
+static ssize_t part_flush(FAR void *dev, FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
+#endif
+
 /* File system methods */
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_PROCFS_EXCLUDE_PARTITIONS)
@@ -246,6 +275,14 @@ static int part_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblock
 	eoffset = priv->firstblock / priv->blkpererase;
 	DEBUGASSERT(eoffset * priv->blkpererase == priv->firstblock);
 
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+	/* Nothing buffered for the erased blocks is valid any longer */
+
+	if (priv->rwb.dev != NULL) {
+		(void)rwb_invalidate(&priv->rwb, startblock * priv->blkpererase, nblocks * priv->blkpererase);
+	}
+#endif
+
 	return priv->parent->erase(priv->parent, startblock + eoffset, nblocks);
 }
 
@@ -270,6 +307,12 @@ static ssize_t part_bread(FAR struct mtd_dev_s *dev, off_t startblock, size_t nb
 		return -ENXIO;
 	}
 
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+	if (priv->rwb.dev != NULL) {
+		return rwb_read(&priv->rwb, startblock, nblocks, buf);
+	}
+#endif
+
 	/* Just add the partition offset to the requested block and let the
 	 * underlying MTD driver perform the read.
 	 */
@@ -298,6 +341,12 @@ static ssize_t part_bwrite(FAR struct mtd_dev_s *dev, off_t startblock, size_t n
 		return -ENXIO;
 	}
 
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+	if (priv->rwb.dev != NULL) {
+		return rwb_write(&priv->rwb, startblock, nblocks, buf);
+	}
+#endif
+
 	/* Just add the partition offset to the requested block and let the
 	 * underlying MTD driver perform the write.
 	 */
@@ -330,6 +379,33 @@ static ssize_t part_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
 			return -ENXIO;
 		}
 
+#if defined(CONFIG_MTD_PARTITION_RWBUFFER) && defined(CONFIG_DRVR_READAHEAD)
+		/* Small reads, like those of a file system walking its headers,
+		 * are served from the read-ahead buffer.
+		 */
+
+		if (priv->rwb.dev != NULL && priv->rwb.rhmaxblocks > 0) {
+			return rwb_readbytes(&priv->rwb, offset, nbytes, buffer);
+		}
+#endif
+
+#if defined(CONFIG_MTD_PARTITION_RWBUFFER) && defined(CONFIG_DRVR_WRITEBUFFER)
+		/* The bytes come from the media, so blocks of them still in the
+		 * write buffer must get there first.
+		 */
+
+		if (priv->rwb.dev != NULL && nbytes > 0) {
+			off_t startblock = offset / priv->blocksize;
+			off_t endblock = (offset + nbytes - 1) / priv->blocksize;
+			int ret;
+
+			ret = rwb_flushblocks(&priv->rwb, startblock, endblock - startblock + 1);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+#endif
+
 		/* Just add the partition offset to the requested block and let the
 		 * underlying MTD driver perform the read.
 		 */
@@ -365,6 +441,29 @@ static ssize_t part_write(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes
 			return -ENXIO;
 		}
 
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+		/* The write goes around the buffers: write out what they hold and
+		 * forget the read-ahead of the blocks being changed.
+		 */
+
+		if (priv->rwb.dev != NULL) {
+			off_t startblock = offset / priv->blocksize;
+			off_t endblock = (offset + nbytes - 1) / priv->blocksize;
+			int ret;
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+			ret = rwb_flush(&priv->rwb);
+			if (ret < 0) {
+				return ret;
+			}
+#endif
+			ret = rwb_invalidate(&priv->rwb, startblock, endblock - startblock + 1);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+#endif
+
 		/* Just add the partition offset to the requested block and let the
 		 * underlying MTD driver perform the write.
 		 */
@@ -428,6 +527,12 @@ static int part_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
 	case MTDIOC_BULKERASE: {
 		/* Erase the entire partition */
 
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+		if (priv->rwb.dev != NULL) {
+			(void)rwb_invalidate(&priv->rwb, 0, priv->rwb.nblocks);
+		}
+#endif
+
 		ret = priv->parent->erase(priv->parent, priv->firstblock / priv->blkpererase, priv->neraseblocks);
 		if (ret == priv->neraseblocks) {
 			ret = OK;
@@ -435,6 +540,34 @@ static int part_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
 	}
 	break;
 
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+	case MTDIOC_FLUSH: {
+		/* Write out the write buffer.  The underlying MTD driver is not
+		 * asked: nothing else buffers the writes of a partition.
+		 */
+
+		ret = OK;
+#ifdef CONFIG_DRVR_WRITEBUFFER
+		if (priv->rwb.dev != NULL) {
+			ret = rwb_flush(&priv->rwb);
+		}
+#endif
+	}
+	break;
+
+	case MTDIOC_RWBSTATS: {
+		FAR struct rwb_stats_s *stats = (FAR struct rwb_stats_s *)arg;
+
+		if (priv->rwb.dev == NULL) {
+			ret = -ENOTTY;
+		} else if (stats) {
+			*stats = priv->rwb.stats;
+			ret = OK;
+		}
+	}
+	break;
+#endif
+
 	default: {
 		/* Pass any unhandled ioctl() calls to the underlying driver */
 
@@ -446,6 +579,40 @@ static int part_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
 	return ret;
 }
 
+/****************************************************************************
+ * Name: part_reload
+ *
+ * Description:
+ *   Read blocks of the partition from the underlying MTD device into the
+ *   read-ahead buffer, or straight into the caller's buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+static ssize_t part_reload(FAR void *dev, FAR uint8_t *buffer, off_t startblock, size_t nblocks)
+{
+	FAR struct mtd_partition_s *priv = (FAR struct mtd_partition_s *)dev;
+
+	return priv->parent->bread(priv->parent, startblock + priv->firstblock, nblocks, buffer);
+}
+
+/****************************************************************************
+ * Name: part_flush
+ *
+ * Description:
+ *   Write blocks of the partition, from the write buffer or the caller's
+ *   buffer, to the underlying MTD device.
+ *
+ ****************************************************************************/
+
+static ssize_t part_flush(FAR void *dev, FAR const uint8_t *buffer, off_t startblock, size_t nblocks)
+{
+	FAR struct mtd_partition_s *priv = (FAR struct mtd_partition_s *)dev;
+
+	return priv->parent->bwrite(priv->parent, startblock + priv->firstblock, nblocks, buffer);
+}
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_PROCFS_EXCLUDE_PARTITIONS)
 
 /****************************************************************************
@@ -794,6 +961,17 @@ FAR struct mtd_dev_s *mtd_partition(FAR struct mtd_dev_s *mtd, off_t firstblock,
 	part->name = NULL;
 #endif
 
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+	/* Buffer the partition with the default sizes.  It still works, just
+	 * unbuffered, if that fails.
+	 */
+
+	ret = mtd_setpartitionrwb(&part->child, CONFIG_MTD_PARTITION_RHBLOCKS, CONFIG_MTD_PARTITION_WRBLOCKS);
+	if (ret < 0) {
+		fdbg("ERROR: Failed to buffer partition %d: %d\n", tagno, ret);
+	}
+#endif
+
 	/* Add this partition to the list of known partitions */
 
 	if (g_pfirstpartition == NULL) {
@@ -865,3 +1043,78 @@ int mtd_setpartitionname(FAR struct mtd_dev_s *mtd, FAR const char *name)
 	return OK;
 }
 #endif
+
+/****************************************************************************
+ * Name: mtd_setpartitionrwb
+ *
+ * Description:
+ *   Sets the size of the read-ahead and write buffers of the specified
+ *   partition, in blocks.  Zero for both removes the buffering.  Anything
+ *   in the old write buffer is written out first.
+ *
+ ****************************************************************************/
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+
+int mtd_setpartitionrwb(FAR struct mtd_dev_s *mtd, uint16_t rhblocks, uint16_t wrblocks)
+{
+	FAR struct mtd_partition_s *priv = (FAR struct mtd_partition_s *)mtd;
+	int ret;
+
+	DEBUGASSERT(mtd);
+
+	/* Release the buffers in use */
+
+	if (priv->rwb.dev != NULL) {
+#ifdef CONFIG_DRVR_WRITEBUFFER
+		(void)rwb_flush(&priv->rwb);
+#endif
+		rwb_uninitialize(&priv->rwb);
+		priv->rwb.dev = NULL;
+	}
+
+#ifndef CONFIG_DRVR_READAHEAD
+	rhblocks = 0;
+#endif
+#ifndef CONFIG_DRVR_WRITEBUFFER
+	wrblocks = 0;
+#endif
+
+	if (rhblocks == 0 && wrblocks == 0) {
+		return OK;
+	}
+
+	/* Set up the new ones */
+
+	memset(&priv->rwb, 0, sizeof(struct rwbuffer_s));
+	priv->rwb.blocksize = priv->blocksize;
+	priv->rwb.nblocks = priv->neraseblocks * priv->blkpererase;
+	priv->rwb.dev = (FAR void *)priv;
+	priv->rwb.wrflush = part_flush;
+	priv->rwb.rhreload = part_reload;
+#ifdef CONFIG_DRVR_WRITEBUFFER
+	priv->rwb.wrmaxblocks = wrblocks;
+#endif
+#ifdef CONFIG_DRVR_READAHEAD
+	priv->rwb.rhmaxblocks = rhblocks;
+#endif
+
+	ret = rwb_initialize(&priv->rwb);
+	if (ret < 0) {
+		fdbg("ERROR: rwb_initialize failed: %d\n", ret);
+		rwb_uninitialize(&priv->rwb);
+		priv->rwb.dev = NULL;
+		return ret;
+	}
+
+#ifdef CONFIG_MTD_REGISTRATION
+	/* List the partition in /proc/mtd, where its statistics are shown */
+
+	if (!priv->registered) {
+		snprintf(priv->rwbname, sizeof(priv->rwbname), "p%u", priv->tagnumber);
+		priv->registered = (mtd_register(&priv->child, priv->rwbname) == OK);
+	}
+#endif
+
+	return OK;
+}
+#endif
@@ -74,6 +74,10 @@
 #include <tinyara/fs/fs.h>
 #include <tinyara/fs/procfs.h>
 #include <tinyara/fs/mtd.h>
+#include <tinyara/fs/ioctl.h>
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+#include <tinyara/rwbuffer.h>
+#endif
 
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_MTD) && defined(CONFIG_FS_PROCFS)
 
@@ -208,6 +212,9 @@ static ssize_t mtd_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 	FAR struct mtd_file_s *priv;
 	ssize_t total = 0;
 	ssize_t ret;
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+	struct rwb_stats_s stats;
+#endif
 
 	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -231,7 +238,16 @@ static ssize_t mtd_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 		/* The provide the requested data */
 
 		do {
-			ret = snprintf(&buffer[total], buflen - total, "%-5d%s\n", priv->pnextmtd->mtdno, priv->pnextmtd->name);
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+			/* Buffered partitions also report how well their buffers do */
+
+			if (MTD_IOCTL(priv->pnextmtd, MTDIOC_RWBSTATS, (unsigned long)((uintptr_t)&stats)) == OK) {
+				ret = snprintf(&buffer[total], buflen - total, "%-5d%-8s rd hit %lu miss %lu (%lu reloads, %lu blocks) wr %lu (%lu flushes)\n", priv->pnextmtd->mtdno, priv->pnextmtd->name, (unsigned long)stats.rdhits, (unsigned long)stats.rdmisses, (unsigned long)stats.rhreloads, (unsigned long)stats.rhblocks, (unsigned long)stats.wrblocks, (unsigned long)stats.wrflushes);
+			} else
+#endif
+			{
+				ret = snprintf(&buffer[total], buflen - total, "%-5d%s\n", priv->pnextmtd->mtdno, priv->pnextmtd->name);
+			}
 
 			if (ret + total < buflen) {
 				total += ret;
@@ -0,0 +1,427 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/mtd/mtd_queue.c
+ *
+ *   A request queue in front of an MTD device.  Callers submit reads, writes
+ *   and erases and are called back when they are done, so that they can
+ *   keep several operations outstanding instead of waiting for each one.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/kthread.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/fs/mtd.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_MTD_QUEUE_PRIORITY
+#define CONFIG_MTD_QUEUE_PRIORITY 100
+#endif
+
+#ifndef CONFIG_MTD_QUEUE_STACKSIZE
+#define CONFIG_MTD_QUEUE_STACKSIZE 2048
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mtd_queue_s {
+	FAR struct mtd_dev_s *mtd;	/* The device the requests are performed on */
+	FAR struct mtd_req_s *head;	/* Outstanding requests, oldest first */
+	FAR struct mtd_req_s *tail;
+	sem_t exclsem;				/* Protects the list and the flags below */
+	sem_t worksem;				/* Posted when there is work for the thread */
+	sem_t exitsem;				/* Posted by the thread as it exits */
+	uint16_t blkper;			/* Read/write blocks per erase block */
+	bool erasing;				/* The thread is in MTD_ERASE() */
+	bool stop;					/* mtd_queue_uninitialize() was called */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The queue being handed to a new thread (see mtd_queue_initialize()) */
+
+static FAR struct mtd_queue_s *g_starting;
+static sem_t g_startsem = SEM_INITIALIZER(1);
+static sem_t g_syncsem = SEM_INITIALIZER(0);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mtdq_takesem
+ ****************************************************************************/
+
+static void mtdq_takesem(FAR sem_t *sem)
+{
+	while (sem_wait(sem) != 0) {
+		/* The only case that an error should occur here is if the wait was
+		 * awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+#define mtdq_givesem(s) sem_post(s)
+
+/****************************************************************************
+ * Name: mtdq_canpass
+ *
+ * Description:
+ *   Return true if every request queued ahead of 'stop' (or all of them if
+ *   'stop' is NULL) is an erase that will not touch the blocks 'read'
+ *   reads, so that the read may be performed first.
+ *
+ ****************************************************************************/
+
+static bool mtdq_canpass(FAR struct mtd_queue_s *queue, FAR struct mtd_req_s *read, FAR struct mtd_req_s *stop)
+{
+	FAR struct mtd_req_s *req;
+	off_t first;
+	off_t last;
+
+	for (req = queue->head; req != stop; req = req->flink) {
+		if (req->op != MTDREQ_ERASE) {
+			return false;
+		}
+
+		/* The blocks it has yet to erase, including the one in progress */
+
+		first = (req->startblock + req->ndone) * queue->blkper;
+		last = (req->startblock + req->nblocks) * queue->blkper;
+		if (read->startblock < last && read->startblock + read->nblocks > first) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/****************************************************************************
+ * Name: mtdq_select
+ *
+ * Description:
+ *   Pick the next request to work on.  This is the oldest one, unless that
+ *   is an erase and the first request after the run of erases at the head
+ *   is a read that can pass them.
+ *
+ ****************************************************************************/
+
+static FAR struct mtd_req_s *mtdq_select(FAR struct mtd_queue_s *queue)
+{
+	FAR struct mtd_req_s *req;
+
+	for (req = queue->head; req != NULL && req->op == MTDREQ_ERASE; req = req->flink) ;
+
+	if (req != NULL && req != queue->head && req->op == MTDREQ_READ && mtdq_canpass(queue, req, req)) {
+		return req;
+	}
+
+	return queue->head;
+}
+
+/****************************************************************************
+ * Name: mtdq_remove
+ ****************************************************************************/
+
+static void mtdq_remove(FAR struct mtd_queue_s *queue, FAR struct mtd_req_s *req)
+{
+	FAR struct mtd_req_s *prev = NULL;
+	FAR struct mtd_req_s *curr;
+
+	for (curr = queue->head; curr != req; prev = curr, curr = curr->flink) {
+		DEBUGASSERT(curr != NULL);
+	}
+
+	if (prev == NULL) {
+		queue->head = req->flink;
+	} else {
+		prev->flink = req->flink;
+	}
+
+	if (queue->tail == req) {
+		queue->tail = prev;
+	}
+
+	req->flink = NULL;
+}
+
+/****************************************************************************
+ * Name: mtdq_thread
+ *
+ * Description:
+ *   The thread serving one queue.  Erases are done one erase block at a
+ *   time and stay at the head of the queue until the last block is done,
+ *   so that a read submitted meanwhile waits for one block at most.
+ *
+ ****************************************************************************/
+
+static int mtdq_thread(int argc, char *argv[])
+{
+	FAR struct mtd_queue_s *queue;
+	FAR struct mtd_req_s *req;
+	FAR struct mtd_dev_s *mtd;
+	off_t block = 0;
+	ssize_t ret;
+	bool done;
+
+	/* Get our queue and let mtd_queue_initialize() go on */
+
+	queue = g_starting;
+	mtd = queue->mtd;
+	mtdq_givesem(&g_syncsem);
+
+	mtdq_takesem(&queue->exclsem);
+	for (;;) {
+		if (queue->head == NULL) {
+			if (queue->stop) {
+				break;
+			}
+
+			mtdq_givesem(&queue->exclsem);
+			mtdq_takesem(&queue->worksem);
+			mtdq_takesem(&queue->exclsem);
+			continue;
+		}
+
+		req = mtdq_select(queue);
+		if (req->op == MTDREQ_ERASE) {
+			block = req->startblock + req->ndone;
+			queue->erasing = true;
+		}
+
+		/* Talk to the device without holding the list */
+
+		mtdq_givesem(&queue->exclsem);
+
+		switch (req->op) {
+		case MTDREQ_READ:
+			ret = MTD_BREAD(mtd, req->startblock, req->nblocks, req->buffer);
+			break;
+
+		case MTDREQ_WRITE:
+			ret = MTD_BWRITE(mtd, req->startblock, req->nblocks, req->buffer);
+			break;
+
+		default:
+			ret = MTD_ERASE(mtd, block, 1);
+			break;
+		}
+
+		mtdq_takesem(&queue->exclsem);
+
+		done = true;
+		if (req->op == MTDREQ_ERASE) {
+			queue->erasing = false;
+			if (ret >= 0 && ++req->ndone < req->nblocks) {
+				done = false;
+			}
+		}
+
+		if (done) {
+			req->result = ret;
+			mtdq_remove(queue, req);
+
+			mtdq_givesem(&queue->exclsem);
+			req->complete(req);
+			mtdq_takesem(&queue->exclsem);
+		}
+	}
+
+	mtdq_givesem(&queue->exclsem);
+
+	/* mtd_queue_uninitialize() frees the queue once we are gone */
+
+	fvdbg("Queue %p stopped\n", queue);
+	mtdq_givesem(&queue->exitsem);
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mtd_queue_initialize
+ *
+ * Description:
+ *   Create a request queue and the thread that serves it for an MTD device.
+ *
+ ****************************************************************************/
+
+FAR struct mtd_queue_s *mtd_queue_initialize(FAR struct mtd_dev_s *mtd)
+{
+	FAR struct mtd_queue_s *queue;
+	struct mtd_geometry_s geo;
+	int pid;
+
+	DEBUGASSERT(mtd != NULL);
+
+	if (MTD_IOCTL(mtd, MTDIOC_GEOMETRY, (unsigned long)((uintptr_t)&geo)) < 0 || geo.blocksize == 0) {
+		fdbg("ERROR: MTDIOC_GEOMETRY failed\n");
+		return NULL;
+	}
+
+	queue = (FAR struct mtd_queue_s *)kmm_zalloc(sizeof(struct mtd_queue_s));
+	if (queue == NULL) {
+		return NULL;
+	}
+
+	queue->mtd = mtd;
+	queue->blkper = geo.erasesize / geo.blocksize;
+	sem_init(&queue->exclsem, 0, 1);
+	sem_init(&queue->worksem, 0, 0);
+	sem_setprotocol(&queue->worksem, SEM_PRIO_NONE);
+	sem_init(&queue->exitsem, 0, 0);
+	sem_setprotocol(&queue->exitsem, SEM_PRIO_NONE);
+
+	/* The inputs to a task started by kernel_thread() are designed for
+	 * command line tasks, so the queue is handed over through g_starting.
+	 */
+
+	mtdq_takesem(&g_startsem);
+	sem_setprotocol(&g_syncsem, SEM_PRIO_NONE);
+	g_starting = queue;
+
+	pid = kernel_thread("mtdq", CONFIG_MTD_QUEUE_PRIORITY, CONFIG_MTD_QUEUE_STACKSIZE, (main_t)mtdq_thread, (FAR char *const *)NULL);
+	if (pid < 0) {
+		mtdq_givesem(&g_startsem);
+		fdbg("ERROR: Failed to start the queue thread\n");
+		sem_destroy(&queue->exclsem);
+		sem_destroy(&queue->worksem);
+		sem_destroy(&queue->exitsem);
+		kmm_free(queue);
+		return NULL;
+	}
+
+	mtdq_takesem(&g_syncsem);
+	mtdq_givesem(&g_startsem);
+	return queue;
+}
+
+/****************************************************************************
+ * Name: mtd_queue_uninitialize
+ *
+ * Description:
+ *   Stop the thread of an idle queue and free the queue once the thread
+ *   has exited.  The thread is still running when worksem is posted, so
+ *   the queue cannot be freed by the thread itself.
+ *
+ ****************************************************************************/
+
+int mtd_queue_uninitialize(FAR struct mtd_queue_s *queue)
+{
+	DEBUGASSERT(queue != NULL);
+
+	mtdq_takesem(&queue->exclsem);
+	if (queue->head != NULL || queue->stop) {
+		mtdq_givesem(&queue->exclsem);
+		return -EBUSY;
+	}
+
+	queue->stop = true;
+	mtdq_givesem(&queue->exclsem);
+	mtdq_givesem(&queue->worksem);
+	mtdq_takesem(&queue->exitsem);
+
+	sem_destroy(&queue->exclsem);
+	sem_destroy(&queue->worksem);
+	sem_destroy(&queue->exitsem);
+	kmm_free(queue);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mtd_submit
+ *
+ * Description:
+ *   Queue a request.  A read that arrives while the thread is erasing, and
+ *   that may go ahead of everything queued, is instead performed right
+ *   away if the device can suspend the erase; its completion is then
+ *   called from here, before mtd_submit() returns.
+ *
+ ****************************************************************************/
+
+int mtd_submit(FAR struct mtd_queue_s *queue, FAR struct mtd_req_s *req)
+{
+	FAR struct mtd_dev_s *mtd;
+
+	DEBUGASSERT(queue != NULL && req != NULL);
+
+	if (req->op > MTDREQ_ERASE || req->nblocks == 0 || req->complete == NULL || (req->op != MTDREQ_ERASE && req->buffer == NULL)) {
+		return -EINVAL;
+	}
+
+	mtd = queue->mtd;
+	req->flink = NULL;
+	req->ndone = 0;
+
+	mtdq_takesem(&queue->exclsem);
+	if (queue->stop) {
+		mtdq_givesem(&queue->exclsem);
+		return -ESHUTDOWN;
+	}
+
+	if (req->op == MTDREQ_READ && queue->erasing && mtdq_canpass(queue, req, NULL) && MTD_IOCTL(mtd, MTDIOC_ERASESUSPEND, 0) == OK) {
+		/* Holding exclsem keeps the thread from starting anything else
+		 * until the erase is resumed.
+		 */
+
+		req->result = MTD_BREAD(mtd, req->startblock, req->nblocks, req->buffer);
+		MTD_IOCTL(mtd, MTDIOC_ERASERESUME, 0);
+		mtdq_givesem(&queue->exclsem);
+
+		req->complete(req);
+		return OK;
+	}
+
+	if (queue->tail == NULL) {
+		queue->head = req;
+	} else {
+		queue->tail->flink = req;
+	}
+
+	queue->tail = req;
+	mtdq_givesem(&queue->exclsem);
+	mtdq_givesem(&queue->worksem);
+	return OK;
+}
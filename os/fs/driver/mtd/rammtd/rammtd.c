@@ -59,11 +59,13 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <string.h>
+#include <unistd.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <tinyara/kmalloc.h>
+#include <tinyara/clock.h>
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/fs/mtd.h>
 
@@ -84,6 +86,22 @@
 #define CONFIG_RAMMTD_ERASESTATE 0xff
 #endif
 
+#ifndef CONFIG_RAMMTD_ERASE_DELAY
+#define CONFIG_RAMMTD_ERASE_DELAY 0
+#endif
+
+#ifndef CONFIG_RAMMTD_WRITE_DELAY
+#define CONFIG_RAMMTD_WRITE_DELAY 0
+#endif
+
+/* Microseconds per read request, like the command and address phase of a
+ * serial FLASH
+ */
+
+#ifndef CONFIG_RAMMTD_READ_DELAY
+#define CONFIG_RAMMTD_READ_DELAY 0
+#endif
+
 #if CONFIG_RAMMTD_ERASESTATE != 0xff && CONFIG_RAMMTD_ERASESTATE != 0x00
 #error "Unsupported value for CONFIG_RAMMTD_ERASESTATE"
 #endif
@@ -112,6 +130,9 @@ struct ram_dev_s {
 	struct mtd_dev_s mtd;		/* MTD device */
 	FAR uint8_t *start;			/* Start of RAM */
 	size_t nblocks;				/* Number of erase blocks */
+#if CONFIG_RAMMTD_ERASE_DELAY > 0
+	volatile uint8_t suspended;	/* Erase suspended (MTDIOC_ERASESUSPEND) */
+#endif
 };
 
 /****************************************************************************
@@ -204,6 +225,9 @@ static int ram_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks
 	FAR struct ram_dev_s *priv = (FAR struct ram_dev_s *)dev;
 	off_t offset;
 	size_t nbytes;
+#if CONFIG_RAMMTD_ERASE_DELAY > 0
+	useconds_t delay;
+#endif
 
 	DEBUGASSERT(dev);
 
@@ -234,6 +258,21 @@ static int ram_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks
 	/* Then erase the data in RAM */
 
 	memset(&priv->start[offset], CONFIG_RAMMTD_ERASESTATE, nbytes);
+
+#if CONFIG_RAMMTD_ERASE_DELAY > 0
+	/* Take as long as a FLASH erase would, not counting the time it is
+	 * suspended.
+	 */
+
+	for (delay = CONFIG_RAMMTD_ERASE_DELAY * (nblocks / RAMMTD_BLKPER); delay > 0;) {
+		useconds_t slice = delay < USEC_PER_TICK ? delay : USEC_PER_TICK;
+
+		usleep(slice);
+		if (priv->suspended == 0) {
+			delay -= slice;
+		}
+	}
+#endif
 	return OK;
 }
 
@@ -271,6 +310,10 @@ static ssize_t ram_bread(FAR struct mtd_dev_s *dev, off_t startblock, size_t nbl
 	/* Then read the data frp, RAM */
 
 	ram_read(buf, &priv->start[offset], nbytes);
+
+#if CONFIG_RAMMTD_READ_DELAY > 0
+	usleep(CONFIG_RAMMTD_READ_DELAY);
+#endif
 	return nblocks;
 }
 
@@ -308,6 +351,10 @@ static ssize_t ram_bwrite(FAR struct mtd_dev_s *dev, off_t startblock, size_t nb
 	/* Then write the data to RAM */
 
 	ram_write(&priv->start[offset], buf, nbytes);
+
+#if CONFIG_RAMMTD_WRITE_DELAY > 0
+	usleep(CONFIG_RAMMTD_WRITE_DELAY * nblocks);
+#endif
 	return nblocks;
 }
 
@@ -328,6 +375,10 @@ static ssize_t ram_byteread(FAR struct mtd_dev_s *dev, off_t offset, size_t nbyt
 	}
 
 	ram_read(buf, &priv->start[offset], nbytes);
+
+#if CONFIG_RAMMTD_READ_DELAY > 0
+	usleep(CONFIG_RAMMTD_READ_DELAY);
+#endif
 	return nbytes;
 }
 
@@ -353,6 +404,10 @@ static ssize_t ram_bytewrite(FAR struct mtd_dev_s *dev, off_t offset, size_t nby
 	/* Then write the data to RAM */
 
 	ram_write(&priv->start[offset], buf, nbytes);
+
+#if CONFIG_RAMMTD_WRITE_DELAY > 0
+	usleep(CONFIG_RAMMTD_WRITE_DELAY * ((nbytes + CONFIG_RAMMTD_BLOCKSIZE - 1) / CONFIG_RAMMTD_BLOCKSIZE));
+#endif
 	return nbytes;
 }
 #endif
@@ -403,6 +458,19 @@ static int ram_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
 	}
 	break;
 
+#if CONFIG_RAMMTD_ERASE_DELAY > 0
+	case MTDIOC_ERASESUSPEND:
+		priv->suspended++;
+		ret = OK;
+		break;
+
+	case MTDIOC_ERASERESUME:
+		DEBUGASSERT(priv->suspended > 0);
+		priv->suspended--;
+		ret = OK;
+		break;
+#endif
+
 	default:
 		ret = -ENOTTY;			/* Bad command */
 		break;
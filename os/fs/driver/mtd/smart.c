@@ -66,6 +66,7 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
+#include <semaphore.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -79,6 +80,10 @@
 #include <tinyara/fs/mtd.h>
 #include <tinyara/fs/smart_procfs.h>
 #include <tinyara/fs/smart.h>
+#ifdef CONFIG_MTD_SMART_BGGC
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+#endif
 
 /****************************************************************************
  * Private Definitions
@@ -170,6 +175,27 @@
 #define SMART_WEAR_ZERO_MASK                0x0F
 #define SMART_WEAR_BLOCK_MASK               0x01
 
+#ifdef CONFIG_MTD_SMART_BGGC
+/* Background collection runs while fewer sectors than this are free.  The
+ * foreground collector starts at sectorsPerBlk + 4.
+ */
+
+#define SMART_BGGC_WATERMARK(d)   ((d)->availSectPerBlk * CONFIG_MTD_SMART_BGGC_WATERMARK + (d)->sectorsPerBlk + 4)
+
+/* Only blocks with at least this many released sectors are pre-cleaned,
+ * so that idle time is not spent moving nearly full blocks.
+ */
+
+#define SMART_BGGC_MINRELEASE(d)  (((d)->availSectPerBlk + 3) >> 2)
+#define SMART_BGGC_IDLE_TICKS     MSEC2TICK(CONFIG_MTD_SMART_BGGC_IDLE)
+
+#define smart_lock(d)             smart_semtake(d)
+#define smart_unlock(d)           sem_post(&(d)->exclsem)
+#else
+#define smart_lock(d)
+#define smart_unlock(d)
+#endif
+
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
 #define SECTOR_IS_RELEASED(h) ((h.status & SMART_STATUS_RELEASED) == 0 ? true : false)
 #define SECTOR_IS_COMMITTED(h) ((h.status & SMART_STATUS_COMMITTED) == 0 ? true : false)
@@ -250,6 +276,17 @@ struct smart_allocsector_s {
 };
 #endif
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+/* Erase blocks linked into one bucket per free (or released) sector count */
+
+struct smart_index_s {
+	FAR uint16_t *head;			/* First block in each bucket, 0xFFFF if empty */
+	FAR uint16_t *next;			/* Next block in the same bucket */
+	FAR uint16_t *prev;			/* Previous block in the bucket, 0xFFFF at the head */
+	uint16_t top;				/* No bucket above this one has any blocks */
+};
+#endif
+
 struct smart_struct_s {
 	FAR struct mtd_dev_s *mtd;	/* Contained MTD interface */
 	struct mtd_geometry_s geo;	/* Device geometry */
@@ -315,6 +352,18 @@ struct smart_struct_s {
 	struct smart_alloc_s
 			alloc[SMART_MAX_ALLOCS];	/* Array of memory allocations */
 #endif
+#ifdef CONFIG_MTD_SMART_BGGC
+	sem_t exclsem;				/* Serializes the ioctls and the collector */
+	struct work_s bggc_work;	/* Background collection on the LP work queue */
+	systime_t bggc_lastio;		/* Time of the last sector write or free */
+	uint16_t bggc_block;		/* Block being cleaned, 0xFFFF if none */
+	uint16_t bggc_next;			/* Next physical sector of it to look at */
+#endif
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+	struct smart_index_s freeindex;	/* Blocks by free sector count */
+	struct smart_index_s releaseindex;	/* Blocks by released sector count */
+	FAR uint8_t *freecursor;	/* First sector of each block that may be free */
+#endif
 };
 
 #define SMART_WEARFLAGS_FORCE_REORG    0x01
@@ -415,6 +464,7 @@ static int smart_readsector(FAR struct smart_struct_s *dev, unsigned long arg);
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 static int smart_read_wearstatus(FAR struct smart_struct_s *dev);
+static int smart_write_wearstatus(struct smart_struct_s *dev);
 static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t block);
 #endif
 
@@ -542,25 +592,27 @@ static int smart_close(FAR struct inode *inode)
 }
 
 /****************************************************************************
- * Name: smart_set_count
+ * Name: smart_get_count
  *
- * Description: Set either the freecount or releasecount value for the
+ * Description: Get either the freecount or releasecount value for the
  *              specified eraseblock (depending on which pointer is passed).
  *
  ****************************************************************************/
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
-static void smart_set_count(FAR struct smart_struct_s *dev, FAR uint8_t *pCount, uint16_t block, uint8_t count)
+static uint8_t smart_get_count(FAR struct smart_struct_s *dev, FAR uint8_t *pCount, uint16_t block)
 {
+	uint8_t count;
+
 	if (dev->sectorsPerBlk > 16) {
-		pCount[block] = count;
+		count = pCount[block];
 	} else {
 		/* Save the lower 4 bits of the count in a shared byte */
 
 		if (block & 0x01) {
-			pCount[block >> 1] = (pCount[block >> 1] & 0xF0) | (count & 0x0F);
+			count = pCount[block >> 1] & 0x0F;
 		} else {
-			pCount[block >> 1] = (pCount[block >> 1] & 0x0F) | ((count & 0x0F) << 4);
+			count = pCount[block >> 1] >> 4;
 		}
 
 		/* If we have 16 sectors per block, then the upper bit (representing 16)
@@ -568,38 +620,159 @@ static void smart_set_count(FAR struct smart_struct_s *dev, FAR uint8_t *pCount,
 		 */
 
 		if (dev->sectorsPerBlk == 16) {
-			if (count == 16) {
-				pCount[(dev->geo.neraseblocks >> 1) + (block >> 3)] |= 1 << (block & 0x07);
-			} else {
-				pCount[(dev->geo.neraseblocks >> 1) + (block >> 3)] &= ~(1 << (block & 0x07));
+			if (pCount[(dev->geo.neraseblocks >> 1) + (block >> 3)] & (1 << (block & 0x07))) {
+				count |= 0x10;
 			}
 		}
 	}
+
+	return count;
 }
+#else
+#define smart_get_count(d, p, b)   ((p)[b])
 #endif
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
 /****************************************************************************
- * Name: smart_get_count
+ * Name: smart_index_carve
  *
- * Description: Get either the freecount or releasecount value for the
+ * Description: Lays out one index at the start of the buffer and links
+ *              every erase block into bucket zero.  Returns the first
+ *              entry past it.
+ *
+ ****************************************************************************/
+
+static FAR uint16_t *smart_index_carve(FAR struct smart_struct_s *dev, FAR struct smart_index_s *index, FAR uint16_t *buffer)
+{
+	uint16_t x;
+
+	index->head = buffer;
+	index->next = index->head + dev->availSectPerBlk + 1;
+	index->prev = index->next + dev->neraseblocks;
+
+	for (x = 0; x <= dev->availSectPerBlk; x++) {
+		index->head[x] = 0xFFFF;
+	}
+
+	for (x = 0; x < dev->neraseblocks; x++) {
+		index->next[x] = x + 1 < dev->neraseblocks ? x + 1 : 0xFFFF;
+		index->prev[x] = x > 0 ? x - 1 : 0xFFFF;
+	}
+
+	index->head[0] = 0;
+	index->top = 0;
+
+	return index->prev + dev->neraseblocks;
+}
+
+/****************************************************************************
+ * Name: smart_index_init
+ *
+ * Description: Sets up the free and release indexes and the free cursors
+ *              in the buffer at dev->freeindex.head, and zeroes the counts
+ *              to match.
+ *
+ ****************************************************************************/
+
+static void smart_index_init(FAR struct smart_struct_s *dev, size_t countsize)
+{
+	FAR uint16_t *next;
+
+	next = smart_index_carve(dev, &dev->freeindex, dev->freeindex.head);
+	next = smart_index_carve(dev, &dev->releaseindex, next);
+
+	dev->freecursor = (FAR uint8_t *)next;
+	memset(dev->freecursor, 0, dev->neraseblocks);
+	memset(dev->releasecount, 0, countsize);
+}
+
+/****************************************************************************
+ * Name: smart_index_move
+ *
+ * Description: Moves an erase block whose free or release count changed
+ *              to the head of the bucket for its new count.
+ *
+ ****************************************************************************/
+
+static void smart_index_move(FAR struct smart_struct_s *dev, FAR uint8_t *pCount, uint16_t block, uint8_t oldcount, uint8_t count)
+{
+	FAR struct smart_index_s *index;
+
+	if (pCount == dev->freecount) {
+		index = &dev->freeindex;
+
+		/* More free sectors means the block was erased */
+
+		if (count > oldcount) {
+			dev->freecursor[block] = 0;
+		}
+	} else {
+		index = &dev->releaseindex;
+	}
+
+	if (oldcount > dev->availSectPerBlk) {
+		oldcount = dev->availSectPerBlk;
+	}
+
+	if (count > dev->availSectPerBlk) {
+		count = dev->availSectPerBlk;
+	}
+
+	if (count == oldcount) {
+		return;
+	}
+
+	/* Unlink from the old bucket */
+
+	if (index->prev[block] == 0xFFFF) {
+		index->head[oldcount] = index->next[block];
+	} else {
+		index->next[index->prev[block]] = index->next[block];
+	}
+
+	if (index->next[block] != 0xFFFF) {
+		index->prev[index->next[block]] = index->prev[block];
+	}
+
+	/* And push onto the new one */
+
+	index->prev[block] = 0xFFFF;
+	index->next[block] = index->head[count];
+	if (index->head[count] != 0xFFFF) {
+		index->prev[index->head[count]] = block;
+	}
+
+	index->head[count] = block;
+	if (count > index->top) {
+		index->top = count;
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_set_count
+ *
+ * Description: Set either the freecount or releasecount value for the
  *              specified eraseblock (depending on which pointer is passed).
  *
  ****************************************************************************/
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-static uint8_t smart_get_count(FAR struct smart_struct_s *dev, FAR uint8_t *pCount, uint16_t block)
+static void smart_set_count(FAR struct smart_struct_s *dev, FAR uint8_t *pCount, uint16_t block, uint8_t count)
 {
-	uint8_t count;
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+	smart_index_move(dev, pCount, block, smart_get_count(dev, pCount, block), count);
+#endif
 
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 	if (dev->sectorsPerBlk > 16) {
-		count = pCount[block];
+		pCount[block] = count;
 	} else {
 		/* Save the lower 4 bits of the count in a shared byte */
 
 		if (block & 0x01) {
-			count = pCount[block >> 1] & 0x0F;
+			pCount[block >> 1] = (pCount[block >> 1] & 0xF0) | (count & 0x0F);
 		} else {
-			count = pCount[block >> 1] >> 4;
+			pCount[block >> 1] = (pCount[block >> 1] & 0x0F) | ((count & 0x0F) << 4);
 		}
 
 		/* If we have 16 sectors per block, then the upper bit (representing 16)
@@ -607,15 +780,17 @@ static uint8_t smart_get_count(FAR struct smart_struct_s *dev, FAR uint8_t *pCou
 		 */
 
 		if (dev->sectorsPerBlk == 16) {
-			if (pCount[(dev->geo.neraseblocks >> 1) + (block >> 3)] & (1 << (block & 0x07))) {
-				count |= 0x10;
+			if (count == 16) {
+				pCount[(dev->geo.neraseblocks >> 1) + (block >> 3)] |= 1 << (block & 0x07);
+			} else {
+				pCount[(dev->geo.neraseblocks >> 1) + (block >> 3)] &= ~(1 << (block & 0x07));
 			}
 		}
 	}
-
-	return count;
-}
+#else
+	pCount[block] = count;
 #endif
+}
 
 /****************************************************************************
  * Name: smart_add_count
@@ -624,7 +799,6 @@ static uint8_t smart_get_count(FAR struct smart_struct_s *dev, FAR uint8_t *pCou
  *
  ****************************************************************************/
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 static void smart_add_count(struct smart_struct_s *dev, uint8_t *pCount, uint16_t block, int adder)
 {
 	int16_t value;
@@ -632,7 +806,6 @@ static void smart_add_count(struct smart_struct_s *dev, uint8_t *pCount, uint16_
 	value = smart_get_count(dev, pCount, block) + adder;
 	smart_set_count(dev, pCount, block, value);
 }
-#endif
 
 /****************************************************************************
  * Name: smart_checkfree
@@ -1041,6 +1214,12 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 		dev->wearstatus = NULL;
 	}
 #endif
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+	if (dev->freeindex.head != NULL) {
+		smart_free(dev, dev->freeindex.head);
+		dev->freeindex.head = NULL;
+	}
+#endif
 
 #ifdef CONFIG_SMARTFS_BAD_SECTOR
 
@@ -1153,6 +1332,20 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 
 #endif							/* CONFIG_MTD_SMART_MINIMIZE_RAM */
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+	/* Allocate the free and release indexes (a bucket head per count plus
+	 * two links per erase block each) and the free cursors.
+	 */
+
+	dev->freeindex.head = (FAR uint16_t *)smart_malloc(dev, ((dev->availSectPerBlk + 1 + (dev->neraseblocks << 1)) << 1) * sizeof(uint16_t) + dev->neraseblocks, "Alloc index");
+	if (!dev->freeindex.head) {
+		fdbg("Error allocating SMART allocation index\n");
+		goto errexit;
+	}
+
+	smart_index_init(dev, allocsize);
+#endif
+
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	/* Allocate a buffer to hold the erase counts */
 
@@ -1233,6 +1426,12 @@ errexit:
 	}
 #endif
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+	if (dev->freeindex.head) {
+		smart_free(dev, dev->freeindex.head);
+	}
+#endif
+
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	if (dev->erasecounts) {
 		smart_free(dev, dev->erasecounts);
@@ -1892,13 +2091,8 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 			prerelease = 0;
 		}
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 		smart_set_count(dev, dev->freecount, sector, dev->availSectPerBlk - prerelease);
 		smart_set_count(dev, dev->releasecount, sector, prerelease);
-#else
-		dev->freecount[sector] = dev->availSectPerBlk - prerelease;
-		dev->releasecount[sector] = prerelease;
-#endif
 	}
 
 	/* Initialize the sector map */
@@ -2062,11 +2256,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 		 * erase block's freecount.
 		 */
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 		smart_add_count(dev, dev->freecount, sector / dev->sectorsPerBlk, -1);
-#else
-		dev->freecount[sector / dev->sectorsPerBlk]--;
-#endif
 		dev->freesectors--;
 
 		/* Test if this sector has been release and if it has,
@@ -2079,11 +2269,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 			 */
 
 			dev->releasesectors++;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 			smart_add_count(dev, dev->releasecount, sector / dev->sectorsPerBlk, 1);
-#else
-			dev->releasecount[sector / dev->sectorsPerBlk]++;
-#endif
 			continue;
 		}
 
@@ -2354,13 +2540,11 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 			dev->sMap[0] = newsector;
-			dev->freecount[newsector / dev->sectorsPerBlk]--;
-			dev->releasecount[sector / dev->sectorsPerBlk]++;
 #else
 			smart_update_cache(dev, 0, newsector);
+#endif
 			smart_add_count(dev, dev->freecount, newsector / dev->sectorsPerBlk, -1);
 			smart_add_count(dev, dev->releasecount, sector / dev->sectorsPerBlk, 1);
-#endif
 
 		}
 	}
@@ -2492,6 +2676,11 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev, uint16_t
 		fvdbg("erase block : %d\n", block);
 		MTD_ERASE(dev->mtd, block, 1);
 		smart_check_eraseblock(dev, block);
+#ifdef CONFIG_MTD_SMART_BGGC
+		if (block == dev->bggc_block) {
+			dev->bggc_block = 0xFFFF;
+		}
+#endif
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 		if (dev->erasecounts) {
@@ -2518,13 +2707,8 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev, uint16_t
 		dev->freesectors += dev->availSectPerBlk - prerelease - freecount;
 		dev->releasesectors -= releasecount - prerelease;
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 		smart_set_count(dev, dev->releasecount, block, prerelease);
 		smart_set_count(dev, dev->freecount, block, dev->availSectPerBlk - prerelease);
-#else
-		dev->releasecount[block] = prerelease;
-		dev->freecount[block] = dev->availSectPerBlk - prerelease;
-#endif							/* CONFIG_MTD_SMART_PACK_COUNTS */
 
 		/* Now that we have erased this block and updated the release / free counts,
 		 * if we are in WEAR LEVELING enabled mode, we must check if this erase block's
@@ -2728,11 +2912,7 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 			smart_update_cache(dev, *((FAR uint16_t *)header->logicalsector), newsector);
 #endif
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 			smart_add_count(dev, dev->freecount, block, -1);
-#else
-			dev->freecount[block]--;
-#endif							/* CONFIG_MTD_SMART_PACK_COUNTS */
 		}
 
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
@@ -3024,6 +3204,9 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 	dev->formatstatus = SMART_FMT_STAT_UNKNOWN;
 	dev->freesectors = dev->availSectPerBlk * dev->geo.neraseblocks - 1;
 	dev->releasesectors = 0;
+#ifdef CONFIG_MTD_SMART_BGGC
+	dev->bggc_block = 0xFFFF;
+#endif
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 	dev->uneven_wearcount = 0;
 #endif
@@ -3040,22 +3223,13 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 		} else {
 			prerelease = 0;
 		}
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 		smart_set_count(dev, dev->releasecount, x, prerelease);
 		smart_set_count(dev, dev->freecount, x, dev->availSectPerBlk - prerelease);
-#else
-		dev->releasecount[x] = prerelease;
-		dev->freecount[x] = dev->availSectPerBlk - prerelease;
-#endif
 	}
 
 	/* Account for the format sector */
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-	smart_set_count(dev, dev->freecount, 0, dev->availSectPerBlk - 1);
-#else
-	dev->freecount[0]--;
-#endif
+	smart_add_count(dev, dev->freecount, 0, -1);
 
 	/* Now initialize the logical to physical sector map */
 
@@ -3267,7 +3441,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 #endif
 #endif
 
-	dev->freecount[block] = 0;
+	smart_set_count(dev, dev->freecount, block, 0);
 #endif
 
 	/* Next move all live data in the block to a new home. */
@@ -3369,17 +3543,18 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 		smart_update_cache(dev, *((FAR uint16_t *)header->logicalsector), newsector);
 #endif
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 		smart_add_count(dev, dev->freecount, newsector / dev->sectorsPerBlk, -1);
-#else
-		dev->freecount[newsector / dev->sectorsPerBlk]--;
-#endif
 	}
 
 	/* Now erase the erase block */
 	fdbg("block : %d\n", block);
 	MTD_ERASE(dev->mtd, block, 1);
 	smart_check_eraseblock(dev, block);
+#ifdef CONFIG_MTD_SMART_BGGC
+	if (block == dev->bggc_block) {
+		dev->bggc_block = 0xFFFF;
+	}
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 	dev->unusedsectors += freecount;
 	dev->blockerases++;
@@ -3410,19 +3585,11 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 		prerelease = 0;
 	}
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 	oldrelease = smart_get_count(dev, dev->releasecount, block);
 	dev->freesectors += oldrelease - prerelease;
 	dev->releasesectors -= oldrelease - prerelease;
 	smart_set_count(dev, dev->freecount, block, dev->availSectPerBlk - prerelease);
 	smart_set_count(dev, dev->releasecount, block, prerelease);
-#else
-	oldrelease = dev->releasecount[block];
-	dev->freesectors += oldrelease - prerelease;
-	dev->releasesectors -= oldrelease - prerelease;
-	dev->freecount[block] = dev->availSectPerBlk - prerelease;
-	dev->releasecount[block] = prerelease;
-#endif
 
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
 	if (smart_checkfree(dev, __LINE__) != OK) {
@@ -3443,14 +3610,90 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 errout:
 	/* Restore the block's freecount if error */
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 	smart_set_count(dev, dev->freecount, block, freecount);
-#else
-	dev->freecount[block] = freecount;
-#endif
 	return ret;
 }
 
+/****************************************************************************
+ * Name: smart_index_findfree
+ *
+ * Description:  Returns the unworn block with the most free sectors, or
+ *               0xFFFF if the free index has none to offer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+static uint16_t smart_index_findfree(FAR struct smart_struct_s *dev)
+{
+	FAR struct smart_index_s *index = &dev->freeindex;
+	uint16_t count;
+	uint16_t block;
+
+	/* Drop the top down to the highest bucket still in use */
+
+	while (index->top > 0 && index->head[index->top] == 0xFFFF) {
+		index->top--;
+	}
+
+	for (count = index->top; count > 0; count--) {
+		for (block = index->head[count]; block != 0xFFFF; block = index->next[block]) {
+#ifdef CONFIG_MTD_SMART_BGGC
+			if (block == dev->bggc_block) {
+				continue;
+			}
+#endif
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+			if (smart_get_wear_level(dev, block) >= SMART_WEAR_FULL_RELOCATE_THRESHOLD) {
+				continue;
+			}
+#endif
+			return block;
+		}
+	}
+
+	return 0xFFFF;
+}
+
+/****************************************************************************
+ * Name: smart_index_findreleased
+ *
+ * Description:  Returns the block with the most released sectors, if it
+ *               has at least minrelease of them and is not worn out, or
+ *               0xFFFF.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_index_findreleased(FAR struct smart_struct_s *dev, uint16_t minrelease)
+{
+	FAR struct smart_index_s *index = &dev->releaseindex;
+	uint16_t count;
+	uint16_t block;
+
+	while (index->top > 0 && index->head[index->top] == 0xFFFF) {
+		index->top--;
+	}
+
+	if (minrelease == 0) {
+		minrelease = 1;
+	}
+
+	for (count = index->top; count >= minrelease; count--) {
+		for (block = index->head[count]; block != 0xFFFF; block = index->next[block]) {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+			/* Don't collect blocks that have been worn completely */
+
+			if (smart_get_wear_level(dev, block) >= SMART_WEAR_REORG_THRESHOLD) {
+				continue;
+			}
+#endif
+			return block;
+		}
+	}
+
+	return 0xFFFF;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_findfreephyssector
  *
@@ -3475,6 +3718,9 @@ static uint16_t smart_findfreephyssector(FAR struct smart_struct_s *dev, uint8_t
 	uint8_t   *sector_buff;
 	int i;
 	bool bitflipped;
+#ifdef CONFIG_MTD_SMART_BGGC
+	uint16_t gcfreecount;
+#endif
 	/* Determine which erase block we should allocate the new
 	 * sector from. This is based on the number of free sectors
 	 * available in each erase block. */
@@ -3492,6 +3738,22 @@ retry:
 #endif
 	bitflipped = FALSE;
 	physicalsector = 0xFFFF;
+#ifdef CONFIG_MTD_SMART_BGGC
+	gcfreecount = 0;
+#endif
+
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+	/* Take the unworn block with the most free sectors straight from the
+	 * index.  Scanning all blocks is left for when only worn blocks or the
+	 * block being cleaned have free sectors.
+	 */
+
+	allocblock = smart_index_findfree(dev);
+	if (allocblock != 0xFFFF) {
+		goto found;
+	}
+#endif
+
 	if (++dev->lastallocblock >= dev->neraseblocks) {
 		dev->lastallocblock = 0;
 	}
@@ -3502,10 +3764,15 @@ retry:
 		 * currently selected block
 		 */
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 		count = smart_get_count(dev, dev->freecount, block);
-#else
-		count = dev->freecount[block];
+
+#ifdef CONFIG_MTD_SMART_BGGC
+		/* Don't refill the block the background collector is emptying */
+
+		if (block == dev->bggc_block) {
+			gcfreecount = count;
+			count = 0;
+		}
 #endif
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
@@ -3544,6 +3811,17 @@ retry:
 		}
 	}
 
+#ifdef CONFIG_MTD_SMART_BGGC
+	if (allocblock == 0xFFFF && gcfreecount > 0) {
+		/* Only the block being cleaned has free sectors left.  Give up
+		 * cleaning it and allocate from it.
+		 */
+
+		allocblock = dev->bggc_block;
+		dev->bggc_block = 0xFFFF;
+	}
+#endif
+
 	/* Check if we found an allocblock. */
 
 	if (allocblock == 0xFFFF) {
@@ -3598,6 +3876,9 @@ retry:
 		}
 	}
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+found:
+#endif
 	/* Now find a free physical sector within this selected erase block to allocate. */
 	sector_buff = (uint8_t *)zalloc(dev->mtdBlksPerSector * dev->geo.blocksize);
 	if (sector_buff == NULL) {
@@ -3605,7 +3886,13 @@ retry:
 		return physicalsector;
 	}
 
-	for (x = allocblock * dev->sectorsPerBlk; x < allocblock * dev->sectorsPerBlk + dev->availSectPerBlk; x++) {
+	x = allocblock * dev->sectorsPerBlk;
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+	/* Skip the sectors already found in use since the block was erased */
+
+	x += dev->freecursor[allocblock];
+#endif
+	for (; x < allocblock * dev->sectorsPerBlk + dev->availSectPerBlk; x++) {
 		/* Check if this physical sector is available. */
 
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
@@ -3674,13 +3961,8 @@ retry:
 						fdbg("Error %d releasing corrupted sector\n", -ret);
 						goto error;
 					}
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 					smart_add_count(dev, dev->freecount, x / dev->sectorsPerBlk, -1);
 					smart_add_count(dev, dev->releasecount, allocblock, 1);
-#else
-					dev->freecount[x / dev->sectorsPerBlk]--;
-					dev->releasecount[allocblock]++;
-#endif
 					dev->freesectors--;
 					dev->releasesectors++;
 				}
@@ -3688,6 +3970,14 @@ retry:
 			}
 #endif
 		}
+
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+		/* This sector can't be allocated before the block is erased again */
+
+		if (x == allocblock * dev->sectorsPerBlk + dev->freecursor[allocblock]) {
+			dev->freecursor[allocblock]++;
+		}
+#endif
 	}
 
 error:
@@ -3733,13 +4023,13 @@ error:
 static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 {
 	uint16_t collectblock;
+#ifndef CONFIG_MTD_SMART_ALLOC_INDEX
 	uint16_t releasemax;
-	bool collect = TRUE;
-	int x;
-	int ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 	uint8_t count;
+	int x;
 #endif
+	bool collect = TRUE;
+	int ret;
 
 	while (collect) {
 		collect = FALSE;
@@ -3763,6 +4053,9 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 		if (collect) {
 			/* Find the block with the most released sectors */
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+			collectblock = smart_index_findreleased(dev, 1);
+#else
 			collectblock = 0xFFFF;
 			releasemax = 0;
 			for (x = 0; x < dev->neraseblocks; x++) {
@@ -3774,19 +4067,13 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 				}
 #endif
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 				count = smart_get_count(dev, dev->releasecount, x);
 				if (count > releasemax) {
 					releasemax = count;
 					collectblock = x;
 				}
-#else
-				if (dev->releasecount[x] > releasemax) {
-					releasemax = dev->releasecount[x];
-					collectblock = x;
-				}
-#endif
 			}
+#endif
 			//releasemax = smart_get_count(dev, dev->releasecount, collectblock);
 
 			if (collectblock == 0xFFFF) {
@@ -3830,6 +4117,274 @@ errout:
 }
 #endif							/* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_semtake
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_semtake(FAR struct smart_struct_s *dev)
+{
+	/* Take the semaphore (perhaps waiting) */
+
+	while (sem_wait(&dev->exclsem) != 0) {
+		/* The only case that an error should occur here is if
+		 * the wait was awakened by a signal.
+		 */
+
+		ASSERT(errno == EINTR);
+	}
+}
+
+/****************************************************************************
+ * Name: smart_bggc_needed
+ *
+ * Description:  Tests if the free sector count is under the background
+ *               collection watermark and there is something to collect.
+ *
+ ****************************************************************************/
+
+static bool smart_bggc_needed(FAR struct smart_struct_s *dev)
+{
+	return dev->formatstatus == SMART_FMT_STAT_FORMATTED && dev->releasesectors >= SMART_BGGC_MINRELEASE(dev) && dev->freesectors < SMART_BGGC_WATERMARK(dev);
+}
+
+/****************************************************************************
+ * Name: smart_bggc_select
+ *
+ * Description:  Picks the block with the most released sectors to clean
+ *               in the background.
+ *
+ ****************************************************************************/
+
+static int smart_bggc_select(FAR struct smart_struct_s *dev)
+{
+	uint16_t block;
+#ifndef CONFIG_MTD_SMART_ALLOC_INDEX
+	uint16_t releasemax;
+	uint16_t count;
+	int x;
+
+	block = 0xFFFF;
+	releasemax = SMART_BGGC_MINRELEASE(dev) - 1;
+	for (x = 0; x < dev->neraseblocks; x++) {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+		/* Don't collect blocks that have been worn completely */
+
+		if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD) {
+			continue;
+		}
+#endif
+
+		count = smart_get_count(dev, dev->releasecount, x);
+		if (count > releasemax) {
+			releasemax = count;
+			block = x;
+		}
+	}
+#else
+	block = smart_index_findreleased(dev, SMART_BGGC_MINRELEASE(dev));
+#endif
+
+	if (block == 0xFFFF) {
+		return -ENOENT;
+	}
+
+	fvdbg("Cleaning block %d, released=%d\n", block, smart_get_count(dev, dev->releasecount, block));
+	dev->bggc_block = block;
+	dev->bggc_next = block * dev->sectorsPerBlk;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smart_bggc_step
+ *
+ * Description:  Moves at most CONFIG_MTD_SMART_BGGC_NSECTORS live sectors
+ *               out of the block being cleaned.  The block takes no new
+ *               allocations meanwhile (see smart_findfreephyssector()), so
+ *               once its last live sector is gone it is erased with no more
+ *               than the cost of the erase.  Each moved sector is released
+ *               and counted exactly as an overwrite in smart_writesector()
+ *               would be, so the device is consistent between steps and
+ *               the foreground collector may take the block over at any
+ *               time.
+ *
+ ****************************************************************************/
+
+static int smart_bggc_step(FAR struct smart_struct_s *dev)
+{
+	FAR struct smart_sect_header_s *header;
+	uint16_t newsector;
+	uint16_t lastsector;
+	uint16_t gcfree;
+	uint16_t block;
+	int nmoved;
+	int ret;
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+	FAR struct smart_allocsector_s *allocsector;
+#endif
+
+	if (dev->bggc_block == 0xFFFF) {
+		ret = smart_bggc_select(dev);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	block = dev->bggc_block;
+	lastsector = block * dev->sectorsPerBlk + dev->availSectPerBlk;
+	header = (FAR struct smart_sect_header_s *)dev->rwbuffer;
+
+	for (nmoved = 0; dev->bggc_next < lastsector; dev->bggc_next++) {
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+		/* A sector with a temporary allocation holds no data yet.  It is
+		 * moved by smart_relocate_block() when the block is erased.
+		 */
+
+		for (allocsector = dev->allocsector; allocsector; allocsector = allocsector->next) {
+			if (allocsector->physical == dev->bggc_next) {
+				break;
+			}
+		}
+
+		if (allocsector) {
+			continue;
+		}
+#endif
+
+		if (nmoved >= CONFIG_MTD_SMART_BGGC_NSECTORS) {
+			return OK;
+		}
+
+		ret = MTD_BREAD(dev->mtd, dev->bggc_next * dev->mtdBlksPerSector, dev->mtdBlksPerSector, (FAR uint8_t *)dev->rwbuffer);
+		if (ret != dev->mtdBlksPerSector) {
+			fdbg("Error reading sector %d\n", dev->bggc_next);
+			ret = -EIO;
+			goto errout;
+		}
+
+		if (((header->status & SMART_STATUS_COMMITTED) == (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED)) || ((header->status & SMART_STATUS_RELEASED) != (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))) {
+			/* Free or released: nothing to move */
+
+			continue;
+		}
+
+		/* Leave the sectors elsewhere to the foreground collector if they
+		 * are about to run out.
+		 */
+
+		gcfree = smart_get_count(dev, dev->freecount, block);
+		if (dev->freesectors <= gcfree + 4) {
+			ret = -ENOSPC;
+			goto errout;
+		}
+
+		newsector = smart_findfreephyssector(dev, FALSE);
+		if (newsector == 0xFFFF || dev->bggc_block != block) {
+			ret = -ENOSPC;
+			goto errout;
+		}
+
+		ret = smart_relocate_sector(dev, dev->bggc_next, newsector);
+		if (ret < 0) {
+			goto errout;
+		}
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+		dev->sMap[UINT8TOUINT16(header->logicalsector)] = newsector;
+#else
+		smart_update_cache(dev, UINT8TOUINT16(header->logicalsector), newsector);
+#endif
+
+		smart_add_count(dev, dev->releasecount, block, 1);
+		smart_add_count(dev, dev->freecount, newsector / dev->sectorsPerBlk, -1);
+		dev->freesectors--;
+		dev->releasesectors++;
+		nmoved++;
+	}
+
+	/* No live data left: erase the block */
+
+	ret = smart_relocate_block(dev, block);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	return OK;
+
+errout:
+	dev->bggc_block = 0xFFFF;
+	return ret;
+}
+
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description:  Runs on the low priority work queue.  Takes one collection
+ *               step once the device has been idle for
+ *               CONFIG_MTD_SMART_BGGC_IDLE milliseconds, and requeues
+ *               itself until the free sectors are back above the
+ *               watermark.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_worker(FAR void *arg)
+{
+	FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+	systime_t idle;
+	uint32_t delay;
+	int ret;
+
+	smart_lock(dev);
+
+	idle = clock_systimer() - dev->bggc_lastio;
+	if (idle < SMART_BGGC_IDLE_TICKS) {
+		/* Written to since we were queued; try again later */
+
+		delay = SMART_BGGC_IDLE_TICKS - idle;
+	} else if (dev->bggc_block != 0xFFFF || smart_bggc_needed(dev)) {
+		ret = smart_bggc_step(dev);
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+		if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED) {
+			smart_write_wearstatus(dev);
+		}
+#endif
+		if (ret < 0 || (dev->bggc_block == 0xFFFF && !smart_bggc_needed(dev))) {
+			/* Done, or nothing we can do; the next write kicks us again */
+
+			smart_unlock(dev);
+			return;
+		}
+
+		delay = 0;
+	} else {
+		smart_unlock(dev);
+		return;
+	}
+
+	if (work_available(&dev->bggc_work)) {
+		work_queue(LPWORK, &dev->bggc_work, smart_bggc_worker, dev, delay);
+	}
+
+	smart_unlock(dev);
+}
+
+/****************************************************************************
+ * Name: smart_bggc_kick
+ *
+ * Description:  Called with the device locked after every sector write,
+ *               allocation and release.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_kick(FAR struct smart_struct_s *dev)
+{
+	dev->bggc_lastio = clock_systimer();
+	if (work_available(&dev->bggc_work) && smart_bggc_needed(dev)) {
+		work_queue(LPWORK, &dev->bggc_work, smart_bggc_worker, dev, SMART_BGGC_IDLE_TICKS);
+	}
+}
+#endif							/* CONFIG_MTD_SMART_BGGC */
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -4487,13 +5042,8 @@ relocate_good_sector:
 		/* Update releasecount for released sector and freecount for the
 		 * newly allocated physical sector. */
 		block = oldphyssector / dev->sectorsPerBlk;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 		smart_add_count(dev, dev->releasecount, block, 1);
 		smart_add_count(dev, dev->freecount, physsector / dev->sectorsPerBlk, -1);
-#else
-		dev->releasecount[block]++;
-		dev->freecount[physsector / dev->sectorsPerBlk]--;
-#endif
 		dev->freesectors--;
 		dev->releasesectors++;
 
@@ -4607,13 +5157,8 @@ errout:
 		 * newly allocated but bad physical sector. */
 
 		block = physsector / dev->sectorsPerBlk;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 		smart_add_count(dev, dev->releasecount, block, 1);
 		smart_add_count(dev, dev->freecount, physsector / dev->sectorsPerBlk, -1);
-#else
-		dev->releasecount[block]++;
-		dev->freecount[physsector / dev->sectorsPerBlk]--;
-#endif
 		dev->freesectors--;
 		dev->releasesectors++;
 
@@ -4982,11 +5527,7 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev, unsigned lon
 	smart_add_sector_to_cache(dev, logsector, physicalsector, __LINE__);
 #endif
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 	smart_add_count(dev, dev->freecount, physicalsector / dev->sectorsPerBlk, -1);
-#else
-	dev->freecount[physicalsector / dev->sectorsPerBlk]--;
-#endif
 	dev->freesectors--;
 
 	/* Return the logical sector number */
@@ -5075,11 +5616,7 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev, unsigned long
 
 	dev->releasesectors++;
 	block = physsector / dev->sectorsPerBlk;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 	smart_add_count(dev, dev->releasecount, block, 1);
-#else
-	dev->releasecount[block]++;
-#endif
 
 	/* Unmap this logical sector */
 
@@ -5124,6 +5661,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+	smart_lock(dev);
+
 	/* Process the ioctl's we care about first, pass any we don't respond
 	 * to directly to the underlying MTD device.
 	 */
@@ -5138,7 +5677,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #ifdef CONFIG_DEBUG
 		if (arg == 0) {
 			fdbg("ERROR: BIOC_XIPBASE argument is NULL\n");
-			return -EINVAL;
+			ret = -EINVAL;
+			goto ok_out;
 		}
 #endif
 
@@ -5177,6 +5717,9 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 		/* Allocate a logical sector for the upper layer file system */
 
 		ret = smart_allocsector(dev, arg);
+#ifdef CONFIG_MTD_SMART_BGGC
+		smart_bggc_kick(dev);
+#endif
 		goto ok_out;
 
 	case BIOC_FREESECT:
@@ -5184,6 +5727,9 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 		/* Free the specified logical sector */
 
 		ret = smart_freesector(dev, arg);
+#ifdef CONFIG_MTD_SMART_BGGC
+		smart_bggc_kick(dev);
+#endif
 		goto ok_out;
 
 	case BIOC_WRITESECT:
@@ -5200,6 +5746,9 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 		}
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+		smart_bggc_kick(dev);
+#endif
 		goto ok_out;
 #endif							/* CONFIG_FS_WRITABLE */
 
@@ -5270,6 +5819,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	}
 
 ok_out:
+	smart_unlock(dev);
 	return ret;
 }
 
@@ -5363,6 +5913,16 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #endif
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
 		dev->allocsector = NULL;
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+		sem_init(&dev->exclsem, 0, 1);
+		memset(&dev->bggc_work, 0, sizeof(struct work_s));
+		dev->bggc_lastio = 0;
+		dev->bggc_block = 0xFFFF;
+		dev->bggc_next = 0;
+#endif
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+		dev->freeindex.head = NULL;
 #endif
 		dev->sectorsize = 0;
 		ret = smart_setsectorsize(dev, CONFIG_MTD_SMART_SECTOR_SIZE);
@@ -5600,11 +6160,7 @@ int smart_recoversectors(FAR struct inode *inode, char *validsectors, int *nobso
 
 			dev->releasesectors++;
 			block = sector / dev->sectorsPerBlk;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 			smart_add_count(dev, dev->releasecount, block, 1);
-#else
-			dev->releasecount[block]++;
-#endif
 
 			/* if the mapping is sane, Unmap this logical->physicalsector map */
 			if (physsector == sector) {
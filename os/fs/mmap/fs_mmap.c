@@ -0,0 +1,178 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/mmap/fs_mmap.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+
+#include "mmap/fs_rammap.h"
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mmap
+ *
+ * Description:
+ *   Map a region of a file into memory.  There is no MMU, so this is
+ *   possible in two ways:
+ *
+ *   1. The file is on directly addressable media: a ROMFS image in XIP
+ *      flash or on a RAM disk.  FIOC_MMAP returns the address of the file
+ *      contents, which are used in place.  No memory is allocated and all
+ *      mappings of the file share the same bytes, but they can only be
+ *      read.
+ *   2. With CONFIG_FS_RAMMAP, any other file is read into a heap buffer.
+ *      That copy is private to the mapping and reflects the file at the
+ *      time of the mmap() call.  It may be written if PROT_WRITE was
+ *      requested, but nothing is written back to the file.
+ *
+ *   A private writable mapping of a file on directly addressable media is
+ *   also made by copying.
+ *
+ * Parameters:
+ *   start  - A hint for the address of the mapping; ignored
+ *   length - The length of the region
+ *   prot   - PROT_READ, optionally with PROT_WRITE and PROT_EXEC
+ *   flags  - MAP_SHARED or MAP_PRIVATE.  MAP_FIXED and MAP_ANONYMOUS are
+ *            not supported.
+ *   fd     - An open file descriptor, open for reading
+ *   offset - The offset of the region in the file
+ *
+ * Returned Value:
+ *   On success, mmap() returns the start of the mapping.  On failure
+ *   MAP_FAILED is returned and errno is set to:
+ *
+ *   EBADF   - fd is not a valid file descriptor
+ *   EACCES  - The file is not open for reading, or a writable shared
+ *             mapping was requested
+ *   EINVAL  - length is zero, offset is negative, or the flags are invalid
+ *   ENXIO   - The region extends past the end of the file
+ *   ENOSYS  - The file is not on directly addressable media and
+ *             CONFIG_FS_RAMMAP is not enabled, or MAP_FIXED or
+ *             MAP_ANONYMOUS was requested
+ *   ENOMEM  - There is not enough memory for the copy
+ *
+ ****************************************************************************/
+
+FAR void *mmap(FAR void *start, size_t length, int prot, int flags, int fd, off_t offset)
+{
+	FAR struct file *filep;
+	FAR void *addr;
+	off_t size;
+	int type;
+	int errcode;
+
+	/* Only file mappings at an address of our choosing are possible */
+
+	if ((flags & (MAP_FIXED | MAP_ANONYMOUS)) != 0) {
+		fdbg("ERROR: Unsupported flags: %04x\n", flags);
+		errcode = ENOSYS;
+		goto errout;
+	}
+
+	type = flags & MAP_TYPE;
+	if (length == 0 || offset < 0 || (type != MAP_SHARED && type != MAP_PRIVATE)) {
+		errcode = EINVAL;
+		goto errout;
+	}
+
+	/* Get the file structure corresponding to the file descriptor */
+
+	filep = fs_getfilep(fd);
+	if (!filep) {
+		/* The errno value has already been set */
+
+		return MAP_FAILED;
+	}
+
+	if ((filep->f_oflags & O_RDOK) == 0) {
+		errcode = EACCES;
+		goto errout;
+	}
+
+	/* Map the file in place if its media is directly addressable.  Only a
+	 * private writable mapping needs its own copy.
+	 */
+
+	if (type == MAP_SHARED || (prot & PROT_WRITE) == 0) {
+		if (ioctl(fd, FIOC_MMAP, (unsigned long)((uintptr_t)&addr)) >= 0) {
+			if ((prot & PROT_WRITE) != 0) {
+				errcode = EACCES;
+				goto errout;
+			}
+
+			/* Ask the file system for the size.  Seeking to the end and back
+			 * would move the position other users of the file rely on.
+			 */
+
+			if (ioctl(fd, FIOC_FILESIZE, (unsigned long)((uintptr_t)&size)) < 0) {
+				errcode = get_errno();
+				goto errout;
+			}
+
+			if (offset > size || length > (size_t)(size - offset)) {
+				errcode = ENXIO;
+				goto errout;
+			}
+
+			return (FAR void *)((FAR uint8_t *)addr + offset);
+		}
+	}
+
+	/* A copy cannot be shared with the writers of the file */
+
+	if (type == MAP_SHARED && (prot & PROT_WRITE) != 0) {
+		errcode = EACCES;
+		goto errout;
+	}
+
+#ifdef CONFIG_FS_RAMMAP
+	return rammap(filep, length, offset);
+#else
+	fdbg("ERROR: fd=%d is not on directly addressable media\n", fd);
+	errcode = ENOSYS;
+#endif
+
+errout:
+	set_errno(errcode);
+	return MAP_FAILED;
+}
+
+#endif							/* CONFIG_NFILE_DESCRIPTORS > 0 */
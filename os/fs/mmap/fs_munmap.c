@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/mmap/fs_munmap.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+
+#include "mmap/fs_rammap.h"
+
+#ifdef CONFIG_FS_RAMMAP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: munmap
+ *
+ * Description:
+ *   Release a mapping created by mmap().  Mappings of files on directly
+ *   addressable media hold no resources, so there is nothing to do for
+ *   them.  A copy made by mmap() must be released as a whole.
+ *
+ * Parameters:
+ *   start  - The address returned by mmap()
+ *   length - The length passed to mmap()
+ *
+ * Returned Value:
+ *   On success, munmap() returns 0.  On failure -1 (ERROR) is returned
+ *   and errno is set to:
+ *
+ *   EINVAL - The length does not cover the whole copy at start
+ *
+ ****************************************************************************/
+
+int munmap(FAR void *start, size_t length)
+{
+	FAR struct fs_rammap_s *prev;
+	FAR struct fs_rammap_s *curr;
+
+	rammap_lock();
+
+	for (prev = NULL, curr = g_rammaps.head; curr && (FAR void *)curr->addr != start; prev = curr, curr = curr->flink) ;
+
+	if (!curr) {
+		/* Not a copy: a mapping of XIP media, or already released */
+
+		rammap_unlock();
+		return OK;
+	}
+
+	if (length != curr->length) {
+		fdbg("ERROR: Partial unmap of %p: %u of %u bytes\n", start, length, curr->length);
+		rammap_unlock();
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	if (prev) {
+		prev->flink = curr->flink;
+	} else {
+		g_rammaps.head = curr->flink;
+	}
+
+	rammap_unlock();
+
+	kumm_free(curr);
+	return OK;
+}
+
+#endif							/* CONFIG_FS_RAMMAP */
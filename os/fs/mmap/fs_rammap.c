@@ -0,0 +1,153 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/mmap/fs_rammap.c
+ *
+ *   Mapping of files that are not on directly addressable media
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <stdint.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+
+#include "mmap/fs_rammap.h"
+
+#ifdef CONFIG_FS_RAMMAP
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct fs_allmaps_s g_rammaps = {
+	SEM_INITIALIZER(1),
+	NULL
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rammap_lock/rammap_unlock
+ *
+ * Description:
+ *   Take/give exclusive access to g_rammaps
+ *
+ ****************************************************************************/
+
+void rammap_lock(void)
+{
+	while (sem_wait(&g_rammaps.exclsem) != 0) {
+		/* The only case that an error should occur here is if the wait
+		 * was awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+void rammap_unlock(void)
+{
+	sem_post(&g_rammaps.exclsem);
+}
+
+/****************************************************************************
+ * Name: rammap
+ *
+ * Description:
+ *   Map a region of a file that is not on directly addressable media by
+ *   reading it into a heap buffer.  The buffer is allocated from the user
+ *   heap because the caller owns the mapping; munmap() releases it.
+ *
+ * Input Parameters:
+ *   filep  - The open file to map
+ *   length - Length of the region
+ *   offset - Offset of the region in the file
+ *
+ * Returned Value:
+ *   The start of the copy on success.  MAP_FAILED on failure with the
+ *   errno set appropriately.
+ *
+ ****************************************************************************/
+
+FAR void *rammap(FAR struct file *filep, size_t length, off_t offset)
+{
+	FAR struct fs_rammap_s *map;
+	size_t nread;
+	ssize_t ret;
+	int errcode;
+
+	DEBUGASSERT(filep && length > 0);
+
+	map = (FAR struct fs_rammap_s *)kumm_malloc(SIZEOF_RAMMAP_S(length));
+	if (!map) {
+		fdbg("ERROR: Failed to allocate %u byte mapping\n", length);
+		errcode = ENOMEM;
+		goto errout;
+	}
+
+	/* The file system may return the region in pieces */
+
+	for (nread = 0; nread < length; nread += ret) {
+		ret = file_pread(filep, &map->addr[nread], length - nread, offset + nread);
+		if (ret < 0) {
+			errcode = get_errno();
+			fdbg("ERROR: Read failed: offset=%d errno=%d\n", (int)(offset + nread), errcode);
+			goto errout_with_map;
+		}
+
+		if (ret == 0) {
+			/* The region extends past the end of the file */
+
+			errcode = ENXIO;
+			goto errout_with_map;
+		}
+	}
+
+	map->length = length;
+
+	rammap_lock();
+	map->flink = g_rammaps.head;
+	g_rammaps.head = map;
+	rammap_unlock();
+
+	return map->addr;
+
+errout_with_map:
+	kumm_free(map);
+
+errout:
+	set_errno(errcode);
+	return MAP_FAILED;
+}
+
+#endif							/* CONFIG_FS_RAMMAP */
@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/mmap/fs_rammap.h
+ *
+ *   Files that are not on directly addressable media are mapped by reading
+ *   them into a heap buffer.  These are the records of those buffers.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_MMAP_FS_RAMMAP_H
+#define __FS_MMAP_FS_RAMMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <semaphore.h>
+
+#ifdef CONFIG_FS_RAMMAP
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One mapped copy.  The file contents follow the header in the same
+ * allocation.
+ */
+
+struct fs_rammap_s {
+	FAR struct fs_rammap_s *flink;	/* Implements a singly linked list */
+	size_t length;				/* Length of the mapping */
+	uint8_t addr[1];			/* Start of the mapping */
+};
+
+#define SIZEOF_RAMMAP_S(n) (sizeof(struct fs_rammap_s) - 1 + (n))
+
+/* All mapped copies */
+
+struct fs_allmaps_s {
+	sem_t exclsem;				/* Provides exclusive access to the list */
+	FAR struct fs_rammap_s *head;	/* Most recently mapped copy */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+extern struct fs_allmaps_s g_rammaps;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rammap_lock/rammap_unlock
+ *
+ * Description:
+ *   Take/give exclusive access to g_rammaps
+ *
+ ****************************************************************************/
+
+void rammap_lock(void);
+void rammap_unlock(void);
+
+/****************************************************************************
+ * Name: rammap
+ *
+ * Description:
+ *   Map a region of a file that is not on directly addressable media by
+ *   reading it into a heap buffer.
+ *
+ * Input Parameters:
+ *   filep  - The open file to map
+ *   length - Length of the region
+ *   offset - Offset of the region in the file
+ *
+ * Returned Value:
+ *   The start of the copy on success.  MAP_FAILED on failure with the
+ *   errno set appropriately.
+ *
+ ****************************************************************************/
+
+struct file;
+FAR void *rammap(FAR struct file *filep, size_t length, off_t offset);
+
+#endif							/* CONFIG_FS_RAMMAP */
+#endif							/* __FS_MMAP_FS_RAMMAP_H */
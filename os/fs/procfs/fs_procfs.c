@@ -94,6 +94,7 @@
 
 extern const struct procfs_operations proc_operations;
 extern const struct procfs_operations cpuload_operations;
+extern const struct procfs_operations latency_operations;
 extern const struct procfs_operations uptime_operations;
 extern const struct procfs_operations version_operations;
 
@@ -107,6 +108,10 @@ extern const struct procfs_operations smartfs_procfsoperations;
 extern const struct procfs_operations power_procfsoperations;
 extern const struct procfs_operations cm_operations;
 
+/* Implemented in net/lwip/src/core/memp_procfs.c */
+
+extern const struct procfs_operations memp_procfsoperations;
+
 /* And even worse, this one is specific to the STM32.  The solution to
  * this nasty couple would be to replace this hard-coded, ROM-able
  * operations table with a RAM-base registration table.
@@ -127,6 +132,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"cpuload", &cpuload_operations},
 #endif
 
+#if defined(CONFIG_SCHED_LATENCY) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LATENCY)
+	{"latency", &latency_operations},
+#endif
+
 #if defined(CONFIG_FS_SMARTFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 	{"fs/smartfs**", &smartfs_procfsoperations},
 #endif
@@ -135,6 +144,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"mtd", &mtd_procfsoperations},
 #endif
 
+#if defined(CONFIG_NET_MEMP_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NET_MEMP)
+	{"net/memp", &memp_procfsoperations},
+#endif
+
 #if defined(CONFIG_MTD_PARTITION) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PARTITIONS)
 	{"partitions", &part_procfsoperations},
 #endif
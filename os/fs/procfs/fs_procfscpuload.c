@@ -83,10 +83,16 @@
  * Pre-processor Definitions
  ****************************************************************************/
 /* Determines the size of an intermediate buffer that must be large enough
- * to handle the longest line generated by this logic.
+ * to handle the longest line generated by this logic.  With cycle accurate
+ * accounting, the busy interrupt vectors and the accounting overhead are
+ * listed after the total load.
  */
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+#define CPULOAD_LINELEN 256
+#else
 #define CPULOAD_LINELEN 16
+#endif
 
 /****************************************************************************
  * Private Types
@@ -261,6 +267,35 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer, size_t buf
 
 		linesize = snprintf(attr->line, CPULOAD_LINELEN, "%3d.%01d%%", intpart, fracpart);
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+		/* Then the interrupt vectors that took at least 0.1% of the CPU,
+		 * and what the accounting itself costs.
+		 */
+
+		{
+			uint32_t percall;
+			uint32_t tmp;
+			int irq;
+
+			for (irq = 0; clock_cpuload_irq(irq, &cpuload) == OK; irq++) {
+				tmp = cpuload.total > 0 ? (1000 * cpuload.active) / cpuload.total : 0;
+				if (tmp > 0 && linesize < CPULOAD_LINELEN) {
+					linesize += snprintf(&attr->line[linesize], CPULOAD_LINELEN - linesize, "\nirq %3d: %3d.%01d%%", irq, tmp / 10, tmp % 10);
+				}
+			}
+
+			clock_cpuload_overhead(&cpuload, &percall);
+			tmp = cpuload.total > 0 ? (1000 * cpuload.active) / cpuload.total : 0;
+			if (linesize < CPULOAD_LINELEN) {
+				linesize += snprintf(&attr->line[linesize], CPULOAD_LINELEN - linesize, "\noverhead: %3d.%01d%% (%u cycles/event)\n", tmp / 10, tmp % 10, (unsigned int)percall);
+			}
+
+			if (linesize >= CPULOAD_LINELEN) {
+				linesize = CPULOAD_LINELEN - 1;
+			}
+		}
+#endif
+
 		/* Save the linesize in case we are re-entered with f_pos > 0 */
 
 		attr->linesize = linesize;
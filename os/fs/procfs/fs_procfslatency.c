@@ -0,0 +1,365 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfslatency.c
+ *
+ * /proc/latency: scheduling and interrupt latency histograms.  Writing
+ * anything to the file clears them.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/latency.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_SCHED_LATENCY) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LATENCY)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LATENCY_LINELEN 256
+
+/* Most histograms a snapshot can hold */
+
+#ifdef CONFIG_SCHED_DEFER
+#define LATENCY_MAXHIST (CONFIG_SCHED_LATENCY_NPRIOS + CONFIG_SCHED_LATENCY_NIRQS + 3 + CONFIG_SCHED_DEFER_NPRIOS)
+#else
+#define LATENCY_MAXHIST (CONFIG_SCHED_LATENCY_NPRIOS + CONFIG_SCHED_LATENCY_NIRQS + 2)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* This structure describes one open "file".  The histograms are copied
+ * when the file is read from offset 0 so that the contents stay consistent
+ * across partial reads.
+ */
+
+struct latency_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	int nhist;					/* Number of valid entries in hist[] */
+	uint8_t type[LATENCY_MAXHIST];	/* LATENCY_* type of each entry */
+	struct latency_hist_s hist[LATENCY_MAXHIST];
+	char line[LATENCY_LINELEN];	/* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* File system methods */
+
+static int latency_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int latency_close(FAR struct file *filep);
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static ssize_t latency_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
+
+static int latency_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int latency_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_latency_names[LATENCY_NTYPES] = {
+	"wakeup",					/* LATENCY_WAKEUP */
+	"irq",						/* LATENCY_IRQ */
+	"irqoff",					/* LATENCY_IRQOFF */
+	"schedlock",				/* LATENCY_SCHEDLOCK */
+	"defer"						/* LATENCY_DEFER */
+};
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations latency_operations = {
+	latency_open,				/* open */
+	latency_close,				/* close */
+	latency_read,				/* read */
+	latency_write,				/* write */
+
+	latency_dup,				/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	latency_stat				/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_snapshot
+ ****************************************************************************/
+
+static void latency_snapshot(FAR struct latency_file_s *attr)
+{
+	int type;
+	int i;
+
+	attr->nhist = 0;
+	for (type = 0; type < LATENCY_NTYPES; type++) {
+		for (i = 0; attr->nhist < LATENCY_MAXHIST; i++) {
+			if (sched_latency_get(type, i, &attr->hist[attr->nhist]) != OK) {
+				break;
+			}
+
+			attr->type[attr->nhist++] = type;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: latency_format
+ ****************************************************************************/
+
+static size_t latency_format(FAR struct latency_file_s *attr, int ndx)
+{
+	FAR struct latency_hist_s *hist = &attr->hist[ndx];
+	size_t linesize;
+	int i;
+
+	linesize = snprintf(attr->line, LATENCY_LINELEN, "%-9s ", g_latency_names[attr->type[ndx]]);
+
+	if (attr->type[ndx] == LATENCY_IRQOFF || attr->type[ndx] == LATENCY_SCHEDLOCK) {
+		linesize += snprintf(&attr->line[linesize], LATENCY_LINELEN - linesize, "%5s", "-");
+	} else if (hist->key == LATENCY_KEY_OTHER) {
+		linesize += snprintf(&attr->line[linesize], LATENCY_LINELEN - linesize, "%5s", "other");
+	} else {
+		linesize += snprintf(&attr->line[linesize], LATENCY_LINELEN - linesize, "%5d", hist->key);
+	}
+
+	linesize += snprintf(&attr->line[linesize], LATENCY_LINELEN - linesize, " %10u %10u %10p |", (unsigned int)hist->count, (unsigned int)hist->max, hist->caller);
+
+	for (i = 0; i < LATENCY_NBUCKETS && linesize < LATENCY_LINELEN; i++) {
+		linesize += snprintf(&attr->line[linesize], LATENCY_LINELEN - linesize, " %u", (unsigned int)hist->bucket[i]);
+	}
+
+	if (linesize < LATENCY_LINELEN) {
+		linesize += snprintf(&attr->line[linesize], LATENCY_LINELEN - linesize, "\n");
+	}
+
+	return linesize < LATENCY_LINELEN ? linesize : LATENCY_LINELEN - 1;
+}
+
+/****************************************************************************
+ * Name: latency_open
+ ****************************************************************************/
+
+static int latency_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct latency_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* "latency" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "latency") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct latency_file_s *)kmm_zalloc(sizeof(struct latency_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: latency_close
+ ****************************************************************************/
+
+static int latency_close(FAR struct file *filep)
+{
+	FAR struct latency_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct latency_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: latency_read
+ ****************************************************************************/
+
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct latency_file_s *attr;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	off_t offset;
+	int i;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct latency_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	if (filep->f_pos == 0) {
+		latency_snapshot(attr);
+	}
+
+	offset = filep->f_pos;
+
+	linesize = snprintf(attr->line, LATENCY_LINELEN, "%-9s %5s %10s %10s %10s | log2 cycles, from <%u\n", "Type", "Key", "Count", "Max", "Caller", 2u << LATENCY_SHIFT);
+	copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+	totalsize = copysize;
+
+	for (i = 0; i < attr->nhist && totalsize < buflen; i++) {
+		linesize = latency_format(attr, i);
+		copysize = procfs_memcpy(attr->line, linesize, &buffer[totalsize], buflen - totalsize, &offset);
+		totalsize += copysize;
+	}
+
+	/* Update the file offset */
+
+	filep->f_pos += totalsize;
+	return totalsize;
+}
+
+/****************************************************************************
+ * Name: latency_write
+ *
+ * Description:
+ *   Any write clears the histograms.
+ *
+ ****************************************************************************/
+
+static ssize_t latency_write(FAR struct file *filep, FAR const char *buffer, size_t buflen)
+{
+	sched_latency_reset();
+	return buflen;
+}
+
+/****************************************************************************
+ * Name: latency_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int latency_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct latency_file_s *oldattr;
+	FAR struct latency_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct latency_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the file attributes */
+
+	newattr = (FAR struct latency_file_s *)kmm_malloc(sizeof(struct latency_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct latency_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: latency_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int latency_stat(const char *relpath, struct stat *buf)
+{
+	/* "latency" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "latency") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "latency" is readable, and writable to clear it */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_SCHED_LATENCY && !CONFIG_FS_PROCFS_EXCLUDE_LATENCY */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -542,6 +542,7 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	FAR struct romfs_mountpt_s *rm;
 	FAR struct romfs_file_s *rf;
 	FAR void **ppv = (FAR void **)arg;
+	FAR off_t *psize = (FAR off_t *)arg;
 
 	fvdbg("cmd: %d arg: %08lx\n", cmd, arg);
 
@@ -556,8 +557,6 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 	DEBUGASSERT(rm != NULL);
 
-	/* Only one ioctl command is supported */
-
 	if (cmd == FIOC_MMAP && rm->rm_xipbase && ppv) {
 		/* Return the address on the media corresponding to the start of
 		 * the file.
@@ -567,6 +566,11 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		return OK;
 	}
 
+	if (cmd == FIOC_FILESIZE && psize) {
+		*psize = rf->rf_size;
+		return OK;
+	}
+
 	fdbg("Invalid cmd: %d \n", cmd);
 	return -ENOTTY;
 }
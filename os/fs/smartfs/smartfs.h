@@ -245,6 +245,10 @@
 #undef  CONFIG_SMARTFS_DYNAMIC_HEADER
 #endif
 
+#if !defined(CONFIG_SMARTFS_JOURNALING) || defined(CONFIG_SMARTFS_USE_SECTOR_BUFFER)
+#undef  CONFIG_SMARTFS_WRITEBACK
+#endif
+
 #ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
 #define ENTRY_VALID(e) ((smartfs_rdle16(&e->flags) & SMARTFS_DIRENT_EMPTY) != \
 						(SMARTFS_ERASEDSTATE_16BIT & SMARTFS_DIRENT_EMPTY)) && \
@@ -325,6 +329,25 @@ struct smartfs_entry_header_s {
 	char name[0];				/* inode name */
 };
 
+#ifdef CONFIG_SMARTFS_DCACHE
+/* This structure caches the result of looking up one name in one
+ * directory.  A negative entry (dsector == 0xFFFF) records that the name
+ * does not exist there.
+ */
+
+struct smartfs_dcache_s {
+	uint32_t age;				/* Time of last use, 0 if the slot is free */
+	uint16_t parent;			/* First sector of the parent directory */
+	uint16_t hash;				/* Hash of the name */
+	uint16_t firstsector;		/* First sector of the file or directory */
+	uint16_t dsector;			/* Sector of the directory entry */
+	uint16_t doffset;			/* Offset of the directory entry */
+	uint16_t flags;				/* Flags, including mode */
+	uint32_t utc;				/* Time stamp */
+	char name[CONFIG_SMARTFS_MAXNAMLEN + 1];	/* Name, as stored in the entry */
+};
+#endif
+
 /* This structure describes the smartfs header at the start of each
  * sector.  It manages the sector chain and used bytes in the sector.
  */
@@ -358,6 +381,11 @@ struct smartfs_ofile_s {
 #ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
 	uint8_t *buffer;			/* Sector buffer to reduce writes */
 	uint8_t bflags;				/* Buffer flags */
+#endif
+#ifdef CONFIG_SMARTFS_WRITEBACK
+	uint8_t *wbuffer;			/* Appended data not yet written to FLASH */
+	FAR struct smartfs_mountpt_s *wbfs;	/* Mount the file is on */
+	FAR struct smartfs_ofile_s *wbnext;	/* Next file open for writing */
 #endif
 	int16_t crefs;				/* Reference count */
 	mode_t oflags;				/* Open mode */
@@ -370,7 +398,9 @@ struct smartfs_ofile_s {
 								 * sector yet.  We delay updating the
 								 * used field until the file is closed,
 								 * a seek, or more data is written that
-								 * causes the sector to change. */
+								 * causes the sector to change.  With
+								 * CONFIG_SMARTFS_WRITEBACK the bytes are
+								 * still in wbuffer, ending at curroffset. */
 };
 
 /* This structure represents the overall mountpoint state.  An instance of this
@@ -395,6 +425,10 @@ struct smartfs_mountpt_s {
 #endif
 #ifdef CONFIG_SMARTFS_JOURNALING
 	struct journal_transaction_manager_s *journal;
+#endif
+#ifdef CONFIG_SMARTFS_DCACHE
+	FAR struct smartfs_dcache_s *fs_dcache;	/* Directory lookup cache */
+	uint32_t fs_dcacheage;		/* Age counter for the lookup cache */
 #endif
 	uint8_t fs_rootsector;		/* Root directory sector num */
 };
@@ -559,6 +593,17 @@ struct fs_dirent_s;
 struct statfs;
 struct stat;
 
+#ifdef CONFIG_SMARTFS_DCACHE
+int smartfs_dcache_init(struct smartfs_mountpt_s *fs);
+void smartfs_dcache_release(struct smartfs_mountpt_s *fs);
+int smartfs_dcache_lookup(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name, struct smartfs_entry_s *entry);
+void smartfs_dcache_add(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name, const struct smartfs_entry_s *entry);
+void smartfs_dcache_forget(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name);
+void smartfs_dcache_remove(struct smartfs_mountpt_s *fs, uint16_t dsector, uint16_t doffset);
+void smartfs_dcache_purgedir(struct smartfs_mountpt_s *fs, uint16_t dirsector);
+void smartfs_dcache_flush(struct smartfs_mountpt_s *fs);
+#endif
+
 #ifdef CONFIG_SMARTFS_JOURNALING
 int smartfs_journal_init(struct smartfs_mountpt_s *fs);
 int smartfs_create_journalentry(struct smartfs_mountpt_s *fs, enum logging_transaction_type_e type, uint16_t curr_sector, uint16_t offset, uint16_t datalen, uint16_t genericdata, uint8_t needsync, const uint8_t *data, uint16_t *t_sector, uint16_t *t_offset);
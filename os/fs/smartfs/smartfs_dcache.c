@@ -0,0 +1,323 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/smartfs/smartfs_dcache.c
+ *
+ *   A small cache of directory lookups.  Each entry maps a name in a
+ *   directory (the first sector of the directory and the name) to where
+ *   its directory entry is and what it holds, or records that the name is
+ *   not there.  smartfs_finddirentry() consults it before reading the
+ *   directory chain.  Entries are dropped when the directory entry they
+ *   describe is created, deleted or renamed; the least recently used entry
+ *   is replaced when the cache is full.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+
+#include "smartfs.h"
+
+#ifdef CONFIG_SMARTFS_DCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DCACHE_NEGATIVE 0xFFFF	/* dsector of a name known not to exist */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: smartfs_dcache_namelen
+ *
+ * Description: Returns how many characters of a name are significant, i.e.
+ *              compared by smartfs_finddirentry().
+ *
+ ****************************************************************************/
+
+static size_t smartfs_dcache_namelen(struct smartfs_mountpt_s *fs, const char *name)
+{
+	return strnlen(name, fs->fs_llformat.namesize);
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_hash
+ ****************************************************************************/
+
+static uint16_t smartfs_dcache_hash(const char *name, size_t len)
+{
+	uint32_t hash = 2166136261u;
+
+	while (len-- > 0) {
+		hash = (hash ^ (uint8_t)*name++) * 16777619u;
+	}
+
+	return (uint16_t)(hash ^ (hash >> 16));
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_find
+ ****************************************************************************/
+
+static FAR struct smartfs_dcache_s *smartfs_dcache_find(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name)
+{
+	FAR struct smartfs_dcache_s *dcache;
+	uint16_t hash;
+	size_t len;
+	int x;
+
+	len = smartfs_dcache_namelen(fs, name);
+	hash = smartfs_dcache_hash(name, len);
+
+	for (x = 0; x < CONFIG_SMARTFS_DCACHE_ENTRIES; x++) {
+		dcache = &fs->fs_dcache[x];
+		if (dcache->age != 0 && dcache->parent == parent && dcache->hash == hash && strncmp(dcache->name, name, len) == 0 && dcache->name[len] == '\0') {
+			return dcache;
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: smartfs_dcache_init
+ *
+ * Description: Allocates an empty lookup cache for the mount.  Names longer
+ *              than CONFIG_SMARTFS_MAXNAMLEN can't be cached, so there is
+ *              no cache for a volume formatted with longer names.
+ *
+ ****************************************************************************/
+
+int smartfs_dcache_init(struct smartfs_mountpt_s *fs)
+{
+	fs->fs_dcacheage = 0;
+	fs->fs_dcache = NULL;
+
+	if (fs->fs_llformat.namesize > CONFIG_SMARTFS_MAXNAMLEN) {
+		fdbg("Names of %d bytes are not cached\n", fs->fs_llformat.namesize);
+		return OK;
+	}
+
+	fs->fs_dcache = (FAR struct smartfs_dcache_s *)kmm_zalloc(CONFIG_SMARTFS_DCACHE_ENTRIES * sizeof(struct smartfs_dcache_s));
+	if (fs->fs_dcache == NULL) {
+		return -ENOMEM;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_release
+ ****************************************************************************/
+
+void smartfs_dcache_release(struct smartfs_mountpt_s *fs)
+{
+	if (fs->fs_dcache != NULL) {
+		kmm_free(fs->fs_dcache);
+		fs->fs_dcache = NULL;
+	}
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_lookup
+ *
+ * Description: Looks up name in the directory starting at sector parent.
+ *              Returns OK with the entry filled in (but for its name and
+ *              length) if the name is cached, -ENOENT if it is cached as
+ *              not existing, or -ENODATA if the directory must be read.
+ *
+ ****************************************************************************/
+
+int smartfs_dcache_lookup(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name, struct smartfs_entry_s *entry)
+{
+	FAR struct smartfs_dcache_s *dcache;
+
+	if (fs->fs_dcache == NULL) {
+		return -ENODATA;
+	}
+
+	dcache = smartfs_dcache_find(fs, parent, name);
+	if (dcache == NULL) {
+		return -ENODATA;
+	}
+
+	dcache->age = ++fs->fs_dcacheage;
+	if (dcache->dsector == DCACHE_NEGATIVE) {
+		return -ENOENT;
+	}
+
+	entry->firstsector = dcache->firstsector;
+	entry->dsector = dcache->dsector;
+	entry->doffset = dcache->doffset;
+	entry->dfirst = parent;
+	entry->flags = dcache->flags;
+	entry->utc = dcache->utc;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_add
+ *
+ * Description: Records the result of reading the directory at sector
+ *              parent for name: the entry found, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_add(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name, const struct smartfs_entry_s *entry)
+{
+	FAR struct smartfs_dcache_s *dcache;
+	FAR struct smartfs_dcache_s *victim;
+	size_t len;
+	int x;
+
+	if (fs->fs_dcache == NULL) {
+		return;
+	}
+
+	/* Take a free slot, or the one used least recently */
+
+	victim = &fs->fs_dcache[0];
+	for (x = 0; x < CONFIG_SMARTFS_DCACHE_ENTRIES && victim->age != 0; x++) {
+		dcache = &fs->fs_dcache[x];
+		if (dcache->age < victim->age) {
+			victim = dcache;
+		}
+	}
+
+	len = smartfs_dcache_namelen(fs, name);
+	victim->age = ++fs->fs_dcacheage;
+	victim->parent = parent;
+	victim->hash = smartfs_dcache_hash(name, len);
+	memcpy(victim->name, name, len);
+	victim->name[len] = '\0';
+
+	if (entry == NULL) {
+		victim->dsector = DCACHE_NEGATIVE;
+		return;
+	}
+
+	victim->firstsector = entry->firstsector;
+	victim->dsector = entry->dsector;
+	victim->doffset = entry->doffset;
+	victim->flags = entry->flags;
+	victim->utc = entry->utc;
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_forget
+ *
+ * Description: Drops what is cached about name in the directory at sector
+ *              parent.  Called when an entry is created there.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_forget(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name)
+{
+	FAR struct smartfs_dcache_s *dcache;
+
+	if (fs->fs_dcache == NULL) {
+		return;
+	}
+
+	dcache = smartfs_dcache_find(fs, parent, name);
+	if (dcache != NULL) {
+		dcache->age = 0;
+	}
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_remove
+ *
+ * Description: Drops the cached entry for the directory entry at the given
+ *              sector and offset.  Called when it is deleted or renamed.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_remove(struct smartfs_mountpt_s *fs, uint16_t dsector, uint16_t doffset)
+{
+	int x;
+
+	if (fs->fs_dcache == NULL) {
+		return;
+	}
+
+	for (x = 0; x < CONFIG_SMARTFS_DCACHE_ENTRIES; x++) {
+		if (fs->fs_dcache[x].dsector == dsector && fs->fs_dcache[x].doffset == doffset) {
+			fs->fs_dcache[x].age = 0;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_purgedir
+ *
+ * Description: Drops everything cached about the contents of the directory
+ *              at sector dirsector.  Called when the directory is deleted,
+ *              as its sector may be reused for another one.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_purgedir(struct smartfs_mountpt_s *fs, uint16_t dirsector)
+{
+	int x;
+
+	if (fs->fs_dcache == NULL) {
+		return;
+	}
+
+	for (x = 0; x < CONFIG_SMARTFS_DCACHE_ENTRIES; x++) {
+		if (fs->fs_dcache[x].parent == dirsector) {
+			fs->fs_dcache[x].age = 0;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_flush
+ *
+ * Description: Empties the cache.  Used when directories are changed behind
+ *              its back, such as by journal replay or sector recovery.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_flush(struct smartfs_mountpt_s *fs)
+{
+	if (fs->fs_dcache != NULL) {
+		memset(fs->fs_dcache, 0, CONFIG_SMARTFS_DCACHE_ENTRIES * sizeof(struct smartfs_dcache_s));
+	}
+}
+
+#endif							/* CONFIG_SMARTFS_DCACHE */
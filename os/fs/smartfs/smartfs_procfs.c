@@ -751,7 +751,7 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer, size
 
 		if (ret == OK) {
 			/* Format and return data in the buffer */
-			len = snprintf(buffer, buflen, "Total Sectors    %d\nFree Sectors     %d\n" "Released Sectors %d\n", procfs_data.totalsectors, procfs_data.freesectors, procfs_data.releasesectors);
+			len = snprintf(buffer, buflen, "Total Sectors    %d\nFree Sectors     %d\n" "Released Sectors %d\nBlock Erases     %d\n", procfs_data.totalsectors, procfs_data.freesectors, procfs_data.releasesectors, procfs_data.blockerases);
 #ifdef CONFIG_DEBUG_FS
 			/* Calculate the sector utilization percentage */
 			if (procfs_data.blockerases == 0) {
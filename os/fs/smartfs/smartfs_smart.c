@@ -75,6 +75,10 @@
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/fs/mtd.h>
 #include <tinyara/fs/smart.h>
+#ifdef CONFIG_SMARTFS_WRITEBACK
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+#endif
 
 #include "smartfs.h"
 
@@ -116,6 +120,10 @@ static int smartfs_stat(struct inode *mountpt, const char *relpath, struct stat
 
 static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf, off_t offset, int whence);
 
+#ifdef CONFIG_SMARTFS_WRITEBACK
+static void smartfs_writeback_worker(FAR void *arg);
+#endif
+
 /****************************************************************************
  * Private Variables
  ****************************************************************************/
@@ -123,6 +131,15 @@ static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs, struct smartfs_
 static uint8_t g_seminitialized = FALSE;
 static sem_t g_sem;
 
+#ifdef CONFIG_SMARTFS_WRITEBACK
+/* Files open for writing on any mount, and the timed flush of their
+ * buffered data.  Both are protected by g_sem, which all mounts share.
+ */
+
+static FAR struct smartfs_ofile_s *g_wbfiles;
+static struct work_s g_wbwork;
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -221,6 +238,20 @@ static int smartfs_open(FAR struct file *filep, const char *relpath, int oflags,
 	sf->bflags = 0;
 #endif							/* CONFIG_SMARTFS_USE_SECTOR_BUFFER */
 
+#ifdef CONFIG_SMARTFS_WRITEBACK
+	/* Allocate a buffer for appended data if opened for writing */
+
+	sf->wbuffer = NULL;
+	if ((oflags & O_WROK) != 0) {
+		sf->wbuffer = (uint8_t *)kmm_malloc(fs->fs_llformat.availbytes);
+		if (sf->wbuffer == NULL) {
+			kmm_free(sf);
+			ret = -ENOMEM;
+			goto errout_with_semaphore;
+		}
+	}
+#endif
+
 	sf->entry.name = NULL;
 	ret = smartfs_finddirentry(fs, &sf->entry, relpath, &parentdirsector, &filename);
 
@@ -341,6 +372,14 @@ static int smartfs_open(FAR struct file *filep, const char *relpath, int oflags,
 	sf->fnext = fs->fs_head;
 	fs->fs_head = sf;
 
+#ifdef CONFIG_SMARTFS_WRITEBACK
+	if (sf->wbuffer != NULL) {
+		sf->wbfs = fs;
+		sf->wbnext = g_wbfiles;
+		g_wbfiles = sf;
+	}
+#endif
+
 	ret = OK;
 	goto errout_with_semaphore;
 
@@ -351,6 +390,11 @@ errout_with_buffer:
 		kmm_free(sf->entry.name);
 		sf->entry.name = NULL;
 	}
+#ifdef CONFIG_SMARTFS_WRITEBACK
+	if (sf->wbuffer != NULL) {
+		kmm_free(sf->wbuffer);
+	}
+#endif
 
 	kmm_free(sf);
 
@@ -443,6 +487,24 @@ static int smartfs_close(FAR struct file *filep)
 		kmm_free(sf->buffer);
 	}
 #endif
+#ifdef CONFIG_SMARTFS_WRITEBACK
+	if (sf->wbuffer != NULL) {
+		/* Take ourselves off the list of files the timed flush visits */
+
+		if (g_wbfiles == sf) {
+			g_wbfiles = sf->wbnext;
+		} else {
+			for (nextfile = g_wbfiles; nextfile != NULL; nextfile = nextfile->wbnext) {
+				if (nextfile->wbnext == sf) {
+					nextfile->wbnext = sf->wbnext;
+					break;
+				}
+			}
+		}
+
+		kmm_free(sf->wbuffer);
+	}
+#endif
 
 	kmm_free(sf);
 
@@ -592,6 +654,9 @@ static int smartfs_sync_internal(struct smartfs_mountpt_s *fs, struct smartfs_of
 	uint16_t used_bytes;
 	uint16_t t_sector, t_offset;
 #endif
+#ifdef CONFIG_SMARTFS_WRITEBACK
+	struct smart_read_write_s wbwrite;
+#endif
 
 #ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
 	if (sf->bflags & SMARTFS_BFLAG_DIRTY) {
@@ -674,13 +739,34 @@ static int smartfs_sync_internal(struct smartfs_mountpt_s *fs, struct smartfs_of
 #ifdef CONFIG_SMARTFS_JOURNALING
 		used_bytes = ((header->used[0] & 0x00FF) | (header->used[1] & 0x00FF) << 8);
 
+#ifdef CONFIG_SMARTFS_WRITEBACK
+		/* The buffered data and the new used count are one transaction,
+		 * however many writes the data came from.  Recovery rewrites the
+		 * data and then the used count, as for an appending T_WRITE.
+		 */
+
+		wbwrite.logsector = sf->currsector;
+		wbwrite.offset = sf->curroffset - sf->byteswritten;
+		wbwrite.count = sf->byteswritten;
+		wbwrite.buffer = &sf->wbuffer[wbwrite.offset];
+
+		ret = smartfs_create_journalentry(fs, T_SYNC, wbwrite.logsector, wbwrite.offset, wbwrite.count, used_bytes, 1, wbwrite.buffer, &t_sector, &t_offset);
+#else
 		ret = smartfs_create_journalentry(fs, T_SYNC, readwrite.logsector, readwrite.offset, 0, used_bytes, 1, NULL, &t_sector, &t_offset);
+#endif
 		if (ret != OK) {
 			fdbg("Journal entry creation failed.\n");
 			goto errout;
 		}
 #endif
+#ifdef CONFIG_SMARTFS_WRITEBACK
+		ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&wbwrite);
+		if (ret >= 0) {
+			ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&readwrite);
+		}
+#else
 		ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&readwrite);
+#endif
 #ifdef CONFIG_SMARTFS_JOURNALING
 		retj = smartfs_finish_journalentry(fs, readwrite.logsector, t_sector, t_offset, T_SYNC);
 		if (retj != OK) {
@@ -861,6 +947,17 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 		memcpy(&sf->buffer[sf->curroffset], &buffer[byteswritten], readwrite.count);
 		sf->bflags |= SMARTFS_BFLAG_DIRTY;
 
+#elif defined(CONFIG_SMARTFS_WRITEBACK)
+		/* Just collect the data; smartfs_sync_internal() writes it */
+
+		readwrite.logsector = sf->currsector;
+		readwrite.count = fs->fs_llformat.availbytes - sf->curroffset;
+		if (readwrite.count > buflen) {
+			readwrite.count = buflen;
+		}
+
+		memcpy(&sf->wbuffer[sf->curroffset], &buffer[byteswritten], readwrite.count);
+
 #else							/* CONFIG_SMARTFS_USE_SECTOR_BUFFER */
 		readwrite.offset = sf->curroffset;
 		readwrite.logsector = sf->currsector;
@@ -1009,6 +1106,14 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 #endif							/* CONFIG_SMARTFS_USE_SECTOR_BUFFER */
 	}
 
+#ifdef CONFIG_SMARTFS_WRITEBACK
+	/* Flush whatever is still buffered after SMARTFS_WRITEBACK_MS */
+
+	if (sf->byteswritten > 0 && work_available(&g_wbwork)) {
+		work_queue(LPWORK, &g_wbwork, smartfs_writeback_worker, NULL, MSEC2TICK(CONFIG_SMARTFS_WRITEBACK_MS));
+	}
+#endif
+
 	ret = byteswritten;
 
 errout_with_semaphore:
@@ -1016,6 +1121,34 @@ errout_with_semaphore:
 	return ret;
 }
 
+#ifdef CONFIG_SMARTFS_WRITEBACK
+/****************************************************************************
+ * Name: smartfs_writeback_worker
+ *
+ * Description: Runs on the low priority work queue SMARTFS_WRITEBACK_MS
+ *   after data was first left in a file's buffer, and flushes every file
+ *   with buffered data, on all mounts, in one pass.
+ *
+ ****************************************************************************/
+
+static void smartfs_writeback_worker(FAR void *arg)
+{
+	FAR struct smartfs_ofile_s *sf;
+
+	while (sem_wait(&g_sem) != 0) {
+		ASSERT(*get_errno_ptr() == EINTR);
+	}
+
+	for (sf = g_wbfiles; sf != NULL; sf = sf->wbnext) {
+		if (sf->byteswritten > 0) {
+			smartfs_sync_internal(sf->wbfs, sf);
+		}
+	}
+
+	sem_post(&g_sem);
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_seek_internal
  *
@@ -2074,6 +2207,9 @@ int smartfs_rename(struct inode *mountpt, const char *oldrelpath, const char *ne
 		readwrite.count = sizeof(uint16_t);
 		readwrite.buffer = (uint8_t *)tmp_pntr;
 		ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&readwrite);
+#ifdef CONFIG_SMARTFS_DCACHE
+		smartfs_dcache_remove(fs, oldentry.dsector, oldentry.doffset);
+#endif
 #ifdef CONFIG_SMARTFS_JOURNALING
 		retj = smartfs_finish_journalentry(fs, 0, t_sector, t_offset, T_RENAME);
 		if (retj != OK) {
@@ -588,6 +588,13 @@ int smartfs_mount(struct smartfs_mountpt_s *fs, bool writeable)
 	fs->fs_workbuffer = (char *)kmm_malloc(256);
 	fs->fs_rootsector = SMARTFS_ROOT_DIR_SECTOR;
 
+#ifdef CONFIG_SMARTFS_DCACHE
+	ret = smartfs_dcache_init(fs);
+	if (ret != OK) {
+		goto errout;
+	}
+#endif
+
 	/* We did it! */
 
 	fs->fs_mounted = TRUE;
@@ -732,6 +739,10 @@ int smartfs_unmount(struct smartfs_mountpt_s *fs)
 	kmm_free(fs->fs_workbuffer);
 #endif
 
+#ifdef CONFIG_SMARTFS_DCACHE
+	smartfs_dcache_release(fs);
+#endif
+
 	return ret;
 }
 
@@ -765,6 +776,7 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 	struct smartfs_chain_header_s *header;
 	struct smart_read_write_s readwrite;
 	struct smartfs_entry_header_s *entry;
+	struct smartfs_entry_s found;
 #ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
 	int used_value;
 #endif
@@ -838,6 +850,15 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 		} else {
 			/* Search for the entry in the current directory */
 
+#ifdef CONFIG_SMARTFS_DCACHE
+			ret = smartfs_dcache_lookup(fs, dirstack[depth], fs->fs_workbuffer, &found);
+			if (ret == OK) {
+				goto found;
+			} else if (ret == -ENOENT) {
+				goto notfound;
+			}
+#endif
+
 			dirsector = dirstack[depth];
 
 			/* Read the directory */
@@ -886,153 +907,146 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 					/* Test if the name matches */
 
 					if (strncmp(entry->name, fs->fs_workbuffer, fs->fs_llformat.namesize) == 0) {
-						/* We found it!  If this is the last segment entry,
-						 * then report the entry.  If it isn't the last
-						 * entry, then validate it is a directory entry and
-						 * open it and continue searching.
+						/* We found it!  Remember where it is and what it
+						 * points to.
 						 */
 
-						if (*ptr == '\0') {
-							/* We are at the last segment.  Report the entry */
-
-							/* Fill in the entry */
-
 #ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
-							direntry->firstsector = smartfs_rdle16(&entry->firstsector);
-							direntry->flags = smartfs_rdle16(&entry->flags);
-							direntry->utc = smartfs_rdle32(&entry->utc);
+						found.firstsector = smartfs_rdle16(&entry->firstsector);
+						found.flags = smartfs_rdle16(&entry->flags);
+						found.utc = smartfs_rdle32(&entry->utc);
 #else
-							direntry->firstsector = entry->firstsector;
-							direntry->flags = entry->flags;
-							direntry->utc = entry->utc;
+						found.firstsector = entry->firstsector;
+						found.flags = entry->flags;
+						found.utc = entry->utc;
 #endif
-							direntry->dsector = readwrite.logsector;
-							direntry->doffset = offset;
-							direntry->dfirst = dirstack[depth];
-							if (direntry->name == NULL) {
-								direntry->name = (char *)kmm_malloc(fs->fs_llformat.namesize + 1);
-								if (direntry->name == NULL) {
-									ret = ERROR;
-									goto errout;
-								}
-							}
+						found.dsector = readwrite.logsector;
+						found.doffset = offset;
+						found.dfirst = dirstack[depth];
+						break;
+					}
 
-							memset(direntry->name, 0, fs->fs_llformat.namesize + 1);
-							strncpy(direntry->name, entry->name, fs->fs_llformat.namesize);
-							direntry->datlen = 0;
+					/* Not this entry.  Skip to the next one */
 
-							/* Scan the file's sectors to calculate the length and perform
-							 * a rudimentary check.
-							 */
+					offset += entrysize;
+					entry = (struct smartfs_entry_header_s *)
+							&fs->fs_rwbuffer[offset];
+				}
 
-#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
-							if ((smartfs_rdle16(&entry->flags) & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_FILE) {
-								dirsector = smartfs_rdle16(&entry->firstsector);
-#else
-							if ((entry->flags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_FILE) {
-								dirsector = entry->firstsector;
-#endif
-								readwrite.count = sizeof(struct smartfs_chain_header_s);
-								readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
-								readwrite.offset = 0;
-
-								while (dirsector != SMARTFS_ERASEDSTATE_16BIT) {
-									/* Read the next sector of the file */
-
-									readwrite.logsector = dirsector;
-									ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
-									if (ret < 0) {
-										fdbg("Error in sector chain at %d!\n", dirsector);
-										break;
-									}
-#ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
-									if (SMARTFS_NEXTSECTOR(header) == SMARTFS_ERASEDSTATE_16BIT) {
-
-										readwrite.count = fs->fs_llformat.availbytes;
-										readwrite.buffer = (uint8_t *)fs->fs_chunk_buffer;
-
-										ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
-										if (ret < 0) {
-											fdbg("Error %d reading sector %d header\n", ret, sf->currsector);
-											break;
-										}
-										used_value = get_leftover_used_byte_count((uint8_t *)readwrite.buffer, get_used_byte_count((uint8_t *)header->used));
-										direntry->datlen += used_value;
-									} else {
-										direntry->datlen += (fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s));
-									}
-									readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
-#else
-									/* Add used bytes to the total and point to next sector */
-									if (SMARTFS_USED(header) != SMARTFS_ERASEDSTATE_16BIT) {
-										direntry->datlen += SMARTFS_USED(header);
-									}
+				/* Test if a directory entry was found and break if it was */
+
+				if (offset < readwrite.count) {
+					break;
+				}
+			}
+
+			if (offset < readwrite.count) {
+#ifdef CONFIG_SMARTFS_DCACHE
+				smartfs_dcache_add(fs, dirstack[depth], fs->fs_workbuffer, &found);
+found:
 #endif
-									dirsector = SMARTFS_NEXTSECTOR(header);
-								}
-							}
+				/* If this is the last segment entry, then report the entry.
+				 * If it isn't the last entry, then validate it is a
+				 * directory entry and open it and continue searching.
+				 */
 
-							*parentdirsector = dirstack[depth];
-							*filename = segment;
-							ret = OK;
+				if (*ptr == '\0') {
+					/* We are at the last segment.  Report the entry */
+
+					direntry->firstsector = found.firstsector;
+					direntry->flags = found.flags;
+					direntry->utc = found.utc;
+					direntry->dsector = found.dsector;
+					direntry->doffset = found.doffset;
+					direntry->dfirst = found.dfirst;
+					if (direntry->name == NULL) {
+						direntry->name = (char *)kmm_malloc(fs->fs_llformat.namesize + 1);
+						if (direntry->name == NULL) {
+							ret = ERROR;
 							goto errout;
-						} else {
-							/* Validate it's a directory */
+						}
+					}
 
-#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
-							if ((smartfs_rdle16(&entry->flags) & SMARTFS_DIRENT_TYPE) != SMARTFS_DIRENT_TYPE_DIR)
-#else
-							if ((entry->flags & SMARTFS_DIRENT_TYPE) != SMARTFS_DIRENT_TYPE_DIR)
-#endif
-							{
-								/* Not a directory!  Report the error */
+					memset(direntry->name, 0, fs->fs_llformat.namesize + 1);
+					strncpy(direntry->name, fs->fs_workbuffer, fs->fs_llformat.namesize);
+					direntry->datlen = 0;
 
-								ret = -ENOTDIR;
-								goto errout;
-							}
+					/* Scan the file's sectors to calculate the length and perform
+					 * a rudimentary check.
+					 */
 
-							/* "Push" the directory and continue searching */
+					if ((found.flags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_FILE) {
+						dirsector = found.firstsector;
+						header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
+						readwrite.count = sizeof(struct smartfs_chain_header_s);
+						readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
+						readwrite.offset = 0;
+
+						while (dirsector != SMARTFS_ERASEDSTATE_16BIT) {
+							/* Read the next sector of the file */
+
+							readwrite.logsector = dirsector;
+							ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+							if (ret < 0) {
+								fdbg("Error in sector chain at %d!\n", dirsector);
+								break;
+							}
+#ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
+							if (SMARTFS_NEXTSECTOR(header) == SMARTFS_ERASEDSTATE_16BIT) {
 
-							if (depth >= CONFIG_SMARTFS_DIRDEPTH - 1) {
-								/* Directory depth too big */
+								readwrite.count = fs->fs_llformat.availbytes;
+								readwrite.buffer = (uint8_t *)fs->fs_chunk_buffer;
 
-								ret = -ENAMETOOLONG;
-								goto errout;
+								ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+								if (ret < 0) {
+									fdbg("Error %d reading sector %d header\n", ret, sf->currsector);
+									break;
+								}
+								used_value = get_leftover_used_byte_count((uint8_t *)readwrite.buffer, get_used_byte_count((uint8_t *)header->used));
+								direntry->datlen += used_value;
+							} else {
+								direntry->datlen += (fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s));
 							}
-#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
-							dirstack[++depth] = smartfs_rdle16(&entry->firstsector);
+							readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
 #else
-							dirstack[++depth] = entry->firstsector;
+							/* Add used bytes to the total and point to next sector */
+							if (SMARTFS_USED(header) != SMARTFS_ERASEDSTATE_16BIT) {
+								direntry->datlen += SMARTFS_USED(header);
+							}
 #endif
-							segment = ptr + 1;
-							break;
+							dirsector = SMARTFS_NEXTSECTOR(header);
 						}
 					}
 
-					/* Not this entry.  Skip to the next one */
-
-					offset += entrysize;
-					entry = (struct smartfs_entry_header_s *)
-							&fs->fs_rwbuffer[offset];
+					*parentdirsector = dirstack[depth];
+					*filename = segment;
+					ret = OK;
+					goto errout;
 				}
 
-				/* Test if a directory entry was found and break if it was */
+				/* Validate it's a directory */
 
-				if (offset < readwrite.count) {
-					break;
+				if ((found.flags & SMARTFS_DIRENT_TYPE) != SMARTFS_DIRENT_TYPE_DIR) {
+					/* Not a directory!  Report the error */
+
+					ret = -ENOTDIR;
+					goto errout;
 				}
-			}
 
-			/* If we found a dir entry, then continue searching */
+				/* "Push" the directory and continue searching */
 
-			if (offset < readwrite.count) {
-				/* Update the segment pointer */
+				if (depth >= CONFIG_SMARTFS_DIRDEPTH - 1) {
+					/* Directory depth too big */
 
-				if (*ptr != '\0') {
-					ptr++;
+					ret = -ENAMETOOLONG;
+					goto errout;
 				}
 
-				segment = ptr;
+				dirstack[++depth] = found.firstsector;
+
+				/* Update the segment pointer */
+
+				segment = ptr + 1;
 				continue;
 			}
 
@@ -1040,6 +1054,10 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 			 * segment, then report the parent directory sector.
 			 */
 
+#ifdef CONFIG_SMARTFS_DCACHE
+			smartfs_dcache_add(fs, dirstack[depth], fs->fs_workbuffer, NULL);
+notfound:
+#endif
 			if (*ptr == '\0') {
 				*parentdirsector = dirstack[depth];
 				*filename = segment;
@@ -1292,6 +1310,12 @@ int smartfs_createentry(struct smartfs_mountpt_s *fs, uint16_t parentdirsector,
 	memset(direntry->name, 0, fs->fs_llformat.namesize + 1);
 	strncpy(direntry->name, filename, fs->fs_llformat.namesize);
 
+#ifdef CONFIG_SMARTFS_DCACHE
+	/* The name may have been looked up and cached as missing */
+
+	smartfs_dcache_forget(fs, parentdirsector, filename);
+#endif
+
 	ret = OK;
 
 errout:
@@ -1321,6 +1345,17 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *en
 	struct smartfs_chain_header_s *header;
 	struct smart_read_write_s readwrite;
 
+#ifdef CONFIG_SMARTFS_DCACHE
+	/* Forget the entry, and the contents of a directory, whether or not
+	 * the delete below completes.
+	 */
+
+	smartfs_dcache_remove(fs, entry->dsector, entry->doffset);
+	if ((entry->flags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_DIR) {
+		smartfs_dcache_purgedir(fs, entry->firstsector);
+	}
+#endif
+
 	/* Okay, delete the file.  Loop through each sector and release them
 
 	 * TODO:  We really should walk the list backward to avoid lost
@@ -1877,6 +1912,10 @@ int smartfs_recover(struct inode *mountpt)
 	fdbg("Obsoleted Sectors : %d\n", nobsolete);
 	fdbg("Recovered Sectors : %d\n\n", nrecovered);
 
+#ifdef CONFIG_SMARTFS_DCACHE
+	smartfs_dcache_flush(fs);
+#endif
+
 errout_with_semaphore:
 	smartfs_semgive(fs);
 	if (validsectors) {
@@ -2017,6 +2056,12 @@ int smartfs_journal_init(struct smartfs_mountpt_s *fs)
 				fdbg("restore_write_transactions failed, but clean journal area\n");
 			}
 		}
+
+#ifdef CONFIG_SMARTFS_DCACHE
+		/* Replayed renames changed directories behind the lookup cache */
+
+		smartfs_dcache_flush(fs);
+#endif
 	}
 
 	/* Clear all the logging sectors */
@@ -0,0 +1,450 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_eventfd.c
+ *
+ *   An eventfd descriptor is a 64-bit counter behind a driver inode.  It
+ *   is the cheapest object a task can both block on with read() and wait
+ *   for together with sockets and other files in poll() or select().
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/eventfd.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <semaphore.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/fs/fs.h>
+
+#include <arch/irq.h>
+
+#ifdef CONFIG_EVENT_FD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EVENT_FD_NPOLLWAITERS
+#define CONFIG_EVENT_FD_NPOLLWAITERS 2
+#endif
+
+/* The largest value the counter may hold */
+
+#define EFD_MAXCOUNT      ((eventfd_t)0xfffffffffffffffeull)
+
+/* Length of "/dev/efdNNNNN" plus terminator */
+
+#define EFD_DEVNAME_LEN   16
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct eventfd_dev_s {
+	eventfd_t counter;			/* Current value of the counter */
+	sem_t rdsem;				/* Readers wait here for a non-zero counter */
+	sem_t wrsem;				/* Writers wait here for room in the counter */
+	uint8_t crefs;				/* Number of open references */
+	bool semaphore;				/* EFD_SEMAPHORE read semantics */
+#ifndef CONFIG_DISABLE_POLL
+	FAR struct pollfd *fds[CONFIG_EVENT_FD_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int eventfd_open(FAR struct file *filep);
+static int eventfd_close(FAR struct file *filep);
+static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static ssize_t eventfd_do_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
+#ifndef CONFIG_DISABLE_POLL
+static int eventfd_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_eventfd_fops = {
+	eventfd_open,				/* open */
+	eventfd_close,				/* close */
+	eventfd_do_read,			/* read */
+	eventfd_do_write,			/* write */
+	0,							/* seek */
+	0,							/* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+	eventfd_poll,				/* poll */
+#endif
+	0							/* unlink */
+};
+
+/* Minor number of the next eventfd inode.  Inodes are unlinked as soon as
+ * they are opened, so the name only has to be unique for that moment.
+ */
+
+static uint16_t g_eventfd_minor;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: eventfd_wakeall
+ *
+ * Description:
+ *   Wake up every task waiting on the semaphore; each re-checks the counter.
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void eventfd_wakeall(FAR sem_t *sem)
+{
+	int sval;
+
+	while (sem_getvalue(sem, &sval) == OK && sval < 0) {
+		sem_post(sem);
+	}
+}
+
+/****************************************************************************
+ * Name: eventfd_pollnotify
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void eventfd_pollnotify(FAR struct eventfd_dev_s *dev, pollevent_t eventset)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_EVENT_FD_NPOLLWAITERS; i++) {
+		FAR struct pollfd *fds = dev->fds[i];
+		if (fds) {
+			fds->revents |= (fds->events & eventset);
+			if (fds->revents != 0) {
+				fvdbg("Report events: %02x\n", fds->revents);
+				sem_post(fds->sem);
+			}
+		}
+	}
+}
+#else
+#define eventfd_pollnotify(dev, event)
+#endif
+
+/****************************************************************************
+ * Name: eventfd_open
+ ****************************************************************************/
+
+static int eventfd_open(FAR struct file *filep)
+{
+	FAR struct eventfd_dev_s *dev = filep->f_inode->i_private;
+	irqstate_t flags;
+	int ret = OK;
+
+	flags = irqsave();
+	if (dev->crefs == UINT8_MAX) {
+		ret = -EMFILE;
+	} else {
+		dev->crefs++;
+	}
+	irqrestore(flags);
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: eventfd_close
+ ****************************************************************************/
+
+static int eventfd_close(FAR struct file *filep)
+{
+	FAR struct eventfd_dev_s *dev = filep->f_inode->i_private;
+	irqstate_t flags;
+	bool last;
+
+	flags = irqsave();
+	DEBUGASSERT(dev->crefs > 0);
+	last = (--dev->crefs == 0);
+	irqrestore(flags);
+
+	/* The inode was unlinked when the descriptor was created and goes away
+	 * together with its last reference; the counter goes with it.
+	 */
+
+	if (last) {
+		sem_destroy(&dev->rdsem);
+		sem_destroy(&dev->wrsem);
+		kmm_free(dev);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_do_read
+ ****************************************************************************/
+
+static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct eventfd_dev_s *dev = filep->f_inode->i_private;
+	irqstate_t flags;
+	eventfd_t value;
+
+	if (buflen < sizeof(eventfd_t)) {
+		return -EINVAL;
+	}
+
+	flags = irqsave();
+	while (dev->counter == 0) {
+		if ((filep->f_oflags & O_NONBLOCK) != 0) {
+			irqrestore(flags);
+			return -EAGAIN;
+		}
+
+		if (sem_wait(&dev->rdsem) < 0) {
+			irqrestore(flags);
+			return -get_errno();
+		}
+	}
+
+	if (dev->semaphore) {
+		value = 1;
+		dev->counter--;
+	} else {
+		value = dev->counter;
+		dev->counter = 0;
+	}
+
+	/* There is room in the counter again */
+
+	eventfd_wakeall(&dev->wrsem);
+	eventfd_pollnotify(dev, POLLOUT);
+	irqrestore(flags);
+
+	memcpy(buffer, &value, sizeof(eventfd_t));
+	return sizeof(eventfd_t);
+}
+
+/****************************************************************************
+ * Name: eventfd_do_write
+ ****************************************************************************/
+
+static ssize_t eventfd_do_write(FAR struct file *filep, FAR const char *buffer, size_t buflen)
+{
+	FAR struct eventfd_dev_s *dev = filep->f_inode->i_private;
+	irqstate_t flags;
+	eventfd_t value;
+
+	if (buflen < sizeof(eventfd_t)) {
+		return -EINVAL;
+	}
+
+	memcpy(&value, buffer, sizeof(eventfd_t));
+	if (value > EFD_MAXCOUNT) {
+		return -EINVAL;
+	}
+
+	flags = irqsave();
+	while (value > EFD_MAXCOUNT - dev->counter) {
+		if ((filep->f_oflags & O_NONBLOCK) != 0) {
+			irqrestore(flags);
+			return -EAGAIN;
+		}
+
+		if (sem_wait(&dev->wrsem) < 0) {
+			irqrestore(flags);
+			return -get_errno();
+		}
+	}
+
+	dev->counter += value;
+	if (dev->counter > 0) {
+		eventfd_wakeall(&dev->rdsem);
+		eventfd_pollnotify(dev, POLLIN);
+	}
+	irqrestore(flags);
+
+	return sizeof(eventfd_t);
+}
+
+/****************************************************************************
+ * Name: eventfd_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int eventfd_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
+{
+	FAR struct eventfd_dev_s *dev = filep->f_inode->i_private;
+	FAR struct pollfd **slot;
+	pollevent_t eventset;
+	irqstate_t flags;
+	int ret = OK;
+	int i;
+
+	flags = irqsave();
+	if (setup) {
+		/* Find an available slot for the poll structure reference */
+
+		for (i = 0; i < CONFIG_EVENT_FD_NPOLLWAITERS; i++) {
+			if (!dev->fds[i]) {
+				dev->fds[i] = fds;
+				fds->priv = &dev->fds[i];
+				break;
+			}
+		}
+
+		if (i >= CONFIG_EVENT_FD_NPOLLWAITERS) {
+			fds->priv = NULL;
+			ret = -EBUSY;
+			goto errout;
+		}
+
+		/* Notify at once if the counter is already readable or writable */
+
+		eventset = 0;
+		if (dev->counter < EFD_MAXCOUNT) {
+			eventset |= POLLOUT;
+		}
+
+		if (dev->counter > 0) {
+			eventset |= POLLIN;
+		}
+
+		if (eventset) {
+			eventfd_pollnotify(dev, eventset);
+		}
+	} else {
+		/* This is a request to tear down the poll. */
+
+		slot = (FAR struct pollfd **)fds->priv;
+		if (!slot) {
+			ret = -EIO;
+			goto errout;
+		}
+
+		*slot = NULL;
+		fds->priv = NULL;
+	}
+
+errout:
+	irqrestore(flags);
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: eventfd
+ *
+ * Description:
+ *   Create an event notification descriptor whose counter starts at
+ *   'count'.  See sys/eventfd.h.
+ *
+ * Return:
+ *   A new file descriptor on success; otherwise, -1 is returned with errno
+ *   set appropriately.
+ *
+ ****************************************************************************/
+
+int eventfd(unsigned int count, int flags)
+{
+	FAR struct eventfd_dev_s *dev;
+	char devname[EFD_DEVNAME_LEN];
+	irqstate_t irqflags;
+	uint16_t minor;
+	int err;
+	int ret;
+	int fd;
+
+	if ((flags & ~(EFD_SEMAPHORE | EFD_NONBLOCK | EFD_CLOEXEC)) != 0) {
+		err = EINVAL;
+		goto errout;
+	}
+
+	dev = (FAR struct eventfd_dev_s *)kmm_zalloc(sizeof(struct eventfd_dev_s));
+	if (!dev) {
+		err = ENOMEM;
+		goto errout;
+	}
+
+	dev->counter = count;
+	dev->semaphore = ((flags & EFD_SEMAPHORE) != 0);
+
+	/* The semaphores are only used for signalling */
+
+	sem_init(&dev->rdsem, 0, 0);
+	sem_setprotocol(&dev->rdsem, SEM_PRIO_NONE);
+	sem_init(&dev->wrsem, 0, 0);
+	sem_setprotocol(&dev->wrsem, SEM_PRIO_NONE);
+
+	irqflags = irqsave();
+	minor = g_eventfd_minor++;
+	irqrestore(irqflags);
+
+	snprintf(devname, EFD_DEVNAME_LEN, "/dev/efd%u", (unsigned int)minor);
+	ret = register_driver(devname, &g_eventfd_fops, 0666, (FAR void *)dev);
+	if (ret < 0) {
+		err = -ret;
+		goto errout_with_dev;
+	}
+
+	fd = open(devname, O_RDWR | (flags & EFD_NONBLOCK));
+	if (fd < 0) {
+		err = get_errno();
+		unregister_driver(devname);
+		goto errout_with_dev;
+	}
+
+	/* Nothing should find the counter by name: the inode lives on only
+	 * through the open descriptor and its dups.
+	 */
+
+	unregister_driver(devname);
+	return fd;
+
+errout_with_dev:
+	sem_destroy(&dev->rdsem);
+	sem_destroy(&dev->wrsem);
+	kmm_free(dev);
+
+errout:
+	set_errno(err);
+	return ERROR;
+}
+
+#endif							/* CONFIG_EVENT_FD */
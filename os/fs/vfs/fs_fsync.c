@@ -64,6 +64,7 @@
 #include <tinyara/sched.h>
 #include <tinyara/cancelpt.h>
 #include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
 
 #include "inode/inode.h"
 
@@ -117,6 +118,23 @@ int file_fsync(FAR struct file *filep)
 	 */
 
 	inode = filep->f_inode;
+
+	/* A driver is asked to write out what it buffers.  The block driver
+	 * proxy passes that on to the block driver it wraps.  A driver that
+	 * does not know BIOC_FLUSH (serial, pipes, ...) cannot be synced,
+	 * which fsync() reports as EINVAL.
+	 */
+
+	if (inode && INODE_IS_DRIVER(inode) && inode->u.i_ops && inode->u.i_ops->ioctl) {
+		ret = inode->u.i_ops->ioctl(filep, BIOC_FLUSH, 0);
+		if (ret >= 0) {
+			return OK;
+		}
+
+		ret = (ret == -ENOTTY) ? EINVAL : -ret;
+		goto errout;
+	}
+
 	if (!inode || !INODE_IS_MOUNTPT(inode) || !inode->u.i_mops || !inode->u.i_mops->sync) {
 		ret = EINVAL;
 		goto errout;
@@ -158,6 +158,24 @@ ssize_t mq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen, FAR int *prio
  */
 int mq_notify(mqd_t mqdes, const struct sigevent *notification);
 
+/**
+ * @brief  Send a message without copying it
+ * @details [SYSTEM CALL API]
+ *   Like mq_send(), but ownership of buf, which must come from malloc(),
+ *   passes to the receiver.  On failure the caller still owns it.
+ * @since Tizen RT v1.1
+ */
+int mq_sendref(mqd_t mqdes, FAR void *buf, size_t buflen, int prio);
+/**
+ * @brief  Receive a message without copying it
+ * @details [SYSTEM CALL API]
+ *   Like mq_receive(), but returns a heap buffer holding the message in
+ *   *bufref; it is the sender's buffer if the message was sent with
+ *   mq_sendref().  The caller must free() it.
+ * @since Tizen RT v1.1
+ */
+ssize_t mq_receiveref(mqd_t mqdes, FAR void **bufref, FAR int *prio);
+
 /**
  * @brief  POSIX APIs (refer to : http://pubs.opengroup.org/onlinepubs/9699919799/)
  * @since Tizen RT v1.0
@@ -306,6 +306,12 @@ struct netconn {
 	 * Also used during connect and close.
 	 */
 	struct api_msg *current_msg;
+#if LWIP_NETCONN_RX_COALESCE
+	/* TCP: pbuf posted to recvmbox but not yet fetched by the application;
+	 * further received data is appended to it (protected by SYS_ARCH_PROTECT)
+	 */
+	struct pbuf *rx_coalesce;
+#endif							/* LWIP_NETCONN_RX_COALESCE */
 #endif							/* LWIP_TCP */
 	/* A callback function that is informed about events for this netconn */
 	netconn_callback callback;
@@ -61,6 +61,7 @@
 #if LWIP_DNS
 
 #include <net/lwip/ip_addr.h>
+#include <net/lwip/err.h>
 
 #ifdef __cplusplus
 extern "C" {
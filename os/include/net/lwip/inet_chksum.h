@@ -82,7 +82,7 @@
 #ifndef LWIP_CHKSUM_COPY
 #define LWIP_CHKSUM_COPY(dst, src, len) lwip_chksum_copy(dst, src, len)
 #ifndef LWIP_CHKSUM_COPY_ALGORITHM
-#define LWIP_CHKSUM_COPY_ALGORITHM 1
+#define LWIP_CHKSUM_COPY_ALGORITHM 2
 #endif							/* LWIP_CHKSUM_COPY_ALGORITHM */
 #else							/* LWIP_CHKSUM_COPY */
 #define LWIP_CHKSUM_COPY_ALGORITHM 0
@@ -111,6 +111,7 @@ u16_t ip6_chksum_pseudo_partial(struct pbuf *p, u8_t proto, u16_t proto_len, u16
 
 u16_t ip_chksum_pseudo(struct pbuf *p, u8_t proto, u16_t proto_len, const ip_addr_t *src, const ip_addr_t *dest);
 u16_t ip_chksum_pseudo_partial(struct pbuf *p, u8_t proto, u16_t proto_len, u16_t chksum_len, const ip_addr_t *src, const ip_addr_t *dest);
+u16_t ip_chksum_pseudo_hdr(u8_t proto, u16_t proto_len, const ip_addr_t *src, const ip_addr_t *dest);
 
 #ifdef __cplusplus
 }
@@ -78,8 +78,12 @@ extern "C" {
 struct ip_reassdata {
 	struct ip_reassdata *next;
 	struct pbuf *p;
+	/* fragment with the highest offset, fragments mostly arrive in order */
+	struct pbuf *last;
 	struct ip_hdr iphdr;
 	u16_t datagram_len;
+	/* payload bytes received so far */
+	u16_t recv_len;
 	u8_t flags;
 	u8_t timer;
 };
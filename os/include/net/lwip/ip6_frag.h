@@ -98,9 +98,13 @@ extern "C" {
 struct ip6_reassdata {
 	struct ip6_reassdata *next;
 	struct pbuf *p;
+	/* fragment with the highest offset, fragments mostly arrive in order */
+	struct pbuf *last;
 	struct ip6_hdr IPV6_FRAG_HDRPTR iphdr;
 	u32_t identification;
 	u16_t datagram_len;
+	/* payload bytes received so far */
+	u16_t recv_len;
 	u8_t nexth;
 	u8_t timer;
 };
@@ -237,6 +237,11 @@
 #define IP_REASS_MAXAGE	               CONFIG_NET_IPV4_REASS_MAXAGE
 #endif
 
+/* if undefined, the value set in the lwip/opts.h */
+#ifdef CONFIG_NET_IP_REASS_HASH_SIZE
+#define IP_REASS_HASH_SIZE	           CONFIG_NET_IP_REASS_HASH_SIZE
+#endif
+
 /* if undefined, the value set in the lwip/opts.h */
 #ifdef CONFIG_NET_IP_DEFAULT_TTL
 #define IP_DEFAULT_TTL                 CONFIG_NET_IP_DEFAULT_TTL
@@ -433,6 +438,22 @@
 #define TCP_OVERSIZE	CONFIG_NET_TCP_OVERSIZE
 #endif
 
+#ifdef CONFIG_NET_TCP_COALESCE
+#define TCP_COALESCE	1
+#else
+#define TCP_COALESCE	0
+#endif
+
+#ifdef CONFIG_NET_TCP_RX_COALESCE
+#define LWIP_NETCONN_RX_COALESCE	1
+#else
+#define LWIP_NETCONN_RX_COALESCE	0
+#endif
+
+#ifdef CONFIG_NET_TCP_RX_COALESCE_MAX
+#define LWIP_NETCONN_RX_COALESCE_MAX	CONFIG_NET_TCP_RX_COALESCE_MAX
+#endif
+
 #ifdef CONFIG_NET_TCP_TIMESTAMPS
 #define TCP_TIMESTAMPS	1
 #else
@@ -498,6 +519,31 @@
 #endif
 /* ---------- SNMP options ---------- */
 
+/* ---------- Checksum options ---------- */
+
+#ifdef CONFIG_NET_LWIP_CHECKSUM_CTRL_PER_NETIF
+#define LWIP_CHECKSUM_CTRL_PER_NETIF	1
+#else
+#define LWIP_CHECKSUM_CTRL_PER_NETIF	0
+#endif
+
+#if defined(CONFIG_NET_LWIP_CHKSUM_ALGORITHM_4)
+#define LWIP_CHKSUM_ALGORITHM	4
+#elif defined(CONFIG_NET_LWIP_CHKSUM_ALGORITHM_3)
+#define LWIP_CHKSUM_ALGORITHM	3
+#elif defined(CONFIG_NET_LWIP_CHKSUM_ALGORITHM_2)
+#define LWIP_CHKSUM_ALGORITHM	2
+#endif
+
+#ifdef CONFIG_NET_LWIP_CHECKSUM_ON_COPY
+#define LWIP_CHECKSUM_ON_COPY	1
+#define LWIP_CHKSUM_COPY_ALGORITHM	2
+#else
+#define LWIP_CHECKSUM_ON_COPY	0
+#endif
+
+/* ---------- Checksum options ---------- */
+
 /* ---------- Memory options ---------- */
 
 #ifdef CONFIG_NET_MEM_ALIGNMENT
@@ -536,6 +582,15 @@
 #define MEMP_SEPARATE_POOLS	CONFIG_NET_MEMP_SEPARATE_POOLS
 #endif
 
+#ifdef CONFIG_NET_MEMP_GROW_FROM_HEAP
+#define MEMP_GROW_FROM_HEAP	1
+#define MEMP_GROW_SLAB_NUM	CONFIG_NET_MEMP_GROW_SLAB_NUM
+#define MEMP_GROW_MAX_SLABS	CONFIG_NET_MEMP_GROW_MAX_SLABS
+#define MEMP_GROW_IDLE_MS	CONFIG_NET_MEMP_GROW_IDLE_MS
+#else
+#define MEMP_GROW_FROM_HEAP	0
+#endif
+
 /* ---------- Memory options ---------- */
 
 /*---------- Interanl Memory Pool Sizes ----*/
@@ -583,8 +638,13 @@
 #endif
 
 #ifdef CONFIG_NET_MEMP_NUM_SYS_TIMEOUT
+#ifdef CONFIG_NET_MEMP_GROW_FROM_HEAP
+/* one more timeout for memp_tmr() */
+#define MEMP_NUM_SYS_TIMEOUT	(CONFIG_NET_MEMP_NUM_SYS_TIMEOUT + 1)
+#else
 #define MEMP_NUM_SYS_TIMEOUT	CONFIG_NET_MEMP_NUM_SYS_TIMEOUT
 #endif
+#endif
 
 #ifdef CONFIG_NET_MEMP_NUM_NETBUF
 #define MEMP_NUM_NETBUF	CONFIG_NET_MEMP_NUM_NETBUF
@@ -1079,6 +1139,12 @@
 #define MEMP_STATS	CONFIG_NET_MEMP_STATS
 #endif
 
+#ifdef CONFIG_NET_MEMP_STATS_OCCUPANCY
+#define MEMP_STATS_OCCUPANCY	1
+#else
+#define MEMP_STATS_OCCUPANCY	0
+#endif
+
 #ifdef CONFIG_NET_SYS_STATS
 #define SYS_STATS	CONFIG_NET_SYS_STATS
 #endif
@@ -1139,7 +1205,42 @@
 #endif
 
 #ifdef CONFIG_NET_DNS_SECURE
-#define LWIP_DNS_SECURE CONFIG_NET_DNS_SECURE
+#define LWIP_DNS_SECURE_LEVEL CONFIG_NET_DNS_SECURE
+#else
+#define LWIP_DNS_SECURE_LEVEL (LWIP_DNS_SECURE_RAND_XID | LWIP_DNS_SECURE_RAND_SRC_PORT)
+#endif
+
+/* Query coalescing is LWIP_DNS_SECURE_NO_MULTIPLE_OUTSTANDING */
+#ifdef CONFIG_NET_DNS_COALESCE
+#define LWIP_DNS_SECURE (LWIP_DNS_SECURE_LEVEL | LWIP_DNS_SECURE_NO_MULTIPLE_OUTSTANDING)
+#else
+#define LWIP_DNS_SECURE LWIP_DNS_SECURE_LEVEL
+#endif
+
+#ifdef CONFIG_NET_DNS_MAX_REQUESTS
+#define DNS_MAX_REQUESTS CONFIG_NET_DNS_MAX_REQUESTS
+#endif
+
+#ifdef CONFIG_NET_DNS_HASH_SIZE
+#define DNS_HASH_SIZE CONFIG_NET_DNS_HASH_SIZE
+#endif
+
+#ifdef CONFIG_NET_DNS_NEG_MAX_TTL
+#define DNS_NEG_MAX_TTL CONFIG_NET_DNS_NEG_MAX_TTL
+#endif
+
+#ifdef CONFIG_NET_DNS_PREFETCH_TTL
+#define DNS_PREFETCH_TTL CONFIG_NET_DNS_PREFETCH_TTL
+#endif
+
+#ifdef CONFIG_NET_DNS_PREFETCH_MIN_HITS
+#define DNS_PREFETCH_MIN_HITS CONFIG_NET_DNS_PREFETCH_MIN_HITS
+#endif
+
+#ifdef CONFIG_NET_DNS_STATS
+#define DNS_STATS CONFIG_NET_DNS_STATS
+#else
+#define DNS_STATS 0
 #endif
 
 #ifdef CONFIG_NET_DNS_MAX_TTL
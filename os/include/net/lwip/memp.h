@@ -109,6 +109,8 @@ LWIP_MEMPOOL_DECLARE_STATS_INSTANCE(memp_stats_ ## name) \
 	\
 static struct memp *memp_tab_ ## name; \
 	\
+LWIP_MEMPOOL_DECLARE_SLABS_INSTANCE(memp_slabs_ ## name) \
+	\
 const struct memp_desc memp_ ## name = { \
 	DECLARE_LWIP_MEMPOOL_DESC(desc) \
 	LWIP_MEMPOOL_DECLARE_STATS_REFERENCE(memp_stats_ ## name) \
@@ -116,6 +118,7 @@ const struct memp_desc memp_ ## name = { \
 	(num), \
 	memp_memory_ ## name ## _base, \
 	&memp_tab_ ## name \
+	LWIP_MEMPOOL_DECLARE_SLABS_REFERENCE(memp_slabs_ ## name) \
 };
 
 #endif							/* MEMP_MEM_MALLOC */
@@ -158,6 +161,10 @@ void *memp_malloc(memp_t type);
 #endif
 void memp_free(memp_t type, void *mem);
 
+#if MEMP_GROW_FROM_HEAP && !MEMP_MEM_MALLOC
+void memp_tmr(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
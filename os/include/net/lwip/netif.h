@@ -164,14 +164,24 @@ enum lwip_internal_netif_client_data_index {
 #define NETIF_CHECKSUM_GEN_TCP      0x0004
 #define NETIF_CHECKSUM_GEN_ICMP     0x0008
 #define NETIF_CHECKSUM_GEN_ICMP6    0x0010
+#define NETIF_CHECKSUM_PARTIAL_UDP  0x0020
+#define NETIF_CHECKSUM_PARTIAL_TCP  0x0040
 #define NETIF_CHECKSUM_CHECK_IP     0x0100
 #define NETIF_CHECKSUM_CHECK_UDP    0x0200
 #define NETIF_CHECKSUM_CHECK_TCP    0x0400
 #define NETIF_CHECKSUM_CHECK_ICMP   0x0800
 #define NETIF_CHECKSUM_CHECK_ICMP6  0x1000
-#define NETIF_CHECKSUM_ENABLE_ALL   0xFFFF
+/* partial checksum seeding is never enabled implicitly, see NETIF_SET_CHECKSUM_PARTIAL() */
+#define NETIF_CHECKSUM_ENABLE_ALL   (0xFFFF & ~(NETIF_CHECKSUM_PARTIAL_UDP | NETIF_CHECKSUM_PARTIAL_TCP))
 #define NETIF_CHECKSUM_DISABLE_ALL  0x0000
 
+/** Checksums a MAC or Wi-Fi firmware can take over from the stack.
+ * Pass a combination of these to NETIF_SET_CHECKSUM_OFFLOAD() from the
+ * driver init function (after netif_add() has reset the flags).
+ */
+#define NETIF_CHECKSUM_OFFLOAD_TX   (NETIF_CHECKSUM_GEN_IP | NETIF_CHECKSUM_GEN_UDP | NETIF_CHECKSUM_GEN_TCP | NETIF_CHECKSUM_GEN_ICMP | NETIF_CHECKSUM_GEN_ICMP6)
+#define NETIF_CHECKSUM_OFFLOAD_RX   (NETIF_CHECKSUM_CHECK_IP | NETIF_CHECKSUM_CHECK_UDP | NETIF_CHECKSUM_CHECK_TCP | NETIF_CHECKSUM_CHECK_ICMP | NETIF_CHECKSUM_CHECK_ICMP6)
+
 #endif							/* LWIP_CHECKSUM_CTRL_PER_NETIF */
 
 struct netif;
@@ -416,10 +426,28 @@ struct netif {
 #define NETIF_SET_CHECKSUM_CTRL(netif, chksumflags) do { \
 	(netif)->chksum_flags = chksumflags; \
 } while (0)
-#define IF__NETIF_CHECKSUM_ENABLED(netif, chksumflag) (if (((netif) == NULL) || (((netif)->chksum_flags & (chksumflag)) != 0)))
+#define IF__NETIF_CHECKSUM_ENABLED(netif, chksumflag) if (((netif) == NULL) || (((netif)->chksum_flags & (chksumflag)) != 0))
+/* Hand the checksums in 'offload' over to hardware. The L4 checksum
+ * field of offloaded TCP/UDP packets is left zero.
+ */
+#define NETIF_SET_CHECKSUM_OFFLOAD(netif, offload) do { \
+	(netif)->chksum_flags = (u16_t)(NETIF_CHECKSUM_ENABLE_ALL & ~(offload)); \
+} while (0)
+/* For hardware that expects a partial checksum: seed the L4 checksum field
+ * of offloaded TCP/UDP packets with the pseudo header sum. Pass
+ * NETIF_CHECKSUM_PARTIAL_UDP and/or NETIF_CHECKSUM_PARTIAL_TCP, after
+ * NETIF_SET_CHECKSUM_OFFLOAD().
+ */
+#define NETIF_SET_CHECKSUM_PARTIAL(netif, partial) do { \
+	(netif)->chksum_flags |= (u16_t)((partial) & (NETIF_CHECKSUM_PARTIAL_UDP | NETIF_CHECKSUM_PARTIAL_TCP)); \
+} while (0)
+#define NETIF_CHECKSUM_PARTIAL_ENABLED(netif, chksumflag) (((netif) != NULL) && (((netif)->chksum_flags & (chksumflag)) != 0))
 #else							/* LWIP_CHECKSUM_CTRL_PER_NETIF */
 #define NETIF_SET_CHECKSUM_CTRL(netif, chksumflags)
 #define IF__NETIF_CHECKSUM_ENABLED(netif, chksumflag)
+#define NETIF_SET_CHECKSUM_OFFLOAD(netif, offload)
+#define NETIF_SET_CHECKSUM_PARTIAL(netif, partial)
+#define NETIF_CHECKSUM_PARTIAL_ENABLED(netif, chksumflag) 0
 #endif							/* LWIP_CHECKSUM_CTRL_PER_NETIF */
 
 #if CONFIG_NSOCKET_DESCRIPTORS > 0
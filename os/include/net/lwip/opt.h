@@ -268,6 +268,41 @@
 #define MEMP_SANITY_CHECK               0
 #endif
 
+/**
+ * MEMP_GROW_FROM_HEAP==1: when a pool runs out of its static elements,
+ * borrow a slab of MEMP_GROW_SLAB_NUM elements from the kernel heap instead
+ * of failing the allocation. Slabs that stay completely unused for
+ * MEMP_GROW_IDLE_MS are returned to the heap by memp_tmr(). Pools never
+ * grow from interrupt context. Has no effect with MEMP_MEM_MALLOC.
+ */
+#ifndef MEMP_GROW_FROM_HEAP
+#define MEMP_GROW_FROM_HEAP             0
+#endif
+
+/**
+ * MEMP_GROW_SLAB_NUM: number of elements borrowed from the heap at once
+ * when a pool grows.
+ */
+#ifndef MEMP_GROW_SLAB_NUM
+#define MEMP_GROW_SLAB_NUM              4
+#endif
+
+/**
+ * MEMP_GROW_MAX_SLABS: upper bound on the number of heap slabs a single
+ * pool may hold at the same time.
+ */
+#ifndef MEMP_GROW_MAX_SLABS
+#define MEMP_GROW_MAX_SLABS             4
+#endif
+
+/**
+ * MEMP_GROW_IDLE_MS: period of memp_tmr(). A heap slab is released once it
+ * has been found completely free on two consecutive ticks.
+ */
+#ifndef MEMP_GROW_IDLE_MS
+#define MEMP_GROW_IDLE_MS               5000
+#endif
+
 /**
  * MEM_USE_POOLS==1: Use an alternative to malloc() by allocating from a set
  * of memory pools of various sizes. When mem_malloc is called, an element of
@@ -426,7 +461,7 @@
  * The formula expects settings to be either '0' or '1'.
  */
 #ifndef MEMP_NUM_SYS_TIMEOUT
-#define MEMP_NUM_SYS_TIMEOUT            (LWIP_TCP + IP_REASSEMBLY + LWIP_ARP + (2*LWIP_DHCP) + LWIP_AUTOIP + LWIP_IGMP + LWIP_DNS + (PPP_SUPPORT*6*MEMP_NUM_PPP_PCB) + (LWIP_IPV6 ? (1 + LWIP_IPV6_REASS + LWIP_IPV6_MLD) : 0))
+#define MEMP_NUM_SYS_TIMEOUT            (LWIP_TCP + IP_REASSEMBLY + LWIP_ARP + (2*LWIP_DHCP) + LWIP_AUTOIP + LWIP_IGMP + LWIP_DNS + (PPP_SUPPORT*6*MEMP_NUM_PPP_PCB) + (LWIP_IPV6 ? (1 + LWIP_IPV6_REASS + LWIP_IPV6_MLD) : 0) + (MEMP_GROW_FROM_HEAP && !MEMP_MEM_MALLOC))
 #endif
 
 /**
@@ -696,6 +731,16 @@
 #define IP_REASS_MAX_PBUFS              10
 #endif
 
+/**
+ * IP_REASS_HASH_SIZE: Number of hash buckets the datagrams being reassembled
+ * are kept in, keyed by source, destination and identification, so that a
+ * fragment finds its datagram without walking all of them. Used for both
+ * IPv4 and IPv6 reassembly.
+ */
+#ifndef IP_REASS_HASH_SIZE
+#define IP_REASS_HASH_SIZE              4
+#endif
+
 /**
  * IP_DEFAULT_TTL: Default value for Time-To-Live used by transport layers.
  */
@@ -1070,6 +1115,35 @@
 #ifndef LWIP_DNS_SUPPORT_MDNS_QUERIES
 #define LWIP_DNS_SUPPORT_MDNS_QUERIES  0
 #endif
+
+/** Number of hash buckets indexing the DNS table by host name (1..255). */
+#ifndef DNS_HASH_SIZE
+#define DNS_HASH_SIZE                   8
+#endif
+
+/** DNS_NEG_MAX_TTL > 0: cache NXDOMAIN answers (RFC 2308) for the TTL given
+ *  by the SOA record of the answer, but at most this many seconds. Lookups of
+ *  a name cached as non-existent fail immediately without a query.
+ *  0 disables negative caching.
+ */
+#ifndef DNS_NEG_MAX_TTL
+#define DNS_NEG_MAX_TTL                 0
+#endif
+
+/** DNS_PREFETCH_TTL > 0: re-query a cached name in the background once its
+ *  remaining TTL drops to this many seconds, provided that it was looked up
+ *  at least DNS_PREFETCH_MIN_HITS times since it was resolved. The old
+ *  address keeps being served until the answer arrives.
+ *  0 disables prefetching.
+ */
+#ifndef DNS_PREFETCH_TTL
+#define DNS_PREFETCH_TTL                0
+#endif
+
+/** Lookups a cached name needs before it is prefetched. */
+#ifndef DNS_PREFETCH_MIN_HITS
+#define DNS_PREFETCH_MIN_HITS           2
+#endif
 /**
  * @}
  */
@@ -1279,6 +1353,16 @@
 #define TCP_OVERSIZE                    TCP_MSS
 #endif
 
+/**
+ * TCP_COALESCE==1: Before transmitting, merge consecutive unsent segments
+ * into one segment of up to MSS bytes backed by a single pbuf. This turns
+ * a run of small tcp_write() calls that could not be appended in place
+ * (e.g. because of TCP_SND_QUEUELEN or NOCOPY data) into fewer packets.
+ */
+#ifndef TCP_COALESCE
+#define TCP_COALESCE                    0
+#endif
+
 /**
  * LWIP_TCP_TIMESTAMPS==1: support the TCP timestamp option.
  * The timestamp option is currently only used to help remote hosts, it is not
@@ -1710,6 +1794,23 @@
 #ifndef LWIP_NETCONN_FULLDUPLEX
 #define LWIP_NETCONN_FULLDUPLEX         0
 #endif
+
+/** LWIP_NETCONN_RX_COALESCE==1: While data posted to a TCP netconn's recvmbox
+ * has not been fetched by the application yet, append newly received
+ * in-order data to that pbuf instead of posting another mbox entry.
+ * This saves mbox traffic and tcp_recved() round trips for applications
+ * that read many small segments.
+ */
+#ifndef LWIP_NETCONN_RX_COALESCE
+#define LWIP_NETCONN_RX_COALESCE        0
+#endif
+
+/** LWIP_NETCONN_RX_COALESCE_MAX: Upper bound in bytes for one coalesced
+ * recvmbox entry (must stay below 64 KB, the pbuf tot_len limit).
+ */
+#ifndef LWIP_NETCONN_RX_COALESCE_MAX
+#define LWIP_NETCONN_RX_COALESCE_MAX    (4 * TCP_MSS)
+#endif
 /**
  * @}
  */
@@ -1959,6 +2060,15 @@
 #define MEMP_STATS                      (MEMP_MEM_MALLOC == 0)
 #endif
 
+/**
+ * MEMP_STATS_OCCUPANCY==1: integrate the number of used elements of every
+ * pool over time so that the average occupancy can be reported next to
+ * the high-water mark. Requires MEMP_STATS.
+ */
+#ifndef MEMP_STATS_OCCUPANCY
+#define MEMP_STATS_OCCUPANCY            0
+#endif
+
 /**
  * SYS_STATS==1: Enable system stats (sem and mbox counts, etc).
  */
@@ -2001,6 +2111,13 @@
 #define ND6_STATS                       (LWIP_IPV6)
 #endif
 
+/**
+ * DNS_STATS==1: Enable DNS resolver cache stats.
+ */
+#ifndef DNS_STATS
+#define DNS_STATS                       (LWIP_DNS)
+#endif
+
 /**
  * MIB2_STATS==1: Stats for SNMP MIB2.
  */
@@ -2027,6 +2144,7 @@
 #define IP6_FRAG_STATS                  0
 #define MLD6_STATS                      0
 #define ND6_STATS                       0
+#define DNS_STATS                       0
 #define MIB2_STATS                      0
 
 #endif							/* LWIP_STATS */
@@ -237,7 +237,7 @@ void pbuf_free_ooseq(void);
 	/* pbuf_alloc() reported PBUF_POOL to be empty -> try to free some
 	 * ooseq queued pbufs now
 	 */ \
-	pbuf_free_ooseq(); }
+	pbuf_free_ooseq(); } \
 } while (0)
 #else							/* LWIP_TCP && TCP_QUEUE_OOSEQ && NO_SYS && PBUF_POOL_FREE_OOSEQ */
 	/* Otherwise declare an empty PBUF_CHECK_FREE_OOSEQ */
@@ -149,12 +149,27 @@ typedef enum {
 #define MEMP_POOL_LAST   ((memp_t) MEMP_POOL_HELPER_LAST)
 #endif							/* MEM_USE_POOLS && MEMP_USE_CUSTOM_POOLS */
 
+#if MEMP_GROW_FROM_HEAP && !MEMP_MEM_MALLOC
+/** A block of pool elements borrowed from the heap by a grown pool */
+struct memp_slab {
+	/** Next slab of the same pool */
+	struct memp_slab *next;
+	/** Free elements of this slab. Elements form a linked list. */
+	struct memp *free;
+	/** Number of elements on the free list */
+	u16_t nfree;
+	/** Set by memp_tmr() when the slab was found completely free */
+	u8_t idle;
+	/* MEMP_GROW_SLAB_NUM elements follow, aligned to MEM_ALIGNMENT */
+};
+#endif							/* MEMP_GROW_FROM_HEAP && !MEMP_MEM_MALLOC */
+
 /** Memory pool descriptor */
 struct memp_desc {
-#if defined(LWIP_DEBUG) || MEMP_OVERFLOW_CHECK || LWIP_STATS_DISPLAY
+#if defined(LWIP_DEBUG) || MEMP_OVERFLOW_CHECK || LWIP_STATS_DISPLAY || MEMP_STATS
 	/** Textual description */
 	const char *desc;
-#endif							/* LWIP_DEBUG || MEMP_OVERFLOW_CHECK || LWIP_STATS_DISPLAY */
+#endif							/* LWIP_DEBUG || MEMP_OVERFLOW_CHECK || LWIP_STATS_DISPLAY || MEMP_STATS */
 #if MEMP_STATS
 	/** Statistics */
 	struct stats_mem *stats;
@@ -172,23 +187,36 @@ struct memp_desc {
 
 	/** First free element of each pool. Elements form a linked list. */
 	struct memp **tab;
+
+#if MEMP_GROW_FROM_HEAP
+	/** Heap slabs currently held by this pool */
+	struct memp_slab **slabs;
+#endif							/* MEMP_GROW_FROM_HEAP */
 #endif							/* MEMP_MEM_MALLOC */
 };
 
-#if defined(LWIP_DEBUG) || MEMP_OVERFLOW_CHECK || LWIP_STATS_DISPLAY
+#if defined(LWIP_DEBUG) || MEMP_OVERFLOW_CHECK || LWIP_STATS_DISPLAY || MEMP_STATS
 #define DECLARE_LWIP_MEMPOOL_DESC(desc) (desc),
 #else
 #define DECLARE_LWIP_MEMPOOL_DESC(desc)
 #endif
 
 #if MEMP_STATS
-#define LWIP_MEMPOOL_DECLARE_STATS_INSTANCE(name) static struct stats_mem name
-#define LWIP_MEMPOOL_DECLARE_STATS_REFERENCE(name) (&name, )
+#define LWIP_MEMPOOL_DECLARE_STATS_INSTANCE(name) static struct stats_mem name;
+#define LWIP_MEMPOOL_DECLARE_STATS_REFERENCE(name) &name,
 #else
 #define LWIP_MEMPOOL_DECLARE_STATS_INSTANCE(name)
 #define LWIP_MEMPOOL_DECLARE_STATS_REFERENCE(name)
 #endif
 
+#if MEMP_GROW_FROM_HEAP && !MEMP_MEM_MALLOC
+#define LWIP_MEMPOOL_DECLARE_SLABS_INSTANCE(name) static struct memp_slab *name;
+#define LWIP_MEMPOOL_DECLARE_SLABS_REFERENCE(name) , &name
+#else
+#define LWIP_MEMPOOL_DECLARE_SLABS_INSTANCE(name)
+#define LWIP_MEMPOOL_DECLARE_SLABS_REFERENCE(name)
+#endif
+
 void memp_init_pool(const struct memp_desc *desc);
 
 #if MEMP_OVERFLOW_CHECK
@@ -199,6 +227,10 @@ void *memp_malloc_pool(const struct memp_desc *desc);
 #endif
 void memp_free_pool(const struct memp_desc *desc, void *mem);
 
+#if MEMP_STATS && MEMP_STATS_OCCUPANCY
+u32_t memp_occupancy_pool(const struct memp_desc *desc);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -86,6 +86,8 @@ struct stats_proto {
 	STAT_COUNTER opterr;	/* Error in options. */
 	STAT_COUNTER err;		/* Misc error. */
 	STAT_COUNTER cachehit;
+	STAT_COUNTER txcoalesced;	/* Runs of unsent segments merged before transmit. */
+	STAT_COUNTER rxcoalesced;	/* Receives appended to a pending entry. */
 };
 
 /** IGMP stats */
@@ -116,6 +118,32 @@ struct stats_mem {
 	mem_size_t used;
 	mem_size_t max;
 	STAT_COUNTER illegal;
+#if MEMP_STATS_OCCUPANCY
+	/** sys_now() when the pool was initialized */
+	u32_t occ_start;
+	/** sys_now() of the last change of 'used' */
+	u32_t occ_stamp;
+	/** 'used' integrated over time, in element-milliseconds */
+	uint64_t occ_sum;
+#endif							/* MEMP_STATS_OCCUPANCY */
+#if MEMP_GROW_FROM_HEAP
+	/** Elements currently borrowed from the heap (included in 'avail') */
+	mem_size_t grown;
+	/** Number of times the pool grew by one slab */
+	STAT_COUNTER grow;
+	/** Number of slabs given back to the heap */
+	STAT_COUNTER shrink;
+#endif							/* MEMP_GROW_FROM_HEAP */
+};
+
+/** DNS resolver stats */
+struct stats_dns {
+	STAT_COUNTER xmit;			/* Queries sent, including retries. */
+	STAT_COUNTER hit;			/* Lookups answered from the cache. */
+	STAT_COUNTER neghit;		/* Lookups failed from the negative cache. */
+	STAT_COUNTER miss;			/* Lookups that started a new query. */
+	STAT_COUNTER coalesced;		/* Lookups that joined an outstanding query. */
+	STAT_COUNTER prefetch;		/* Cached names refreshed before expiry. */
 };
 
 /** System element stats */
@@ -324,6 +352,10 @@ struct stats_ {
 	/** Neighbor discovery */
 	struct stats_proto nd6;
 #endif
+#if DNS_STATS
+	/** DNS resolver */
+	struct stats_dns dns;
+#endif
 #if MIB2_STATS
 	/** SNMP MIB2 */
 	struct stats_mib2 mib2;
@@ -491,6 +523,14 @@ void stats_init(void);
 #define ND6_STATS_DISPLAY()
 #endif
 
+#if DNS_STATS
+#define DNS_STATS_INC(x) STATS_INC(x)
+#define DNS_STATS_DISPLAY() stats_display_dns(&lwip_stats.dns)
+#else
+#define DNS_STATS_INC(x)
+#define DNS_STATS_DISPLAY()
+#endif
+
 #if MIB2_STATS
 #define MIB2_STATS_INC(x) STATS_INC(x)
 #else
@@ -505,6 +545,7 @@ void stats_display_igmp(struct stats_igmp *igmp, const char *name);
 void stats_display_mem(struct stats_mem *mem, const char *name);
 void stats_display_memp(struct stats_mem *mem, int index);
 void stats_display_sys(struct stats_sys *sys);
+void stats_display_dns(struct stats_dns *dns);
 #else							/* LWIP_STATS_DISPLAY */
 #define stats_display()
 #define stats_display_proto(proto, name)
@@ -512,6 +553,7 @@ void stats_display_sys(struct stats_sys *sys);
 #define stats_display_mem(mem, name)
 #define stats_display_memp(mem, index)
 #define stats_display_sys(sys)
+#define stats_display_dns(dns)
 #endif							/* LWIP_STATS_DISPLAY */
 
 #ifdef __cplusplus
@@ -78,6 +78,8 @@
 
 #define PRIOINHERIT_FLAGS_DISABLE (1 << 0) /* Bit 0: Priority inheritance
 					    * is disabled for this semaphore */
+#define PRIOINHERIT_FLAGS_SIGNAL  (1 << 1) /* Bit 1: Posted by a non-holder,
+					    * no holders are recorded */
 
 /****************************************************************************
  * Public Type Declarations
@@ -87,22 +89,25 @@
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 struct tcb_s;					/* Forward reference */
+struct sem_s;					/* Forward reference */
 /**
  * @ingroup SEMAPHORE_KERNEL
  * @brief Structure of semholder
  */
 struct semholder_s {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-	struct semholder_s *flink;	/* Implements singly linked list */
+	struct semholder_s *flink;	/* Next holder of the same semaphore */
 #endif
+	FAR struct semholder_s *tlink;	/* Next semaphore held by the same thread */
+	FAR struct sem_s *sem;		/* The semaphore held */
 	FAR struct tcb_s *htcb;		/* Holder TCB */
 	int16_t counts;				/* Number of counts owned by this holder */
 };
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#define SEMHOLDER_INITIALIZER {NULL, NULL, 0}
+#define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, NULL, 0}
 #else
-#define SEMHOLDER_INITIALIZER {NULL, 0}
+#define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, 0}
 #endif
 #endif							/* CONFIG_PRIORITY_INHERITANCE */
 
@@ -119,10 +124,9 @@ struct sem_s {
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	uint8_t flags;			/* See PRIOINHERIT_FLAGS_* definitions */
+	struct semholder_s holder;	/* First holder, the only one of a mutex */
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-	FAR struct semholder_s *hhead;	/* List of holders of semaphore counts */
-#else
-	struct semholder_s holder;	/* Single holder */
+	FAR struct semholder_s *hhead;	/* Further holders of semaphore counts */
 #endif
 #endif
 #ifdef CONFIG_SEM_SUPPORT_TRACE
@@ -139,10 +143,10 @@ typedef struct sem_s sem_t;
  */
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#define SEM_INITIALIZER(c) {(c), 0, NULL} /* semcount, flags, hhead */
+#define SEM_INITIALIZER(c) {(c), 0, SEMHOLDER_INITIALIZER, NULL} /* semcount, flags, holder, hhead */
 #ifdef CONFIG_SEM_SUPPORT_TRACE
 #  undef SEM_INITIALIZER
-#  define SEM_INITIALIZER(c) {(c), 0, NULL, 0} /* semcount, flags, hhead */
+#  define SEM_INITIALIZER(c) {(c), 0, SEMHOLDER_INITIALIZER, NULL, 0} /* semcount, flags, holder, hhead */
 #endif
 #else
 #define SEM_INITIALIZER(c) {(c), 0, SEMHOLDER_INITIALIZER} /* semcount, flags, holder */
@@ -0,0 +1,108 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @defgroup EVENTFD_KERNEL EVENTFD
+ * @brief Provides APIs for event notification file descriptors
+ * @ingroup KERNEL
+ *
+ * @{
+ */
+
+/// @file eventfd.h
+/// @brief eventfd APIs
+
+#ifndef __INCLUDE_SYS_EVENTFD_H
+#define __INCLUDE_SYS_EVENTFD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <fcntl.h>
+
+#ifdef CONFIG_EVENT_FD
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/* Flags for eventfd() */
+
+#define EFD_SEMAPHORE (1 << 0)	/* read() returns 1 and decrements the counter */
+#define EFD_NONBLOCK  O_NONBLOCK	/* read() and write() do not block */
+#define EFD_CLOEXEC   0			/* Accepted for compatibility */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+typedef uint64_t eventfd_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/**
+ * @brief Create a file descriptor for event notification
+ *
+ * @details The descriptor refers to a 64-bit counter that starts at
+ *   'count'.  write() of an 8-byte value adds it to the counter, waking any
+ *   reader.  read() of 8 bytes waits until the counter is non-zero, then
+ *   returns it and resets it to zero, or returns 1 and decrements it with
+ *   EFD_SEMAPHORE.  The descriptor is readable to poll() and select() while
+ *   the counter is non-zero.
+ * @param[in] count The initial counter value
+ * @param[in] flags EFD_SEMAPHORE, EFD_NONBLOCK or EFD_CLOEXEC
+ * @return A new file descriptor on success; -1 is returned on failure with
+ *   errno set appropriately.
+ * @since Tizen RT v1.1
+ */
+int eventfd(unsigned int count, int flags);
+
+/**
+ * @brief Read the counter of an eventfd descriptor
+ * @return 0 on success; -1 on failure with errno set appropriately.
+ * @since Tizen RT v1.1
+ */
+int eventfd_read(int fd, FAR eventfd_t *value);
+
+/**
+ * @brief Add to the counter of an eventfd descriptor
+ * @return 0 on success; -1 on failure with errno set appropriately.
+ * @since Tizen RT v1.1
+ */
+int eventfd_write(int fd, eventfd_t value);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_EVENT_FD */
+#endif							/* __INCLUDE_SYS_EVENTFD_H */
+/** @} */
@@ -185,7 +185,7 @@ int munlockall(void);
 #ifdef CONFIG_FS_RAMMAP
 int munmap(FAR void *start, size_t length);
 #else
-#define munmap(start, length)
+#define munmap(start, length) (0)
 #endif
 
 int posix_madvise(FAR void *addr, size_t len, int advice);
@@ -106,12 +106,13 @@
 #define SYS_sem_timedwait              (CONFIG_SYS_RESERVED+16)
 #define SYS_sem_trywait                (CONFIG_SYS_RESERVED+17)
 #define SYS_sem_wait                   (CONFIG_SYS_RESERVED+18)
+#define SYS_sem_tickwait               (CONFIG_SYS_RESERVED+19)
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
-#define SYS_sem_setprotocol            (CONFIG_SYS_RESERVED+19)
-#define __SYS_named_sem                (CONFIG_SYS_RESERVED+20)
+#define SYS_sem_setprotocol            (CONFIG_SYS_RESERVED+20)
+#define __SYS_named_sem                (CONFIG_SYS_RESERVED+21)
 #else
-#define __SYS_named_sem                (CONFIG_SYS_RESERVED+19)
+#define __SYS_named_sem                (CONFIG_SYS_RESERVED+20)
 #endif
 
 /* Named semaphores */
@@ -288,12 +289,26 @@
 #define SYS_statfs                     (__SYS_filedesc+14)
 #define SYS_telldir                    (__SYS_filedesc+15)
 
+#ifdef CONFIG_EVENT_FD
+#define SYS_eventfd                    (__SYS_filedesc+16)
+#define __SYS_rammap                   (__SYS_filedesc+17)
+#else
+#define __SYS_rammap                   (__SYS_filedesc+16)
+#endif
+
+#ifdef CONFIG_FS_RAMMAP
+#define SYS_munmap                     (__SYS_rammap+0)
+#define __SYS_streams                  (__SYS_rammap+1)
+#else
+#define __SYS_streams                  __SYS_rammap
+#endif
+
 #if CONFIG_NFILE_STREAMS > 0
-#define SYS_fs_fdopen                  (__SYS_filedesc+16)
-#define SYS_sched_getstreams           (__SYS_filedesc+17)
-#define __SYS_mountpoint               (__SYS_filedesc+18)
+#define SYS_fs_fdopen                  (__SYS_streams+0)
+#define SYS_sched_getstreams           (__SYS_streams+1)
+#define __SYS_mountpoint               (__SYS_streams+2)
 #else
-#define __SYS_mountpoint               (__SYS_filedesc+16)
+#define __SYS_mountpoint               __SYS_streams
 #endif
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT)
@@ -376,7 +391,9 @@
 #define SYS_mq_timedreceive            (__SYS_mqueue+7)
 #define SYS_mq_timedsend               (__SYS_mqueue+8)
 #define SYS_mq_unlink                  (__SYS_mqueue+9)
-#define __SYS_environ                  (__SYS_mqueue+10)
+#define SYS_mq_sendref                 (__SYS_mqueue+10)
+#define SYS_mq_receiveref              (__SYS_mqueue+11)
+#define __SYS_environ                  (__SYS_mqueue+12)
 #else
 #define __SYS_environ                  __SYS_mqueue
 #endif
@@ -1765,6 +1765,23 @@ void sched_alarm_expiration(FAR const struct timespec *ts);
 void weak_function sched_process_cpuload(void);
 #endif
 
+/****************************************************************************
+ * Name: up_cyclecount_initialize and up_cyclecount
+ *
+ * Description:
+ *   Start and read the free running 32-bit CPU cycle counter.  The counter
+ *   wraps silently; callers only use differences between two readings.
+ *   up_cyclecount() is called on every context switch and interrupt when
+ *   CONFIG_SCHED_CPULOAD_CYCLES is enabled, so it must be a single register
+ *   read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CYCLECOUNT
+void up_cyclecount_initialize(void);
+uint32_t up_cyclecount(void);
+#endif
+
 /****************************************************************************
  * Name: irq_dispatch
  *
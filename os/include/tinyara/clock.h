@@ -198,7 +198,7 @@
 
 #ifdef CONFIG_SCHED_CPULOAD
 struct cpuload_s {
-	volatile uint32_t total;	/* Total number of clock ticks */
+	volatile uint32_t total;	/* Total number of clock ticks (or scaled cycles) */
 	volatile uint32_t active;	/* Number of ticks while this thread was active */
 };
 #endif
@@ -369,6 +369,30 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
  */
 #endif
 
+/****************************************************************************
+ * Function:  clock_cpuload_irq and clock_cpuload_overhead
+ *
+ * Description:
+ *   With CONFIG_SCHED_CPULOAD_CYCLES, interrupt time is not charged to the
+ *   interrupted thread.  clock_cpuload_irq() returns the load of one
+ *   interrupt vector and clock_cpuload_overhead() the load of the
+ *   accounting itself, with the average cost of one accounting hook in
+ *   cycles.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+/**
+ * @cond
+ * @internal
+ */
+int clock_cpuload_irq(int irq, FAR struct cpuload_s *cpuload);
+void clock_cpuload_overhead(FAR struct cpuload_s *cpuload, FAR uint32_t *percall);
+/**
+ * @endcond
+ */
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
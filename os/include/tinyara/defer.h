@@ -0,0 +1,110 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/defer.h
+ *
+ * Deferred call rings (CONFIG_SCHED_DEFER): a lighter bottom half than the
+ * high priority work queue for interrupt handlers that only need to get a
+ * function called in thread context soon.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_DEFER_H
+#define __INCLUDE_TINYARA_DEFER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#ifdef CONFIG_SCHED_DEFER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Ring priorities.  Calls in a lower numbered ring always run first. */
+
+#define DEFER_HIPRI       0
+#define DEFER_LOPRI       (CONFIG_SCHED_DEFER_NPRIOS - 1)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+typedef CODE void (*defer_func_t)(FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: defer_call
+ *
+ * Description:
+ *   Have the deferred call thread call func(arg).  Safe from interrupt
+ *   handlers, including nested ones, and from threads; interrupts are not
+ *   masked to queue the call.  Unlike work_queue(), nothing has to be
+ *   allocated by the caller, so the same call may be queued any number of
+ *   times.  Calls of one priority run in the order they were queued.
+ *
+ *   The calls share one thread, so they should be short.  A call that has
+ *   to wait for slow I/O belongs on a work queue.
+ *
+ * Parameters:
+ *   prio - Ring to queue the call in, DEFER_HIPRI ... DEFER_LOPRI
+ *   func - The function to call
+ *   arg  - Its argument
+ *
+ * Return Value:
+ *   OK (0) on success; -EAGAIN if the ring is full; -EINVAL if prio is out
+ *   of range.
+ *
+ ****************************************************************************/
+
+int defer_call(int prio, defer_func_t func, FAR void *arg);
+
+/****************************************************************************
+ * Name: defer_start
+ *
+ * Description:
+ *   Start the deferred call thread.  Called by the OS during bring-up.
+ *   Calls queued before it runs are kept until then.
+ *
+ * Return Value:
+ *   The pid of the thread, or a negated errno value.
+ *
+ ****************************************************************************/
+
+int defer_start(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_SCHED_DEFER */
+#endif							/* __INCLUDE_TINYARA_DEFER_H */
@@ -0,0 +1,166 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/evtgroup.h
+ *
+ * Event flag groups (CONFIG_EVTGROUP).
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_EVTGROUP_H
+#define __INCLUDE_TINYARA_EVTGROUP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+
+#ifdef CONFIG_EVTGROUP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags for evtgroup_wait() and evtgroup_timedwait() */
+
+#define EVTGROUP_WAITANY  0			/* Wake when any requested event is set */
+#define EVTGROUP_WAITALL  (1 << 0)	/* Wake only when all of them are set */
+#define EVTGROUP_CONSUME  (1 << 1)	/* Clear the events that woke the waiter */
+
+#define EVTGROUP_INITIALIZER(e) { (e), { NULL, NULL } }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An event flag group is a 32-bit set of events.  Any number of threads may
+ * wait for a combination of them, and threads or interrupt handlers set
+ * them with evtgroup_post().
+ */
+
+struct evtgroup_s {
+	volatile uint32_t events;	/* Events currently set */
+	dq_queue_t waiters;			/* Waiting threads, in arrival order */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: evtgroup_init
+ *
+ * Description:
+ *   Initialize an event flag group with the given events set.
+ *
+ ****************************************************************************/
+
+void evtgroup_init(FAR struct evtgroup_s *grp, uint32_t events);
+
+/****************************************************************************
+ * Name: evtgroup_destroy
+ *
+ * Description:
+ *   Release an event flag group.
+ *
+ * Return Value:
+ *   0 (OK), or -EBUSY if threads are still waiting on it.
+ *
+ ****************************************************************************/
+
+int evtgroup_destroy(FAR struct evtgroup_s *grp);
+
+/****************************************************************************
+ * Name: evtgroup_post
+ *
+ * Description:
+ *   Set events and wake, in arrival order, every waiter they satisfy.  A
+ *   waiter using EVTGROUP_CONSUME clears its events before the next waiter
+ *   is checked.  May be called from interrupt handlers.
+ *
+ * Return Value:
+ *   The events still set afterwards.
+ *
+ ****************************************************************************/
+
+uint32_t evtgroup_post(FAR struct evtgroup_s *grp, uint32_t events);
+
+/****************************************************************************
+ * Name: evtgroup_clear
+ *
+ * Description:
+ *   Clear events.  May be called from interrupt handlers.
+ *
+ * Return Value:
+ *   The events that were set before.
+ *
+ ****************************************************************************/
+
+uint32_t evtgroup_clear(FAR struct evtgroup_s *grp, uint32_t events);
+
+/****************************************************************************
+ * Name: evtgroup_wait
+ *
+ * Description:
+ *   Wait until any (EVTGROUP_WAITANY) or all (EVTGROUP_WAITALL) of the
+ *   given events are set.
+ *
+ * Parameters:
+ *   grp    - The event flag group
+ *   events - The events to wait for; must not be zero
+ *   flags  - EVTGROUP_WAITANY or EVTGROUP_WAITALL, optionally with
+ *            EVTGROUP_CONSUME
+ *   result - If not NULL, receives the requested events that were set
+ *
+ * Return Value:
+ *   0 (OK), or a negated errno value: -EINVAL for bad arguments, -EINTR if
+ *   interrupted by a signal.
+ *
+ ****************************************************************************/
+
+int evtgroup_wait(FAR struct evtgroup_s *grp, uint32_t events, int flags, FAR uint32_t *result);
+
+/****************************************************************************
+ * Name: evtgroup_timedwait
+ *
+ * Description:
+ *   Like evtgroup_wait(), but give up after 'ticks' clock ticks and return
+ *   -ETIMEDOUT.  With zero ticks it only checks the events.
+ *
+ ****************************************************************************/
+
+int evtgroup_timedwait(FAR struct evtgroup_s *grp, uint32_t events, int flags, uint32_t ticks, FAR uint32_t *result);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_EVTGROUP */
+#endif							/* __INCLUDE_TINYARA_EVTGROUP_H */
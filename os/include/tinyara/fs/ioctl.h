@@ -147,6 +147,11 @@
 #define FIONWRITE       _FIOC(0x0006)	/* IN:  Location to return value (int *)
 										 * OUT: Bytes writable to this fd
 										 */
+#define FIOC_FILESIZE   _FIOC(0x0007)	/* IN:  Location to return size (off_t *)
+										 * OUT: Size of the open file.  Unlike
+										 *      lseek(SEEK_END), the file position
+										 *      is not touched.
+										 */
 
 /* TinyAra file system ioctl definitions **************************************/
 
@@ -229,6 +234,11 @@
 										 *      the block with specific debug
 										 *      command and data.
 										 * OUT: None.  */
+#define BIOC_FLUSH      _BIOC(0x000C)	/* Write out what the block driver
+										 * buffers.
+										 * IN:  None
+										 * OUT: None (ioctl return value provides
+										 *      success/failure indication). */
 
 /* TinyAra MTD driver ioctl definitions ***************************************/
 
@@ -249,6 +259,24 @@
 											 * OUT: None */
 #define MTDIOC_SETSPEED   _MTDIOC(0x0004)	/* IN:  New bus speed in Hz
 											 * OUT: None */
+#define MTDIOC_ERASESUSPEND _MTDIOC(0x0005)	/* IN:  None
+											 * OUT: OK once an erase in progress,
+											 *      if any, is suspended and the
+											 *      device may be read until
+											 *      MTDIOC_ERASERESUME */
+#define MTDIOC_ERASERESUME _MTDIOC(0x0006)	/* IN:  None
+											 * OUT: None */
+#define MTDIOC_ERASESECTORS _MTDIOC(0x0007)	/* IN:  Pointer to struct mtd_erase_s
+											 *      describing the erase blocks to
+											 *      erase ahead of the writer
+											 * OUT: None */
+#define MTDIOC_RWBSTATS   _MTDIOC(0x0008)	/* IN:  Pointer to write-able struct
+											 *      rwb_stats_s in which to receive
+											 *      the buffer statistics
+											 * OUT: Statistics of a buffered partition */
+#define MTDIOC_FLUSH      _MTDIOC(0x0009)	/* IN:  None
+											 * OUT: None.  What the MTD driver
+											 *      buffers is on the media */
 
 /* TinyAra ARP driver ioctl definitions (see include/netinet/arp.h) *******************/
 
@@ -79,6 +79,12 @@
 #define CONFIG_MTD_REGISTRATION   1
 #endif
 
+/* Operations of a queued MTD request (see struct mtd_req_s) */
+
+#define MTDREQ_READ            0	/* bread() into buffer */
+#define MTDREQ_WRITE           1	/* bwrite() from buffer */
+#define MTDREQ_ERASE           2	/* erase(); units are erase blocks */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -96,6 +102,13 @@ struct mtd_geometry_s {
 	size_t neraseblocks;		/* Number of erase blocks */
 };
 
+/* The following describes a range of erase blocks (MTDIOC_ERASESECTORS) */
+
+struct mtd_erase_s {
+	off_t startblock;			/* First erase block */
+	size_t nblocks;				/* Number of erase blocks */
+};
+
 /* The following defines the information for writing bytes to a sector
  * that are not a full page write (bytewrite).
  */
@@ -162,6 +175,39 @@ struct mtd_dev_s {
 #endif
 };
 
+#ifdef CONFIG_MTD_QUEUE
+/* A request submitted to the queue of an MTD device with mtd_submit().  The
+ * queue's thread performs it and then calls 'complete', which must not
+ * block for long.  The request and its buffer belong to the queue until
+ * then.  A read performed during a suspended erase is completed by
+ * mtd_submit() itself, in the submitter's context, so 'complete' may run
+ * on either thread and must not call mtd_submit() or
+ * mtd_queue_uninitialize() on the same queue.
+ *
+ * Requests are performed in the order submitted, except that a read may be
+ * performed ahead of queued erases that do not touch the blocks it reads.
+ * A multi-block erase is performed one erase block at a time so that reads
+ * get in between.
+ */
+
+struct mtd_req_s;
+typedef CODE void (*mtd_complete_t)(FAR struct mtd_req_s *req);
+
+struct mtd_req_s {
+	FAR struct mtd_req_s *flink;	/* Used by the queue */
+	uint8_t op;					/* MTDREQ_READ, MTDREQ_WRITE or MTDREQ_ERASE */
+	off_t startblock;			/* First read/write block, or erase block */
+	size_t nblocks;				/* Number of read/write, or erase blocks */
+	FAR uint8_t *buffer;		/* Data to write, or buffer to read into */
+	ssize_t result;				/* On completion: as returned by the MTD method */
+	size_t ndone;				/* Used by the queue: erase blocks done */
+	mtd_complete_t complete;	/* Called when done, see above */
+	FAR void *priv;				/* For use by the submitter */
+};
+
+struct mtd_queue_s;
+#endif
+
 enum mtd_partition_tag_s {
 	MTD_MASTER = 0,
 	MTD_FS = 1,
@@ -240,6 +286,19 @@ FAR struct mtd_dev_s *get_mtd_partition(uint16_t tagno);
 int mtd_setpartitionname(FAR struct mtd_dev_s *mtd, FAR const char *name);
 #endif
 
+/****************************************************************************
+ * Name: mtd_setpartitionrwb
+ *
+ * Description:
+ *       Sets the size, in blocks, of the read-ahead and write buffers of the
+ *       specified partition.  Zero for both disables buffering.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_PARTITION_RWBUFFER
+int mtd_setpartitionrwb(FAR struct mtd_dev_s *mtd, uint16_t rhblocks, uint16_t wrblocks);
+#endif
+
 /****************************************************************************
  * Name: ftl_initialize
  *
@@ -257,6 +316,20 @@ int mtd_setpartitionname(FAR struct mtd_dev_s *mtd, FAR const char *name);
 int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd);
 #endif
 
+/****************************************************************************
+ * Name: ftl_log_initialize
+ *
+ * Description:
+ *   Like ftl_initialize(), but the block driver appends sector writes to
+ *   erased pages and maps them, instead of rewriting the whole erase block
+ *   for every write.  It exports fewer sectors (see CONFIG_FTL_LOG).
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MTD_FTL) && defined(CONFIG_FTL_LOG)
+int ftl_log_initialize(int minor, FAR struct mtd_dev_s *mtd);
+#endif
+
 /****************************************************************************
 * Name: m25p_initialize
 *
@@ -343,6 +416,53 @@ FAR struct mtd_dev_s *rammtd_initialize(FAR uint8_t *start, size_t size);
 
 FAR struct mtd_dev_s *progmem_initialize(void);
 
+/****************************************************************************
+ * Name: mtd_queue_initialize
+ *
+ * Description:
+ *   Create a request queue, and the thread that serves it, for an MTD
+ *   device.  Requests to one queue are performed one at a time; requests
+ *   to the queues of different devices, such as two partitions, may be
+ *   performed concurrently if the driver below allows it.
+ *
+ *   While the thread is erasing, mtd_submit() tries to suspend the erase
+ *   with MTDIOC_ERASESUSPEND to perform a read that may go ahead of it
+ *   right away, in the submitter's context.  Drivers without erase suspend
+ *   simply fail that ioctl and the read waits for the erase block to
+ *   finish.
+ *
+ * Returned Value:
+ *   The new queue, or NULL if out of memory.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_QUEUE
+FAR struct mtd_queue_s *mtd_queue_initialize(FAR struct mtd_dev_s *mtd);
+
+/****************************************************************************
+ * Name: mtd_queue_uninitialize
+ *
+ * Description:
+ *   Stop the thread of an idle queue, wait for it to exit and free the
+ *   queue.  Returns -EBUSY if requests are still outstanding.
+ *
+ ****************************************************************************/
+
+int mtd_queue_uninitialize(FAR struct mtd_queue_s *queue);
+
+/****************************************************************************
+ * Name: mtd_submit
+ *
+ * Description:
+ *   Queue a request.  Returns OK, or a negated errno if the request is
+ *   malformed; the result of the operation itself is reported through
+ *   req->complete.
+ *
+ ****************************************************************************/
+
+int mtd_submit(FAR struct mtd_queue_s *queue, FAR struct mtd_req_s *req);
+#endif
+
 #ifdef CONFIG_MTD_REGISTRATION
 int mtd_register(FAR struct mtd_dev_s *mtd, FAR const char *name);
 #endif
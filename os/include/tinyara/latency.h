@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/latency.h
+ *
+ * Scheduling and interrupt latency histograms (CONFIG_SCHED_LATENCY).
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_LATENCY_H
+#define __INCLUDE_TINYARA_LATENCY_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_SCHED_LATENCY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Latencies are in CPU cycles and binned by log2.  Bucket 0 holds everything
+ * below 2^(LATENCY_SHIFT + 1) cycles, bucket n > 0 the range
+ * [2^(n + LATENCY_SHIFT), 2^(n + LATENCY_SHIFT + 1)), and the last bucket
+ * everything above.
+ */
+
+#define LATENCY_NBUCKETS  16
+#define LATENCY_SHIFT     6
+
+/* The histograms kept.  WAKEUP and IRQ have one histogram per priority or
+ * vector, DEFER one per deferred call priority; IRQOFF and SCHEDLOCK have a
+ * single one.
+ */
+
+#define LATENCY_WAKEUP    0		/* Ready-to-run until running, per priority */
+#define LATENCY_IRQ       1		/* Held off by masked interrupts, per vector */
+#define LATENCY_IRQOFF    2		/* Length of irqsave() sections */
+#define LATENCY_SCHEDLOCK 3		/* Length of sched_lock() sections */
+#define LATENCY_DEFER     4		/* Deferred call queued until run, per priority */
+#define LATENCY_NTYPES    5
+
+/* Key of the histogram that collects the priorities or vectors that did not
+ * fit in the table.
+ */
+
+#define LATENCY_KEY_OTHER (-1)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct latency_hist_s {
+	int16_t key;				/* Priority or IRQ number */
+	uint32_t count;				/* Number of samples */
+	uint32_t max;				/* Longest sample */
+	FAR void *caller;			/* Code responsible for the longest sample */
+	uint32_t bucket[LATENCY_NBUCKETS];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sched_latency_get
+ *
+ * Description:
+ *   Copy out one histogram.
+ *
+ * Parameters:
+ *   type  - One of LATENCY_WAKEUP ... LATENCY_DEFER
+ *   index - Index of the histogram within the type, from 0
+ *   hist  - Location to return the histogram
+ *
+ * Return Value:
+ *   OK (0) on success; -ENOENT if there is no such histogram or it has no
+ *   samples yet.
+ *
+ ****************************************************************************/
+
+int sched_latency_get(int type, int index, FAR struct latency_hist_s *hist);
+
+/****************************************************************************
+ * Name: sched_latency_reset
+ *
+ * Description:
+ *   Clear all histograms.
+ *
+ ****************************************************************************/
+
+void sched_latency_reset(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_SCHED_LATENCY */
+#endif							/* __INCLUDE_TINYARA_LATENCY_H */
@@ -72,6 +72,16 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Largest mq_msgsize a queue may be created with.  Messages larger than
+ * CONFIG_MQ_MAXMSGSIZE are kept in a slab owned by the queue.
+ */
+
+#if defined(CONFIG_MQ_QUEUE_MAXMSGSIZE) && CONFIG_MQ_QUEUE_MAXMSGSIZE > CONFIG_MQ_MAXMSGSIZE
+#define MQ_QUEUE_MAXMSGSIZE CONFIG_MQ_QUEUE_MAXMSGSIZE
+#else
+#define MQ_QUEUE_MAXMSGSIZE CONFIG_MQ_MAXMSGSIZE
+#endif
+
 /****************************************************************************
  * Global Type Declarations
  ****************************************************************************/
@@ -87,11 +97,15 @@ struct mqueue_inode_s {
 	int16_t nmsgs;				/* Number of message in the queue */
 	int16_t nwaitnotfull;		/* Number tasks waiting for not full */
 	int16_t nwaitnotempty;		/* Number tasks waiting for not empty */
-#if CONFIG_MQ_MAXMSGSIZE < 256
+#if MQ_QUEUE_MAXMSGSIZE < 256
 	uint8_t maxmsgsize;			/* Max size of message in message queue */
 #else
 	uint16_t maxmsgsize;		/* Max size of message in message queue */
 #endif
+#if MQ_QUEUE_MAXMSGSIZE > CONFIG_MQ_MAXMSGSIZE
+	sq_queue_t slabfree;		/* Free messages of maxmsgsize bytes */
+	FAR void *slab;				/* Allocated on first use, NULL before */
+#endif
 #ifndef CONFIG_DISABLE_SIGNALS
 	FAR struct mq_des *ntmqdes;	/* Notification: Owning mqdes (NULL if none) */
 	pid_t ntpid;				/* Notification: Receiving Task's PID */
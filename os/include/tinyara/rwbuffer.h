@@ -81,6 +81,21 @@
 typedef ssize_t (*rwbreload_t)(FAR void *dev, FAR uint8_t *buffer, off_t startblock, size_t nblocks);
 typedef ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
 
+/* Buffer statistics, all counted in blocks except for the reloads and
+ * flushes.  A read served by the read-ahead buffer is a hit; anything that
+ * had to go to the media is a miss, whether it was read through the buffer
+ * or straight into the caller's one.
+ */
+
+struct rwb_stats_s {
+	uint32_t rdhits;			/* Blocks read from the read-ahead buffer */
+	uint32_t rdmisses;			/* Blocks read from the media */
+	uint32_t rhreloads;			/* Number of read-ahead buffer reloads */
+	uint32_t rhblocks;			/* Blocks loaded by those reloads */
+	uint32_t wrblocks;			/* Blocks written through the write buffer */
+	uint32_t wrflushes;			/* Number of write buffer flushes */
+};
+
 /* This structure holds the state of the buffers.  In typical usage,
  * an instance of this structure is declared within each block driver
  * status structure like:
@@ -164,7 +179,11 @@ struct rwbuffer_s {
 	uint8_t *rhbuffer;			/* Allocated read-ahead buffer */
 	uint16_t rhnblocks;			/* Number of blocks in read-ahead buffer */
 	off_t rhblockstart;			/* First block in read-ahead buffer */
+	off_t rhexpectedblock;		/* Block following the last one read */
+	uint16_t rhwindow;			/* Blocks to read ahead, grows with sequential reads */
 #endif
+
+	struct rwb_stats_s stats;	/* Hit/miss statistics */
 };
 
 /**********************************************************************
@@ -193,6 +212,13 @@ EXTERN "C" {
 	ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount, FAR uint8_t *rdbuffer);
 	ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount, FAR const uint8_t *wrbuffer);
 
+	/* Write any buffered data to the media */
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+	int rwb_flush(FAR struct rwbuffer_s *rwb);
+	int rwb_flushblocks(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks);
+#endif
+
 	/* Character oriented transfers */
 
 #ifdef CONFIG_DRVR_READBYTES
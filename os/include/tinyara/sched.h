@@ -500,6 +500,7 @@ struct tcb_s {
 	uint8_t pend_reprios[CONFIG_SEM_NNESTPRIO];
 #endif
 	uint8_t base_priority;		/* "Normal" priority of the thread     */
+	FAR struct semholder_s *holdsem;	/* Semaphores this thread holds counts on */
 #endif
 
 	uint8_t task_state;			/* Current state of the thread         */
@@ -514,6 +515,13 @@ struct tcb_s {
 #endif
 	FAR struct wdog_s *waitdog;	/* All timed waits used this wdog      */
 
+#ifdef CONFIG_SCHED_LATENCY
+	uint32_t readystamp;		/* Cycle count when made ready-to-run  */
+	uint32_t lockstamp;			/* Cycle count at the outer sched_lock() */
+	uint32_t lockpause;			/* Cycle count when switched out locked */
+	FAR void *lockcaller;		/* Caller of the outer sched_lock()    */
+#endif
+
 	/* Stack-Related Fields ****************************************************** */
 
 	size_t adj_stack_size;		/* Stack size after adjustment         */
@@ -523,6 +531,10 @@ struct tcb_s {
 	/* Need to deallocate stack            */
 	FAR void *adj_stack_ptr;	/* Adjusted stack_alloc_ptr for HW     */
 	/* The initial stack pointer value     */
+#ifdef CONFIG_SCHED_TCBCACHE
+	size_t cache_stack_size;	/* Stack size requested from the TCB   */
+	/* cache, 0 if not from there          */
+#endif
 
 #ifdef CONFIG_MPU_STACKGUARD
 	FAR void *stack_guard;          /* address of the stack guard */
@@ -60,6 +60,8 @@
 
 #include <semaphore.h>
 
+#include <tinyara/clock.h>
+
 #include <tinyara/fs/fs.h>
 
 /****************************************************************************
@@ -126,6 +128,30 @@ int sem_wait_for_isr(FAR sem_t *sem);
  */
 int sem_post_from_isr(FAR sem_t *sem);
 
+/****************************************************************************
+ * Name: sem_tickwait
+ *
+ * Description:
+ *   This function is a lighter weight version of sem_timedwait().  It is
+ *   non-standard.  The delay counts system ticks, so it is not affected by
+ *   changes of the time of day.  Also available to the user-space work
+ *   queue through a system call.
+ *
+ * Parameters:
+ *   sem   - Semaphore object
+ *   start - The system time that the delay is relative to.
+ *   delay - Ticks to wait from the start time until the semaphore is
+ *           posted.  If ticks is zero, then this function is equivalent
+ *           to sem_trywait().
+ *
+ * Return Value:
+ *   Zero (OK) is returned on success.  On failure, -1 (ERROR) is returned
+ *   and the errno is set appropriately (ETIMEDOUT on timeout).
+ *
+ ****************************************************************************/
+
+int sem_tickwait(FAR sem_t *sem, systime_t start, uint32_t delay);
+
 /****************************************************************************
  * Name: sem_reset
  *
@@ -125,6 +125,20 @@
 	(dev->ops->rxflowcontrol && dev->ops->rxflowcontrol(dev, n, u))
 #endif
 
+#ifdef CONFIG_SERIAL_TXDMA
+#define uart_dmasend(dev) \
+	((dev)->ops->dmasend ? (dev)->ops->dmasend(dev) : (void)0)
+#define uart_dmatxavail(dev) \
+	((dev)->ops->dmatxavail ? (dev)->ops->dmatxavail(dev) : (void)0)
+#endif
+
+#ifdef CONFIG_SERIAL_RXDMA
+#define uart_dmareceive(dev) \
+	((dev)->ops->dmareceive ? (dev)->ops->dmareceive(dev) : (void)0)
+#define uart_dmarxfree(dev) \
+	((dev)->ops->dmarxfree ? (dev)->ops->dmarxfree(dev) : (void)0)
+#endif
+
 /************************************************************************************
  * Public Types
  ************************************************************************************/
@@ -142,6 +156,23 @@ struct uart_buffer_s {
 	FAR char *buffer;			/* Pointer to the allocated buffer memory */
 };
 
+/* A DMA transfer into or out of one of the buffers.  The free (RX) or filled
+ * (TX) part of a circular buffer may wrap, so it is described as up to two
+ * contiguous pieces.  The lower half sets 'nbytes' to the number of bytes
+ * actually transferred before calling uart_recvchars_done() or
+ * uart_xmitchars_done().
+ */
+
+#if defined(CONFIG_SERIAL_RXDMA) || defined(CONFIG_SERIAL_TXDMA)
+struct uart_dmaxfer_s {
+	FAR char *buffer;			/* First piece */
+	FAR char *nbuffer;			/* Second piece at the start of the buffer, or NULL */
+	size_t length;				/* Length of the first piece */
+	size_t nlength;				/* Length of the second piece */
+	size_t nbytes;				/* Bytes transferred */
+};
+#endif
+
 /* This structure defines all of the operations providd by the architecture specific
  * logic.  All fields must be provided with non-NULL function pointers by the
  * caller of uart_register().
@@ -233,6 +264,24 @@ struct uart_ops_s {
 	 */
 
 	CODE bool(*txempty)(FAR struct uart_dev_s *dev);
+
+#ifdef CONFIG_SERIAL_RXDMA
+	/* Start a DMA receive into dev->dmarx, set up by uart_recvchars_dma(), and
+	 * learn that read() has freed room in the RX buffer.  Either may be NULL.
+	 */
+
+	CODE void (*dmareceive)(FAR struct uart_dev_s *dev);
+	CODE void (*dmarxfree)(FAR struct uart_dev_s *dev);
+#endif
+
+#ifdef CONFIG_SERIAL_TXDMA
+	/* Start a DMA send from dev->dmatx, set up by uart_xmitchars_dma(), and
+	 * learn that write() has added data to the TX buffer.  Either may be NULL.
+	 */
+
+	CODE void (*dmasend)(FAR struct uart_dev_s *dev);
+	CODE void (*dmatxavail)(FAR struct uart_dev_s *dev);
+#endif
 };
 
 /* This is the device structure used by the driver.  The caller of
@@ -277,6 +326,12 @@ struct uart_dev_s {
 
 	struct uart_buffer_s xmit;	/* Describes transmit buffer */
 	struct uart_buffer_s recv;	/* Describes receive buffer */
+#ifdef CONFIG_SERIAL_TXDMA
+	struct uart_dmaxfer_s dmatx;	/* TX DMA transfer in progress */
+#endif
+#ifdef CONFIG_SERIAL_RXDMA
+	struct uart_dmaxfer_s dmarx;	/* RX DMA transfer in progress */
+#endif
 
 	/* Driver interface */
 
@@ -347,6 +402,40 @@ void uart_xmitchars(FAR uart_dev_t *dev);
 
 void uart_recvchars(FAR uart_dev_t *dev);
 
+/************************************************************************************
+ * Name: uart_xmitchars_dma / uart_xmitchars_done
+ *
+ * Description:
+ *   For lower halves that send with DMA.  uart_xmitchars_dma() describes the
+ *   buffered TX data in dev->dmatx and calls the dmasend method; it is normally
+ *   called from dmatxavail or the TX interrupt.  When the transfer completes, the
+ *   lower half sets dev->dmatx.nbytes and calls uart_xmitchars_done(), which
+ *   releases the data and wakes writers.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_TXDMA
+void uart_xmitchars_dma(FAR uart_dev_t *dev);
+void uart_xmitchars_done(FAR uart_dev_t *dev);
+#endif
+
+/************************************************************************************
+ * Name: uart_recvchars_dma / uart_recvchars_done
+ *
+ * Description:
+ *   For lower halves that receive with DMA.  uart_recvchars_dma() describes the
+ *   free part of the RX buffer in dev->dmarx and calls the dmareceive method.
+ *   When data has arrived (transfer complete or line idle), the lower half sets
+ *   dev->dmarx.nbytes and calls uart_recvchars_done(), which publishes the data
+ *   and wakes readers.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_dma(FAR uart_dev_t *dev);
+void uart_recvchars_done(FAR uart_dev_t *dev);
+#endif
+
 /************************************************************************************
  * Name: uart_datareceived
  *
@@ -0,0 +1,281 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/event/evtgroup.c
+ *
+ *   Each waiter blocks on a private semaphore on its own stack, so a post
+ *   wakes exactly the threads whose condition became true and nobody has
+ *   to re-check the group after waking.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/evtgroup.h>
+
+#include <arch/irq.h>
+
+#ifdef CONFIG_EVTGROUP
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct evtgroup_waiter_s {
+	dq_entry_t node;			/* Link in the waiters of the group */
+	sem_t sem;					/* Posted when the wait is satisfied */
+	uint32_t events;			/* Events waited for */
+	uint32_t result;			/* Requested events that were set */
+	uint8_t flags;				/* EVTGROUP_WAITALL, EVTGROUP_CONSUME */
+	bool done;					/* The wait was satisfied */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: evtgroup_match
+ *
+ * Description:
+ *   Check the events of the group against a wait and, if satisfied, take
+ *   the events the wait consumes.  Called with interrupts disabled.
+ *
+ * Return Value:
+ *   The requested events that were set, or zero if the wait is not
+ *   satisfied.
+ *
+ ****************************************************************************/
+
+static uint32_t evtgroup_match(FAR struct evtgroup_s *grp, uint32_t events, int flags)
+{
+	uint32_t set = grp->events & events;
+
+	if (set == 0 || ((flags & EVTGROUP_WAITALL) != 0 && set != events)) {
+		return 0;
+	}
+
+	if ((flags & EVTGROUP_CONSUME) != 0) {
+		grp->events &= ~set;
+	}
+
+	return set;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: evtgroup_init
+ ****************************************************************************/
+
+void evtgroup_init(FAR struct evtgroup_s *grp, uint32_t events)
+{
+	DEBUGASSERT(grp != NULL);
+
+	grp->events = events;
+	dq_init(&grp->waiters);
+}
+
+/****************************************************************************
+ * Name: evtgroup_destroy
+ ****************************************************************************/
+
+int evtgroup_destroy(FAR struct evtgroup_s *grp)
+{
+	irqstate_t flags;
+	int ret = OK;
+
+	DEBUGASSERT(grp != NULL);
+
+	flags = irqsave();
+	if (!dq_empty(&grp->waiters)) {
+		ret = -EBUSY;
+	} else {
+		grp->events = 0;
+	}
+	irqrestore(flags);
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: evtgroup_post
+ ****************************************************************************/
+
+uint32_t evtgroup_post(FAR struct evtgroup_s *grp, uint32_t events)
+{
+	FAR struct evtgroup_waiter_s *waiter;
+	FAR struct evtgroup_waiter_s *next;
+	irqstate_t flags;
+	uint32_t set;
+	bool inisr;
+
+	DEBUGASSERT(grp != NULL);
+
+	/* Waking a higher priority waiter must not switch to it until the walk
+	 * is over, or the list could change under us.  Interrupt handlers never
+	 * switch context before they return.
+	 */
+
+	inisr = up_interrupt_context();
+	if (!inisr) {
+		sched_lock();
+	}
+
+	flags = irqsave();
+	grp->events |= events;
+
+	for (waiter = (FAR struct evtgroup_waiter_s *)grp->waiters.head; waiter && grp->events != 0; waiter = next) {
+		next = (FAR struct evtgroup_waiter_s *)waiter->node.flink;
+		set = evtgroup_match(grp, waiter->events, waiter->flags);
+		if (set != 0) {
+			dq_rem(&waiter->node, &grp->waiters);
+			waiter->result = set;
+			waiter->done = true;
+			sem_post(&waiter->sem);
+		}
+	}
+
+	set = grp->events;
+	irqrestore(flags);
+
+	if (!inisr) {
+		sched_unlock();
+	}
+
+	return set;
+}
+
+/****************************************************************************
+ * Name: evtgroup_clear
+ ****************************************************************************/
+
+uint32_t evtgroup_clear(FAR struct evtgroup_s *grp, uint32_t events)
+{
+	irqstate_t flags;
+	uint32_t prev;
+
+	DEBUGASSERT(grp != NULL);
+
+	flags = irqsave();
+	prev = grp->events;
+	grp->events = prev & ~events;
+	irqrestore(flags);
+
+	return prev;
+}
+
+/****************************************************************************
+ * Name: evtgroup_timedwait
+ ****************************************************************************/
+
+int evtgroup_timedwait(FAR struct evtgroup_s *grp, uint32_t events, int flags, uint32_t ticks, FAR uint32_t *result)
+{
+	struct evtgroup_waiter_s waiter;
+	irqstate_t irqflags;
+	uint32_t set;
+	int ret = OK;
+
+	if (grp == NULL || events == 0 || (flags & ~(EVTGROUP_WAITALL | EVTGROUP_CONSUME)) != 0) {
+		return -EINVAL;
+	}
+
+	irqflags = irqsave();
+
+	/* Already satisfied? */
+
+	set = evtgroup_match(grp, events, flags);
+	if (set != 0) {
+		goto out;
+	}
+
+	if (ticks == 0) {
+		ret = -ETIMEDOUT;
+		goto out;
+	}
+
+	DEBUGASSERT(!up_interrupt_context());
+
+	waiter.events = events;
+	waiter.flags = (uint8_t)flags;
+	waiter.result = 0;
+	waiter.done = false;
+	sem_init(&waiter.sem, 0, 0);
+	sem_setprotocol(&waiter.sem, SEM_PRIO_NONE);
+	dq_addlast(&waiter.node, &grp->waiters);
+
+	if (ticks == UINT32_MAX) {
+		ret = sem_wait(&waiter.sem);
+	} else {
+		ret = sem_tickwait(&waiter.sem, clock_systimer(), ticks);
+	}
+
+	if (ret < 0) {
+		ret = -get_errno();
+	}
+
+	/* A post that raced with a timeout or a signal still counts: its events
+	 * were already handed to us.
+	 */
+
+	if (waiter.done) {
+		ret = OK;
+	} else {
+		dq_rem(&waiter.node, &grp->waiters);
+	}
+
+	set = waiter.result;
+	sem_destroy(&waiter.sem);
+
+out:
+	irqrestore(irqflags);
+
+	if (result) {
+		*result = set;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: evtgroup_wait
+ ****************************************************************************/
+
+int evtgroup_wait(FAR struct evtgroup_s *grp, uint32_t events, int flags, FAR uint32_t *result)
+{
+	return evtgroup_timedwait(grp, events, flags, UINT32_MAX, result);
+}
+
+#endif							/* CONFIG_EVTGROUP */
@@ -69,6 +69,7 @@
 #include <tinyara/kthread.h>
 #include <tinyara/userspace.h>
 #include <tinyara/net/net.h>
+#include <tinyara/defer.h>
 #ifdef CONFIG_LOGM
 #include <tinyara/logm.h>
 #endif
@@ -194,7 +195,8 @@ static inline void os_pgworker(void)
  * Name: os_workqueues
  *
  * Description:
- *   Start the worker threads that service the work queues.
+ *   Start the worker threads that service the work queues and the
+ *   deferred call rings.
  *
  * Input Parameters:
  *   None
@@ -204,9 +206,16 @@ static inline void os_pgworker(void)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_WORKQUEUE
+#if defined(CONFIG_SCHED_WORKQUEUE) || defined(CONFIG_SCHED_DEFER)
 static inline void os_workqueues(void)
 {
+#ifdef CONFIG_SCHED_DEFER
+	/* Start the thread that runs calls deferred by interrupt handlers */
+
+	(void)defer_start();
+
+#endif							/* CONFIG_SCHED_DEFER */
+
 #ifdef CONFIG_SCHED_HPWORK
 	/* Start the high-priority worker thread to support device driver lower
 	 * halves.
@@ -226,10 +235,10 @@ static inline void os_workqueues(void)
 #endif							/* CONFIG_SCHED_LPWORK */
 }
 
-#else							/* CONFIG_SCHED_WORKQUEUE */
+#else							/* CONFIG_SCHED_WORKQUEUE || CONFIG_SCHED_DEFER */
 #define os_workqueues()
 
-#endif							/* CONFIG_SCHED_WORKQUEUE */
+#endif							/* CONFIG_SCHED_WORKQUEUE || CONFIG_SCHED_DEFER */
 
 /****************************************************************************
  * Name: os_start_application
@@ -499,6 +499,15 @@ void os_start(void)
 	 * that are different for each  processor and hardware platform.
 	 */
 
+#if defined(CONFIG_SCHED_CPULOAD_CYCLES) || defined(CONFIG_SCHED_LATENCY)
+	/* Start the cycle counter before the first interrupt can be taken */
+
+	up_cyclecount_initialize();
+#endif
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+	sched_cpuload_initialize();
+#endif
+
 	up_initialize();
 
 #if defined(CONFIG_TTRACE)
@@ -61,6 +61,9 @@
 #include <tinyara/irq.h>
 
 #include "irq/irq.h"
+#if defined(CONFIG_SCHED_CPULOAD_CYCLES) || defined(CONFIG_SCHED_LATENCY)
+#include "sched/sched.h"
+#endif
 
 /****************************************************************************
  * Definitions
@@ -99,6 +102,9 @@ void irq_dispatch(int irq, FAR void *context)
 {
 	xcpt_t vector;
 	FAR void *arg;
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+	int owner;
+#endif
 
 	/* Perform some sanity checks */
 
@@ -115,7 +121,17 @@ void irq_dispatch(int irq, FAR void *context)
 	arg    = NULL;
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY
+	sched_latency_irq(irq);
+#endif
+
 	/* Then dispatch to the interrupt handler */
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+	owner = sched_cpuload_irqenter(irq);
 	vector(irq, context, arg);
+	sched_cpuload_irqleave(owner);
+#else
+	vector(irq, context, arg);
+#endif
 }
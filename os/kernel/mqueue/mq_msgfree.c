@@ -96,6 +96,7 @@
  *   allocated dynamically it will be deallocated.
  *
  * Inputs:
+ *   msgq  - message queue the message was sent to
  *   mqmsg - message to free
  *
  * Return Value:
@@ -103,7 +104,7 @@
  *
  ************************************************************************/
 
-void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
+void mq_msgfree(FAR struct mqueue_inode_s *msgq, FAR struct mqueue_msg_s *mqmsg)
 {
 	irqstate_t saved_state;
 
@@ -135,6 +136,18 @@ void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
 		irqrestore(saved_state);
 	}
 
+#if MQ_MAX_QBYTES > MQ_MAX_BYTES
+	/* If this message came from the slab of the message queue, then
+	 * return it there.
+	 */
+
+	else if (mqmsg->type == MQ_ALLOC_SLAB) {
+		saved_state = irqsave();
+		sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->slabfree);
+		irqrestore(saved_state);
+	}
+#endif
+
 	/* Otherwise, deallocate it.  Note:  interrupt handlers
 	 * will never deallocate messages because they will not
 	 * received them.
@@ -117,8 +117,8 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode, FAR struct mq_attr *attr)
 	 * larger than the configured maximum message size.
 	 */
 
-	DEBUGASSERT(!attr || attr->mq_msgsize <= MQ_MAX_BYTES);
-	if (attr && attr->mq_msgsize > MQ_MAX_BYTES) {
+	DEBUGASSERT(!attr || attr->mq_msgsize <= MQ_MAX_QBYTES);
+	if (attr && attr->mq_msgsize > MQ_MAX_QBYTES) {
 		return NULL;
 	}
 
@@ -130,6 +130,9 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode, FAR struct mq_attr *attr)
 		/* Initialize the new named message queue */
 
 		sq_init(&msgq->msglist);
+#if MQ_MAX_QBYTES > MQ_MAX_BYTES
+		sq_init(&msgq->slabfree);
+#endif
 		if (attr) {
 			msgq->maxmsgs    = (int16_t)attr->mq_maxmsg;
 			msgq->maxmsgsize = (int16_t)attr->mq_msgsize;
@@ -56,6 +56,7 @@
 
 #include <tinyara/config.h>
 
+#include <string.h>
 #include <debug.h>
 #include <tinyara/kmalloc.h>
 #include "mqueue/mqueue.h"
@@ -106,18 +107,34 @@ void mq_msgqfree(FAR struct mqueue_inode_s *msgq)
 {
 	FAR struct mqueue_msg_s *curr;
 	FAR struct mqueue_msg_s *next;
+	FAR void *buffer;
 
 	/* Deallocate any stranded messages in the message queue. */
 
 	curr = (FAR struct mqueue_msg_s *)msgq->msglist.head;
 	while (curr) {
+		/* Nobody will receive the buffer of a message sent by reference */
+
+		if (curr->byref) {
+			memcpy(&buffer, (const void *)curr->mail, sizeof(FAR void *));
+			kumm_free(buffer);
+		}
+
 		/* Deallocate the message structure. */
 
 		next = curr->next;
-		mq_msgfree(curr);
+		mq_msgfree(msgq, curr);
 		curr = next;
 	}
 
+#if MQ_MAX_QBYTES > MQ_MAX_BYTES
+	/* All messages are back in the slab now */
+
+	if (msgq->slab) {
+		sched_kfree(msgq->slab);
+	}
+#endif
+
 	/* Then deallocate the message queue itself */
 
 	sched_kfree(msgq);
@@ -66,6 +66,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
 #include <tinyara/cancelpt.h>
 
 #include "sched/sched.h"
@@ -255,10 +256,14 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
  *   mqdes - Message queue descriptor
  *   mqmsg   - The message obtained by mq_waitmsg()
  *   ubuffer - The address of the user provided buffer to receive the message
+ *   ubufref - If ubuffer is NULL, the location to return a heap buffer
+ *             holding the message (mq_receiveref).  The caller owns it.
  *   prio    - The user-provided location to return the message priority.
  *
  * Return Value:
- *   Returns the length of the received message.  This function does not fail.
+ *   Returns the length of the received message.  This function only fails
+ *   (with errno ENOMEM, leaving the message queued) if ubufref is used and
+ *   no buffer can be allocated to hold a message that was copied in.
  *
  * Assumptions:
  * - The caller has provided all validity checking of the input parameters
@@ -269,22 +274,71 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
  *
  ****************************************************************************/
 
-ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuffer, int *prio)
+ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuffer, FAR void **ubufref, int *prio)
 {
 	FAR struct tcb_s *btcb;
 	irqstate_t saved_state;
 	FAR struct mqueue_inode_s *msgq;
+	FAR struct mqueue_msg_s *next;
+	FAR struct mqueue_msg_s *prev;
+	FAR void *buffer = NULL;
 	ssize_t rcvmsglen;
 
 	trace_begin(TTRACE_TAG_IPC, "mq_doreceive");
 
+	msgq = mqdes->msgq;
+
 	/* Get the length of the message (also the return value) */
 
 	rcvmsglen = mqmsg->msglen;
 
-	/* Copy the message into the caller's buffer */
+	/* A message sent by reference carries the sender's buffer */
+
+	if (mqmsg->byref) {
+		memcpy(&buffer, (const void *)mqmsg->mail, sizeof(FAR void *));
+	}
 
-	memcpy(ubuffer, (const void *)mqmsg->mail, rcvmsglen);
+	if (ubuffer) {
+		/* Copy the message into the caller's buffer */
+
+		if (buffer) {
+			memcpy(ubuffer, buffer, rcvmsglen);
+			kumm_free(buffer);
+		} else {
+			memcpy(ubuffer, (const void *)mqmsg->mail, rcvmsglen);
+		}
+	} else {
+		/* Hand over the sender's buffer, or one holding a copy */
+
+		if (!buffer) {
+			buffer = kumm_malloc(rcvmsglen > 0 ? rcvmsglen : 1);
+			if (!buffer) {
+				/* Put the message back where it was, ahead of any
+				 * message of the same priority.
+				 */
+
+				saved_state = irqsave();
+				for (prev = NULL, next = (FAR struct mqueue_msg_s *)msgq->msglist.head; next && mqmsg->priority < next->priority; prev = next, next = next->next) ;
+
+				if (prev) {
+					sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg, &msgq->msglist);
+				} else {
+					sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
+				}
+
+				msgq->nmsgs++;
+				irqrestore(saved_state);
+
+				set_errno(ENOMEM);
+				trace_end(TTRACE_TAG_IPC);
+				return ERROR;
+			}
+
+			memcpy(buffer, (const void *)mqmsg->mail, rcvmsglen);
+		}
+
+		*ubufref = buffer;
+	}
 
 	/* Copy the message priority as well (if a buffer is provided) */
 
@@ -294,11 +348,10 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 	/* We are done with the message.  Deallocate it now. */
 
-	mq_msgfree(mqmsg);
+	mq_msgfree(msgq, mqmsg);
 
 	/* Check if any tasks are waiting for the MQ not full event. */
 
-	msgq = mqdes->msgq;
 	if (msgq->nwaitnotfull > 0) {
 		/* Find the highest priority task that is waiting for
 		 * this queue to be not-full in g_waitingformqnotfull list.
@@ -183,7 +183,7 @@ ssize_t mq_receive(mqd_t mqdes, FAR char *msg, size_t msglen, FAR int *prio)
 	 */
 
 	if (mqmsg) {
-		ret = mq_doreceive(mqdes, mqmsg, msg, prio);
+		ret = mq_doreceive(mqdes, mqmsg, msg, NULL, prio);
 	}
 
 	sched_unlock();
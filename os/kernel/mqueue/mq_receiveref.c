@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <debug.h>
+#include <tinyara/arch.h>
+#include <tinyara/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_receiveref
+ *
+ * Description:
+ *   This function behaves like mq_receive() but, instead of copying the
+ *   message into a caller's buffer, returns a heap buffer holding it.  If
+ *   the message was sent with mq_sendref(), that is the sender's buffer
+ *   and nothing is copied.  Otherwise a buffer is allocated and the
+ *   message copied into it.  Either way the caller must free() it.
+ *
+ * Parameters:
+ *   mqdes - Message Queue Descriptor
+ *   bufref - The location to return the buffer holding the message
+ *   prio - If not NULL, the location to store message priority.
+ *
+ * Return Value:
+ *   One success, the length of the selected message in bytes is returned.
+ *   On failure, -1 (ERROR) is returned and the errno is set as described
+ *   for mq_receive(), or to ENOMEM if a copied message could not be put
+ *   into a buffer (the message then stays queued).
+ *
+ ****************************************************************************/
+
+ssize_t mq_receiveref(mqd_t mqdes, FAR void **bufref, FAR int *prio)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+	irqstate_t saved_state;
+	ssize_t ret = ERROR;
+
+	DEBUGASSERT(up_interrupt_context() == false);
+
+	/* mq_receiveref() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	if (!bufref || !mqdes) {
+		set_errno(EINVAL);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	if ((mqdes->oflags & O_RDOK) == 0) {
+		set_errno(EPERM);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	/* Get the next message from the message queue, exactly as mq_receive()
+	 * does.
+	 */
+
+	sched_lock();
+	saved_state = irqsave();
+	mqmsg = mq_waitreceive(mqdes);
+	irqrestore(saved_state);
+
+	if (mqmsg) {
+		ret = mq_doreceive(mqdes, mqmsg, NULL, bufref, prio);
+	}
+
+	sched_unlock();
+	leave_cancellation_point();
+	return ret;
+}
@@ -0,0 +1,111 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include  <tinyara/config.h>
+
+#include  <sys/types.h>
+#include  <mqueue.h>
+#include  <errno.h>
+#include  <assert.h>
+#include  <debug.h>
+
+#include  <tinyara/arch.h>
+#include  <tinyara/cancelpt.h>
+
+#include  "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_sendref
+ *
+ * Description:
+ *   This function behaves like mq_send() but does not copy the message.
+ *   Instead, ownership of "buf", which must have been obtained from
+ *   malloc(), passes to the message queue and then to the receiver:
+ *   mq_receiveref() returns the very same buffer, while mq_receive()
+ *   copies it out and frees it.  If the queue is deleted with the
+ *   message still queued, the buffer is freed.
+ *
+ *   On failure, the caller still owns "buf".
+ *
+ * Parameters:
+ *   mqdes - Message queue descriptor
+ *   buf - Heap buffer holding the message
+ *   buflen - The length of the message in bytes, which must not exceed
+ *            the maximum message length from mq_getattr()
+ *   prio - The priority of the message
+ *
+ * Return Value:
+ *   On success, mq_sendref() returns 0 (OK); on error, -1 (ERROR)
+ *   is returned, with errno set as described for mq_send().
+ *
+ ****************************************************************************/
+
+int mq_sendref(mqd_t mqdes, FAR void *buf, size_t buflen, int prio)
+{
+	FAR struct mqueue_inode_s *msgq;
+	FAR struct mqueue_msg_s *mqmsg = NULL;
+	irqstate_t saved_state;
+	int ret = ERROR;
+
+	/* The reference must fit into any message */
+
+	DEBUGASSERT(sizeof(FAR void *) <= MQ_MAX_BYTES);
+
+	/* mq_sendref() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	if (mq_verifysend(mqdes, (FAR const char *)buf, buflen, prio) != OK) {
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	sched_lock();
+	msgq = mqdes->msgq;
+
+	/* Allocate a message structure just as mq_send() does.  It only needs
+	 * to hold the reference, so it always comes from the common pool.
+	 */
+
+	saved_state = irqsave();
+	if (up_interrupt_context() ||	/* In an interrupt handler */
+		msgq->nmsgs < msgq->maxmsgs ||	/* OR Message queue not full */
+		mq_waitsend(mqdes) == OK) {	/* OR Successfully waited for mq not full */
+		irqrestore(saved_state);
+		mqmsg = mq_msgalloc(msgq, sizeof(FAR void *));
+	} else {
+		irqrestore(saved_state);
+	}
+
+	if (mqmsg) {
+		mqmsg->byref = true;
+		ret = mq_dosend(mqdes, mqmsg, (FAR const char *)buf, buflen, prio);
+	}
+
+	sched_unlock();
+	leave_cancellation_point();
+	return ret;
+}
@@ -149,13 +149,82 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
 	return OK;
 }
 
+/****************************************************************************
+ * Name: mq_slaballoc
+ *
+ * Description:
+ *   Get a message of msgq->maxmsgsize bytes from the slab of the message
+ *   queue.  The slab holds one message for each message the queue can
+ *   hold and is allocated the first time it is needed, outside of
+ *   interrupt handlers.  If it is exhausted (interrupt handlers may
+ *   overfill a queue), a message of that size is allocated instead.
+ *
+ * Inputs:
+ *   msgq - The message queue the message will be sent to
+ *
+ * Return Value:
+ *   A reference to the allocated msg structure or NULL if none is available
+ *   to an interrupt handler.
+ *
+ ****************************************************************************/
+
+#if MQ_MAX_QBYTES > MQ_MAX_BYTES
+static FAR struct mqueue_msg_s *mq_slaballoc(FAR struct mqueue_inode_s *msgq)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+	FAR uint8_t *slab;
+	sq_queue_t slabfree;
+	irqstate_t saved_state;
+	size_t size = MQ_MSG_SIZE(msgq->maxmsgsize);
+	int i;
+
+	saved_state = irqsave();
+	mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->slabfree);
+	irqrestore(saved_state);
+
+	if (mqmsg || up_interrupt_context()) {
+		return mqmsg;
+	}
+
+	if (!msgq->slab) {
+		slab = (FAR uint8_t *)kmm_malloc(size * msgq->maxmsgs);
+		if (slab) {
+			/* Carve the messages out of the slab, keeping one for us */
+
+			sq_init(&slabfree);
+			for (i = 0; i < msgq->maxmsgs; i++) {
+				mqmsg = (FAR struct mqueue_msg_s *)(slab + i * size);
+				mqmsg->type = MQ_ALLOC_SLAB;
+				if (i > 0) {
+					sq_addlast((FAR sq_entry_t *)mqmsg, &slabfree);
+				}
+			}
+
+			mqmsg = (FAR struct mqueue_msg_s *)slab;
+
+			saved_state = irqsave();
+			msgq->slab = slab;
+			msgq->slabfree = slabfree;
+			irqrestore(saved_state);
+			return mqmsg;
+		}
+	}
+
+	mqmsg = (FAR struct mqueue_msg_s *)kmm_malloc(size);
+	ASSERT(mqmsg);
+	mqmsg->type = MQ_ALLOC_DYN;
+	return mqmsg;
+}
+#endif
+
 /****************************************************************************
  * Name: mq_msgalloc
  *
  * Description:
  *   The mq_msgalloc function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  Messages of up to MQ_MAX_BYTES will be allocated
+ *   from the g_msgfree list, larger ones from the slab of the message
+ *   queue.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -168,7 +237,8 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
  *   handler will be notified.
  *
  * Inputs:
- *   None
+ *   msgq   - The message queue the message will be sent to
+ *   msglen - The number of bytes of data the message must hold
  *
  * Return Value:
  *   A reference to the allocated msg structure.  On a failure to allocate,
@@ -176,11 +246,22 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
  *
  ****************************************************************************/
 
-FAR struct mqueue_msg_s *mq_msgalloc(void)
+FAR struct mqueue_msg_s *mq_msgalloc(FAR struct mqueue_inode_s *msgq, size_t msglen)
 {
 	FAR struct mqueue_msg_s *mqmsg;
 	irqstate_t saved_state;
 
+#if MQ_MAX_QBYTES > MQ_MAX_BYTES
+	if (msglen > MQ_MAX_BYTES) {
+		mqmsg = mq_slaballoc(msgq);
+		if (mqmsg) {
+			mqmsg->byref = false;
+		}
+
+		return mqmsg;
+	}
+#endif
+
 	/* If we were called from an interrupt handler, then try to get the message
 	 * from generally available list of messages. If this fails, then try the
 	 * list of messages reserved for interrupt handlers
@@ -220,6 +301,10 @@ FAR struct mqueue_msg_s *mq_msgalloc(void)
 		}
 	}
 
+	if (mqmsg) {
+		mqmsg->byref = false;
+	}
+
 	return mqmsg;
 }
 
@@ -335,6 +420,8 @@ int mq_waitsend(mqd_t mqdes)
  *
  * Parameters:
  *   mqdes - Message queue descriptor
+ *   mqmsg - Message from mq_msgalloc(); with byref set, msg is a heap
+ *           buffer whose ownership passes to the receiver
  *   msg - Message to send
  *   msglen - The length of the message in bytes
  *   prio - The priority of the message
@@ -366,9 +453,15 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 	mqmsg->priority = prio;
 	mqmsg->msglen = msglen;
 
-	/* Copy the message data into the message */
+	/* Copy the message data into the message, or only the reference to it
+	 * if the caller gives up the buffer (mq_sendref).
+	 */
 
-	memcpy((void *)mqmsg->mail, (FAR const void *)msg, msglen);
+	if (mqmsg->byref) {
+		memcpy((void *)mqmsg->mail, (FAR const void *)&msg, sizeof(FAR const char *));
+	} else {
+		memcpy((void *)mqmsg->mail, (FAR const void *)msg, msglen);
+	}
 
 	/* Insert the new message in the message queue */
 
@@ -311,7 +311,7 @@ ssize_t mq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen, FAR int *prio
 	 */
 
 	if (mqmsg) {
-		ret = mq_doreceive(mqdes, mqmsg, msg, prio);
+		ret = mq_doreceive(mqdes, mqmsg, msg, NULL, prio);
 	}
 
 	sched_unlock();
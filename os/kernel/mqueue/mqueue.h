@@ -63,6 +63,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <limits.h>
 #include <mqueue.h>
 #include <sched.h>
@@ -77,6 +78,7 @@
  ****************************************************************************/
 
 #define MQ_MAX_BYTES   CONFIG_MQ_MAXMSGSIZE
+#define MQ_MAX_QBYTES  MQ_QUEUE_MAXMSGSIZE
 #define MQ_MAX_MSGS    16
 #define MQ_PRIO_MAX    _POSIX_MQ_PRIO_MAX
 
@@ -92,6 +94,11 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* Size of a message structure with room for 'n' bytes of data */
+
+#define MQ_MSG_SIZE(n) \
+	(((offsetof(struct mqueue_msg_s, mail) + (n)) + sizeof(FAR void *) - 1) & ~(sizeof(FAR void *) - 1))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -99,7 +106,8 @@
 enum mqalloc_e {
 	MQ_ALLOC_FIXED = 0,			/* pre-allocated; never freed */
 	MQ_ALLOC_DYN,				/* dynamically allocated; free when unused */
-	MQ_ALLOC_IRQ				/* Preallocated, reserved for interrupt handling */
+	MQ_ALLOC_IRQ,				/* Preallocated, reserved for interrupt handling */
+	MQ_ALLOC_SLAB				/* From the slab of the message queue */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -108,12 +116,14 @@ struct mqueue_msg_s {
 	FAR struct mqueue_msg_s *next;	/* Forward link to next message */
 	uint8_t type;					/* (Used to manage allocations) */
 	uint8_t priority;				/* priority of message */
-#if MQ_MAX_BYTES < 256
+#if MQ_MAX_QBYTES < 256
 	uint8_t msglen;					/* Message data length */
 #else
 	uint16_t msglen;				/* Message data length */
 #endif
-	char mail[MQ_MAX_BYTES];		/* Message data */
+	bool byref;						/* mail holds a pointer to a heap buffer */
+	char mail[MQ_MAX_BYTES];		/* Message data.  Messages from a slab
+									 * are MQ_MSG_SIZE(maxmsgsize) long. */
 };
 
 /****************************************************************************
@@ -156,7 +166,7 @@ void weak_function mq_initialize(void);
 void mq_desblockalloc(void);
 
 FAR struct mqueue_inode_s *mq_findnamed(FAR const char *mq_name);
-void mq_msgfree(FAR struct mqueue_msg_s *mqmsg);
+void mq_msgfree(FAR struct mqueue_inode_s *msgq, FAR struct mqueue_msg_s *mqmsg);
 
 /* mq_waitirq.c ************************************************************/
 
@@ -166,12 +176,12 @@ void mq_waitirq(FAR struct tcb_s *wtcb, int errcode);
 
 int mq_verifyreceive(mqd_t mqdes, FAR char *msg, size_t msglen);
 FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes);
-ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuffer, FAR int *prio);
+ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuffer, FAR void **ubufref, FAR int *prio);
 
 /* mq_sndinternal.c ********************************************************/
 
 int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio);
-FAR struct mqueue_msg_s *mq_msgalloc(void);
+FAR struct mqueue_msg_s *mq_msgalloc(FAR struct mqueue_inode_s *msgq, size_t msglen);
 int mq_waitsend(mqd_t mqdes);
 int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg, size_t msglen, int prio);
 
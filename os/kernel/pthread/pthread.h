@@ -136,6 +136,16 @@ int pthread_sem_trytake(sem_t *sem);
 #define pthread_mutex_give(m)   pthread_givesemaphore(&(m)->sem)
 #endif
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+bool pthread_mutex_fastlock(FAR struct pthread_mutex_s *mutex, int mypid);
+bool pthread_mutex_fastunlock(FAR struct pthread_mutex_s *mutex, int mypid);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+void pthread_mutex_addowner(FAR struct pthread_mutex_s *mutex);
+#else
+#define pthread_mutex_addowner(m)
+#endif
+#endif
+
 #if defined(CONFIG_CANCELLATION_POINTS) && !defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
 uint16_t pthread_disable_cancel(void);
 void pthread_enable_cancel(uint16_t oldstate);
@@ -263,7 +263,11 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr, pthrea
 
 	/* Allocate a TCB for the new task. */
 
+#ifdef CONFIG_SCHED_TCBCACHE
+	ptcb = (FAR struct pthread_tcb_s *)sched_tcballoc(TCB_FLAG_TTYPE_PTHREAD, attr->stacksize);
+#else
 	ptcb = (FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s));
+#endif
 	if (!ptcb) {
 		sdbg("ERROR: Failed to allocate TCB\n");
 		return ENOMEM;
@@ -0,0 +1,271 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/pthread/pthread_mutexfast.c
+ *
+ * The uncontended mutex fast path.  An unlocked mutex has pid == -1 and a
+ * semaphore count of one.  The fast lock takes the count with an exclusive
+ * compare-and-swap from one and only then records itself in the pid word,
+ * so that the mutex is never owned by a pid that does not hold the count.
+ * The fast unlock clears the pid and gives the count back with a
+ * compare-and-swap from zero, which fails if a waiter has decremented it
+ * below zero; then the pid is put back and the ordinary sem_post() path
+ * is used.
+ *
+ * Neither path disables interrupts or locks the scheduler.  A thread that
+ * must wait for the mutex calls pthread_mutex_addowner() with the scheduler
+ * locked so that the owner becomes a holder of the semaphore and inherits
+ * the waiter's priority exactly as if it had called sem_wait().
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/sched.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+#include "pthread/pthread.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_cas16
+ *
+ * Description:
+ *   Compare-and-swap of a half-word.  GCC emits an LDREXH/STREXH loop for
+ *   this on ARMv7-M and ARMv7-R.
+ *
+ ****************************************************************************/
+
+static inline bool pthread_cas16(FAR int16_t *word, int16_t expect, int16_t desired)
+{
+	return __atomic_compare_exchange_n(word, &expect, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+/****************************************************************************
+ * Name: pthread_mutex_link, pthread_mutex_unlink
+ *
+ * Description:
+ *   Add the mutex to or remove it from the list of mutexes held by the
+ *   running thread.  The list is only changed by its owner, and every
+ *   single store leaves it consistent for pthread_mutex_inconsistent(), so
+ *   interrupts need not be disabled here.
+ *
+ ****************************************************************************/
+
+static inline void pthread_mutex_link(FAR struct pthread_mutex_s *mutex)
+{
+	FAR struct pthread_tcb_s *rtcb = (FAR struct pthread_tcb_s *)this_task();
+
+	DEBUGASSERT(mutex->flink == NULL);
+	mutex->flink = rtcb->mhead;
+	rtcb->mhead = mutex;
+}
+
+static inline void pthread_mutex_unlink(FAR struct pthread_mutex_s *mutex)
+{
+	FAR struct pthread_tcb_s *rtcb = (FAR struct pthread_tcb_s *)this_task();
+	FAR struct pthread_mutex_s *curr;
+	FAR struct pthread_mutex_s *prev;
+
+	for (prev = NULL, curr = rtcb->mhead; curr != NULL && curr != mutex; prev = curr, curr = curr->flink) ;
+
+	DEBUGASSERT(curr == mutex);
+	if (prev == NULL) {
+		rtcb->mhead = mutex->flink;
+	} else {
+		prev->flink = mutex->flink;
+	}
+
+	mutex->flink = NULL;
+}
+#else
+#define pthread_mutex_link(m)
+#define pthread_mutex_unlink(m)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_fastlock
+ *
+ * Description:
+ *   Take the mutex if it is free, without blocking and without entering
+ *   the semaphore logic.
+ *
+ * Parameters:
+ *   mutex - The mutex to be locked
+ *   mypid - The ID of the calling thread
+ *
+ * Return Value:
+ *   true if the caller now owns the mutex.  false if the mutex is held,
+ *   being handed over, or inconsistent; the caller must then take the
+ *   slow path, which also deals with relocking and robustness.
+ *
+ ****************************************************************************/
+
+bool pthread_mutex_fastlock(FAR struct pthread_mutex_s *mutex, int mypid)
+{
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+	if ((mutex->flags & _PTHREAD_MFLAGS_INCONSISTENT) != 0) {
+		return false;
+	}
+#endif
+
+	/* The count decides who owns the mutex.  Claiming the pid first would
+	 * let a thread that takes and releases the mutex through the semaphore
+	 * in between reset the pid, leaving the mutex held by nobody that
+	 * pthread_mutex_unlock() would accept.  Until the pid is stored a
+	 * waiter does not know whom to boost; it still blocks on the count and
+	 * the unlock, seeing it, goes through sem_post().
+	 */
+
+	if (!pthread_cas16(&mutex->sem.semcount, 1, 0)) {
+		return false;
+	}
+
+	mutex->pid = mypid;
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+	mutex->nlocks = 1;
+#endif
+	pthread_mutex_link(mutex);
+	return true;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_fastunlock
+ *
+ * Description:
+ *   Release a mutex that the caller holds once and that nobody waits for,
+ *   without entering the semaphore logic.
+ *
+ * Parameters:
+ *   mutex - The mutex to be unlocked
+ *   mypid - The ID of the calling thread
+ *
+ * Return Value:
+ *   true if the mutex has been released.  false if the caller must take
+ *   the slow path: the mutex is not held by the caller, is held
+ *   recursively, has waiters or has priority inheritance holders.
+ *
+ ****************************************************************************/
+
+bool pthread_mutex_fastunlock(FAR struct pthread_mutex_s *mutex, int mypid)
+{
+	if (mutex->pid != mypid || mutex->sem.semcount != 0 || sem_hasholders(&mutex->sem)) {
+		return false;
+	}
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+	if (mutex->nlocks > 1) {
+		return false;
+	}
+	mutex->nlocks = 0;
+#endif
+
+	/* The mutex is still ours until the count is given back.  The pid goes
+	 * first so that it is never left behind for the next owner.
+	 */
+
+	pthread_mutex_unlink(mutex);
+	mutex->pid = -1;
+	if (!pthread_cas16(&mutex->sem.semcount, 0, 1)) {
+		/* A waiter arrived since the check above */
+
+		mutex->pid = mypid;
+		pthread_mutex_link(mutex);
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+		mutex->nlocks = 1;
+#endif
+		return false;
+	}
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	/* A waiter that made us a holder and then gave up waiting (signal) may
+	 * have left its record behind.  Its departure already restored our
+	 * priority; only the record is left to discard.
+	 */
+
+	if (sem_hasholders(&mutex->sem)) {
+		irqstate_t flags = irqsave();
+		sem_dropholder(&mutex->sem);
+		irqrestore(flags);
+	}
+#endif
+
+	return true;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_addowner
+ *
+ * Description:
+ *   Called with the scheduler locked by a thread about to wait for the
+ *   mutex.  If the owner took the mutex on the fast path it is not known
+ *   to the semaphore yet; make it a holder so that the wait boosts its
+ *   priority and its unlock goes through sem_post().
+ *
+ * Parameters:
+ *   mutex - The mutex about to be waited for
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+void pthread_mutex_addowner(FAR struct pthread_mutex_s *mutex)
+{
+	FAR struct tcb_s *htcb;
+	irqstate_t flags;
+	int pid = mutex->pid;
+
+	if (mutex->sem.semcount > 0 || pid <= 0 || sem_hasholders(&mutex->sem)) {
+		return;
+	}
+
+	htcb = sched_gettcb(pid);
+	if (htcb != NULL) {
+		/* The owner unlocks what it locked, even if an earlier fast path
+		 * unlock made the mutex look like a signalling semaphore.
+		 */
+
+		flags = irqsave();
+		mutex->sem.flags &= ~PRIOINHERIT_FLAGS_SIGNAL;
+		sem_addholder_tcb(htcb, &mutex->sem);
+		irqrestore(flags);
+	}
+}
+#endif
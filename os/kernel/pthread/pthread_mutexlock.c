@@ -150,6 +150,14 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
 	DEBUGASSERT(mutex != NULL);
 
 	if (mutex != NULL) {
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+		/* Nothing more to do if the mutex was free */
+
+		if (pthread_mutex_fastlock(mutex, mypid)) {
+			return OK;
+		}
+#endif
+
 		/* Make sure the semaphore is stable while we make the following
 		 * checks.  This all needs to be one atomic action.
 		 */
@@ -232,6 +240,9 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
 			 * default mutex.
 			 */
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+			pthread_mutex_addowner(mutex);
+#endif
 			ret = pthread_mutex_take(mutex, true);
 
 			/* If we succussfully obtained the semaphore, then indicate
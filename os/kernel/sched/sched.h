@@ -110,7 +110,9 @@
 struct pidhash_s {
 	FAR struct tcb_s *tcb;		/* TCB assigned to this PID */
 	pid_t pid;					/* The full PID value */
-#ifdef CONFIG_SCHED_CPULOAD
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+	uint64_t cycles;			/* Number of CPU cycles on this thread */
+#elif defined(CONFIG_SCHED_CPULOAD)
 	uint32_t ticks;				/* Number of ticks on this thread */
 #endif
 };
@@ -230,12 +232,17 @@ extern struct pidhash_s g_pidhash[CONFIG_MAX_TASKS];
 extern const struct tasklist_s g_tasklisttable[NUM_TASK_STATES];
 
 #ifdef CONFIG_SCHED_CPULOAD
-/* This is the total number of clock tick counts.  Essentially the
- * 'denominator' for all CPU load calculations.
+/* This is the total number of clock tick counts (or CPU cycles with
+ * CONFIG_SCHED_CPULOAD_CYCLES).  Essentially the 'denominator' for all CPU
+ * load calculations.
  */
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+extern volatile uint64_t g_cpuload_total;
+#else
 extern volatile uint32_t g_cpuload_total;
 #endif
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -270,7 +277,37 @@ void sched_timer_reassess(void);
 void weak_function sched_process_cpuload(void);
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+void sched_cpuload_initialize(void);
+void sched_cpuload_switch(FAR struct tcb_s *rtcb);
+int sched_cpuload_irqenter(int irq);
+void sched_cpuload_irqleave(int owner);
+#else
+#define sched_cpuload_switch(rtcb)
+#endif
+
+#ifdef CONFIG_SCHED_LATENCY
+void sched_latency_ready(FAR struct tcb_s *tcb);
+void sched_latency_switch(FAR struct tcb_s *rtcb, FAR struct tcb_s *ntcb);
+void sched_latency_irq(int irq);
+void sched_latency_lock(FAR struct tcb_s *rtcb, FAR void *caller);
+void sched_latency_unlock(FAR struct tcb_s *rtcb);
+#ifdef CONFIG_SCHED_DEFER
+void sched_latency_defer(int prio, uint32_t cycles, FAR void *func);
+#endif
+#else
+#define sched_latency_ready(tcb)
+#define sched_latency_switch(rtcb, ntcb)
+#define sched_latency_lock(rtcb, caller)
+#define sched_latency_unlock(rtcb)
+#endif
+
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
+#ifdef CONFIG_SCHED_TCBCACHE
+FAR struct tcb_s *sched_tcballoc(uint8_t ttype, size_t stack_size);
+void sched_tcbfree(FAR struct tcb_s *tcb, uint8_t ttype);
+#endif
+
 #endif							/* __SCHED_SCHED_SCHED_H */
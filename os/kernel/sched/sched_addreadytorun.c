@@ -122,6 +122,10 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 	FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_readytorun.head;
 	bool ret;
 
+	/* Start the wake-up latency clock of btcb */
+
+	sched_latency_ready(btcb);
+
 	/* Check if pre-emption is disabled for the current running task and if
 	 * the new ready-to-run task would cause the current running task to be
 	 * pre-empted.
@@ -143,6 +147,8 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 		/* Inform the instrumentation logic that we are switching tasks */
 
 		sched_note_switch(rtcb, btcb);
+		sched_cpuload_switch(rtcb);
+		sched_latency_switch(rtcb, btcb);
 
 		/* The new btcb was added at the head of the ready-to-run list.  It
 		 * is now to new active task!
@@ -59,6 +59,7 @@
 #include <errno.h>
 #include <assert.h>
 
+#include <tinyara/arch.h>
 #include <tinyara/clock.h>
 #include <arch/irq.h>
 
@@ -82,6 +83,22 @@
 #define CPULOAD_TICKSPERSEC CLOCKS_PER_SEC
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+/* Cycles since g_cpuload_stamp belong to the thread at the head of the
+ * ready-to-run list when g_cpuload_owner is CPULOAD_THREAD, otherwise to
+ * the IRQ number in g_cpuload_owner.
+ */
+
+#define CPULOAD_THREAD  (-1)
+
+/* Cycle counts are scaled down below this before they are returned in a
+ * struct cpuload_s, so that callers can still compute 1000 * active / total
+ * in 32 bits.
+ */
+
+#define CPULOAD_MAXTOTAL (1ul << 22)
+#endif
+
 /************************************************************************
  * Private Type Declarations
  ************************************************************************/
@@ -94,20 +111,181 @@
  * Private Variables
  ************************************************************************/
 
-/* This is the total number of clock tick counts.  Essentially the
- * 'denominator' for all CPU load calculations.
+/* This is the total number of clock tick counts (or CPU cycles).
+ * Essentially the 'denominator' for all CPU load calculations.
  */
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+volatile uint64_t g_cpuload_total;
+
+static uint32_t g_cpuload_ticks;	/* Ticks since the counts were last aged */
+static uint32_t g_cpuload_stamp;	/* Cycle count at the last accounting point */
+static int g_cpuload_owner = CPULOAD_THREAD;
+
+static uint64_t g_cpuload_irq[NR_IRQS];	/* Cycles spent in each interrupt */
+static uint64_t g_cpuload_overhead;	/* Cycles spent in the accounting hooks */
+static uint32_t g_cpuload_events;	/* Number of hook invocations */
+#else
 volatile uint32_t g_cpuload_total;
+#endif
 
 /************************************************************************
  * Private Functions
  ************************************************************************/
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+/************************************************************************
+ * Name: cpuload_charge
+ *
+ * Description:
+ *   Charge the cycles since the last accounting point to their owner:
+ *   the interrupt being serviced, or else rtcb.  Returns the cycle count
+ *   that is the new accounting point.  Interrupts must be disabled.
+ *
+ ************************************************************************/
+
+static inline uint32_t cpuload_charge(FAR struct tcb_s *rtcb)
+{
+	uint32_t now = up_cyclecount();
+	uint32_t elapsed = now - g_cpuload_stamp;
+
+	if (g_cpuload_owner == CPULOAD_THREAD) {
+		g_pidhash[PIDHASH(rtcb->pid)].cycles += elapsed;
+	} else {
+		g_cpuload_irq[g_cpuload_owner] += elapsed;
+	}
+
+	g_cpuload_total += elapsed;
+	g_cpuload_stamp = now;
+	return now;
+}
+
+/************************************************************************
+ * Name: cpuload_overhead
+ *
+ * Description:
+ *   Account the cycles spent in a hook since 'start' as overhead rather
+ *   than charging them to the next owner.  Interrupts must be disabled.
+ *
+ ************************************************************************/
+
+static inline void cpuload_overhead(uint32_t start)
+{
+	uint32_t now = up_cyclecount();
+
+	g_cpuload_overhead += now - start;
+	g_cpuload_total += now - start;
+	g_cpuload_events++;
+	g_cpuload_stamp = now;
+}
+
+/************************************************************************
+ * Name: cpuload_scale
+ *
+ * Description:
+ *   Return 'active' cycles out of the total in a struct cpuload_s.
+ *
+ ************************************************************************/
+
+static void cpuload_scale(FAR struct cpuload_s *cpuload, uint64_t active)
+{
+	uint64_t total = g_cpuload_total;
+
+	while (total >= CPULOAD_MAXTOTAL) {
+		total >>= 1;
+		active >>= 1;
+	}
+
+	cpuload->total = (uint32_t)total;
+	cpuload->active = (uint32_t)active;
+}
+#endif
+
 /************************************************************************
  * Public Functions
  ************************************************************************/
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+/************************************************************************
+ * Name: sched_cpuload_initialize
+ *
+ * Description:
+ *   Take the first accounting point.  Called once, after the cycle counter
+ *   has been started and before interrupts are enabled.
+ *
+ ************************************************************************/
+
+void sched_cpuload_initialize(void)
+{
+	g_cpuload_stamp = up_cyclecount();
+}
+
+/************************************************************************
+ * Name: sched_cpuload_switch
+ *
+ * Description:
+ *   Called when rtcb gives up the CPU.  The cycles since the last
+ *   accounting point are charged to rtcb.
+ *
+ *   A switch made by an interrupt handler changes nothing here: the
+ *   cycles up to now belong to the interrupt and those after it to the
+ *   new thread, which sched_cpuload_irqleave() takes care of.
+ *
+ ************************************************************************/
+
+void sched_cpuload_switch(FAR struct tcb_s *rtcb)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	if (g_cpuload_owner == CPULOAD_THREAD) {
+		cpuload_overhead(cpuload_charge(rtcb));
+	}
+
+	irqrestore(flags);
+}
+
+/************************************************************************
+ * Name: sched_cpuload_irqenter and sched_cpuload_irqleave
+ *
+ * Description:
+ *   Bracket the dispatch of an interrupt.  The cycles before entry are
+ *   charged to the interrupted thread (or interrupt, if nested) and those
+ *   inside to 'irq'.  sched_cpuload_irqenter() returns the previous owner
+ *   which must be passed back to sched_cpuload_irqleave().
+ *
+ ************************************************************************/
+
+int sched_cpuload_irqenter(int irq)
+{
+	irqstate_t flags;
+	int owner;
+
+	flags = irqsave();
+	owner = g_cpuload_owner;
+	if ((unsigned)irq < NR_IRQS) {
+		uint32_t start = cpuload_charge((FAR struct tcb_s *)g_readytorun.head);
+		g_cpuload_owner = irq;
+		cpuload_overhead(start);
+	}
+
+	irqrestore(flags);
+	return owner;
+}
+
+void sched_cpuload_irqleave(int owner)
+{
+	irqstate_t flags;
+	uint32_t start;
+
+	flags = irqsave();
+	start = cpuload_charge((FAR struct tcb_s *)g_readytorun.head);
+	g_cpuload_owner = owner;
+	cpuload_overhead(start);
+	irqrestore(flags);
+}
+#endif
+
 /************************************************************************
  * Name: sched_process_cpuload
  *
@@ -126,6 +304,37 @@ volatile uint32_t g_cpuload_total;
  *
  ************************************************************************/
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+void weak_function sched_process_cpuload(void)
+{
+	uint64_t total;
+	int i;
+
+	/* The cycles are accounted at each switch and interrupt.  The tick is
+	 * only used to age them with the same time constant as the tick
+	 * based measurement.
+	 */
+
+	if (++g_cpuload_ticks > (CONFIG_SCHED_CPULOAD_TIMECONSTANT * CPULOAD_TICKSPERSEC)) {
+		g_cpuload_ticks >>= 1;
+		total = 0;
+
+		for (i = 0; i < CONFIG_MAX_TASKS; i++) {
+			g_pidhash[i].cycles >>= 1;
+			total += g_pidhash[i].cycles;
+		}
+
+		for (i = 0; i < NR_IRQS; i++) {
+			g_cpuload_irq[i] >>= 1;
+			total += g_cpuload_irq[i];
+		}
+
+		g_cpuload_overhead >>= 1;
+		g_cpuload_events >>= 1;
+		g_cpuload_total = total + g_cpuload_overhead;
+	}
+}
+#else
 void weak_function sched_process_cpuload(void)
 {
 	FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_readytorun.head;
@@ -165,6 +374,7 @@ void weak_function sched_process_cpuload(void)
 		g_cpuload_total = total;
 	}
 }
+#endif
 
 /****************************************************************************
  * Function:  clock_cpuload
@@ -214,8 +424,15 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
 	 */
 
 	if (g_pidhash[hash_index].tcb && g_pidhash[hash_index].pid == pid) {
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+		/* Bring the running thread (or interrupt) up to date first */
+
+		cpuload_charge((FAR struct tcb_s *)g_readytorun.head);
+		cpuload_scale(cpuload, g_pidhash[hash_index].cycles);
+#else
 		cpuload->total = g_cpuload_total;
 		cpuload->active = g_pidhash[hash_index].ticks;
+#endif
 		ret = OK;
 	}
 
@@ -223,4 +440,70 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
 	return ret;
 }
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+/****************************************************************************
+ * Function:  clock_cpuload_irq
+ *
+ * Description:
+ *   Return load measurement data for the select interrupt vector.
+ *
+ * Parameters:
+ *   irq - The IRQ number of interest.
+ *   cpuload - The location to return the CPU load
+ *
+ * Return Value:
+ *   OK (0) on success; -EINVAL if 'irq' is not a valid IRQ number.
+ *
+ ****************************************************************************/
+
+int clock_cpuload_irq(int irq, FAR struct cpuload_s *cpuload)
+{
+	irqstate_t flags;
+
+	DEBUGASSERT(cpuload);
+
+	if ((unsigned)irq >= NR_IRQS) {
+		return -EINVAL;
+	}
+
+	flags = irqsave();
+	cpuload_charge((FAR struct tcb_s *)g_readytorun.head);
+	cpuload_scale(cpuload, g_cpuload_irq[irq]);
+	irqrestore(flags);
+	return OK;
+}
+
+/****************************************************************************
+ * Function:  clock_cpuload_overhead
+ *
+ * Description:
+ *   Return the share of the CPU spent in the cycle accounting itself.
+ *
+ * Parameters:
+ *   cpuload - The location to return the CPU load
+ *   percall - The location to return the average cost of one accounting
+ *             hook in CPU cycles.  May be NULL.
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clock_cpuload_overhead(FAR struct cpuload_s *cpuload, FAR uint32_t *percall)
+{
+	irqstate_t flags;
+
+	DEBUGASSERT(cpuload);
+
+	flags = irqsave();
+	cpuload_charge((FAR struct tcb_s *)g_readytorun.head);
+	cpuload_scale(cpuload, g_cpuload_overhead);
+	if (percall) {
+		*percall = g_cpuload_events ? (uint32_t)(g_cpuload_overhead / g_cpuload_events) : 0;
+	}
+
+	irqrestore(flags);
+}
+#endif
+
 #endif							/* CONFIG_SCHED_CPULOAD */
@@ -0,0 +1,380 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/sched/sched_latency.c
+ *
+ * Always-on latency histograms, read through /proc/latency:
+ *
+ *   - Wake-up latency: from a thread being made ready-to-run until it runs,
+ *     per priority.
+ *   - IRQ latency: how long an interrupt was held off because interrupts
+ *     were masked when it was raised, per vector.
+ *   - The length of irqsave() and sched_lock() sections, with the caller
+ *     of the longest one.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/irq.h>
+#include <tinyara/latency.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LATENCY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The last slot of the per-priority and per-vector tables is reserved for
+ * the keys that did not get a slot of their own.
+ */
+
+#if CONFIG_SCHED_LATENCY_NPRIOS < 2
+#error CONFIG_SCHED_LATENCY_NPRIOS must be at least 2
+#endif
+
+#if CONFIG_SCHED_LATENCY_NIRQS < 2
+#error CONFIG_SCHED_LATENCY_NIRQS must be at least 2
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Set by sched_latency_irqon() just before irqrestore() unmasks interrupts
+ * and cleared by irqrestore() just after.  An interrupt that finds it set
+ * was pending while interrupts were masked.
+ */
+
+volatile uint8_t g_latency_unmask;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct latency_hist_s g_latency_wakeup[CONFIG_SCHED_LATENCY_NPRIOS];
+static struct latency_hist_s g_latency_irq[CONFIG_SCHED_LATENCY_NIRQS];
+static struct latency_hist_s g_latency_irqoff;
+static struct latency_hist_s g_latency_schedlock;
+#ifdef CONFIG_SCHED_DEFER
+/* One spare so that every deferred call priority gets a slot of its own */
+
+static struct latency_hist_s g_latency_defer[CONFIG_SCHED_DEFER_NPRIOS + 1];
+#endif
+
+/* Start and caller of the current irqsave() section */
+
+static uint32_t g_irqoff_stamp;
+static FAR void *g_irqoff_caller;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_record
+ *
+ * Description:
+ *   Add one sample to a histogram.  Interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+static void latency_record(FAR struct latency_hist_s *hist, uint32_t cycles, FAR void *caller)
+{
+	int ndx;
+
+	ndx = (cycles >> LATENCY_SHIFT) ? 31 - __builtin_clz(cycles >> LATENCY_SHIFT) : 0;
+	if (ndx >= LATENCY_NBUCKETS) {
+		ndx = LATENCY_NBUCKETS - 1;
+	}
+
+	hist->bucket[ndx]++;
+	hist->count++;
+	if (cycles >= hist->max) {
+		hist->max = cycles;
+		hist->caller = caller;
+	}
+}
+
+/****************************************************************************
+ * Name: latency_slot
+ *
+ * Description:
+ *   Find the histogram of 'key' in a per-priority or per-vector table,
+ *   claiming a free slot for it if it has none.  Slots are claimed in order
+ *   and only released by sched_latency_reset(), so the first unused slot
+ *   ends the search.
+ *
+ ****************************************************************************/
+
+static FAR struct latency_hist_s *latency_slot(FAR struct latency_hist_s *table, int nslots, int key)
+{
+	int i;
+
+	for (i = 0; i < nslots - 1; i++) {
+		if (table[i].count == 0) {
+			table[i].key = key;
+			return &table[i];
+		}
+
+		if (table[i].key == key) {
+			return &table[i];
+		}
+	}
+
+	table[i].key = LATENCY_KEY_OTHER;
+	return &table[i];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_latency_ready and sched_latency_switch
+ *
+ * Description:
+ *   sched_latency_ready() is called when tcb is made ready-to-run;
+ *   sched_latency_switch() when the CPU passes from rtcb to ntcb.  Threads
+ *   that were only preempted have no stamp and are not counted.
+ *
+ *   A thread that gives up the CPU inside a sched_lock() section has its
+ *   section paused until it runs again, so it is not charged for the
+ *   threads that run meanwhile.  Interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+void sched_latency_ready(FAR struct tcb_s *tcb)
+{
+	if (tcb->readystamp == 0) {
+		tcb->readystamp = up_cyclecount() | 1;
+	}
+}
+
+void sched_latency_switch(FAR struct tcb_s *rtcb, FAR struct tcb_s *ntcb)
+{
+	FAR struct latency_hist_s *hist;
+	uint32_t now = up_cyclecount();
+
+	if (rtcb->lockcount > 0) {
+		rtcb->lockpause = now | 1;
+	}
+
+	if (ntcb->lockpause != 0) {
+		ntcb->lockstamp += now - ntcb->lockpause;
+		ntcb->lockpause = 0;
+	}
+
+	if (ntcb->readystamp != 0) {
+		hist = latency_slot(g_latency_wakeup, CONFIG_SCHED_LATENCY_NPRIOS, ntcb->sched_priority);
+		latency_record(hist, now - ntcb->readystamp, NULL);
+		ntcb->readystamp = 0;
+	}
+}
+
+/****************************************************************************
+ * Name: sched_latency_irq
+ *
+ * Description:
+ *   Called from irq_dispatch() before the handler runs.  If the interrupt
+ *   was taken as irqrestore() unmasked interrupts, it was raised at some
+ *   point during that section and is charged the section up to now, with
+ *   the caller that masked interrupts.  Otherwise it was taken at once and
+ *   counts as zero.  The fixed cost of the exception entry is not included;
+ *   the interrupt controller does not record when an interrupt was raised.
+ *
+ ****************************************************************************/
+
+void sched_latency_irq(int irq)
+{
+	FAR struct latency_hist_s *hist;
+	uint32_t cycles = 0;
+	FAR void *caller = NULL;
+
+	if (g_latency_unmask) {
+		cycles = up_cyclecount() - g_irqoff_stamp;
+		caller = g_irqoff_caller;
+		g_latency_unmask = 0;
+	}
+
+	hist = latency_slot(g_latency_irq, CONFIG_SCHED_LATENCY_NIRQS, irq);
+	latency_record(hist, cycles, caller);
+}
+
+/****************************************************************************
+ * Name: sched_latency_irqoff and sched_latency_irqon
+ *
+ * Description:
+ *   Called by irqsave() when it masks interrupts that were enabled, and by
+ *   irqrestore() just before it enables them again.  Both are called with
+ *   interrupts masked and so must not use irqsave() themselves.
+ *
+ ****************************************************************************/
+
+void sched_latency_irqoff(void)
+{
+	g_irqoff_stamp = up_cyclecount();
+	g_irqoff_caller = __builtin_return_address(0);
+}
+
+void sched_latency_irqon(void)
+{
+	latency_record(&g_latency_irqoff, up_cyclecount() - g_irqoff_stamp, g_irqoff_caller);
+	g_latency_unmask = 1;
+}
+
+/****************************************************************************
+ * Name: sched_latency_lock and sched_latency_unlock
+ *
+ * Description:
+ *   Called when rtcb takes its outer sched_lock() and when the matching
+ *   sched_unlock() makes it preemptible again.  The start is kept in the
+ *   TCB and moved forward by sched_latency_switch() over any time the
+ *   thread spent switched out, so a thread that blocks while locked is not
+ *   charged for the threads that run meanwhile.
+ *
+ ****************************************************************************/
+
+void sched_latency_lock(FAR struct tcb_s *rtcb, FAR void *caller)
+{
+	rtcb->lockstamp = up_cyclecount();
+	rtcb->lockpause = 0;
+	rtcb->lockcaller = caller;
+}
+
+void sched_latency_unlock(FAR struct tcb_s *rtcb)
+{
+	latency_record(&g_latency_schedlock, up_cyclecount() - rtcb->lockstamp, rtcb->lockcaller);
+}
+
+/****************************************************************************
+ * Name: sched_latency_defer
+ *
+ * Description:
+ *   Called by the deferred call thread before it runs func, which was
+ *   queued 'cycles' ago at priority prio.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_DEFER
+void sched_latency_defer(int prio, uint32_t cycles, FAR void *func)
+{
+	FAR struct latency_hist_s *hist;
+	irqstate_t flags;
+
+	flags = irqsave();
+	hist = latency_slot(g_latency_defer, CONFIG_SCHED_DEFER_NPRIOS + 1, prio);
+	latency_record(hist, cycles, func);
+	irqrestore(flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_latency_get
+ *
+ * Description:
+ *   Copy out one histogram.  See include/tinyara/latency.h.
+ *
+ ****************************************************************************/
+
+int sched_latency_get(int type, int index, FAR struct latency_hist_s *hist)
+{
+	FAR struct latency_hist_s *src;
+	irqstate_t flags;
+	int ret = -ENOENT;
+
+	if (index < 0) {
+		return -ENOENT;
+	}
+
+	switch (type) {
+	case LATENCY_WAKEUP:
+		src = index < CONFIG_SCHED_LATENCY_NPRIOS ? &g_latency_wakeup[index] : NULL;
+		break;
+
+	case LATENCY_IRQ:
+		src = index < CONFIG_SCHED_LATENCY_NIRQS ? &g_latency_irq[index] : NULL;
+		break;
+
+	case LATENCY_IRQOFF:
+		src = index == 0 ? &g_latency_irqoff : NULL;
+		break;
+
+	case LATENCY_SCHEDLOCK:
+		src = index == 0 ? &g_latency_schedlock : NULL;
+		break;
+
+#ifdef CONFIG_SCHED_DEFER
+	case LATENCY_DEFER:
+		src = index <= CONFIG_SCHED_DEFER_NPRIOS ? &g_latency_defer[index] : NULL;
+		break;
+#endif
+
+	default:
+		src = NULL;
+		break;
+	}
+
+	if (src != NULL) {
+		flags = irqsave();
+		if (src->count > 0) {
+			memcpy(hist, src, sizeof(struct latency_hist_s));
+			ret = OK;
+		}
+
+		irqrestore(flags);
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: sched_latency_reset
+ *
+ * Description:
+ *   Clear all histograms.
+ *
+ ****************************************************************************/
+
+void sched_latency_reset(void)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	memset(g_latency_wakeup, 0, sizeof(g_latency_wakeup));
+	memset(g_latency_irq, 0, sizeof(g_latency_irq));
+	memset(&g_latency_irqoff, 0, sizeof(g_latency_irqoff));
+	memset(&g_latency_schedlock, 0, sizeof(g_latency_schedlock));
+#ifdef CONFIG_SCHED_DEFER
+	memset(g_latency_defer, 0, sizeof(g_latency_defer));
+#endif
+	irqrestore(flags);
+}
+
+#endif							/* CONFIG_SCHED_LATENCY */
@@ -119,6 +119,10 @@ int sched_lock(void)
 
 	if (rtcb && !up_interrupt_context()) {
 		ASSERT(rtcb->lockcount < MAX_LOCK_COUNT);
+		if (rtcb->lockcount == 0) {
+			sched_latency_lock(rtcb, __builtin_return_address(0));
+		}
+
 		rtcb->lockcount++;
 	}
 
@@ -151,6 +151,8 @@ bool sched_mergepending(void)
 			/* Inform the instrumentation layer that we are switching tasks */
 
 			sched_note_switch(rtrtcb, pndtcb);
+			sched_cpuload_switch(rtrtcb);
+			sched_latency_switch(rtrtcb, pndtcb);
 
 			/* Then insert at the head of the list */
 
@@ -99,9 +99,14 @@ static void sched_releasepid(pid_t pid)
 	 * defunct thread to zero.
 	 */
 
+#ifdef CONFIG_SCHED_CPULOAD_CYCLES
+	g_cpuload_total -= g_pidhash[hash_ndx].cycles;
+	g_pidhash[hash_ndx].cycles = 0;
+#else
 	g_cpuload_total -= g_pidhash[hash_ndx].ticks;
 	g_pidhash[hash_ndx].ticks = 0;
 #endif
+#endif
 }
 
 /************************************************************************
@@ -163,9 +168,15 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 			sched_releasepid(tcb->pid);
 		}
 
-		/* Delete the thread's stack if one has been allocated */
+		/* Delete the thread's stack if one has been allocated.  A TCB from
+		 * the TCB cache keeps its stack until sched_tcbfree() decides.
+		 */
 
+#ifdef CONFIG_SCHED_TCBCACHE
+		if (tcb->stack_alloc_ptr && tcb->cache_stack_size == 0) {
+#else
 		if (tcb->stack_alloc_ptr) {
+#endif
 #ifdef CONFIG_BUILD_KERNEL
 			/* If the exiting thread is not a kernel thread, then it has an
 			 * address environment.  Don't bother to release the stack memory
@@ -215,7 +226,11 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
 		/* And, finally, release the TCB itself */
 
+#ifdef CONFIG_SCHED_TCBCACHE
+		sched_tcbfree(tcb, ttype);
+#else
 		sched_kfree(tcb);
+#endif
 	}
 
 	return ret;
@@ -0,0 +1,194 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <queue.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_TCBCACHE
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+/* TCBs of one thread type, each still holding a stack of one size */
+
+struct tcbcache_bucket_s {
+	sq_queue_t tcbs;			/* Cached TCBs, linked through flink */
+	size_t stack_size;			/* Stack size they were created with */
+	uint8_t ttype;				/* TCB_FLAG_TTYPE_* of all of them */
+	uint8_t ntcbs;				/* Number of TCBs in the bucket */
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+static struct tcbcache_bucket_s g_tcbcache[CONFIG_SCHED_TCBCACHE_NBUCKETS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline size_t sched_tcbsize(uint8_t ttype)
+{
+#ifndef CONFIG_DISABLE_PTHREAD
+	if (ttype == TCB_FLAG_TTYPE_PTHREAD) {
+		return sizeof(struct pthread_tcb_s);
+	}
+#endif
+
+	return sizeof(struct task_tcb_s);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_tcballoc
+ *
+ * Description:
+ *   Allocate a zeroed TCB for a new thread of the given type.  A TCB that
+ *   was cached by sched_tcbfree() together with a stack of the requested
+ *   size is reused if there is one; its stack is left in stack_alloc_ptr
+ *   for up_create_stack() to take over instead of allocating a new one.
+ *
+ * Inputs:
+ *   ttype      - Thread type (TCB_FLAG_TTYPE_*)
+ *   stack_size - The size that will be passed to up_create_stack()
+ *
+ * Return Value:
+ *   The TCB or NULL if no memory is available.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *sched_tcballoc(uint8_t ttype, size_t stack_size)
+{
+	FAR struct tcbcache_bucket_s *bucket;
+	FAR struct tcb_s *tcb = NULL;
+	FAR void *stack;
+	irqstate_t flags;
+	int i;
+
+	flags = irqsave();
+	for (i = 0; i < CONFIG_SCHED_TCBCACHE_NBUCKETS; i++) {
+		bucket = &g_tcbcache[i];
+		if (bucket->ntcbs > 0 && bucket->ttype == ttype && bucket->stack_size == stack_size) {
+			tcb = (FAR struct tcb_s *)sq_remfirst(&bucket->tcbs);
+			bucket->ntcbs--;
+			break;
+		}
+	}
+	irqrestore(flags);
+
+	if (tcb) {
+		stack = tcb->stack_alloc_ptr;
+		memset(tcb, 0, sched_tcbsize(ttype));
+
+		/* A stack of exactly the requested size is kept by up_create_stack() */
+
+		tcb->stack_alloc_ptr = stack;
+		tcb->adj_stack_size = stack_size;
+	} else {
+		tcb = (FAR struct tcb_s *)kmm_zalloc(sched_tcbsize(ttype));
+		if (!tcb) {
+			return NULL;
+		}
+	}
+
+	tcb->cache_stack_size = stack_size;
+	return tcb;
+}
+
+/****************************************************************************
+ * Name: sched_tcbfree
+ *
+ * Description:
+ *   Release a TCB that sched_releasetcb() is done with, keeping it and its
+ *   stack for a later sched_tcballoc() if it came from there and there is
+ *   room in the cache.  Otherwise both are freed.
+ *
+ *   This may be called with interrupts disabled.
+ *
+ * Inputs:
+ *   tcb   - The TCB to release
+ *   ttype - Thread type (TCB_FLAG_TTYPE_*)
+ *
+ ****************************************************************************/
+
+void sched_tcbfree(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+	FAR struct tcbcache_bucket_s *bucket;
+	FAR struct tcbcache_bucket_s *empty = NULL;
+	irqstate_t flags;
+	int i;
+
+	if (tcb->stack_alloc_ptr && tcb->cache_stack_size > 0) {
+		flags = irqsave();
+		for (i = 0; i < CONFIG_SCHED_TCBCACHE_NBUCKETS; i++) {
+			bucket = &g_tcbcache[i];
+			if (bucket->ntcbs == 0) {
+				if (!empty) {
+					empty = bucket;
+				}
+			} else if (bucket->ttype == ttype && bucket->stack_size == tcb->cache_stack_size) {
+				break;
+			}
+		}
+
+		if (i == CONFIG_SCHED_TCBCACHE_NBUCKETS) {
+			/* Start a new bucket if there is an unused one */
+
+			bucket = empty;
+			if (bucket) {
+				bucket->ttype = ttype;
+				bucket->stack_size = tcb->cache_stack_size;
+			}
+		}
+
+		if (bucket && bucket->ntcbs < CONFIG_SCHED_TCBCACHE_DEPTH) {
+			sq_addfirst((FAR sq_entry_t *)tcb, &bucket->tcbs);
+			bucket->ntcbs++;
+			irqrestore(flags);
+			return;
+		}
+
+		irqrestore(flags);
+	}
+
+	if (tcb->stack_alloc_ptr) {
+		up_release_stack(tcb, ttype);
+	}
+
+	sched_kfree(tcb);
+}
+
+#endif							/* CONFIG_SCHED_TCBCACHE */
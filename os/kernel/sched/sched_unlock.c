@@ -120,6 +120,9 @@ int sched_unlock(void)
 
 		if (rtcb->lockcount) {
 			rtcb->lockcount--;
+			if (rtcb->lockcount == 0) {
+				sched_latency_unlock(rtcb);
+			}
 		}
 
 		/* Check if the lock counter has decremented to zero.  If so,
@@ -127,6 +127,8 @@ int sched_yield(void)
 
 		/* A context switch will occur. */
 		sched_note_switch(rtcb, ntcb);
+		sched_cpuload_switch(rtcb);
+		sched_latency_switch(rtcb, ntcb);
 		ntcb->task_state = TSTATE_TASK_RUNNING;
 		switch_needed = true;
 
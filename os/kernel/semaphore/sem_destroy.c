@@ -59,6 +59,8 @@
 #include <semaphore.h>
 #include <errno.h>
 
+#include <tinyara/irq.h>
+
 #include "semaphore/semaphore.h"
 
 #include <os_trace_events_tizenrt.h>
@@ -113,6 +115,8 @@
 
 int sem_destroy(FAR sem_t *sem)
 {
+	irqstate_t flags;
+
 	/* Assure a valid semaphore is specified */
 
 	SYSVIEW_GET_RETADDR
@@ -133,9 +137,14 @@ int sem_destroy(FAR sem_t *sem)
 			sem->semcount = 1;
 		}
 
-		/* Release holders of the semaphore */
+		/* Release holders of the semaphore.  This also unlinks the
+		 * semaphore from the list of each thread that held it, so it
+		 * must not race with a post from an interrupt handler.
+		 */
 
+		flags = irqsave();
 		sem_destroyholder(sem);
+		irqrestore(flags);
 		return OK;
 	} else {
 		set_errno(EINVAL);
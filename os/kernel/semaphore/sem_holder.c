@@ -93,7 +93,10 @@ typedef int (*holderhandler_t)(FAR struct semholder_s *pholder, FAR sem_t *sem,
  * Private Variables
  ****************************************************************************/
 
-/* Preallocated holder structures */
+/* Preallocated holder structures.  The first holder of a semaphore always
+ * uses the container built into the semaphore, so these are only needed
+ * when several threads hold counts on the same counting semaphore.
+ */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
 static struct semholder_s g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS];
@@ -108,41 +111,44 @@ static FAR struct semholder_s *g_freeholders;
  * Name: sem_allocholder
  ****************************************************************************/
 
-static inline FAR struct semholder_s *sem_allocholder(sem_t *sem)
+static inline FAR struct semholder_s *sem_allocholder(sem_t *sem, FAR struct tcb_s *htcb)
 {
 	FAR struct semholder_s *pholder;
 
-	/* Check if the "built-in" holder is being used.  We have this built-in
-	 * holder to optimize for the simplest case where semaphores are only
-	 * used to implement mutexes.
+	/* Use the "built-in" holder if it is free.  That is all a semaphore used
+	 * as a mutex ever needs.
 	 */
 
+	if (!sem->holder.htcb) {
+		pholder = &sem->holder;
+	}
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-	pholder = g_freeholders;
-	if (pholder) {
+	else if (g_freeholders) {
 		/* Remove the holder from the free list an put it into the semaphore's
 		 * holder list
 		 */
 
+		pholder = g_freeholders;
 		g_freeholders = pholder->flink;
 		pholder->flink = sem->hhead;
 		sem->hhead = pholder;
-
-		/* Make sure the initial count is zero */
-
-		pholder->counts = 0;
-	}
-#else
-	if (!sem->holder.htcb) {
-		pholder = &sem->holder;
-		pholder->counts = 0;
 	}
 #endif
 	else {
 		sdbg("Insufficient pre-allocated holders\n");
-		pholder = NULL;
+		return NULL;
 	}
 
+	/* Make sure the initial count is zero and add the semaphore to the list
+	 * of semaphores held by the thread.
+	 */
+
+	pholder->htcb = htcb;
+	pholder->sem = sem;
+	pholder->counts = 0;
+	pholder->tlink = htcb->holdsem;
+	htcb->holdsem = pholder;
+
 	return pholder;
 }
 
@@ -152,24 +158,27 @@ static inline FAR struct semholder_s *sem_allocholder(sem_t *sem)
 
 static FAR struct semholder_s *sem_findholder(sem_t *sem, FAR struct tcb_s *htcb)
 {
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
 	FAR struct semholder_s *pholder;
+#endif
 
 	/* Try to find the holder in the list of holders associated with this
-	 * semaphore
+	 * semaphore.  A mutex only ever has the built-in holder.
 	 */
 
+	if (sem->holder.htcb == htcb) {
+		return &sem->holder;
+	}
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-	for (pholder = sem->hhead; pholder; pholder = pholder->flink)
-#else
-	pholder = &sem->holder;
-#endif
-	{
+
+	for (pholder = sem->hhead; pholder; pholder = pholder->flink) {
 		if (pholder->htcb == htcb) {
 			/* Got it! */
 
 			return pholder;
 		}
 	}
+#endif
 
 	/* The holder does not appear in the list */
 
@@ -184,7 +193,7 @@ static inline FAR struct semholder_s *sem_findorallocateholder(sem_t *sem, FAR s
 {
 	FAR struct semholder_s *pholder = sem_findholder(sem, htcb);
 	if (!pholder) {
-		pholder = sem_allocholder(sem);
+		pholder = sem_allocholder(sem, htcb);
 	}
 
 	return pholder;
@@ -196,17 +205,38 @@ static inline FAR struct semholder_s *sem_findorallocateholder(sem_t *sem, FAR s
 
 static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
 {
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
 	FAR struct semholder_s *curr;
 	FAR struct semholder_s *prev;
-#endif
+
+	/* Remove the semaphore from the list of semaphores held by the thread.
+	 * Semaphores are usually released in the reverse order of taking them,
+	 * so this normally stops at the head of the list.
+	 */
+
+	if (pholder->htcb) {
+		for (prev = NULL, curr = pholder->htcb->holdsem; curr && curr != pholder; prev = curr, curr = curr->tlink) ;
+
+		if (curr) {
+			if (prev) {
+				prev->tlink = pholder->tlink;
+			} else {
+				pholder->htcb->holdsem = pholder->tlink;
+			}
+		}
+	}
 
 	/* Release the holder and counts */
 
+	pholder->tlink = NULL;
+	pholder->sem = NULL;
 	pholder->htcb = NULL;
 	pholder->counts = 0;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+	if (pholder == &sem->holder) {
+		return;
+	}
+
 	/* Search the list for the matching holder */
 
 	for (prev = NULL, curr = sem->hhead; curr && curr != pholder; prev = curr, curr = curr->flink) ;
@@ -234,46 +264,83 @@ static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
 
 static int sem_foreachholder(FAR sem_t *sem, holderhandler_t handler, FAR void *arg)
 {
-	FAR struct semholder_s *pholder;
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+	FAR struct semholder_s *pholder;
 	FAR struct semholder_s *next;
 #endif
 	int ret = 0;
 
+	/* The "built-in" container may hold a NULL holder */
+
+	if (sem->holder.htcb) {
+		ret = handler(&sem->holder, sem, arg);
+	}
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-	for (pholder = sem->hhead; pholder && ret == 0; pholder = next)
-#else
-	pholder = &sem->holder;
-#endif
-	{
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+
+	for (pholder = sem->hhead; pholder && ret == 0; pholder = next) {
 		/* In case this holder gets deleted */
 
 		next = pholder->flink;
+		ret = handler(pholder, sem, arg);
+	}
 #endif
-		/* The initial "built-in" container may hold a NULL holder */
 
-		if (pholder->htcb) {
-			/* Call the handler */
+	return ret;
+}
+
+/****************************************************************************
+ * Name: sem_holderprio
+ *
+ * Description:
+ *   Return the priority the holder thread has to run at: the priority of
+ *   the highest priority thread waiting for a semaphore that it holds
+ *   counts on, or its base priority if that is higher.
+ *
+ *   Only the semaphores on the holder's own list are visited, and only
+ *   those with waiters cause a look at the waiting list.  That list is
+ *   ordered by priority, so each look stops at the first waiter for the
+ *   semaphore or at the first waiter that could not raise the result.
+ *
+ * Parameters:
+ *   htcb    - The holder thread
+ *   exclude - A waiting thread to ignore because it is giving up its wait,
+ *             or NULL
+ *
+ ****************************************************************************/
+
+static int sem_holderprio(FAR struct tcb_s *htcb, FAR struct tcb_s *exclude)
+{
+	FAR struct semholder_s *pholder;
+	FAR struct tcb_s *wtcb;
+	int rpriority = htcb->base_priority;
+
+	for (pholder = htcb->holdsem; pholder; pholder = pholder->tlink) {
+		/* A semaphore without waiters cannot boost the holder */
 
-			ret = handler(pholder, sem, arg);
+		if (pholder->counts <= 0 || pholder->sem->semcount >= 0) {
+			continue;
+		}
+
+		for (wtcb = (FAR struct tcb_s *)g_waitingforsemaphore.head; wtcb && wtcb->sched_priority > rpriority; wtcb = wtcb->flink) {
+			if (wtcb != exclude && wtcb->waitsem == pholder->sem) {
+				rpriority = wtcb->sched_priority;
+				break;
+			}
 		}
 	}
 
-	return ret;
+	return rpriority;
 }
 
 /****************************************************************************
  * Name: sem_recoverholders
  ****************************************************************************/
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
 static int sem_recoverholders(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR void *arg)
 {
 	sem_freeholder(sem, pholder);
 	return 0;
 }
-#endif
 
 /****************************************************************************
  * Name: sem_boostholderprio
@@ -294,61 +361,12 @@ static int sem_boostholderprio(FAR struct semholder_s *pholder, FAR sem_t *sem,
 		sdbg("TCB 0x%08x is a stale handle, counts lost\n", htcb);
 		sem_freeholder(sem, pholder);
 	}
-#if CONFIG_SEM_NNESTPRIO > 0
 
-	/* If the priority of the thread that is waiting for a count is greater
-	 * than the base priority of the thread holding a count, then we may need
-	 * to adjust the holder's priority now or later to that priority.
-	 */
-
-	else if (rtcb->sched_priority > htcb->base_priority) {
-		/* If the new priority is greater than the current, possibly already
-		 * boosted priority of the holder thread, then we will have to raise
-		 * the holder's priority now.
-		 */
-
-		if (rtcb->sched_priority > htcb->sched_priority) {
-			/* If the current priority of holder thread has already been
-			 * boosted, then add the boost priority to the list of restoration
-			 * priorities.  When the higher priority waiter thread gets its
-			 * count, then we need to revert the holder thread to this saved
-			 * priority (not to its base priority).
-			 */
-
-			if (htcb->sched_priority > htcb->base_priority) {
-				/* Save the current, boosted priority of the holder thread. */
-
-				if (htcb->npend_reprio < CONFIG_SEM_NNESTPRIO) {
-					htcb->pend_reprios[htcb->npend_reprio] = htcb->sched_priority;
-					htcb->npend_reprio++;
-				} else {
-					sdbg("CONFIG_SEM_NNESTPRIO exceeded\n");
-				}
-			}
-
-			/* Raise the priority of the thread holding of the semaphore.
-			 * This cannot cause a context switch because we have preemption
-			 * disabled.  The holder thread may be marked "pending" and the
-			 * switch may occur during up_block_task() processing.
-			 */
-
-			(void)sched_setpriority(htcb, rtcb->sched_priority);
-		} else {
-			/* The new priority is above the base priority of the holder,
-			 * but not as high as its current working priority.  Just put it
-			 * in the list of pending restoration priorities so that when the
-			 * higher priority thread gets its count, we can revert to this
-			 * saved priority and not to the base priority.
-			 */
-
-			htcb->pend_reprios[htcb->npend_reprio] = rtcb->sched_priority;
-			htcb->npend_reprio++;
-		}
-	}
-#else
 	/* If the priority of the thread that is waiting for a count is less than
 	 * of equal to the priority of the thread holding a count, then do nothing
 	 * because the thread is already running at a sufficient priority.
+	 * Nothing needs to be remembered for the later restoration: that is
+	 * worked out from the threads still waiting at that time.
 	 */
 
 	else if (rtcb->sched_priority > htcb->sched_priority) {
@@ -360,7 +378,6 @@ static int sem_boostholderprio(FAR struct semholder_s *pholder, FAR sem_t *sem,
 
 		(void)sched_setpriority(htcb, rtcb->sched_priority);
 	}
-#endif
 
 	return 0;
 }
@@ -396,28 +413,24 @@ static int sem_verifyholder(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR
 #if defined(CONFIG_DEBUG) && defined(CONFIG_SEM_PHDEBUG)
 static int sem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR void *arg)
 {
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-	vdbg("  %08x: %08x %08x %04x\n", pholder, pholder->flink, pholder->htcb, pholder->counts);
-#else
-	vdbg("  %08x: %08x %04x\n", pholder, pholder->htcb, pholder->counts);
-#endif
+	vdbg("  %08x: %08x %08x %04x\n", pholder, pholder->tlink, pholder->htcb, pholder->counts);
 	return 0;
 }
 #endif
 
 /****************************************************************************
  * Name: sem_restoreholderprio
+ *
+ * Description:
+ *   Drop the priority of a boosted holder to what the threads still waiting
+ *   for its semaphores call for.  arg is a waiting thread to ignore.
+ *
  ****************************************************************************/
 
 static int sem_restoreholderprio(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR void *arg)
 {
 	FAR struct tcb_s *htcb = (FAR struct tcb_s *)pholder->htcb;
-#if CONFIG_SEM_NNESTPRIO > 0
-	FAR struct tcb_s *stcb = (FAR struct tcb_s *)arg;
 	int rpriority;
-	int i;
-	int j;
-#endif
 
 	/* Make sure that the holder thread is still active.  If it exited without
 	 * releasing its counts, then that would be a bad thing.  But we can take
@@ -431,105 +444,22 @@ static int sem_restoreholderprio(FAR struct semholder_s *pholder, FAR sem_t *sem
 	}
 
 	/* Was the priority of the holder thread boosted? If so, then drop its
-	 * priority back to the correct level.  What is the correct level?
+	 * priority back to the correct level.
 	 */
 
 	else if (htcb->sched_priority != htcb->base_priority) {
-#if CONFIG_SEM_NNESTPRIO > 0
-		/* Are there other, pending priority levels to revert to? */
-
-		if (htcb->npend_reprio < 1) {
-			/* No... the holder thread has only been boosted once.
-			 * npend_reprio should be 0 and the boosted priority should be the
-			 * priority of the task that just got the semaphore
-			 * (stcb->sched_priority)
-			 *
-			 * That latter assumption may not be true if the stcb's priority
-			 * was also boosted so that it no longer matches the htcb's
-			 * sched_priority.  Or if CONFIG_SEM_NNESTPRIO is too small (so
-			 * that we do not have a proper record of the reprioritizations).
-			 */
-
-			DEBUGASSERT(/* htcb->sched_priority == stcb->sched_priority && */
-				htcb->npend_reprio == 0);
-
+		rpriority = sem_holderprio(htcb, (FAR struct tcb_s *)arg);
+		if (rpriority == htcb->base_priority) {
 			/* Reset the holder's priority back to the base priority. */
 
-			sched_reprioritize(htcb, htcb->base_priority);
-		}
-
-		/* There are multiple pending priority levels. The holder thread's
-		 * "boosted" priority could greater than or equal to
-		 * "stcb->sched_priority" (it could be greater if its priority we
-		 * boosted because it also holds another semaphore).
-		 */
-
-		else if (htcb->sched_priority <= stcb->sched_priority) {
-			/* The holder thread has been boosted to the same priority as the
-			 * waiter thread that just received the count.  We will simply
-			 * reprioritize to the next highest priority that we have in
-			 * rpriority.
+			sched_reprioritize(htcb, rpriority);
+		} else if (rpriority < htcb->sched_priority) {
+			/* Still boosted by a waiter for another semaphore that it holds,
+			 * apply that priority while retaining the base_priority.
 			 */
 
-			/* Find the highest pending priority and remove it from the list */
-
-			for (i = 1, j = 0; i < htcb->npend_reprio; i++) {
-				if (htcb->pend_reprios[i] > htcb->pend_reprios[j]) {
-					j = i;
-				}
-			}
-
-			/* Remove the highest priority pending priority from the list */
-
-			rpriority = htcb->pend_reprios[j];
-			i = htcb->npend_reprio - 1;
-			if (i > 0) {
-				htcb->pend_reprios[j] = htcb->pend_reprios[i];
-			}
-
-			htcb->npend_reprio = i;
-
-			/* And apply that priority to the thread (while retaining the
-			 * base_priority)
-			 */
-
-			sched_setpriority(htcb, rpriority);
-		} else {
-			/* The holder thread has been boosted to a higher priority than the
-			 * waiter task.  The pending priority should be in the list (unless
-			 * it was lost because of of list overflow or because the holder
-			 * was reprioritized again unbeknownst to the priority inheritance
-			 * logic).
-			 *
-			 * Search the list for the matching priority.
-			 */
-
-			for (i = 0; i < htcb->npend_reprio; i++) {
-				/* Does this pending priority match the priority of the thread
-				 * that just received the count?
-				 */
-
-				if (htcb->pend_reprios[i] == stcb->sched_priority) {
-					/* Yes, remove it from the list */
-
-					j = htcb->npend_reprio - 1;
-					if (j > 0) {
-						htcb->pend_reprios[i] = htcb->pend_reprios[j];
-					}
-
-					htcb->npend_reprio = j;
-					break;
-				}
-			}
+			(void)sched_setpriority(htcb, rpriority);
 		}
-#else
-		/* There is no alternative restore priorities, drop the priority
-		 * of the holder thread all the way back to the threads "base"
-		 * priority.
-		 */
-
-		sched_reprioritize(htcb, htcb->base_priority);
-#endif
 	}
 
 	return 0;
@@ -553,25 +483,6 @@ static int sem_restoreholderprioA(FAR struct semholder_s *pholder, FAR sem_t *se
 	return 0;
 }
 
-/****************************************************************************
- * Name: sem_restoreholderprioB
- *
- * Description:
- *   Reprioritize only the currently executing task
- *
- ****************************************************************************/
-
-static int sem_restoreholderprioB(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR void *arg)
-{
-	FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_readytorun.head;
-	if (pholder->htcb == rtcb) {
-		(void)sem_restoreholderprio(pholder, sem, arg);
-		return 1;
-	}
-
-	return 0;
-}
-
 /****************************************************************************
  * Name: sem_restorebaseprio_irq
  *
@@ -607,16 +518,15 @@ static int sem_restoreholderprioB(FAR struct semholder_s *pholder, FAR sem_t *se
 static inline void sem_restorebaseprio_irq(FAR struct tcb_s *stcb, FAR sem_t *sem)
 {
 	/* Perform the following actions only if a new thread was given a count.
-	 * The thread that received the count should be the highest priority
-	 * of all threads waiting for a count from the semaphore.  So in that
-	 * case, the priority of all holder threads should be dropped to the
-	 * next highest pending priority.
+	 * The thread that received the count no longer waits, so the priority
+	 * of the holder threads may have to drop to what the remaining waiters
+	 * call for.
 	 */
 
 	if (stcb) {
 		/* Drop the priority of all holder threads */
 
-		(void)sem_foreachholder(sem, sem_restoreholderprio, stcb);
+		(void)sem_foreachholder(sem, sem_restoreholderprio, NULL);
 	}
 
 	/* If there are no tasks waiting for available counts, then all holders
@@ -666,29 +576,18 @@ static inline void sem_restorebaseprio_task(FAR struct tcb_s *stcb, FAR sem_t *s
 {
 	FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_readytorun.head;
 	FAR struct semholder_s *pholder;
+	int rpriority;
 
 	/* Perform the following actions only if a new thread was given a count.
-	 * The thread that received the count should be the highest priority
-	 * of all threads waiting for a count from the semaphore.  So in that
-	 * case, the priority of all holder threads should be dropped to the
-	 * next highest pending priority.
+	 * The currently executed thread should be the lower priority thread that
+	 * just posted the count and caused this action.  However, we cannot drop
+	 * the priority of the currently running thread -- because that will
+	 * cause it to be suspended.  So first reprioritize all holders except
+	 * for the running thread.
 	 */
 
 	if (stcb) {
-		/* The currently executed thread should be the lower priority
-		 * thread that just posted the count and caused this action.
-		 * However, we cannot drop the priority of the currently running
-		 * thread -- because that will cause it to be suspended.
-		 *
-		 * So, do this in two passes.  First, reprioritizing all holders
-		 * except for the running thread.
-		 */
-
-		(void)sem_foreachholder(sem, sem_restoreholderprioA, stcb);
-
-		/* Now, find an reprioritize only the ready to run task */
-
-		(void)sem_foreachholder(sem, sem_restoreholderprioB, stcb);
+		(void)sem_foreachholder(sem, sem_restoreholderprioA, NULL);
 	}
 
 	/* If there are no tasks waiting for available counts, then all holders
@@ -716,6 +615,20 @@ static inline void sem_restorebaseprio_task(FAR struct tcb_s *stcb, FAR sem_t *s
 			sem_freeholder(sem, pholder);
 		}
 	}
+
+	/* Now the running thread.  Unless it still holds another semaphore that
+	 * a higher priority thread waits for, this returns it to its base
+	 * priority at once.
+	 */
+
+	if (rtcb->sched_priority != rtcb->base_priority) {
+		rpriority = sem_holderprio(rtcb, NULL);
+		if (rpriority == rtcb->base_priority) {
+			sched_reprioritize(rtcb, rpriority);
+		} else if (rpriority < rtcb->sched_priority) {
+			(void)sched_setpriority(rtcb, rpriority);
+		}
+	}
 }
 
 /****************************************************************************
@@ -781,21 +694,18 @@ void sem_destroyholder(FAR sem_t *sem)
 	 * state of any of the holder threads.
 	 *
 	 * So just recover any stranded holders and hope the task knows what it is
-	 * doing.
+	 * doing.  They must be recovered in any case, since the holders' lists
+	 * of held semaphores still refer to them.
 	 */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-	if (sem->hhead) {
-		sdbg("Semaphore destroyed with holders\n");
-		(void)sem_foreachholder(sem, sem_recoverholders, NULL);
-	}
+	if (sem->holder.htcb || sem->hhead) {
 #else
 	if (sem->holder.htcb) {
-		sdbg("Semaphore destroyed with holder\n");
-	}
-
-	sem->holder.htcb = NULL;
 #endif
+		sdbg("Semaphore destroyed with holders\n");
+		(void)sem_foreachholder(sem, sem_recoverholders, NULL);
+	}
 }
 
 /****************************************************************************
@@ -803,6 +713,8 @@ void sem_destroyholder(FAR sem_t *sem)
  *
  * Description:
  *   Called from sem_post() when the waiting thread obtains the semaphore.
+ *   Nothing is recorded for a semaphore with priority inheritance disabled
+ *   or one that is used for signalling.
  *
  * Parameters:
  *   htcb - TCB of the thread that just obtained the semaphore
@@ -821,20 +733,22 @@ void sem_addholder_tcb(FAR struct tcb_s *htcb, FAR sem_t *sem)
 	FAR struct semholder_s *pholder;
 
 	/*
-	 * If priority inheritance is disabled for this thread, then do not
+	 * If priority inheritance is disabled for this semaphore, then do not
 	 * add the holder. If there are never holders of the semaphore,
-	 * the priority inheritance is effectively disabled.
+	 * the priority inheritance is effectively disabled.  The same goes for
+	 * a signalling semaphore: the thread taking a count never gives it
+	 * back, so the holder would only stay on its list until it exits.
 	 */
 
-	if ((sem->flags & PRIOINHERIT_FLAGS_DISABLE) == 0) {
+	if ((sem->flags & (PRIOINHERIT_FLAGS_DISABLE | PRIOINHERIT_FLAGS_SIGNAL)) == 0) {
 		/* Find or allocate a container for this new holder */
+
 		pholder = sem_findorallocateholder(sem, htcb);
 		if (pholder != NULL) {
 			/*
-			 * Then set the holder and increment the number of
-			 * counts held by this holder
+			 * Then increment the number of counts held by this holder
 			 */
-			pholder->htcb = htcb;
+
 			pholder->counts++;
 			OS_TRACE_SEM_ADDHOLDER(sem, htcb, pholder->counts);
 		}
@@ -863,6 +777,77 @@ void sem_addholder(FAR sem_t *sem)
 	sem_addholder_tcb(rtcb, sem);
 }
 
+/****************************************************************************
+ * Name: sem_hasholders
+ *
+ * Description:
+ *   Return true if some thread is recorded as holding counts on the
+ *   semaphore.  Used by the pthread mutex fast path to decide whether the
+ *   owner of a mutex must be made known to priority inheritance.
+ *
+ * Parameters:
+ *   sem - A reference to the semaphore
+ *
+ * Return Value:
+ *   true if any holder holds counts
+ *
+ * Assumptions:
+ *   The scheduler is locked or the caller tolerates a stale answer.
+ *
+ ****************************************************************************/
+
+bool sem_hasholders(FAR sem_t *sem)
+{
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+	FAR struct semholder_s *pholder;
+#endif
+
+	if (sem->holder.htcb != NULL && sem->holder.counts > 0) {
+		return true;
+	}
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+
+	for (pholder = sem->hhead; pholder; pholder = pholder->flink) {
+		if (pholder->counts > 0) {
+			return true;
+		}
+	}
+#endif
+
+	return false;
+}
+
+/****************************************************************************
+ * Name: sem_dropholder
+ *
+ * Description:
+ *   Forget the counts held by the running thread.  This is for a count that
+ *   was returned without sem_post(), as the pthread mutex fast path does.
+ *
+ * Parameters:
+ *   sem - A reference to the semaphore
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sem_dropholder(FAR sem_t *sem)
+{
+	FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_readytorun.head;
+	FAR struct semholder_s *pholder;
+
+	pholder = sem_findholder(sem, rtcb);
+	if (pholder) {
+		pholder->counts = 0;
+		OS_TRACE_SEM_DELHOLDER(sem, pholder->htcb, pholder->counts);
+		sem_freeholder(sem, pholder);
+	}
+}
+
 /****************************************************************************
  * Name: void sem_boostpriority(sem_t *sem)
  *
@@ -896,7 +881,9 @@ void sem_boostpriority(FAR sem_t *sem)
  *
  * Description:
  *   Called from sem_post() after a thread releases one count on the
- *   semaphore.
+ *   semaphore.  A count posted by an interrupt handler or by a thread that
+ *   holds none marks the semaphore as a signalling semaphore; no further
+ *   holders are recorded for it.
  *
  * Parameters:
  *   sem - A reference to the semaphore being posted
@@ -905,6 +892,7 @@ void sem_boostpriority(FAR sem_t *sem)
  *   None
  *
  * Assumptions:
+ *   Interrupts are disabled.
  *
  ****************************************************************************/
 
@@ -913,6 +901,11 @@ void sem_releaseholder(FAR sem_t *sem)
 	FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_readytorun.head;
 	FAR struct semholder_s *pholder;
 
+	if (up_interrupt_context()) {
+		sem->flags |= PRIOINHERIT_FLAGS_SIGNAL;
+		return;
+	}
+
 	/* Find the container for this holder */
 
 	pholder = sem_findholder(sem, rtcb);
@@ -923,6 +916,8 @@ void sem_releaseholder(FAR sem_t *sem)
 
 		pholder->counts--;
 		OS_TRACE_SEM_DELHOLDER(sem, pholder->htcb, pholder->counts);
+	} else {
+		sem->flags |= PRIOINHERIT_FLAGS_SIGNAL;
 	}
 }
 
@@ -1012,6 +1007,34 @@ void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem)
 }
 #endif
 
+/****************************************************************************
+ * Name: sem_freeholders
+ *
+ * Description:
+ *   Called from sem_recover() when a thread exits or is deleted.  Free the
+ *   holder of every semaphore on the thread's list, so that no semaphore
+ *   refers to the TCB any longer.  The counts themselves are not returned.
+ *
+ * Parameters:
+ *   htcb - The TCB of the terminated task or thread
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sem_freeholders(FAR struct tcb_s *htcb)
+{
+	FAR struct semholder_s *pholder;
+
+	while ((pholder = htcb->holdsem) != NULL) {
+		sem_freeholder(pholder->sem, pholder);
+	}
+}
+
 /****************************************************************************
  * Name: sem_enumholders
  *
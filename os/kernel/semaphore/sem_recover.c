@@ -93,16 +93,15 @@
  * Name: sem_recover
  *
  * Description:
- *   This function is called from task_recover() when a task is deleted via
- *   task_delete() or via pthread_cancel().  It current only checks on the
+ *   This function is called from task_recover() when a task exits or is
+ *   deleted via task_delete() or via pthread_cancel().  It checks on the
  *   case where a task is waiting for semaphore at the time that is was
- *   killed.
+ *   killed and, with priority inheritance, frees the holder records on the
+ *   task's list of held semaphores.
  *
- *   REVISIT:  A more complete implementation would release counts on all
- *   semaphores held by the thread.  That would, however, require some
- *   significant extension to the semaphore data structures because given
- *   only the task, there is not mechanism to traverse all of the semaphores
- *   with counts held by the task.
+ *   The counts held by the task are deliberately not posted: a mutex held
+ *   by a dead owner must stay locked so that a robust mutex can report
+ *   EOWNERDEAD to the next thread that locks it.
  *
  * Inputs:
  *   tcb - The TCB of the terminated task or thread
@@ -161,5 +160,8 @@ void sem_recover(FAR struct tcb_s *tcb)
 
 	}
 
+	/* No semaphore may refer to the TCB as a holder once it is gone */
+
+	sem_freeholders(tcb);
 	irqrestore(flags);
 }
@@ -125,7 +125,7 @@ int sem_setprotocol(FAR sem_t *sem, int protocol)
 	case SEM_PRIO_INHERIT:
 		/* Enable priority inheritance (dangerous) */
 
-		sem->flags &= ~PRIOINHERIT_FLAGS_DISABLE;
+		sem->flags &= ~(PRIOINHERIT_FLAGS_DISABLE | PRIOINHERIT_FLAGS_SIGNAL);
 		return OK;
 
 	case SEM_PRIO_PROTECT:
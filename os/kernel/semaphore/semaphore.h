@@ -112,6 +112,9 @@ void sem_initholders(void);
 void sem_destroyholder(FAR sem_t *sem);
 void sem_addholder(FAR sem_t *sem);
 void sem_addholder_tcb(FAR struct tcb_s *tcb, FAR sem_t *sem);
+bool sem_hasholders(FAR sem_t *sem);
+void sem_dropholder(FAR sem_t *sem);
+void sem_freeholders(FAR struct tcb_s *htcb);
 void sem_boostpriority(FAR sem_t *sem);
 void sem_releaseholder(FAR sem_t *sem);
 void sem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
@@ -125,6 +128,9 @@ void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #define sem_destroyholder(sem)
 #define sem_addholder(sem)
 #define sem_addholder_tcb(tcb, sem)
+#define sem_hasholders(sem) false
+#define sem_dropholder(sem)
+#define sem_freeholders(htcb)
 #define sem_boostpriority(sem)
 #define sem_releaseholder(sem)
 #define sem_restorebaseprio(stcb, sem)
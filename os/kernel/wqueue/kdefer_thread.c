@@ -0,0 +1,320 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wqueue/kdefer_thread.c
+ *
+ *   Each priority has a bounded multi-producer, single-consumer ring of
+ *   (function, argument) pairs.  Producers claim a slot by advancing the
+ *   ring tail with a compare-and-swap and publish it by storing the slot
+ *   sequence number, so an interrupt handler can queue a call even while it
+ *   interrupted another producer half way.  One thread drains the rings,
+ *   highest priority first.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kthread.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/defer.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEFER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SCHED_DEFER_NENTRIES & (CONFIG_SCHED_DEFER_NENTRIES - 1)) != 0
+#error CONFIG_SCHED_DEFER_NENTRIES must be a power of two
+#endif
+
+#define DEFER_MASK        (CONFIG_SCHED_DEFER_NENTRIES - 1)
+
+/* Slot sequence numbers are kept relative to the slot index so that the
+ * zeroed rings in .bss are already valid and calls can be queued before
+ * defer_start().  With 'pos' the free-running ring position of a slot:
+ *
+ *   seq + index == pos      the slot is free for the producer at pos
+ *   seq + index == pos + 1  the slot holds the call queued at pos
+ */
+
+#define DEFER_FREE(pos)   ((pos) - ((pos) & DEFER_MASK))
+#define DEFER_FULL(pos)   ((pos) + 1 - ((pos) & DEFER_MASK))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct defer_slot_s {
+	volatile uint32_t seq;		/* See DEFER_FREE()/DEFER_FULL() */
+	defer_func_t func;			/* Function to call */
+	FAR void *arg;				/* Its argument */
+#ifdef CONFIG_SCHED_LATENCY
+	uint32_t stamp;				/* Cycle count when queued */
+#endif
+};
+
+struct defer_ring_s {
+	volatile uint32_t tail;		/* Next position to claim; producers */
+	uint32_t head;				/* Next position to run; the thread only */
+	struct defer_slot_s slot[CONFIG_SCHED_DEFER_NENTRIES];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct defer_ring_s g_defer_ring[CONFIG_SCHED_DEFER_NPRIOS];
+
+/* The thread sets g_defer_idle before it sleeps on g_defer_sem; the first
+ * producer to see it set clears it and posts the semaphore.  Producers do
+ * not touch the semaphore while the thread is busy.
+ */
+
+static volatile uint8_t g_defer_idle;
+static sem_t g_defer_sem;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: defer_drain
+ *
+ * Description:
+ *   Run up to 'budget' calls from one ring.  Returns the number run.
+ *
+ ****************************************************************************/
+
+static int defer_drain(int prio, int budget)
+{
+	FAR struct defer_ring_s *ring = &g_defer_ring[prio];
+	FAR struct defer_slot_s *slot;
+	defer_func_t func;
+	FAR void *arg;
+	uint32_t pos;
+	int ncalls;
+
+	for (ncalls = 0; ncalls < budget; ncalls++) {
+		pos = ring->head;
+		slot = &ring->slot[pos & DEFER_MASK];
+		if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != DEFER_FULL(pos)) {
+			/* Empty, or the next call is still being written by a producer
+			 * that was interrupted.  That producer will wake us again.
+			 */
+
+			break;
+		}
+
+		func = slot->func;
+		arg = slot->arg;
+#ifdef CONFIG_SCHED_LATENCY
+		sched_latency_defer(prio, up_cyclecount() - slot->stamp, (FAR void *)func);
+#endif
+
+		/* Hand the slot back to the producers of the next lap */
+
+		__atomic_store_n(&slot->seq, DEFER_FREE(pos + CONFIG_SCHED_DEFER_NENTRIES), __ATOMIC_RELEASE);
+		ring->head = pos + 1;
+
+		func(arg);
+	}
+
+	return ncalls;
+}
+
+/****************************************************************************
+ * Name: defer_empty
+ *
+ * Description:
+ *   Return true if no ring has a published call at its head.  A slot that
+ *   is claimed but not yet published does not count: its producer may be a
+ *   lower priority thread that cannot run until we sleep, and it posts the
+ *   semaphore itself once the call is published.
+ *
+ ****************************************************************************/
+
+static bool defer_empty(void)
+{
+	FAR struct defer_ring_s *ring;
+	uint32_t pos;
+	int prio;
+
+	for (prio = 0; prio < CONFIG_SCHED_DEFER_NPRIOS; prio++) {
+		ring = &g_defer_ring[prio];
+		pos = ring->head;
+		if (__atomic_load_n(&ring->slot[pos & DEFER_MASK].seq, __ATOMIC_SEQ_CST) == DEFER_FULL(pos)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/****************************************************************************
+ * Name: defer_thread
+ *
+ * Description:
+ *   Run deferred calls.  After each batch the rings are searched from the
+ *   highest priority again, so a flood of low priority calls cannot hold
+ *   up a high priority one for more than CONFIG_SCHED_DEFER_BATCH calls.
+ *
+ ****************************************************************************/
+
+static int defer_thread(int argc, char *argv[])
+{
+	int prio;
+
+	for (;;) {
+		for (prio = 0; prio < CONFIG_SCHED_DEFER_NPRIOS; prio++) {
+			if (defer_drain(prio, CONFIG_SCHED_DEFER_BATCH) > 0) {
+				break;
+			}
+		}
+
+		if (prio < CONFIG_SCHED_DEFER_NPRIOS) {
+			continue;
+		}
+
+		/* Nothing to run.  Declare ourselves idle, then check again: a call
+		 * queued before the flag was set did not post the semaphore.
+		 */
+
+		__atomic_store_n(&g_defer_idle, 1, __ATOMIC_SEQ_CST);
+		if (!defer_empty()) {
+			/* If a producer got to the flag first, its post only costs an
+			 * extra pass through the loop.
+			 */
+
+			__atomic_store_n(&g_defer_idle, 0, __ATOMIC_SEQ_CST);
+			continue;
+		}
+
+		while (sem_wait(&g_defer_sem) < 0) {
+			DEBUGASSERT(get_errno() == EINTR);
+		}
+	}
+
+	return OK;					/* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: defer_call
+ ****************************************************************************/
+
+int defer_call(int prio, defer_func_t func, FAR void *arg)
+{
+	FAR struct defer_ring_s *ring;
+	FAR struct defer_slot_s *slot;
+	uint32_t pos;
+	int32_t diff;
+
+	if (prio < 0 || prio >= CONFIG_SCHED_DEFER_NPRIOS || func == NULL) {
+		return -EINVAL;
+	}
+
+	ring = &g_defer_ring[prio];
+
+	/* Claim the slot at the tail */
+
+	pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	for (;;) {
+		slot = &ring->slot[pos & DEFER_MASK];
+		diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - DEFER_FREE(pos));
+		if (diff == 0) {
+			if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+
+			/* Somebody else took it; pos now holds the new tail */
+		} else if (diff < 0) {
+			/* The slot still holds the call of the previous lap: full */
+
+			return -EAGAIN;
+		} else {
+			pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+		}
+	}
+
+	/* Fill it in and publish it */
+
+	slot->func = func;
+	slot->arg = arg;
+#ifdef CONFIG_SCHED_LATENCY
+	slot->stamp = up_cyclecount();
+#endif
+	__atomic_store_n(&slot->seq, DEFER_FULL(pos), __ATOMIC_RELEASE);
+
+	/* Wake the thread if it went to sleep */
+
+	if (__atomic_exchange_n(&g_defer_idle, 0, __ATOMIC_SEQ_CST) != 0) {
+		sem_post(&g_defer_sem);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: defer_start
+ ****************************************************************************/
+
+int defer_start(void)
+{
+	int pid;
+
+	/* The semaphore is used for signaling and, hence, should not have
+	 * priority inheritance enabled.
+	 */
+
+	sem_init(&g_defer_sem, 0, 0);
+	sem_setprotocol(&g_defer_sem, SEM_PRIO_NONE);
+
+	svdbg("Starting deferred call thread\n");
+
+	pid = kernel_thread("defer", CONFIG_SCHED_DEFER_PRIORITY, CONFIG_SCHED_DEFER_STACKSIZE, (main_t)defer_thread, (FAR char *const *)NULL);
+
+	DEBUGASSERT(pid > 0);
+	if (pid < 0) {
+		int errcode = errno;
+		DEBUGASSERT(errcode > 0);
+
+		slldbg("kernel_thread failed: %d\n", errcode);
+		return -errcode;
+	}
+
+	return pid;
+}
+
+#endif							/* CONFIG_SCHED_DEFER */
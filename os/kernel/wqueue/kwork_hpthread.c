@@ -60,6 +60,7 @@
 #include <queue.h>
 #include <debug.h>
 
+#include <tinyara/semaphore.h>
 #include <tinyara/wqueue.h>
 #include <tinyara/kthread.h>
 #include <tinyara/kmalloc.h>
@@ -178,6 +179,13 @@ int work_hpstart(void)
 	g_hpwork.delay = CONFIG_SCHED_HPWORKPERIOD / USEC_PER_TICK;
 	dq_init(&g_hpwork.q);
 
+	/* The semaphore is used for signaling and, hence, should not have
+	 * priority inheritance enabled.
+	 */
+
+	sem_init(&g_hpwork.sem, 0, 0);
+	sem_setprotocol(&g_hpwork.sem, SEM_PRIO_NONE);
+
 	/* Start the high-priority, kernel mode worker thread */
 
 	svdbg("Starting high-priority kernel worker thread\n");
@@ -63,6 +63,7 @@
 #include <queue.h>
 #include <debug.h>
 
+#include <tinyara/semaphore.h>
 #include <tinyara/wqueue.h>
 #include <tinyara/kthread.h>
 #include <tinyara/kmalloc.h>
@@ -213,6 +214,13 @@ int work_lpstart(void)
 	g_lpwork.delay = CONFIG_SCHED_LPWORKPERIOD / USEC_PER_TICK;
 	dq_init(&g_lpwork.q);
 
+	/* The semaphore is used for signaling and, hence, should not have
+	 * priority inheritance enabled.
+	 */
+
+	sem_init(&g_lpwork.sem, 0, 0);
+	sem_setprotocol(&g_lpwork.sem, SEM_PRIO_NONE);
+
 	/* Don't permit any of the threads to run until we have fully initialized
 	 * g_lpwork.
 	 */
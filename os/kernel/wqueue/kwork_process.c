@@ -56,12 +56,12 @@
 #include <tinyara/config.h>
 
 #include <stdint.h>
-#include <unistd.h>
-#include <signal.h>
+#include <semaphore.h>
 #include <assert.h>
 #include <queue.h>
 
 #include <tinyara/clock.h>
+#include <tinyara/semaphore.h>
 #include <tinyara/wqueue.h>
 
 #include <arch/irq.h>
@@ -131,10 +131,10 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 	irqstate_t flags;
 	FAR void *arg;
 	systime_t elapsed;
-#ifndef CONFIG_SCHED_WORKQUEUE_SORTING
 	systime_t remaining;
-#endif
+#ifndef CONFIG_SCHED_WORKQUEUE_SORTING
 	systime_t stick;
+#endif
 	systime_t ctick;
 	systime_t next;
 
@@ -145,9 +145,14 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 	next = period;
 	flags = irqsave();
 
-	/* Get the time that we started this polling cycle in clock ticks. */
+	/* Get the time that we started this polling cycle in clock ticks.  ctick
+	 * is the reference of the final wait even if no work is examined.
+	 */
 
-	stick = clock_systimer();
+	ctick = clock_systimer();
+#ifndef CONFIG_SCHED_WORKQUEUE_SORTING
+	stick = ctick;
+#endif
 
 	/* And check each entry in the work queue.  Since we have disabled
 	 * interrupts we know:  (1) we will not be suspended unless we do
@@ -212,6 +217,15 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 			}
 		} else {				/* elapsed < work->delay */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+			/* This one is not ready.  The queue is ordered by due time, so
+			 * nothing behind it is ready either: sleep until exactly this
+			 * one is due (relative to ctick).
+			 */
+
+			next = work->delay - elapsed;
+			break;
+#else
 			/* This one is not ready.
 			 *
 			 * NOTE that elapsed is relative to the the current time,
@@ -228,12 +242,6 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 
 			/* Will it be ready before the next scheduled wakeup interval? */
 
-#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
-			next = work->delay - elapsed;
-
-			/* Then break at while loop due to sorted list */
-			break;
-#else
 			remaining = work->delay - elapsed;
 			if (remaining < next) {
 				/* Yes.. Then schedule to wake up when the work is ready */
@@ -262,25 +270,22 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 	 */
 
 	if (period == 0) {
-		sigset_t set;
-
-		/* Wait indefinitely until signalled with SIGWORK */
-
-		sigemptyset(&set);
-		sigaddset(&set, SIGWORK);
+		/* Wait indefinitely until work_signal() posts the semaphore */
 
 		wqueue->worker[wndx].busy = false;
-		DEBUGVERIFY(sigwaitinfo(&set, NULL));
+		(void)sem_wait(&wqueue->sem);
 		wqueue->worker[wndx].busy = true;
 	} else
 #endif
 	{
 #ifdef CONFIG_SCHED_WORKQUEUE_SORTING
 		if (next > 0) {
+			remaining = next;
 #else
 		/* Get the delay (in clock ticks) since we started the sampling */
 
-		elapsed = clock_systimer() - stick;
+		ctick = clock_systimer();
+		elapsed = ctick - stick;
 		if (elapsed < period && next > 0) {
 			/* How much time would we need to delay to get to the end of the
 			 * sampling period?  The amount of time we delay should be the smaller
@@ -289,14 +294,15 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 			 */
 
 			remaining = period - elapsed;
-			next = MIN(next, remaining);
+			remaining = MIN(next, remaining);
 #endif
 			/* Wait awhile to check the work list.  We will wait here until
-			 * either the time elapses or until we are awakened by a signal.
-			 * Interrupts will be re-enabled while we wait.
+			 * either the time elapses or until work_signal() posts the
+			 * semaphore.  Interrupts will be re-enabled while we wait.
 			 */
+
 			wqueue->worker[wndx].busy = false;
-			usleep(next * USEC_PER_TICK);
+			(void)sem_tickwait(&wqueue->sem, ctick, remaining);
 			wqueue->worker[wndx].busy = true;
 		}
 	}
@@ -89,6 +89,24 @@
  ****************************************************************************/
 
 #if defined(CONFIG_SCHED_HPWORK) || defined(CONFIG_SCHED_LPWORK)
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+/****************************************************************************
+ * Name: work_remaining
+ *
+ * Description:
+ *   Ticks from 'now' until queued work is due, zero if it is already due.
+ *   This stays correct across wrap-around of the system timer.
+ *
+ ****************************************************************************/
+
+static inline systime_t work_remaining(FAR struct work_s *work, systime_t now)
+{
+	systime_t elapsed = now - work->qtime;
+
+	return (elapsed >= work->delay) ? 0 : work->delay - elapsed;
+}
+#endif
+
 /****************************************************************************
  * Name: work_qqueue
  *
@@ -120,27 +138,26 @@
 
 static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay)
 {
-	struct work_s *cur_work;
-	struct work_s *next_work;
+	FAR struct work_s *cur_work;
 	irqstate_t flags;
+#ifdef CONFIG_SCHED_WORKQUEUE_SORTING
+	systime_t now;
+#endif
 	DEBUGASSERT(work != NULL);
 
-	next_work = NULL;
 	flags = irqsave();
 
-	/* check whether requested work is in queue list or not */
-	cur_work = (struct work_s *)wqueue->q.head;
-	while (cur_work != NULL) {
-		if (cur_work == work) {
-			irqrestore(flags);
-			return -EALREADY;
-		}
+	/* check whether requested work is in queue list or not.  Queued work
+	 * always has a worker, so only such work needs to be looked for.
+	 */
 
-		if ((cur_work->delay > delay) && (next_work == NULL)) {
-			next_work = cur_work;
+	if (work->worker != NULL) {
+		for (cur_work = (FAR struct work_s *)wqueue->q.head; cur_work != NULL; cur_work = (FAR struct work_s *)cur_work->dq.flink) {
+			if (cur_work == work) {
+				irqrestore(flags);
+				return -EALREADY;
+			}
 		}
-
-		cur_work = (struct work_s *)cur_work->dq.flink;
 	}
 
 	work->worker = worker;		/* Work callback */
@@ -149,8 +166,21 @@ static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wor
 	work->qtime = clock_systimer();	/* Time work queued */
 
 #ifdef CONFIG_SCHED_WORKQUEUE_SORTING
-	if (next_work) {
-		dq_addbefore((FAR dq_entry_t *)next_work, (FAR dq_entry_t *)work, &wqueue->q);
+	/* Keep the queue ordered by due time so that the worker only has to
+	 * look at its head.  Work with the same due time stays in FIFO order.
+	 * New work is usually due after all pending work, so try the tail
+	 * first before searching from the head.
+	 */
+
+	now = work->qtime;
+	cur_work = (FAR struct work_s *)wqueue->q.tail;
+	if (cur_work != NULL && work_remaining(cur_work, now) > delay) {
+		cur_work = (FAR struct work_s *)wqueue->q.head;
+		while (work_remaining(cur_work, now) <= delay) {
+			cur_work = (FAR struct work_s *)cur_work->dq.flink;
+		}
+
+		dq_addbefore((FAR dq_entry_t *)cur_work, (FAR dq_entry_t *)work, &wqueue->q);
 	} else {
 		dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
 	}
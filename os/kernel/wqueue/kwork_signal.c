@@ -56,11 +56,13 @@
 
 #include <tinyara/config.h>
 
-#include <signal.h>
+#include <semaphore.h>
 #include <errno.h>
 
 #include <tinyara/wqueue.h>
 
+#include <arch/irq.h>
+
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
@@ -86,50 +88,38 @@
 
 int work_signal(int qid)
 {
-	pid_t pid;
-	int ret;
-
-	/* Get the process ID of the worker thread */
+	FAR struct kwork_wqueue_s *wqueue;
+	irqstate_t flags;
+	int semcount;
+	int ret = OK;
 
 #ifdef CONFIG_SCHED_HPWORK
 	if (qid == HPWORK) {
-		pid = g_hpwork.worker[0].pid;
+		wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork;
 	} else
 #endif
 #ifdef CONFIG_SCHED_LPWORK
 		if (qid == LPWORK) {
-			int wndx;
-			int i;
-
-			/* Find an IDLE worker thread */
-
-			for (wndx = 0, i = 0; i < CONFIG_SCHED_LPNTHREADS; i++) {
-				/* Is this worker thread busy? */
-
-				if (!g_lpwork.worker[i].busy) {
-					/* No.. select this thread */
-
-					wndx = i;
-					break;
-				}
-			}
-
-			/* Use the process ID of the IDLE worker thread (or the ID of worker
-			 * thread 0 if all of the worker threads are busy).
-			 */
-
-			pid = g_lpwork.worker[wndx].pid;
+			wqueue = (FAR struct kwork_wqueue_s *)&g_lpwork;
 		} else
 #endif
 		{
 			return -EINVAL;
 		}
 
-	/* Signal the worker thread */
+	/* Wake up one idle worker thread.  If no worker is waiting, a single
+	 * pending post makes a busy worker re-assess the queue before it sleeps
+	 * again, so the count never needs to grow beyond one.
+	 */
+
+	flags = irqsave();
+	if (sem_getvalue(&wqueue->sem, &semcount) == OK && semcount < 1) {
+		ret = sem_post(&wqueue->sem);
+	}
+	irqrestore(flags);
 
-	ret = kill(pid, SIGWORK);
 	if (ret < 0) {
-		int errcode = errno;
+		int errcode = get_errno();
 		return -errcode;
 	}
 
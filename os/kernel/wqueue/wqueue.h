@@ -62,6 +62,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -89,6 +90,7 @@ struct kworker_s {
 struct kwork_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+	sem_t sem;					/* Posted to wake up an idle worker */
 	struct kworker_s worker[1];	/* Describes a worker thread */
 };
 
@@ -100,6 +102,7 @@ struct kwork_wqueue_s {
 struct hp_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+	sem_t sem;					/* Posted to wake up an idle worker */
 	struct kworker_s worker[1];	/* Describes the single high priority worker */
 };
 #endif
@@ -112,6 +115,7 @@ struct hp_wqueue_s {
 struct lp_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+	sem_t sem;					/* Posted to wake up an idle worker */
 
 	/* Describes each thread in the low priority queue's thread pool */
 
@@ -525,6 +525,19 @@ static err_t netconn_recv_data(struct netconn *conn, void **new_buf)
 	sys_arch_mbox_fetch(&conn->recvmbox, &buf, 0);
 #endif							/* LWIP_SO_RCVTIMEO */
 
+#if LWIP_TCP && LWIP_NETCONN_RX_COALESCE
+	if (buf != NULL && NETCONNTYPE_GROUP(conn->type) == NETCONN_TCP) {
+		SYS_ARCH_DECL_PROTECT(lev);
+
+		/* stop tcpip_thread from appending to the entry we now own */
+		SYS_ARCH_PROTECT(lev);
+		if (conn->rx_coalesce == buf) {
+			conn->rx_coalesce = NULL;
+		}
+		SYS_ARCH_UNPROTECT(lev);
+	}
+#endif							/* LWIP_TCP && LWIP_NETCONN_RX_COALESCE */
+
 #if LWIP_TCP
 #if (LWIP_UDP || LWIP_RAW)
 	if (NETCONNTYPE_GROUP(conn->type) == NETCONN_TCP)
@@ -295,7 +295,40 @@ static err_t recv_tcp(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
 		len = 0;
 	}
 
+#if LWIP_NETCONN_RX_COALESCE
+	if (p != NULL) {
+		SYS_ARCH_DECL_PROTECT(lev);
+
+		SYS_ARCH_PROTECT(lev);
+		if (conn->rx_coalesce != NULL && (u32_t)conn->rx_coalesce->tot_len + len <= LWIP_NETCONN_RX_COALESCE_MAX) {
+			/* the previous entry is still waiting in recvmbox: extend it.
+			 * Account for it in the same step, the reader subtracts the
+			 * tot_len it detaches.
+			 */
+			pbuf_cat(conn->rx_coalesce, p);
+#if LWIP_SO_RCVBUF
+			conn->recv_avail += len;
+#endif							/* LWIP_SO_RCVBUF */
+			SYS_ARCH_UNPROTECT(lev);
+			TCP_STATS_INC(tcp.rxcoalesced);
+			return ERR_OK;
+		}
+		/* publish before posting: the reader may fetch p right away */
+		conn->rx_coalesce = p;
+		SYS_ARCH_UNPROTECT(lev);
+	}
+#endif							/* LWIP_NETCONN_RX_COALESCE */
+
 	if (sys_mbox_trypost(&conn->recvmbox, p) != ERR_OK) {
+#if LWIP_NETCONN_RX_COALESCE
+		if (p != NULL) {
+			SYS_ARCH_DECL_PROTECT(lev);
+
+			SYS_ARCH_PROTECT(lev);
+			conn->rx_coalesce = NULL;
+			SYS_ARCH_UNPROTECT(lev);
+		}
+#endif							/* LWIP_NETCONN_RX_COALESCE */
 		/* don't deallocate p: it is presented to us later again from tcp_fasttmr! */
 		return ERR_MEM;
 	} else {
@@ -715,6 +748,9 @@ struct netconn *netconn_alloc(enum netconn_type t, netconn_callback callback)
 #if LWIP_TCP
 	conn->current_msg = NULL;
 	conn->write_offset = 0;
+#if LWIP_NETCONN_RX_COALESCE
+	conn->rx_coalesce = NULL;
+#endif							/* LWIP_NETCONN_RX_COALESCE */
 #endif							/* LWIP_TCP */
 #if LWIP_SO_SNDTIMEO
 	conn->send_timeout = 0;
@@ -797,6 +833,10 @@ static void netconn_drain(struct netconn *conn)
 		}
 		sys_mbox_free(&conn->recvmbox);
 		sys_mbox_set_invalid(&conn->recvmbox);
+#if LWIP_NETCONN_RX_COALESCE
+		/* a pending coalesced pbuf was freed with its mbox entry above */
+		conn->rx_coalesce = NULL;
+#endif							/* LWIP_NETCONN_RX_COALESCE */
 	}
 
 	/* Delete and drain the acceptmbox. */
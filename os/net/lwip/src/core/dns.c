@@ -109,6 +109,7 @@
 #include <net/lwip/udp.h>
 #include <net/lwip/mem.h>
 #include <net/lwip/memp.h>
+#include <net/lwip/stats.h>
 #include <net/lwip/dns.h>
 #include <net/lwip/prot/dns.h>
 
@@ -147,6 +148,9 @@ static u16_t dns_txid;
 #if DNS_MAX_SERVERS > 255
 #error DNS_MAX_SERVERS must fit into an u8_t
 #endif
+#if (DNS_HASH_SIZE < 1) || (DNS_HASH_SIZE > 255)
+#error DNS_HASH_SIZE must be in the range 1..255
+#endif
 
 /* The number of parallel requests (i.e. calls to dns_gethostbyname
  * that cannot be answered from the DNS table.
@@ -246,9 +250,16 @@ typedef enum {
 	DNS_STATE_UNUSED = 0,
 	DNS_STATE_NEW = 1,
 	DNS_STATE_ASKING = 2,
-	DNS_STATE_DONE = 3
+	DNS_STATE_DONE = 3,
+	/* answered, but being asked again before the TTL runs out */
+	DNS_STATE_PREFETCH = 4,
+	/* the name does not exist (NXDOMAIN) */
+	DNS_STATE_NEGATIVE = 5
 } dns_state_enum_t;
 
+/* Query in flight for this entry? */
+#define DNS_STATE_PENDING(state) (((state) == DNS_STATE_ASKING) || ((state) == DNS_STATE_PREFETCH))
+
 /** DNS table entry */
 struct dns_table_entry {
 	u32_t ttl;
@@ -259,6 +270,13 @@ struct dns_table_entry {
 	u8_t tmr;
 	u8_t retries;
 	u8_t seqno;
+	/* name hash bucket + 1 (0: not hashed) and next entry index + 1 in it */
+	u8_t hash;
+	u8_t hash_next;
+#if DNS_PREFETCH_TTL
+	/* lookups answered from this entry since it was resolved */
+	u8_t hits;
+#endif
 #if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_RAND_SRC_PORT) != 0)
 	u8_t pcb_idx;
 #endif
@@ -339,6 +357,8 @@ static u8_t dns_last_pcb_idx;
 #endif
 static u8_t dns_seqno;
 static struct dns_table_entry dns_table[DNS_TABLE_SIZE];
+/* first entry index + 1 of every name hash bucket (0: empty) */
+static u8_t dns_hash[DNS_HASH_SIZE];
 static struct dns_req_entry dns_requests[DNS_MAX_REQUESTS];
 static ip_addr_t dns_servers[DNS_MAX_SERVERS];
 
@@ -617,6 +637,51 @@ err_t dns_local_addhost(const char *hostname, const ip_addr_t *addr)
 #endif							/* DNS_LOCAL_HOSTLIST_IS_DYNAMIC */
 #endif							/* DNS_LOCAL_HOSTLIST */
 
+/**
+ * Compute the hash bucket of a host name. Names compare case-insensitive,
+ * so they are hashed case-insensitive as well (FNV-1a).
+ */
+static u8_t dns_hash_name(const char *name)
+{
+	u32_t h = 2166136261UL;
+	size_t n;
+
+	for (n = 0; (n < DNS_MAX_NAME_LENGTH) && (name[n] != 0); n++) {
+		char c = name[n];
+
+		if ((c >= 'A') && (c <= 'Z')) {
+			c += 'a' - 'A';
+		}
+		h = (h ^ (u8_t)c) * 16777619UL;
+	}
+	return (u8_t)(h % DNS_HASH_SIZE);
+}
+
+/**
+ * Move a table entry to the hash chain of its (new) name.
+ *
+ * @param idx dns table index of the entry whose name was just set
+ */
+static void dns_hash_link(u8_t idx)
+{
+	struct dns_table_entry *entry = &dns_table[idx];
+	u8_t *link;
+
+	/* unlink it from the chain of the name it had before */
+	if (entry->hash != 0) {
+		for (link = &dns_hash[entry->hash - 1]; *link != 0; link = &dns_table[*link - 1].hash_next) {
+			if (*link == idx + 1) {
+				*link = entry->hash_next;
+				break;
+			}
+		}
+	}
+
+	entry->hash = dns_hash_name(entry->name) + 1;
+	entry->hash_next = dns_hash[entry->hash - 1];
+	dns_hash[entry->hash - 1] = idx + 1;
+}
+
 /**
  * Look up a hostname in the array of known hostnames.
  *
@@ -629,7 +694,7 @@ err_t dns_local_addhost(const char *hostname, const ip_addr_t *addr)
  * @param addr the hostname's IP address, as u32_t (instead of ip_addr_t to
  *         better check for failure: != IPADDR_NONE) or IPADDR_NONE if the hostname
  *         was not found in the cached dns_table.
- * @return ERR_OK if found, ERR_ARG if not found
+ * @return ERR_OK if found, ERR_VAL if cached as non-existent, ERR_ARG if not found
  */
 static err_t dns_lookup(const char *name, ip_addr_t *addr LWIP_DNS_ADDRTYPE_ARG(u8_t dns_addrtype))
 {
@@ -649,15 +714,37 @@ static err_t dns_lookup(const char *name, ip_addr_t *addr LWIP_DNS_ADDRTYPE_ARG(
 	}
 #endif							/* DNS_LOOKUP_LOCAL_EXTERN */
 
-	/* Walk through name list, return entry if found. If not, return NULL. */
-	for (i = 0; i < DNS_TABLE_SIZE; ++i) {
-		if ((dns_table[i].state == DNS_STATE_DONE) && (lwip_strnicmp(name, dns_table[i].name, sizeof(dns_table[i].name)) == 0) && LWIP_DNS_ADDRTYPE_MATCH_IP(dns_addrtype, dns_table[i].ipaddr)) {
+	/* Walk through the hash chain of the name, return entry if found. */
+	for (i = dns_hash[dns_hash_name(name)]; i != 0; i = dns_table[i - 1].hash_next) {
+		struct dns_table_entry *entry = &dns_table[i - 1];
+
+		if ((entry->state != DNS_STATE_DONE) && (entry->state != DNS_STATE_PREFETCH) && (entry->state != DNS_STATE_NEGATIVE)) {
+			continue;
+		}
+		if (lwip_strnicmp(name, entry->name, sizeof(entry->name)) != 0) {
+			continue;
+		}
+		if (entry->state == DNS_STATE_NEGATIVE) {
+			/* the name does not exist, whatever address type is asked for */
+			LWIP_DEBUGF(DNS_DEBUG, ("dns_lookup: \"%s\": cached as non-existent\n", name));
+			DNS_STATS_INC(dns.neghit);
+			return ERR_VAL;
+		}
+		if (LWIP_DNS_ADDRTYPE_MATCH_IP(dns_addrtype, entry->ipaddr)) {
 			LWIP_DEBUGF(DNS_DEBUG, ("dns_lookup: \"%s\": found = ", name));
-			ip_addr_debug_print(DNS_DEBUG, &(dns_table[i].ipaddr));
+			ip_addr_debug_print(DNS_DEBUG, &(entry->ipaddr));
 			LWIP_DEBUGF(DNS_DEBUG, ("\n"));
 			if (addr) {
-				ip_addr_copy(*addr, dns_table[i].ipaddr);
+				ip_addr_copy(*addr, entry->ipaddr);
+			}
+			/* keep recently used names away from replacement */
+			entry->seqno = dns_seqno;
+#if DNS_PREFETCH_TTL
+			if (entry->hits < 0xFF) {
+				entry->hits++;
 			}
+#endif
+			DNS_STATS_INC(dns.hit);
 			return ERR_OK;
 		}
 	}
@@ -736,21 +823,16 @@ static u16_t dns_skip_name(struct pbuf *p, u16_t query_idx)
 		/** @see RFC 1035 - 4.1.4. Message compression */
 		if ((n & 0xc0) == 0xc0) {
 			/* Compressed name: since we only want to skip it (not check it), stop here */
-			break;
-		} else {
-			/* Not compressed name */
-			if (offset + n >= p->tot_len) {
-				return 0xFFFF;
-			}
-			offset = (u16_t)(offset + n);
+			return offset + 1;
 		}
-		n = pbuf_try_get_at(p, offset);
-		if (n < 0) {
+		/* Not compressed name; a zero length label ends it (also the root name) */
+		if ((n != 0) && (offset + n >= p->tot_len)) {
 			return 0xFFFF;
 		}
+		offset = (u16_t)(offset + n);
 	} while (n != 0);
 
-	return offset + 1;
+	return offset;
 }
 
 /**
@@ -855,6 +937,9 @@ static err_t dns_send(u8_t idx)
 			dst = &dns_servers[entry->server_idx];
 		}
 		err = udp_sendto(dns_pcbs[pcb_idx], p, dst, dst_port);
+		if (err == ERR_OK) {
+			DNS_STATS_INC(dns.xmit);
+		}
 
 		/* free pbuf */
 		pbuf_free(p);
@@ -978,11 +1063,11 @@ static void dns_call_found(u8_t idx, ip_addr_t *addr)
 #endif
 #if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_RAND_SRC_PORT) != 0)
 	/* close the pcb used unless other request are using it */
-	for (i = 0; i < DNS_MAX_REQUESTS; i++) {
+	for (i = 0; i < DNS_TABLE_SIZE; i++) {
 		if (i == idx) {
 			continue;			/* only check other requests */
 		}
-		if (dns_table[i].state == DNS_STATE_ASKING) {
+		if (DNS_STATE_PENDING(dns_table[i].state)) {
 			if (dns_table[i].pcb_idx == dns_table[idx].pcb_idx) {
 				/* another request is still using the same pcb */
 				dns_table[idx].pcb_idx = DNS_MAX_SOURCE_PORTS;
@@ -1010,7 +1095,7 @@ again:
 
 	/* check whether the ID is unique */
 	for (i = 0; i < DNS_TABLE_SIZE; i++) {
-		if ((dns_table[i].state == DNS_STATE_ASKING) && (dns_table[i].txid == txid)) {
+		if (DNS_STATE_PENDING(dns_table[i].state) && (dns_table[i].txid == txid)) {
 			/* ID already used by another pending query */
 			goto again;
 		}
@@ -1019,12 +1104,51 @@ again:
 	return txid;
 }
 
+#if DNS_PREFETCH_TTL
+/**
+ * Ask again for a cached name that is still in use before its TTL runs out.
+ * The entry keeps answering lookups with the old address meanwhile.
+ *
+ * @param i index of the dns_table entry to refresh
+ */
+static void dns_prefetch(u8_t i)
+{
+	err_t err;
+	struct dns_table_entry *entry = &dns_table[i];
+
+	/* it has to earn the next prefetch with new lookups */
+	entry->hits = 0;
+
+#if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_RAND_SRC_PORT) != 0)
+	entry->pcb_idx = dns_alloc_pcb();
+	if (entry->pcb_idx >= DNS_MAX_SOURCE_PORTS) {
+		/* no pcb: let the entry expire and be asked for on the next lookup */
+		return;
+	}
+#endif
+
+	LWIP_DEBUGF(DNS_DEBUG, ("dns_prefetch: \"%s\": ttl %" U32_F "\n", entry->name, entry->ttl));
+	entry->txid = dns_create_txid();
+	entry->state = DNS_STATE_PREFETCH;
+	entry->server_idx = 0;
+	entry->tmr = 1;
+	entry->retries = 0;
+	DNS_STATS_INC(dns.prefetch);
+
+	err = dns_send(i);
+	if (err != ERR_OK) {
+		LWIP_DEBUGF(DNS_DEBUG | LWIP_DBG_LEVEL_WARNING, ("dns_send returned error: %s\n", lwip_strerr(err)));
+	}
+}
+#endif							/* DNS_PREFETCH_TTL */
+
 /**
  * dns_check_entry() - see if entry has not yet been queried and, if so, sends out a query.
  * Check an entry in the dns_table:
  * - send out query for new entries
  * - retry old pending entries on timeout (also with different servers)
  * - remove completed entries from the table if their TTL has expired
+ * - refresh busy entries before their TTL expires (DNS_PREFETCH_TTL)
  *
  * @param i index of the dns_table entry to check
  */
@@ -1050,6 +1174,12 @@ static void dns_check_entry(u8_t i)
 			LWIP_DEBUGF(DNS_DEBUG | LWIP_DBG_LEVEL_WARNING, ("dns_send returned error: %s\n", lwip_strerr(err)));
 		}
 		break;
+	case DNS_STATE_PREFETCH:
+		/* the cached answer expires while asking: from now on lookups have to wait */
+		if ((entry->ttl == 0) || (--entry->ttl == 0)) {
+			entry->state = DNS_STATE_ASKING;
+		}
+		/* fall through */
 	case DNS_STATE_ASKING:
 		if (--entry->tmr == 0) {
 			if (++entry->retries == DNS_MAX_RETRIES) {
@@ -1066,8 +1196,13 @@ static void dns_check_entry(u8_t i)
 					LWIP_DEBUGF(DNS_DEBUG, ("dns_check_entry: \"%s\": timeout\n", entry->name));
 					/* call specified callback function if provided */
 					dns_call_found(i, NULL);
-					/* flush this entry */
-					entry->state = DNS_STATE_UNUSED;
+					if (entry->state == DNS_STATE_PREFETCH) {
+						/* keep serving the cached address until it expires */
+						entry->state = DNS_STATE_DONE;
+					} else {
+						/* flush this entry */
+						entry->state = DNS_STATE_UNUSED;
+					}
 					break;
 				}
 			} else {
@@ -1083,12 +1218,18 @@ static void dns_check_entry(u8_t i)
 		}
 		break;
 	case DNS_STATE_DONE:
+	case DNS_STATE_NEGATIVE:
 		/* if the time to live is nul */
 		if ((entry->ttl == 0) || (--entry->ttl == 0)) {
 			LWIP_DEBUGF(DNS_DEBUG, ("dns_check_entry: \"%s\": flush\n", entry->name));
 			/* flush this entry, there cannot be any related pending entries in this state */
 			entry->state = DNS_STATE_UNUSED;
 		}
+#if DNS_PREFETCH_TTL
+		else if ((entry->state == DNS_STATE_DONE) && (entry->ttl <= DNS_PREFETCH_TTL) && (entry->hits >= DNS_PREFETCH_MIN_HITS)) {
+			dns_prefetch(i);
+		}
+#endif
 		break;
 	case DNS_STATE_UNUSED:
 		/* nothing to do */
@@ -1145,6 +1286,68 @@ static void dns_correct_response(u8_t idx, u32_t ttl)
 	}
 }
 
+#if DNS_NEG_MAX_TTL
+/**
+ * Get the time a name error answer may be cached for (RFC 2308, section 5):
+ * the smaller of the TTL and the MINIMUM field of the SOA record sent along
+ * in the authority section, limited to DNS_NEG_MAX_TTL.
+ *
+ * @param p pbuf containing the DNS response
+ * @param hdr header of the response
+ * @param res_idx offset into p behind the question section
+ * @return negative TTL in seconds, 0 if the answer must not be cached
+ */
+static u32_t dns_negative_ttl(struct pbuf *p, const struct dns_hdr *hdr, u16_t res_idx)
+{
+	struct dns_answer ans;
+	u32_t nrecords;
+	u32_t minimum;
+	u32_t ttl;
+
+	if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != DNS_FLAG2_ERR_NAME) {
+		return 0;
+	}
+
+	/* the SOA record is in the authority section, behind any answers */
+	nrecords = (u32_t)lwip_htons(hdr->numanswers) + lwip_htons(hdr->numauthrr);
+	while ((nrecords > 0) && (res_idx < p->tot_len)) {
+		res_idx = dns_skip_name(p, res_idx);
+		if (res_idx == 0xFFFF) {
+			return 0;
+		}
+		if (pbuf_copy_partial(p, &ans, SIZEOF_DNS_ANSWER, res_idx) != SIZEOF_DNS_ANSWER) {
+			return 0;
+		}
+		res_idx += SIZEOF_DNS_ANSWER;
+
+		if ((ans.type == PP_HTONS(DNS_RRTYPE_SOA)) && (ans.cls == PP_HTONS(DNS_RRCLASS_IN))) {
+			/* skip MNAME and RNAME, MINIMUM is the last of five 32-bit fields */
+			res_idx = dns_skip_name(p, res_idx);
+			if (res_idx == 0xFFFF) {
+				return 0;
+			}
+			res_idx = dns_skip_name(p, res_idx);
+			if ((res_idx == 0xFFFF) || (res_idx > 0xFFFF - 20)) {
+				return 0;
+			}
+			if (pbuf_copy_partial(p, &minimum, sizeof(minimum), res_idx + 16) != sizeof(minimum)) {
+				return 0;
+			}
+			ttl = LWIP_MIN(lwip_ntohl(ans.ttl), lwip_ntohl(minimum));
+			return LWIP_MIN(ttl, DNS_NEG_MAX_TTL);
+		}
+
+		if ((u32_t)res_idx + lwip_htons(ans.len) > 0xFFFF) {
+			return 0;
+		}
+		res_idx += lwip_htons(ans.len);
+		nrecords--;
+	}
+
+	return 0;
+}
+#endif							/* DNS_NEG_MAX_TTL */
+
 /**
  * Receive input function for DNS response packets arriving for the dns UDP pcb.
  */
@@ -1157,6 +1360,9 @@ static void dns_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_ad
 	struct dns_answer ans;
 	struct dns_query qry;
 	u16_t nquestions, nanswers;
+#if DNS_NEG_MAX_TTL
+	u32_t negttl = 0;
+#endif
 
 	LWIP_UNUSED_ARG(arg);
 	LWIP_UNUSED_ARG(pcb);
@@ -1176,7 +1382,7 @@ static void dns_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_ad
 		for (i = 0; i < DNS_TABLE_SIZE; i++) {
 			const struct dns_table_entry *entry = &dns_table[i];
 
-			if ((entry->state == DNS_STATE_ASKING) && (entry->txid == txid)) {
+			if (DNS_STATE_PENDING(entry->state) && (entry->txid == txid)) {
 
 				/**
 				 * We only care about the question(s) and the answers. The authrr
@@ -1231,6 +1437,9 @@ static void dns_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_ad
 				/* Check for error. If so, call callback to inform. */
 				if (hdr.flags2 & DNS_FLAG2_ERR_MASK) {
 					LWIP_DEBUGF(DNS_DEBUG, ("dns_recv: \"%s\": error in flags\n", entry->name));
+#if DNS_NEG_MAX_TTL
+					negttl = dns_negative_ttl(p, &hdr, res_idx);
+#endif
 				} else {
 					while ((nanswers > 0) && (res_idx < p->tot_len)) {
 						/* skip answer resource record's host name */
@@ -1312,6 +1521,15 @@ static void dns_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_ad
 				/* call callback to indicate error, clean up memory and return */
 				pbuf_free(p);
 				dns_call_found(i, NULL);
+#if DNS_NEG_MAX_TTL
+				if (negttl > 0) {
+					/* remember that the name does not exist (RFC 2308) */
+					LWIP_DEBUGF(DNS_DEBUG, ("dns_recv: \"%s\": non-existent for %" U32_F " s\n", dns_table[i].name, negttl));
+					dns_table[i].ttl = negttl;
+					dns_table[i].state = DNS_STATE_NEGATIVE;
+					return;
+				}
+#endif
 				dns_table[i].state = DNS_STATE_UNUSED;
 				return;
 			}
@@ -1341,9 +1559,11 @@ static err_t dns_enqueue(const char *name, size_t hostnamelen, dns_found_callbac
 	struct dns_req_entry *req;
 
 #if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_NO_MULTIPLE_OUTSTANDING) != 0)
+	u8_t h;
 	u8_t r;
-	/* check for duplicate entries */
-	for (i = 0; i < DNS_TABLE_SIZE; i++) {
+	/* check for duplicate entries: only names in the same hash chain can match */
+	for (h = dns_hash[dns_hash_name(name)]; h != 0; h = dns_table[i].hash_next) {
+		i = h - 1;
 		if ((dns_table[i].state == DNS_STATE_ASKING) && (lwip_strnicmp(name, dns_table[i].name, sizeof(dns_table[i].name)) == 0)) {
 #if LWIP_IPV4 && LWIP_IPV6
 			if (dns_table[i].reqaddrtype != dns_addrtype) {
@@ -1363,9 +1583,13 @@ static err_t dns_enqueue(const char *name, size_t hostnamelen, dns_found_callbac
 					dns_requests[r].dns_table_idx = i;
 					LWIP_DNS_SET_ADDRTYPE(dns_requests[r].reqaddrtype, dns_addrtype);
 					LWIP_DEBUGF(DNS_DEBUG, ("dns_enqueue: \"%s\": duplicate request\n", name));
+					DNS_STATS_INC(dns.coalesced);
 					return ERR_INPROGRESS;
 				}
 			}
+			/* no request entry left to wait on it: go on with a lookup of our own */
+			LWIP_DEBUGF(DNS_DEBUG, ("dns_enqueue: \"%s\": no request entry to share the query\n", name));
+			break;
 		}
 	}
 	/* no duplicate entries found */
@@ -1381,7 +1605,7 @@ static err_t dns_enqueue(const char *name, size_t hostnamelen, dns_found_callbac
 			break;
 		}
 		/* check if this is the oldest completed entry */
-		if (entry->state == DNS_STATE_DONE) {
+		if ((entry->state == DNS_STATE_DONE) || (entry->state == DNS_STATE_NEGATIVE)) {
 			u8_t age = dns_seqno - entry->seqno;
 
 			if (age > lseq) {
@@ -1393,7 +1617,7 @@ static err_t dns_enqueue(const char *name, size_t hostnamelen, dns_found_callbac
 
 	/* if we don't have found an unused entry, use the oldest completed one */
 	if (i == DNS_TABLE_SIZE) {
-		if ((lseqi >= DNS_TABLE_SIZE) || (dns_table[lseqi].state != DNS_STATE_DONE)) {
+		if (lseqi >= DNS_TABLE_SIZE) {
 			/* no entry can be used now, table is full */
 			LWIP_DEBUGF(DNS_DEBUG, ("dns_enqueue: \"%s\": DNS entries table is full\n", name));
 			return ERR_MEM;
@@ -1429,6 +1653,9 @@ static err_t dns_enqueue(const char *name, size_t hostnamelen, dns_found_callbac
 	/* fill the entry */
 	entry->state = DNS_STATE_NEW;
 	entry->seqno = dns_seqno;
+#if DNS_PREFETCH_TTL
+	entry->hits = 0;
+#endif
 	LWIP_DNS_SET_ADDRTYPE(entry->reqaddrtype, dns_addrtype);
 	LWIP_DNS_SET_ADDRTYPE(req->reqaddrtype, dns_addrtype);
 	req->found = found;
@@ -1436,6 +1663,8 @@ static err_t dns_enqueue(const char *name, size_t hostnamelen, dns_found_callbac
 	namelen = LWIP_MIN(hostnamelen, DNS_MAX_NAME_LENGTH - 1);
 	MEMCPY(entry->name, name, namelen);
 	entry->name[namelen] = 0;
+	dns_hash_link(i);
+	DNS_STATS_INC(dns.miss);
 
 #if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_RAND_SRC_PORT) != 0)
 	entry->pcb_idx = dns_alloc_pcb();
@@ -1472,6 +1701,7 @@ static err_t dns_enqueue(const char *name, size_t hostnamelen, dns_found_callbac
  * - ERR_INPROGRESS enqueue a request to be sent to the DNS server
  *   for resolution if no errors are present.
  * - ERR_ARG: dns client not initialized or invalid hostname
+ * - ERR_VAL: no DNS server set, or the name is cached as non-existent
  *
  * @param hostname the hostname that is to be queried
  * @param addr pointer to a ip_addr_t where to store the address if it is already
@@ -1539,11 +1769,12 @@ err_t dns_gethostbyname_addrtype(const char *hostname, ip_addr_t *addr, dns_foun
 		}
 	}
 	/* already have this address cached? */
-	u8_t err;
+	err_t err;
 
 	err = dns_lookup(hostname, addr LWIP_DNS_ADDRTYPE_ARG(dns_addrtype));
-	if (err == ERR_OK) {
-		return ERR_OK;
+	if ((err == ERR_OK) || (err == ERR_VAL)) {
+		/* resolved, or known not to exist */
+		return err;
 	}
 #if LWIP_IPV4 && LWIP_IPV6
 	if ((dns_addrtype == LWIP_DNS_ADDRTYPE_IPV4_IPV6) || (dns_addrtype == LWIP_DNS_ADDRTYPE_IPV6_IPV4)) {
@@ -27,7 +27,7 @@
  * \#define LWIP_CHKSUM your_checksum_routine
  *
  * Or you can select from the implementations below by defining
- * LWIP_CHKSUM_ALGORITHM to 1, 2 or 3.
+ * LWIP_CHKSUM_ALGORITHM to 1, 2, 3 or 4.
  */
 
 /*
@@ -277,6 +277,83 @@ u16_t lwip_standard_chksum(const void *dataptr, int len)
 }
 #endif
 
+#if (LWIP_CHKSUM_ALGORITHM == 4)	/* Alternative version #4 */
+/**
+ * Word-at-a-time checksum for 32-bit cores. 32-bit words are added into
+ * a 64-bit accumulator so no per-word carry handling is needed, and the
+ * inner loop is unrolled to consume 32 bytes per iteration.
+ *
+ * @arg start of buffer to be checksummed. May be an odd byte address.
+ * @len number of bytes in the buffer to be checksummed.
+ * @return host order (!) lwip checksum (non-inverted Internet sum)
+ */
+u16_t lwip_standard_chksum(const void *dataptr, int len)
+{
+	const u8_t *pb = (const u8_t *)dataptr;
+	const u16_t *ps;
+	const u32_t *pl;
+	u16_t t = 0;
+	uint64_t sum = 0;
+	u32_t sum32;
+	/* starts at odd byte address? */
+	int odd = ((mem_ptr_t) pb & 1);
+
+	if (odd && len > 0) {
+		((u8_t *)&t)[1] = *pb++;
+		len--;
+	}
+
+	ps = (const u16_t *)(const void *)pb;
+
+	if (((mem_ptr_t) ps & 3) && len > 1) {
+		sum += *ps++;
+		len -= 2;
+	}
+
+	pl = (const u32_t *)(const void *)ps;
+
+	while (len >= 32) {
+		sum += (uint64_t)pl[0] + pl[1] + pl[2] + pl[3];
+		sum += (uint64_t)pl[4] + pl[5] + pl[6] + pl[7];
+		pl += 8;
+		len -= 32;
+	}
+
+	while (len > 3) {
+		sum += *pl++;
+		len -= 4;
+	}
+
+	ps = (const u16_t *)(const void *)pl;
+
+	/* 16-bit aligned word remaining? */
+	if (len > 1) {
+		sum += *ps++;
+		len -= 2;
+	}
+
+	/* dangling tail byte remaining? */
+	if (len > 0) {
+		((u8_t *)&t)[0] = *(const u8_t *)ps;
+	}
+
+	sum += t;
+
+	/* Fold 64-bit sum to 32 bits, then 32 bits to 16 */
+	sum = (sum >> 32) + (sum & 0xffffffffULL);
+	sum = (sum >> 32) + (sum & 0xffffffffULL);
+	sum32 = (u32_t)sum;
+	sum32 = FOLD_U32T(sum32);
+	sum32 = FOLD_U32T(sum32);
+
+	if (odd) {
+		sum32 = SWAP_BYTES_IN_WORD(sum32);
+	}
+
+	return (u16_t) sum32;
+}
+#endif
+
 /** Parts of the pseudo checksum which are common to IPv4 and IPv6 */
 static u16_t inet_cksum_pseudo_base(struct pbuf *p, u8_t proto, u16_t proto_len, u32_t acc)
 {
@@ -558,6 +635,63 @@ u16_t ip_chksum_pseudo_partial(struct pbuf *p, u8_t proto, u16_t proto_len, u16_
 #endif							/* LWIP_IPV4 */
 }
 
+/* ip_chksum_pseudo_hdr:
+ *
+ * Calculates the sum over the IPv4 or IPv6 pseudo header only. Used to seed
+ * the TCP/UDP checksum field for interfaces whose hardware completes the
+ * checksum over the payload (partial checksum offload).
+ *
+ * @param proto ip protocol (used for checksum of pseudo header)
+ * @param proto_len length of the ip data part (used for checksum of pseudo header)
+ * @param src source ip address (used for checksum of pseudo header)
+ * @param dest destination ip address (used for checksum of pseudo header)
+ * @return non-inverted pseudo header sum (as u16_t) in network order
+ */
+u16_t ip_chksum_pseudo_hdr(u8_t proto, u16_t proto_len, const ip_addr_t *src, const ip_addr_t *dest)
+{
+	u32_t acc = 0;
+	u32_t addr;
+
+	if (src == NULL || dest == NULL) {
+		return 0;
+	}
+
+#if LWIP_IPV6
+	if (IP_IS_V6(dest)) {
+		u8_t addr_part;
+
+		for (addr_part = 0; addr_part < 4; addr_part++) {
+			addr = ip_2_ip6(src)->addr[addr_part];
+			acc += (addr & 0xffffUL);
+			acc += ((addr >> 16) & 0xffffUL);
+			addr = ip_2_ip6(dest)->addr[addr_part];
+			acc += (addr & 0xffffUL);
+			acc += ((addr >> 16) & 0xffffUL);
+		}
+	}
+#endif							/* LWIP_IPV6 */
+#if LWIP_IPV4 && LWIP_IPV6
+	else
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+#if LWIP_IPV4
+	{
+		addr = ip4_addr_get_u32(ip_2_ip4(src));
+		acc += (addr & 0xffffUL);
+		acc += ((addr >> 16) & 0xffffUL);
+		addr = ip4_addr_get_u32(ip_2_ip4(dest));
+		acc += (addr & 0xffffUL);
+		acc += ((addr >> 16) & 0xffffUL);
+	}
+#endif							/* LWIP_IPV4 */
+
+	acc += (u32_t) lwip_htons((u16_t) proto);
+	acc += (u32_t) lwip_htons(proto_len);
+
+	acc = FOLD_U32T(acc);
+	acc = FOLD_U32T(acc);
+	return (u16_t) (acc & 0xffffUL);
+}
+
 /* inet_chksum:
  *
  * Calculates the Internet checksum over a portion of memory. Used primarily for IP
@@ -621,3 +755,87 @@ u16_t lwip_chksum_copy(void *dst, const void *src, u16_t len)
 	return LWIP_CHKSUM(dst, len);
 }
 #endif							/* (LWIP_CHKSUM_COPY_ALGORITHM == 1) */
+
+#if (LWIP_CHKSUM_COPY_ALGORITHM == 2)	/* Version #2 */
+/** Copy and checksum in a single pass over the data. When source and
+ * destination share the same alignment, the bulk is moved as 32-bit words
+ * which are summed while they are in registers; otherwise fall back to
+ * MEMCPY followed by LWIP_CHKSUM.
+ */
+u16_t lwip_chksum_copy(void *dst, const void *src, u16_t len)
+{
+	const u8_t *s = (const u8_t *)src;
+	u8_t *d = (u8_t *)dst;
+	const u32_t *sl;
+	u32_t *dl;
+	u32_t w0;
+	u32_t w1;
+	u32_t w2;
+	u32_t w3;
+	u32_t acc;
+	uint64_t sum = 0;
+	u16_t head;
+	u16_t words;
+	u16_t tail;
+	u16_t part;
+
+	if ((((mem_ptr_t) s ^ (mem_ptr_t) d) & 3) != 0 || len < 16) {
+		MEMCPY(dst, src, len);
+		return LWIP_CHKSUM(dst, len);
+	}
+
+	head = (u16_t) ((4 - ((mem_ptr_t) s & 3)) & 3);
+	words = (u16_t) ((len - head) & ~3);
+	tail = (u16_t) (len - head - words);
+
+	acc = 0;
+	if (head > 0) {
+		MEMCPY(d, s, head);
+		acc = LWIP_CHKSUM(d, head);
+		s += head;
+		d += head;
+	}
+
+	sl = (const u32_t *)(const void *)s;
+	dl = (u32_t *)(void *)d;
+	for (part = words; part >= 16; part -= 16) {
+		w0 = sl[0];
+		w1 = sl[1];
+		w2 = sl[2];
+		w3 = sl[3];
+		dl[0] = w0;
+		dl[1] = w1;
+		dl[2] = w2;
+		dl[3] = w3;
+		sum += (uint64_t)w0 + w1 + w2 + w3;
+		sl += 4;
+		dl += 4;
+	}
+	for (; part > 0; part -= 4) {
+		w0 = *sl++;
+		*dl++ = w0;
+		sum += w0;
+	}
+
+	sum = (sum >> 32) + (sum & 0xffffffffULL);
+	sum = (sum >> 32) + (sum & 0xffffffffULL);
+	w0 = FOLD_U32T((u32_t)sum);
+	w0 = FOLD_U32T(w0);
+
+	if (tail > 0) {
+		MEMCPY(dl, sl, tail);
+		w0 += LWIP_CHKSUM(dl, tail);
+		w0 = FOLD_U32T(w0);
+	}
+
+	/* the word-aligned part started at an odd offset of the buffer */
+	if (head & 1) {
+		w0 = SWAP_BYTES_IN_WORD(w0);
+	}
+
+	acc += w0;
+	acc = FOLD_U32T(acc);
+	acc = FOLD_U32T(acc);
+	return (u16_t) acc;
+}
+#endif							/* (LWIP_CHKSUM_COPY_ALGORITHM == 2) */
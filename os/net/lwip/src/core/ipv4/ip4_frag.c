@@ -124,10 +124,26 @@ PACK_STRUCT_END
 	((ip4_addr_cmp(&(iphdrA)->src, &(iphdrB)->src) && \
 	ip4_addr_cmp(&(iphdrA)->dest, &(iphdrB)->dest) && \
 	IPH_ID(iphdrA) == IPH_ID(iphdrB)) ? 1 : 0)
+#if IP_REASS_HASH_SIZE < 1
+#error IP_REASS_HASH_SIZE must be at least 1
+#endif
+
 /* global variables */
-static struct ip_reassdata *reassdatagrams;
+static struct ip_reassdata *reassdatagrams[IP_REASS_HASH_SIZE];
 static u16_t ip_reass_pbufcount;
 
+/**
+ * Get the list of the hash bucket the datagram of an IP header belongs to.
+ * All fragments of a datagram carry the same source, destination and ID.
+ */
+static struct ip_reassdata **ip_reass_bucket(const struct ip_hdr *iphdr)
+{
+	u32_t h = IPH_ID(iphdr) ^ ip4_addr_get_u32(&iphdr->src) ^ ip4_addr_get_u32(&iphdr->dest);
+
+	h ^= h >> 16;
+	return &reassdatagrams[h % IP_REASS_HASH_SIZE];
+}
+
 /* function prototypes */
 static void ip_reass_dequeue_datagram(struct ip_reassdata *ipr, struct ip_reassdata *prev);
 static int ip_reass_free_complete_datagram(struct ip_reassdata *ipr, struct ip_reassdata *prev);
@@ -140,29 +156,33 @@ static int ip_reass_free_complete_datagram(struct ip_reassdata *ipr, struct ip_r
  */
 void ip_reass_tmr(void)
 {
-	struct ip_reassdata *r, *prev = NULL;
+	struct ip_reassdata *r, *prev;
+	int b;
 
-	r = reassdatagrams;
-	while (r != NULL) {
-		/**
-		 * Decrement the timer. Once it reaches 0,
-		 * clean up the incomplete fragment assembly
-		 */
-		if (r->timer > 0) {
-			r->timer--;
-			LWIP_DEBUGF(IP_REASS_DEBUG, ("ip_reass_tmr: timer dec %" U16_F "\n", (u16_t) r->timer));
-			prev = r;
-			r = r->next;
-		} else {
-			/* reassembly timed out */
-			struct ip_reassdata *tmp;
-
-			LWIP_DEBUGF(IP_REASS_DEBUG, ("ip_reass_tmr: timer timed out\n"));
-			tmp = r;
-			/* get the next pointer before freeing */
-			r = r->next;
-			/* free the helper struct and all enqueued pbufs */
-			ip_reass_free_complete_datagram(tmp, prev);
+	for (b = 0; b < IP_REASS_HASH_SIZE; b++) {
+		prev = NULL;
+		r = reassdatagrams[b];
+		while (r != NULL) {
+			/**
+			 * Decrement the timer. Once it reaches 0,
+			 * clean up the incomplete fragment assembly
+			 */
+			if (r->timer > 0) {
+				r->timer--;
+				LWIP_DEBUGF(IP_REASS_DEBUG, ("ip_reass_tmr: timer dec %" U16_F "\n", (u16_t) r->timer));
+				prev = r;
+				r = r->next;
+			} else {
+				/* reassembly timed out */
+				struct ip_reassdata *tmp;
+
+				LWIP_DEBUGF(IP_REASS_DEBUG, ("ip_reass_tmr: timer timed out\n"));
+				tmp = r;
+				/* get the next pointer before freeing */
+				r = r->next;
+				/* free the helper struct and all enqueued pbufs */
+				ip_reass_free_complete_datagram(tmp, prev);
+			}
 		}
 	}
 }
@@ -173,7 +193,7 @@ void ip_reass_tmr(void)
  * SNMP counters and sends an ICMP time exceeded packet.
  *
  * @param ipr datagram to free
- * @param prev the previous datagram in the linked list
+ * @param prev the previous datagram in the list of its hash bucket
  * @return the number of pbufs freed
  */
 static int ip_reass_free_complete_datagram(struct ip_reassdata *ipr, struct ip_reassdata *prev)
@@ -243,12 +263,10 @@ static int ip_reass_free_complete_datagram(struct ip_reassdata *ipr, struct ip_r
  */
 static int ip_reass_remove_oldest_datagram(struct ip_hdr *fraghdr, int pbufs_needed)
 {
-	/* @todo Can't we simply remove the last datagram in the
-	 *       linked list behind reassdatagrams?
-	 */
 	struct ip_reassdata *r, *oldest, *prev, *oldest_prev;
 	int pbufs_freed = 0, pbufs_freed_current;
 	int other_datagrams;
+	int b;
 
 	/**
 	 * Free datagrams until being allowed to enqueue 'pbufs_needed' pbufs,
@@ -256,27 +274,22 @@ static int ip_reass_remove_oldest_datagram(struct ip_hdr *fraghdr, int pbufs_nee
 	 */
 	do {
 		oldest = NULL;
-		prev = NULL;
 		oldest_prev = NULL;
 		other_datagrams = 0;
-		r = reassdatagrams;
-		while (r != NULL) {
-			if (!IP_ADDRESSES_AND_ID_MATCH(&r->iphdr, fraghdr)) {
-				/* Not the same datagram as fraghdr */
-				other_datagrams++;
-				if (oldest == NULL) {
-					oldest = r;
-					oldest_prev = prev;
-				} else if (r->timer <= oldest->timer) {
-					/* older than the previous oldest */
-					oldest = r;
-					oldest_prev = prev;
+		for (b = 0; b < IP_REASS_HASH_SIZE; b++) {
+			prev = NULL;
+			for (r = reassdatagrams[b]; r != NULL; r = r->next) {
+				if (!IP_ADDRESSES_AND_ID_MATCH(&r->iphdr, fraghdr)) {
+					/* Not the same datagram as fraghdr */
+					other_datagrams++;
+					if ((oldest == NULL) || (r->timer <= oldest->timer)) {
+						/* older than the previous oldest */
+						oldest = r;
+						oldest_prev = prev;
+					}
 				}
-			}
-			if (r->next != NULL) {
 				prev = r;
 			}
-			r = r->next;
 		}
 		if (oldest != NULL) {
 			pbufs_freed_current = ip_reass_free_complete_datagram(oldest, oldest_prev);
@@ -296,6 +309,7 @@ static int ip_reass_remove_oldest_datagram(struct ip_hdr *fraghdr, int pbufs_nee
 static struct ip_reassdata *ip_reass_enqueue_new_datagram(struct ip_hdr *fraghdr, int clen)
 {
 	struct ip_reassdata *ipr;
+	struct ip_reassdata **bucket;
 #if !IP_REASS_FREE_OLDEST
 	LWIP_UNUSED_ARG(clen);
 #endif
@@ -318,9 +332,10 @@ static struct ip_reassdata *ip_reass_enqueue_new_datagram(struct ip_hdr *fraghdr
 	memset(ipr, 0, sizeof(struct ip_reassdata));
 	ipr->timer = IP_REASS_MAXAGE;
 
-	/* enqueue the new structure to the front of the list */
-	ipr->next = reassdatagrams;
-	reassdatagrams = ipr;
+	/* enqueue the new structure to the front of the list of its bucket */
+	bucket = ip_reass_bucket(fraghdr);
+	ipr->next = *bucket;
+	*bucket = ipr;
 	/* copy the ip header for later tests and input */
 	/* @todo: no ip options supported? */
 	SMEMCPY(&(ipr->iphdr), fraghdr, IP_HLEN);
@@ -333,10 +348,12 @@ static struct ip_reassdata *ip_reass_enqueue_new_datagram(struct ip_hdr *fraghdr
  */
 static void ip_reass_dequeue_datagram(struct ip_reassdata *ipr, struct ip_reassdata *prev)
 {
+	struct ip_reassdata **bucket = ip_reass_bucket(&ipr->iphdr);
+
 	/* dequeue the reass struct  */
-	if (reassdatagrams == ipr) {
+	if (*bucket == ipr) {
 		/* it was the first in the list */
-		reassdatagrams = ipr->next;
+		*bucket = ipr->next;
 	} else {
 		/* it wasn't the first, so it must have a valid 'prev' */
 		LWIP_ASSERT("sanity check linked list", prev != NULL);
@@ -350,8 +367,9 @@ static void ip_reass_dequeue_datagram(struct ip_reassdata *ipr, struct ip_reassd
 /**
  * Chain a new pbuf into the pbuf list that composes the datagram.  The pbuf list
  * will grow over time as  new pbufs are rx.
- * Also checks that the datagram passes basic continuity checks (if the last
- * fragment was received at least once).
+ * Since duplicate and overlapping fragments are thrown away, the datagram can only
+ * be complete once the last fragment arrived and the received payload adds up to
+ * the datagram length: the list is only walked for the final continuity check then.
  * @param ipr points to the reassembly state
  * @param new_p points to the pbuf for the current fragment
  * @return 0 if invalid, >0 otherwise
@@ -362,7 +380,6 @@ static int ip_reass_chain_frag_into_datagram_and_validate(struct ip_reassdata *i
 	struct pbuf *q;
 	u16_t offset, len;
 	struct ip_hdr *fraghdr;
-	int valid = 1;
 
 	/* Extract length and fragment offset from current fragment */
 	fraghdr = (struct ip_hdr *)new_p->payload;
@@ -380,125 +397,85 @@ static int ip_reass_chain_frag_into_datagram_and_validate(struct ip_reassdata *i
 	iprh->start = offset;
 	iprh->end = offset + len;
 
-	/**
-	 * Iterate through until we either get to the end of the list (append),
-	 * or we find one with a larger offset (insert).
-	 */
-	for (q = ipr->p; q != NULL;) {
-		iprh_tmp = (struct ip_reass_helper *)q->payload;
-		if (iprh->start < iprh_tmp->start) {
-			/* the new pbuf should be inserted before this */
-			iprh->next_pbuf = q;
-			if (iprh_prev != NULL) {
-				/* not the fragment with the lowest offset */
+	if ((ipr->last != NULL) && (iprh->start >= ((struct ip_reass_helper *)ipr->last->payload)->end)) {
+		/* in order: append it behind the fragment with the highest offset */
+		((struct ip_reass_helper *)ipr->last->payload)->next_pbuf = new_p;
+		ipr->last = new_p;
+	} else {
+		/**
+		 * Iterate through until we either get to the end of the list (append),
+		 * or we find one with a larger offset (insert).
+		 */
+		for (q = ipr->p; q != NULL;) {
+			iprh_tmp = (struct ip_reass_helper *)q->payload;
+			if (iprh->start < iprh_tmp->start) {
 #if IP_REASS_CHECK_OVERLAP
-				if ((iprh->start < iprh_prev->end) || (iprh->end > iprh_tmp->start)) {
+				if ((iprh->end > iprh_tmp->start) || ((iprh_prev != NULL) && (iprh->start < iprh_prev->end))) {
 					/* fragment overlaps with previous or following, throw away */
 					goto freepbuf;
 				}
 #endif							/* IP_REASS_CHECK_OVERLAP */
-				iprh_prev->next_pbuf = new_p;
-			} else {
-				/* fragment with the lowest offset */
-				ipr->p = new_p;
-			}
-			break;
-		} else if (iprh->start == iprh_tmp->start) {
-			/* received the same datagram twice: no need to keep the datagram */
-			goto freepbuf;
+				/* the new pbuf should be inserted before this */
+				iprh->next_pbuf = q;
+				if (iprh_prev != NULL) {
+					/* not the fragment with the lowest offset */
+					iprh_prev->next_pbuf = new_p;
+				} else {
+					/* fragment with the lowest offset */
+					ipr->p = new_p;
+				}
+				break;
+			} else if (iprh->start == iprh_tmp->start) {
+				/* received the same datagram twice: no need to keep the datagram */
+				goto freepbuf;
 #if IP_REASS_CHECK_OVERLAP
-		} else if (iprh->start < iprh_tmp->end) {
-			/* overlap: no need to keep the new datagram */
-			goto freepbuf;
+			} else if (iprh->start < iprh_tmp->end) {
+				/* overlap: no need to keep the new datagram */
+				goto freepbuf;
 #endif							/* IP_REASS_CHECK_OVERLAP */
-		} else {
-			/* Check if the fragments received so far have no holes. */
-			if (iprh_prev != NULL) {
-				if (iprh_prev->end != iprh_tmp->start) {
-					/**
-					 * There is a fragment missing between the current
-					 * and the previous fragment
-					 */
-					valid = 0;
-				}
 			}
+			q = iprh_tmp->next_pbuf;
+			iprh_prev = iprh_tmp;
 		}
-		q = iprh_tmp->next_pbuf;
-		iprh_prev = iprh_tmp;
-	}
 
-	/* If q is NULL, then we made it to the end of the list. Determine what to do now */
-	if (q == NULL) {
-		if (iprh_prev != NULL) {
-			/**
-			 * this is (for now), the fragment with the highest offset:
-			 * chain it to the last fragment
-			 */
-#if IP_REASS_CHECK_OVERLAP
-			LWIP_ASSERT("check fragments don't overlap", iprh_prev->end <= iprh->start);
-#endif							/* IP_REASS_CHECK_OVERLAP */
-			iprh_prev->next_pbuf = new_p;
-			if (iprh_prev->end != iprh->start) {
-				valid = 0;
+		/* If q is NULL, then we made it to the end of the list. */
+		if (q == NULL) {
+			if (iprh_prev != NULL) {
+				/* this is (for now), the fragment with the highest offset */
+				iprh_prev->next_pbuf = new_p;
+			} else {
+				/* this is the first fragment we ever received for this ip datagram */
+				ipr->p = new_p;
 			}
-		} else {
-#if IP_REASS_CHECK_OVERLAP
-			LWIP_ASSERT("no previous fragment, this must be the first fragment!", ipr->p == NULL);
-#endif							/* IP_REASS_CHECK_OVERLAP */
-			/* this is the first fragment we ever received for this ip datagram */
-			ipr->p = new_p;
+			ipr->last = new_p;
 		}
 	}
+	ipr->recv_len += len;
 
-	/* At this point, the validation part begins: */
-	/* If we already received the last fragment */
-	if ((ipr->flags & IP_REASS_FLAG_LASTFRAG) != 0) {
-		/* and had no holes so far */
-		if (valid) {
-			/* then check if the rest of the fragments is here */
-			/* Check if the queue starts with the first datagram */
-			if ((ipr->p == NULL) || (((struct ip_reass_helper *)ipr->p->payload)->start != 0)) {
-				valid = 0;
-			} else {
-				/* and check that there are no holes after this datagram */
-				iprh_prev = iprh;
-				q = iprh->next_pbuf;
-				while (q != NULL) {
-					iprh = (struct ip_reass_helper *)q->payload;
-					if (iprh_prev->end != iprh->start) {
-						valid = 0;
-						break;
-					}
-					iprh_prev = iprh;
-					q = iprh->next_pbuf;
-				}
-				/**
-				 * if still valid, all fragments are received
-				 * (because to the MF==0 already arrived
-				 */
-				if (valid) {
-					LWIP_ASSERT("sanity check", ipr->p != NULL);
-					LWIP_ASSERT("sanity check", ((struct ip_reass_helper *)ipr->p->payload) != iprh);
-					LWIP_ASSERT("validate_datagram:next_pbuf!=NULL", iprh->next_pbuf == NULL);
-					LWIP_ASSERT("validate_datagram:datagram end!=datagram len", iprh->end == ipr->datagram_len);
-				}
-			}
+	/* Not complete before the last fragment and all data in front of it arrived */
+	if (((ipr->flags & IP_REASS_FLAG_LASTFRAG) == 0) || (ipr->recv_len < ipr->datagram_len)) {
+		return 0;
+	}
+
+	/**
+	 * Check once that the fragments have no holes and end with the datagram:
+	 * if not (e.g. overlaps with IP_REASS_CHECK_OVERLAP==0, or bogus fragments
+	 * behind the last one), the datagram simply times out.
+	 */
+	iprh_prev = NULL;
+	for (q = ipr->p; q != NULL; q = iprh->next_pbuf) {
+		iprh = (struct ip_reass_helper *)q->payload;
+		if (iprh->start != ((iprh_prev != NULL) ? iprh_prev->end : 0)) {
+			return 0;
 		}
-		/**
-		 * If valid is 0 here, there are some fragments missing in the middle
-		 * (since MF == 0 has already arrived). Such datagrams simply time out if
-		 * no more fragments are received...
-		 */
-		return valid;
+		iprh_prev = iprh;
 	}
-	/* If we come here, not all fragments were received, yet! */
-	return 0;					/* not yet valid! */
-#if IP_REASS_CHECK_OVERLAP
+	return (iprh_prev != NULL) && (iprh_prev->end == ipr->datagram_len);
+
 freepbuf:
 	ip_reass_pbufcount -= pbuf_clen(new_p);
 	pbuf_free(new_p);
 	return 0;
-#endif							/* IP_REASS_CHECK_OVERLAP */
 }
 
 /**
@@ -547,9 +524,9 @@ struct pbuf *ip4_reass(struct pbuf *p)
 
 	/**
 	 * Look for the datagram the fragment belongs to in the current datagram queue,
-	 * remembering the previous in the queue for later dequeueing.
+	 * only the datagrams of its hash bucket can match.
 	 */
-	for (ipr = reassdatagrams; ipr != NULL; ipr = ipr->next) {
+	for (ipr = *ip_reass_bucket(fraghdr); ipr != NULL; ipr = ipr->next) {
 		/**
 		 * Check if the incoming fragment matches the one currently present
 		 * in the reassembly buffer. If so, we proceed with copying the
@@ -635,11 +612,12 @@ struct pbuf *ip4_reass(struct pbuf *p)
 			r = iprh->next_pbuf;
 		}
 
-		/* find the previous entry in the linked list */
-		if (ipr == reassdatagrams) {
+		/* find the previous entry in the list of the bucket */
+		ipr_prev = *ip_reass_bucket(&ipr->iphdr);
+		if (ipr == ipr_prev) {
 			ipr_prev = NULL;
 		} else {
-			for (ipr_prev = reassdatagrams; ipr_prev != NULL; ipr_prev = ipr_prev->next) {
+			for (; ipr_prev != NULL; ipr_prev = ipr_prev->next) {
 				if (ipr_prev->next == ipr) {
 					break;
 				}
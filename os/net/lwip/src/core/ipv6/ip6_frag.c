@@ -115,8 +115,12 @@ PACK_STRUCT_END
 #ifdef PACK_STRUCT_USE_INCLUDES
 #include "arch/epstruct.h"
 #endif
+#if IP_REASS_HASH_SIZE < 1
+#error IP_REASS_HASH_SIZE must be at least 1
+#endif
+
 /* static variables */
-static struct ip6_reassdata *reassdatagrams;
+static struct ip6_reassdata *reassdatagrams[IP_REASS_HASH_SIZE];
 static u16_t ip6_reass_pbufcount;
 
 /* Forward declarations. */
@@ -125,30 +129,67 @@ static void ip6_reass_free_complete_datagram(struct ip6_reassdata *ipr);
 static void ip6_reass_remove_oldest_datagram(struct ip6_reassdata *ipr, int pbufs_needed);
 #endif							/* IP_REASS_FREE_OLDEST */
 
+/**
+ * Get the list of the hash bucket a datagram belongs to, from its
+ * identification and the low words of its source and destination address.
+ */
+static struct ip6_reassdata **ip6_reass_bucket(u32_t identification, u32_t src, u32_t dest)
+{
+	u32_t h = identification ^ src ^ dest;
+
+	h ^= h >> 16;
+	return &reassdatagrams[h % IP_REASS_HASH_SIZE];
+}
+
+/**
+ * Unlink a datagram from the list of its hash bucket.
+ * Must be called while the IPv6 header of the datagram is still valid.
+ */
+static void ip6_reass_dequeue_datagram(struct ip6_reassdata *ipr)
+{
+	struct ip6_reassdata **bucket;
+	struct ip6_reassdata *prev;
+
+	bucket = ip6_reass_bucket(ipr->identification, IPV6_FRAG_HDRREF(ipr->iphdr)->src.addr[3], IPV6_FRAG_HDRREF(ipr->iphdr)->dest.addr[3]);
+	if (*bucket == ipr) {
+		*bucket = ipr->next;
+	} else {
+		for (prev = *bucket; prev != NULL; prev = prev->next) {
+			if (prev->next == ipr) {
+				prev->next = ipr->next;
+				break;
+			}
+		}
+	}
+}
+
 void ip6_reass_tmr(void)
 {
 	struct ip6_reassdata *r, *tmp;
+	int b;
 
 #if !IPV6_FRAG_COPYHEADER
 	LWIP_ASSERT("sizeof(struct ip6_reass_helper) <= IP6_FRAG_HLEN, set IPV6_FRAG_COPYHEADER to 1", sizeof(struct ip6_reass_helper) <= IP6_FRAG_HLEN);
 #endif							/* !IPV6_FRAG_COPYHEADER */
 
-	r = reassdatagrams;
-	while (r != NULL) {
-		/**
-		 * Decrement the timer. Once it reaches 0,
-		 * clean up the incomplete fragment assembly
-		 */
-		if (r->timer > 0) {
-			r->timer--;
-			r = r->next;
-		} else {
-			/* reassembly timed out */
-			tmp = r;
-			/* get the next pointer before freeing */
-			r = r->next;
-			/* free the helper struct and all enqueued pbufs */
-			ip6_reass_free_complete_datagram(tmp);
+	for (b = 0; b < IP_REASS_HASH_SIZE; b++) {
+		r = reassdatagrams[b];
+		while (r != NULL) {
+			/**
+			 * Decrement the timer. Once it reaches 0,
+			 * clean up the incomplete fragment assembly
+			 */
+			if (r->timer > 0) {
+				r->timer--;
+				r = r->next;
+			} else {
+				/* reassembly timed out */
+				tmp = r;
+				/* get the next pointer before freeing */
+				r = r->next;
+				/* free the helper struct and all enqueued pbufs */
+				ip6_reass_free_complete_datagram(tmp);
+			}
 		}
 	}
 }
@@ -162,12 +203,14 @@ void ip6_reass_tmr(void)
  */
 static void ip6_reass_free_complete_datagram(struct ip6_reassdata *ipr)
 {
-	struct ip6_reassdata *prev;
 	u16_t pbufs_freed = 0;
 	u16_t clen;
 	struct pbuf *p;
 	struct ip6_reass_helper *iprh;
 
+	/* First, unchain the struct ip6_reassdata from its list (ipr->iphdr may point into ipr->p). */
+	ip6_reass_dequeue_datagram(ipr);
+
 #if LWIP_ICMP6
 	iprh = (struct ip6_reass_helper *)ipr->p->payload;
 	if (iprh->start == 0) {
@@ -192,7 +235,7 @@ static void ip6_reass_free_complete_datagram(struct ip6_reassdata *ipr)
 #endif							/* LWIP_ICMP6 */
 
 	/**
-	 * First, free all received pbufs.  The individual pbufs need to be released
+	 * Then, free all received pbufs.  The individual pbufs need to be released
 	 * separately as they have not yet been chained
 	 */
 	p = ipr->p;
@@ -209,21 +252,6 @@ static void ip6_reass_free_complete_datagram(struct ip6_reassdata *ipr)
 		pbuf_free(pcur);
 	}
 
-	/* Then, unchain the struct ip6_reassdata from the list and free it. */
-	if (ipr == reassdatagrams) {
-		reassdatagrams = ipr->next;
-	} else {
-		prev = reassdatagrams;
-		while (prev != NULL) {
-			if (prev->next == ipr) {
-				break;
-			}
-			prev = prev->next;
-		}
-		if (prev != NULL) {
-			prev->next = ipr->next;
-		}
-	}
 	memp_free(MEMP_IP6_REASSDATA, ipr);
 
 	/* Finally, update number of pbufs in reassembly queue */
@@ -243,30 +271,28 @@ static void ip6_reass_free_complete_datagram(struct ip6_reassdata *ipr)
 static void ip6_reass_remove_oldest_datagram(struct ip6_reassdata *ipr, int pbufs_needed)
 {
 	struct ip6_reassdata *r, *oldest;
+	int b;
 
 	/**
 	 * Free datagrams until being allowed to enqueue 'pbufs_needed' pbufs,
 	 * but don't free the current datagram!
 	 */
 	do {
-		r = oldest = reassdatagrams;
-		while (r != NULL) {
-			if (r != ipr) {
-				if (r->timer <= oldest->timer) {
+		oldest = NULL;
+		for (b = 0; b < IP_REASS_HASH_SIZE; b++) {
+			for (r = reassdatagrams[b]; r != NULL; r = r->next) {
+				if ((r != ipr) && ((oldest == NULL) || (r->timer <= oldest->timer))) {
 					/* older than the previous oldest */
 					oldest = r;
 				}
 			}
-			r = r->next;
 		}
-		if (oldest == ipr) {
-			/* nothing to free, ipr is the only element on the list */
+		if (oldest == NULL) {
+			/* nothing to free, ipr is the only datagram being reassembled */
 			return;
 		}
-		if (oldest != NULL) {
-			ip6_reass_free_complete_datagram(oldest);
-		}
-	} while (((ip6_reass_pbufcount + pbufs_needed) > IP_REASS_MAX_PBUFS) && (reassdatagrams != NULL));
+		ip6_reass_free_complete_datagram(oldest);
+	} while ((ip6_reass_pbufcount + pbufs_needed) > IP_REASS_MAX_PBUFS);
 }
 #endif							/* IP_REASS_FREE_OLDEST */
 
@@ -279,7 +305,8 @@ static void ip6_reass_remove_oldest_datagram(struct ip6_reassdata *ipr, int pbuf
  */
 struct pbuf *ip6_reass(struct pbuf *p)
 {
-	struct ip6_reassdata *ipr, *ipr_prev;
+	struct ip6_reassdata *ipr;
+	struct ip6_reassdata **bucket;
 	struct ip6_reass_helper *iprh, *iprh_tmp, *iprh_prev = NULL;
 	struct ip6_frag_hdr *frag_hdr;
 	u16_t offset, len;
@@ -313,9 +340,10 @@ struct pbuf *ip6_reass(struct pbuf *p)
 
 	/**
 	 * Look for the datagram the fragment belongs to in the current datagram queue,
-	 * remembering the previous in the queue for later dequeueing.
+	 * only the datagrams of its hash bucket can match.
 	 */
-	for (ipr = reassdatagrams, ipr_prev = NULL; ipr != NULL; ipr = ipr->next) {
+	bucket = ip6_reass_bucket(frag_hdr->_identification, ip6_current_src_addr()->addr[3], ip6_current_dest_addr()->addr[3]);
+	for (ipr = *bucket; ipr != NULL; ipr = ipr->next) {
 		/**
 		 * Check if the incoming fragment matches the one currently present
 		 * in the reassembly buffer. If so, we proceed with copying the
@@ -325,7 +353,6 @@ struct pbuf *ip6_reass(struct pbuf *p)
 			IP6_FRAG_STATS_INC(ip6_frag.cachehit);
 			break;
 		}
-		ipr_prev = ipr;
 	}
 
 	if (ipr == NULL) {
@@ -336,14 +363,7 @@ struct pbuf *ip6_reass(struct pbuf *p)
 			/* Make room and try again. */
 			ip6_reass_remove_oldest_datagram(ipr, clen);
 			ipr = (struct ip6_reassdata *)memp_malloc(MEMP_IP6_REASSDATA);
-			if (ipr != NULL) {
-				/* re-search ipr_prev since it might have been removed */
-				for (ipr_prev = reassdatagrams; ipr_prev != NULL; ipr_prev = ipr_prev->next) {
-					if (ipr_prev->next == ipr) {
-						break;
-					}
-				}
-			} else
+			if (ipr == NULL)
 #endif							/* IP_REASS_FREE_OLDEST */
 			{
 				IP6_FRAG_STATS_INC(ip6_frag.memerr);
@@ -355,9 +375,9 @@ struct pbuf *ip6_reass(struct pbuf *p)
 		memset(ipr, 0, sizeof(struct ip6_reassdata));
 		ipr->timer = LWIP_IPV6_REASS_MAXAGE;
 
-		/* enqueue the new structure to the front of the list */
-		ipr->next = reassdatagrams;
-		reassdatagrams = ipr;
+		/* enqueue the new structure to the front of the list of its bucket */
+		ipr->next = *bucket;
+		*bucket = ipr;
 
 		/**
 		 * Use the current IPv6 header for src/dest address reference.
@@ -382,14 +402,7 @@ struct pbuf *ip6_reass(struct pbuf *p)
 	if ((ip6_reass_pbufcount + clen) > IP_REASS_MAX_PBUFS) {
 #if IP_REASS_FREE_OLDEST
 		ip6_reass_remove_oldest_datagram(ipr, clen);
-		if ((ip6_reass_pbufcount + clen) <= IP_REASS_MAX_PBUFS) {
-			/* re-search ipr_prev since it might have been removed */
-			for (ipr_prev = reassdatagrams; ipr_prev != NULL; ipr_prev = ipr_prev->next) {
-				if (ipr_prev->next == ipr) {
-					break;
-				}
-			}
-		} else
+		if ((ip6_reass_pbufcount + clen) > IP_REASS_MAX_PBUFS)
 #endif							/* IP_REASS_FREE_OLDEST */
 		{
 			/* @todo: send ICMPv6 time exceeded here? */
@@ -421,86 +434,70 @@ struct pbuf *ip6_reass(struct pbuf *p)
 	iprh->end = (offset & IP6_FRAG_OFFSET_MASK) + len;
 
 	/* find the right place to insert this pbuf */
-	/**
-	 * Iterate through until we either get to the end of the list (append),
-	 * or we find on with a larger offset (insert).
-	 */
-	for (q = ipr->p; q != NULL;) {
-		iprh_tmp = (struct ip6_reass_helper *)q->payload;
-		if (iprh->start < iprh_tmp->start) {
+	if ((ipr->last != NULL) && (iprh->start >= ((struct ip6_reass_helper *)ipr->last->payload)->end)) {
+		/* in order: append it behind the fragment with the highest offset */
+		((struct ip6_reass_helper *)ipr->last->payload)->next_pbuf = p;
+		ipr->last = p;
+	} else {
+		/**
+		 * Iterate through until we either get to the end of the list (append),
+		 * or we find on with a larger offset (insert).
+		 */
+		for (q = ipr->p; q != NULL;) {
+			iprh_tmp = (struct ip6_reass_helper *)q->payload;
+			if (iprh->start < iprh_tmp->start) {
 #if IP_REASS_CHECK_OVERLAP
-			if (iprh->end > iprh_tmp->start) {
-				/* fragment overlaps with following, throw away */
-				IP6_FRAG_STATS_INC(ip6_frag.proterr);
-				IP6_FRAG_STATS_INC(ip6_frag.drop);
-				goto nullreturn;
-			}
-			if (iprh_prev != NULL) {
-				if (iprh->start < iprh_prev->end) {
-					/* fragment overlaps with previous, throw away */
+				if (iprh->end > iprh_tmp->start) {
+					/* fragment overlaps with following, throw away */
 					IP6_FRAG_STATS_INC(ip6_frag.proterr);
 					IP6_FRAG_STATS_INC(ip6_frag.drop);
 					goto nullreturn;
 				}
-			}
+				if (iprh_prev != NULL) {
+					if (iprh->start < iprh_prev->end) {
+						/* fragment overlaps with previous, throw away */
+						IP6_FRAG_STATS_INC(ip6_frag.proterr);
+						IP6_FRAG_STATS_INC(ip6_frag.drop);
+						goto nullreturn;
+					}
+				}
 #endif							/* IP_REASS_CHECK_OVERLAP */
-			/* the new pbuf should be inserted before this */
-			iprh->next_pbuf = q;
-			if (iprh_prev != NULL) {
-				/* not the fragment with the lowest offset */
-				iprh_prev->next_pbuf = p;
-			} else {
-				/* fragment with the lowest offset */
-				ipr->p = p;
-			}
-			break;
-		} else if (iprh->start == iprh_tmp->start) {
-			/* received the same datagram twice: no need to keep the datagram */
-			IP6_FRAG_STATS_INC(ip6_frag.drop);
-			goto nullreturn;
+				/* the new pbuf should be inserted before this */
+				iprh->next_pbuf = q;
+				if (iprh_prev != NULL) {
+					/* not the fragment with the lowest offset */
+					iprh_prev->next_pbuf = p;
+				} else {
+					/* fragment with the lowest offset */
+					ipr->p = p;
+				}
+				break;
+			} else if (iprh->start == iprh_tmp->start) {
+				/* received the same datagram twice: no need to keep the datagram */
+				IP6_FRAG_STATS_INC(ip6_frag.drop);
+				goto nullreturn;
 #if IP_REASS_CHECK_OVERLAP
-		} else if (iprh->start < iprh_tmp->end) {
-			/* overlap: no need to keep the new datagram */
-			IP6_FRAG_STATS_INC(ip6_frag.proterr);
-			IP6_FRAG_STATS_INC(ip6_frag.drop);
-			goto nullreturn;
+			} else if (iprh->start < iprh_tmp->end) {
+				/* overlap: no need to keep the new datagram */
+				IP6_FRAG_STATS_INC(ip6_frag.proterr);
+				IP6_FRAG_STATS_INC(ip6_frag.drop);
+				goto nullreturn;
 #endif							/* IP_REASS_CHECK_OVERLAP */
-		} else {
-			/* Check if the fragments received so far have no gaps. */
-			if (iprh_prev != NULL) {
-				if (iprh_prev->end != iprh_tmp->start) {
-					/**
-					 * There is a fragment missing between the current
-					 * and the previous fragment
-					 */
-					valid = 0;
-				}
 			}
+			q = iprh_tmp->next_pbuf;
+			iprh_prev = iprh_tmp;
 		}
-		q = iprh_tmp->next_pbuf;
-		iprh_prev = iprh_tmp;
-	}
 
-	/* If q is NULL, then we made it to the end of the list. Determine what to do now */
-	if (q == NULL) {
-		if (iprh_prev != NULL) {
-			/**
-			 * this is (for now), the fragment with the highest offset:
-			 * chain it to the last fragment
-			 */
-#if IP_REASS_CHECK_OVERLAP
-			LWIP_ASSERT("check fragments don't overlap", iprh_prev->end <= iprh->start);
-#endif							/* IP_REASS_CHECK_OVERLAP */
-			iprh_prev->next_pbuf = p;
-			if (iprh_prev->end != iprh->start) {
-				valid = 0;
+		/* If q is NULL, then we made it to the end of the list. */
+		if (q == NULL) {
+			if (iprh_prev != NULL) {
+				/* this is (for now), the fragment with the highest offset */
+				iprh_prev->next_pbuf = p;
+			} else {
+				/* this is the first fragment we ever received for this ip datagram */
+				ipr->p = p;
 			}
-		} else {
-#if IP_REASS_CHECK_OVERLAP
-			LWIP_ASSERT("no previous fragment, this must be the first fragment!", ipr->p == NULL);
-#endif							/* IP_REASS_CHECK_OVERLAP */
-			/* this is the first fragment we ever received for this ip datagram */
-			ipr->p = p;
+			ipr->last = p;
 		}
 	}
 
@@ -509,6 +506,7 @@ struct pbuf *ip6_reass(struct pbuf *p)
 	 * the number of fragments that may be enqueued at any one time
 	 */
 	ip6_reass_pbufcount += clen;
+	ipr->recv_len += len;
 
 	/* Remember IPv6 header if this is the first fragment. */
 	if (iprh->start == 0) {
@@ -527,26 +525,26 @@ struct pbuf *ip6_reass(struct pbuf *p)
 		ipr->datagram_len = iprh->end;
 	}
 
-	/* Additional validity tests: we have received first and last fragment. */
-	iprh_tmp = (struct ip6_reass_helper *)ipr->p->payload;
-	if (iprh_tmp->start != 0) {
-		valid = 0;
-	}
-	if (ipr->datagram_len == 0) {
+	/**
+	 * Duplicate and overlapping fragments are thrown away, so the datagram can
+	 * only be complete once the last fragment arrived and the received payload
+	 * adds up to the datagram length: only then walk the list once to check
+	 * that there are no holes.
+	 */
+	if ((ipr->datagram_len == 0) || (ipr->recv_len < ipr->datagram_len)) {
 		valid = 0;
-	}
-
-	/* Final validity test: no gaps between current and last fragment. */
-	iprh_prev = iprh;
-	q = iprh->next_pbuf;
-	while ((q != NULL) && valid) {
-		iprh = (struct ip6_reass_helper *)q->payload;
-		if (iprh_prev->end != iprh->start) {
+	} else {
+		iprh_prev = NULL;
+		for (q = ipr->p; (q != NULL) && valid; q = iprh_tmp->next_pbuf) {
+			iprh_tmp = (struct ip6_reass_helper *)q->payload;
+			if (iprh_tmp->start != ((iprh_prev != NULL) ? iprh_prev->end : 0)) {
+				valid = 0;
+			}
+			iprh_prev = iprh_tmp;
+		}
+		if ((iprh_prev == NULL) || (iprh_prev->end != ipr->datagram_len)) {
 			valid = 0;
-			break;
 		}
-		iprh_prev = iprh;
-		q = iprh->next_pbuf;
 	}
 
 	if (valid) {
@@ -616,14 +614,7 @@ struct pbuf *ip6_reass(struct pbuf *p)
 		frag_hdr->_identification = 0;
 
 		/* release the sources allocate for the fragment queue entry */
-		if (reassdatagrams == ipr) {
-			/* it was the first in the list */
-			reassdatagrams = ipr->next;
-		} else {
-			/* it wasn't the first, so it must have a valid 'prev' */
-			LWIP_ASSERT("sanity check linked list", ipr_prev != NULL);
-			ipr_prev->next = ipr->next;
-		}
+		ip6_reass_dequeue_datagram(ipr);
 		memp_free(MEMP_IP6_REASSDATA, ipr);
 
 		/* adjust the number of pbufs currently queued for reassembly. */
@@ -772,18 +763,16 @@ err_t ip6_frag(struct pbuf *p, struct netif *netif, const ip6_addr_t *dest)
 		ip6hdr = (struct ip6_hdr *)rambuf->payload;
 		frag_hdr = (struct ip6_frag_hdr *)((u8_t *) rambuf->payload + IP6_HLEN);
 
-		/* Can just adjust p directly for needed offset. */
-		p->payload = (u8_t *) p->payload + poff;
-		p->len -= poff;
-		p->tot_len -= poff;
-
+		/* Point into p at the current offset, p itself is left untouched. */
 		left_to_copy = cop;
 		while (left_to_copy) {
 			struct pbuf_custom_ref *pcr;
+			u16_t plen = p->len - poff;
 
-			newpbuflen = (left_to_copy < p->len) ? left_to_copy : p->len;
+			newpbuflen = LWIP_MIN(left_to_copy, plen);
 			/* Is this pbuf already empty? */
 			if (!newpbuflen) {
+				poff = 0;
 				p = p->next;
 				continue;
 			}
@@ -794,7 +783,7 @@ err_t ip6_frag(struct pbuf *p, struct netif *netif, const ip6_addr_t *dest)
 				return ERR_MEM;
 			}
 			/* Mirror this pbuf, although we might not need all of it. */
-			newpbuf = pbuf_alloced_custom(PBUF_RAW, newpbuflen, PBUF_REF, &pcr->pc, p->payload, newpbuflen);
+			newpbuf = pbuf_alloced_custom(PBUF_RAW, newpbuflen, PBUF_REF, &pcr->pc, (u8_t *) p->payload + poff, newpbuflen);
 			if (newpbuf == NULL) {
 				ip6_frag_free_pbuf_custom_ref(pcr);
 				pbuf_free(rambuf);
@@ -811,10 +800,11 @@ err_t ip6_frag(struct pbuf *p, struct netif *netif, const ip6_addr_t *dest)
 			pbuf_cat(rambuf, newpbuf);
 			left_to_copy -= newpbuflen;
 			if (left_to_copy) {
+				poff = 0;
 				p = p->next;
 			}
 		}
-		poff = newpbuflen;
+		poff += newpbuflen;
 #endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
 
 		/* Set headers */
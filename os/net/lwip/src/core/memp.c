@@ -60,6 +60,7 @@
 #include <net/lwip/opt.h>
 
 #include <net/lwip/memp.h>
+#include <net/lwip/sys.h>
 #include <net/lwip/pbuf.h>
 #include <net/lwip/raw.h>
 #include <net/lwip/udp.h>
@@ -83,6 +84,13 @@
 #include <net/lwip/ip6_frag.h>
 #include <net/lwip/mld6.h>
 
+#if MEMP_GROW_FROM_HEAP && !MEMP_MEM_MALLOC
+#include <sched.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
+#endif
+
 #define LWIP_MEMPOOL(name, num, size, desc) LWIP_MEMPOOL_DECLARE(name, num, size, desc)
 #include <net/lwip/priv/memp_std.h>
 
@@ -222,6 +230,269 @@ static void memp_overflow_check_all(void)
 #endif							/* MEMP_OVERFLOW_CHECK >= 2 */
 #endif							/* MEMP_OVERFLOW_CHECK */
 
+#if MEMP_STATS && MEMP_STATS_OCCUPANCY
+/**
+ * Accumulate the time the pool spent at its current 'used' level.
+ * Must be called with SYS_ARCH_PROTECT held, before 'used' changes.
+ */
+static void memp_occupancy_update(const struct memp_desc *desc)
+{
+	u32_t now = sys_now();
+
+	desc->stats->occ_sum += (uint64_t)desc->stats->used * (u32_t)(now - desc->stats->occ_stamp);
+	desc->stats->occ_stamp = now;
+}
+
+/**
+ * Get the time-weighted average number of used elements of a pool since it
+ * was initialized.
+ *
+ * @param desc the pool to query
+ * @return average occupancy multiplied by 100
+ */
+u32_t memp_occupancy_pool(const struct memp_desc *desc)
+{
+	uint64_t sum;
+	u32_t elapsed;
+	u32_t now;
+
+	SYS_ARCH_DECL_PROTECT(old_level);
+
+	SYS_ARCH_PROTECT(old_level);
+	now = sys_now();
+	sum = desc->stats->occ_sum + (uint64_t)desc->stats->used * (u32_t)(now - desc->stats->occ_stamp);
+	elapsed = now - desc->stats->occ_start;
+	SYS_ARCH_UNPROTECT(old_level);
+
+	if (elapsed == 0) {
+		return (u32_t)desc->stats->used * 100;
+	}
+	return (u32_t)((sum * 100) / elapsed);
+}
+#endif							/* MEMP_STATS && MEMP_STATS_OCCUPANCY */
+
+#if MEMP_GROW_FROM_HEAP && !MEMP_MEM_MALLOC
+/* Size of one element including its header and sanity regions */
+#if MEMP_OVERFLOW_CHECK
+#define MEMP_ELEM_SIZE(desc) (MEMP_SIZE + (desc)->size + MEMP_SANITY_REGION_AFTER_ALIGNED)
+#else
+#define MEMP_ELEM_SIZE(desc) (MEMP_SIZE + (desc)->size)
+#endif
+
+#define MEMP_SLAB_HDR_SIZE   LWIP_MEM_ALIGN_SIZE(sizeof(struct memp_slab))
+
+/** Get the first element of a heap slab */
+#define MEMP_SLAB_FIRST(slab) ((struct memp *)LWIP_MEM_ALIGN((u8_t *)(slab) + MEMP_SLAB_HDR_SIZE))
+
+/**
+ * Check whether an element is part of the static array of a pool.
+ */
+static int memp_is_static(const struct memp_desc *desc, struct memp *memp)
+{
+	u8_t *base = (u8_t *)LWIP_MEM_ALIGN(desc->base);
+
+	return ((u8_t *)memp >= base) && ((u8_t *)memp < base + (mem_ptr_t)desc->num * MEMP_ELEM_SIZE(desc));
+}
+
+/**
+ * Allocate a slab from the heap and put all of its elements on the slab's
+ * free list. The slab is not linked to the pool yet.
+ */
+static struct memp_slab *memp_slab_new(const struct memp_desc *desc)
+{
+	struct memp_slab *slab;
+	struct memp *memp;
+	int i;
+
+	slab = (struct memp_slab *)kmm_malloc(MEMP_SLAB_HDR_SIZE + MEMP_GROW_SLAB_NUM * MEMP_ELEM_SIZE(desc) + MEM_ALIGNMENT - 1);
+	if (slab == NULL) {
+		return NULL;
+	}
+
+	slab->next = NULL;
+	slab->free = NULL;
+	slab->idle = 0;
+
+	memp = MEMP_SLAB_FIRST(slab);
+	for (i = 0; i < MEMP_GROW_SLAB_NUM; ++i) {
+		memp->next = slab->free;
+		slab->free = memp;
+#if MEMP_OVERFLOW_CHECK
+		memp_overflow_init_element(memp, desc);
+#endif							/* MEMP_OVERFLOW_CHECK */
+		memp = (struct memp *)(void *)((u8_t *) memp + MEMP_ELEM_SIZE(desc));
+	}
+	slab->nfree = MEMP_GROW_SLAB_NUM;
+
+	return slab;
+}
+
+/**
+ * Take a free element from the heap slabs of a pool.
+ * Must be called with SYS_ARCH_PROTECT held.
+ */
+static struct memp *memp_slab_take(const struct memp_desc *desc)
+{
+	struct memp_slab *slab;
+	struct memp *memp;
+
+	for (slab = *desc->slabs; slab != NULL; slab = slab->next) {
+		memp = slab->free;
+		if (memp != NULL) {
+			slab->free = memp->next;
+			slab->nfree--;
+			slab->idle = 0;
+			return memp;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Give an element back to the heap slab it was carved from.
+ * Must be called with SYS_ARCH_PROTECT held.
+ */
+static void memp_slab_put(const struct memp_desc *desc, struct memp *memp)
+{
+	struct memp_slab *slab;
+	u8_t *first;
+
+	for (slab = *desc->slabs; slab != NULL; slab = slab->next) {
+		first = (u8_t *)MEMP_SLAB_FIRST(slab);
+		if (((u8_t *)memp >= first) && ((u8_t *)memp < first + MEMP_GROW_SLAB_NUM * MEMP_ELEM_SIZE(desc))) {
+			memp->next = slab->free;
+			slab->free = memp;
+			slab->nfree++;
+			return;
+		}
+	}
+
+	LWIP_ASSERT("memp_free: element does not belong to pool", 0);
+}
+
+/**
+ * Count the heap slabs of a pool.
+ * Must be called with SYS_ARCH_PROTECT held.
+ */
+static int memp_slab_count(const struct memp_desc *desc)
+{
+	struct memp_slab *s;
+	int nslabs = 0;
+
+	for (s = *desc->slabs; s != NULL; s = s->next) {
+		nslabs++;
+	}
+
+	return nslabs;
+}
+
+/**
+ * Grow an exhausted pool by one heap slab, unless the pool already holds
+ * MEMP_GROW_MAX_SLABS slabs. The heap is only used from a context that may
+ * block: not from interrupt context and not while the scheduler is locked,
+ * which includes a SYS_ARCH_PROTECT held by our caller. Pools that are
+ * allocated from with interrupts disabled must not rely on growing.
+ * Must be called without SYS_ARCH_PROTECT held.
+ */
+static void memp_grow(const struct memp_desc *desc)
+{
+	struct memp_slab *slab;
+	int nslabs;
+
+	SYS_ARCH_DECL_PROTECT(old_level);
+
+	if (up_interrupt_context() || sched_lockcount() > 0) {
+		return;
+	}
+
+	/* cheap early out, the count is checked again when linking */
+	SYS_ARCH_PROTECT(old_level);
+	nslabs = memp_slab_count(desc);
+	SYS_ARCH_UNPROTECT(old_level);
+
+	if (nslabs >= MEMP_GROW_MAX_SLABS) {
+		return;
+	}
+
+	slab = memp_slab_new(desc);
+	if (slab == NULL) {
+		LWIP_DEBUGF(MEMP_DEBUG | LWIP_DBG_LEVEL_SERIOUS, ("memp_grow: out of heap for pool %s\n", desc->desc));
+		return;
+	}
+
+	/* another thread may have grown the pool meanwhile: count and link
+	 * in one step so the limit holds
+	 */
+	SYS_ARCH_PROTECT(old_level);
+	if (memp_slab_count(desc) >= MEMP_GROW_MAX_SLABS) {
+		SYS_ARCH_UNPROTECT(old_level);
+		kmm_free(slab);
+		return;
+	}
+	slab->next = *desc->slabs;
+	*desc->slabs = slab;
+#if MEMP_STATS
+	desc->stats->avail += MEMP_GROW_SLAB_NUM;
+	desc->stats->grown += MEMP_GROW_SLAB_NUM;
+	desc->stats->grow++;
+#endif							/* MEMP_STATS */
+	SYS_ARCH_UNPROTECT(old_level);
+
+	LWIP_DEBUGF(MEMP_DEBUG, ("memp_grow: pool %s grew by %d elements\n", desc->desc, MEMP_GROW_SLAB_NUM));
+}
+
+/**
+ * Cyclic timer: give heap slabs back to the heap once they have been found
+ * completely unused on two consecutive calls. Pools that cycle through
+ * their slabs quickly keep them, idle pools shrink back to their static
+ * size.
+ */
+void memp_tmr(void)
+{
+	const struct memp_desc *desc;
+	struct memp_slab **link;
+	struct memp_slab *slab;
+	struct memp_slab *release;
+	u16_t i;
+
+	SYS_ARCH_DECL_PROTECT(old_level);
+
+	for (i = 0; i < LWIP_ARRAYSIZE(memp_pools); i++) {
+		desc = memp_pools[i];
+		release = NULL;
+
+		SYS_ARCH_PROTECT(old_level);
+		link = desc->slabs;
+		while ((slab = *link) != NULL) {
+			if (slab->nfree < MEMP_GROW_SLAB_NUM) {
+				slab->idle = 0;
+				link = &slab->next;
+			} else if (!slab->idle) {
+				slab->idle = 1;
+				link = &slab->next;
+			} else {
+				*link = slab->next;
+				slab->next = release;
+				release = slab;
+#if MEMP_STATS
+				desc->stats->avail -= MEMP_GROW_SLAB_NUM;
+				desc->stats->grown -= MEMP_GROW_SLAB_NUM;
+				desc->stats->shrink++;
+#endif							/* MEMP_STATS */
+			}
+		}
+		SYS_ARCH_UNPROTECT(old_level);
+
+		while (release != NULL) {
+			slab = release;
+			release = slab->next;
+			kmm_free(slab);
+		}
+	}
+}
+#endif							/* MEMP_GROW_FROM_HEAP && !MEMP_MEM_MALLOC */
+
 /**
  * Initialize custom memory pool.
  * Related functions: memp_malloc_pool, memp_free_pool
@@ -252,11 +523,20 @@ void memp_init_pool(const struct memp_desc *desc)
 #endif
 									  );
 	}
+#if MEMP_GROW_FROM_HEAP
+	*desc->slabs = NULL;
+#endif							/* MEMP_GROW_FROM_HEAP */
 #if MEMP_STATS
 	desc->stats->avail = desc->num;
 #endif							/* MEMP_STATS */
 #endif							/* !MEMP_MEM_MALLOC */
 
+#if MEMP_STATS && MEMP_STATS_OCCUPANCY
+	desc->stats->occ_start = sys_now();
+	desc->stats->occ_stamp = desc->stats->occ_start;
+	desc->stats->occ_sum = 0;
+#endif							/* MEMP_STATS && MEMP_STATS_OCCUPANCY */
+
 #if MEMP_STATS && (defined(LWIP_DEBUG) || LWIP_STATS_DISPLAY)
 	desc->stats->name = desc->desc;
 #endif							/* MEMP_STATS && (defined(LWIP_DEBUG) || LWIP_STATS_DISPLAY) */
@@ -305,6 +585,21 @@ do_memp_malloc_pool_fn(const struct memp_desc *desc, const char *file, const int
 	SYS_ARCH_PROTECT(old_level);
 
 	memp = *desc->tab;
+	if (memp != NULL) {
+		*desc->tab = memp->next;
+	}
+#if MEMP_GROW_FROM_HEAP
+	else {
+		/* static elements exhausted: use a heap slab, adding one if needed */
+		memp = memp_slab_take(desc);
+		if (memp == NULL) {
+			SYS_ARCH_UNPROTECT(old_level);
+			memp_grow(desc);
+			SYS_ARCH_PROTECT(old_level);
+			memp = memp_slab_take(desc);
+		}
+	}
+#endif							/* MEMP_GROW_FROM_HEAP */
 #endif							/* MEMP_MEM_MALLOC */
 
 	if (memp != NULL) {
@@ -314,7 +609,6 @@ do_memp_malloc_pool_fn(const struct memp_desc *desc, const char *file, const int
 		memp_overflow_check_element_underflow(memp, desc);
 #endif							/* MEMP_OVERFLOW_CHECK */
 
-		*desc->tab = memp->next;
 #if MEMP_OVERFLOW_CHECK
 		memp->next = NULL;
 #endif							/* MEMP_OVERFLOW_CHECK */
@@ -328,6 +622,9 @@ do_memp_malloc_pool_fn(const struct memp_desc *desc, const char *file, const int
 #endif							/* MEMP_OVERFLOW_CHECK */
 		LWIP_ASSERT("memp_malloc: memp properly aligned", ((mem_ptr_t) memp % MEM_ALIGNMENT) == 0);
 #if MEMP_STATS
+#if MEMP_STATS_OCCUPANCY
+		memp_occupancy_update(desc);
+#endif
 		desc->stats->used++;
 		if (desc->stats->used > desc->stats->max) {
 			desc->stats->max = desc->stats->used;
@@ -421,6 +718,9 @@ static void do_memp_free_pool(const struct memp_desc *desc, void *mem)
 #endif							/* MEMP_OVERFLOW_CHECK */
 
 #if MEMP_STATS
+#if MEMP_STATS_OCCUPANCY
+	memp_occupancy_update(desc);
+#endif
 	desc->stats->used--;
 #endif
 
@@ -429,6 +729,13 @@ static void do_memp_free_pool(const struct memp_desc *desc, void *mem)
 	SYS_ARCH_UNPROTECT(old_level);
 	mem_free(memp);
 #else							/* MEMP_MEM_MALLOC */
+#if MEMP_GROW_FROM_HEAP
+	if (!memp_is_static(desc, memp)) {
+		memp_slab_put(desc, memp);
+		SYS_ARCH_UNPROTECT(old_level);
+		return;
+	}
+#endif							/* MEMP_GROW_FROM_HEAP */
 	memp->next = *desc->tab;
 	*desc->tab = memp;
 
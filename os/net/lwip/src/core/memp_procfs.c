@@ -0,0 +1,373 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * net/lwip/src/core/memp_procfs.c
+ *
+ * /proc/net/memp: per-pool usage of the lwIP memory pools.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/memp.h>
+#include <net/lwip/stats.h>
+#include <net/lwip/sys.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_NET_MEMP) && LWIP_STATS && MEMP_STATS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MEMP_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* Snapshot of one pool, taken when the file is read from offset 0 so that
+ * the contents stay consistent across partial reads.
+ */
+
+struct memp_snapshot_s {
+	u16_t size;
+	mem_size_t avail;
+	mem_size_t used;
+	mem_size_t max;
+	STAT_COUNTER err;
+#if MEMP_STATS_OCCUPANCY
+	u32_t occupancy;			/* Average used elements x 100 */
+#endif
+#if MEMP_GROW_FROM_HEAP
+	mem_size_t grown;
+	STAT_COUNTER grow;
+	STAT_COUNTER shrink;
+#endif
+};
+
+/* This structure describes one open "file" */
+
+struct memp_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	struct memp_snapshot_s pool[MEMP_MAX];	/* Pool usage at offset 0 */
+	char line[MEMP_LINELEN];	/* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* File system methods */
+
+static int memp_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int memp_close(FAR struct file *filep);
+static ssize_t memp_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int memp_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int memp_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations memp_procfsoperations = {
+	memp_open,					/* open */
+	memp_close,					/* close */
+	memp_read,					/* read */
+	NULL,						/* write */
+
+	memp_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	memp_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memp_snapshot
+ ****************************************************************************/
+
+static void memp_snapshot(FAR struct memp_file_s *attr)
+{
+	FAR const struct memp_desc *desc;
+	FAR struct memp_snapshot_s *snap;
+	int i;
+
+	SYS_ARCH_DECL_PROTECT(old_level);
+
+	for (i = 0; i < MEMP_MAX; i++) {
+		desc = memp_pools[i];
+		snap = &attr->pool[i];
+
+		SYS_ARCH_PROTECT(old_level);
+		snap->size = desc->size;
+		snap->avail = desc->stats->avail;
+		snap->used = desc->stats->used;
+		snap->max = desc->stats->max;
+		snap->err = desc->stats->err;
+#if MEMP_GROW_FROM_HEAP
+		snap->grown = desc->stats->grown;
+		snap->grow = desc->stats->grow;
+		snap->shrink = desc->stats->shrink;
+#endif
+		SYS_ARCH_UNPROTECT(old_level);
+
+#if MEMP_STATS_OCCUPANCY
+		snap->occupancy = memp_occupancy_pool(desc);
+#endif
+	}
+}
+
+/****************************************************************************
+ * Name: memp_open
+ ****************************************************************************/
+
+static int memp_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct memp_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "net/memp" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "net/memp") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct memp_file_s *)kmm_zalloc(sizeof(struct memp_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: memp_close
+ ****************************************************************************/
+
+static int memp_close(FAR struct file *filep)
+{
+	FAR struct memp_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct memp_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: memp_read
+ ****************************************************************************/
+
+static ssize_t memp_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct memp_file_s *attr;
+	FAR struct memp_snapshot_s *snap;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	off_t offset;
+	int i;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct memp_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Sample the pools on the first read only, so that a reader using a
+	 * small buffer still sees one consistent table.
+	 */
+
+	if (filep->f_pos == 0) {
+		memp_snapshot(attr);
+	}
+
+	offset = filep->f_pos;
+
+	linesize = snprintf(attr->line, MEMP_LINELEN, "%-16s %5s %5s %5s %5s %5s"
+#if MEMP_STATS_OCCUPANCY
+						" %8s"
+#endif
+#if MEMP_GROW_FROM_HEAP
+						" %5s %5s %6s"
+#endif
+						"\n", "Pool", "Size", "Avail", "Used", "Max", "Err"
+#if MEMP_STATS_OCCUPANCY
+						, "AvgUsed"
+#endif
+#if MEMP_GROW_FROM_HEAP
+						, "Grown", "Grow", "Shrink"
+#endif
+					   );
+	copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+	totalsize = copysize;
+
+	for (i = 0; i < MEMP_MAX && totalsize < buflen; i++) {
+		snap = &attr->pool[i];
+
+		linesize = snprintf(attr->line, MEMP_LINELEN, "%-16s %5u %5u %5u %5u %5u"
+#if MEMP_STATS_OCCUPANCY
+							" %5u.%02u"
+#endif
+#if MEMP_GROW_FROM_HEAP
+							" %5u %5u %6u"
+#endif
+							"\n", memp_pools[i]->desc, (unsigned int)snap->size, (unsigned int)snap->avail, (unsigned int)snap->used, (unsigned int)snap->max, (unsigned int)snap->err
+#if MEMP_STATS_OCCUPANCY
+							, (unsigned int)(snap->occupancy / 100), (unsigned int)(snap->occupancy % 100)
+#endif
+#if MEMP_GROW_FROM_HEAP
+							, (unsigned int)snap->grown, (unsigned int)snap->grow, (unsigned int)snap->shrink
+#endif
+						   );
+		copysize = procfs_memcpy(attr->line, linesize, &buffer[totalsize], buflen - totalsize, &offset);
+		totalsize += copysize;
+	}
+
+	/* Update the file offset */
+
+	filep->f_pos += totalsize;
+	return totalsize;
+}
+
+/****************************************************************************
+ * Name: memp_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int memp_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct memp_file_s *oldattr;
+	FAR struct memp_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct memp_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the file attributes */
+
+	newattr = (FAR struct memp_file_s *)kmm_malloc(sizeof(struct memp_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct memp_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: memp_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int memp_stat(const char *relpath, struct stat *buf)
+{
+	/* "net/memp" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "net/memp") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "memp" is the name for a read-only file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* !CONFIG_FS_PROCFS_EXCLUDE_NET_MEMP && LWIP_STATS && MEMP_STATS */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -91,7 +91,9 @@ void stats_display_proto(struct stats_proto *proto, const char *name)
 	LWIP_STATS_DIAG(("proterr: %" STAT_COUNTER_F "\n\t", proto->proterr));
 	LWIP_STATS_DIAG(("opterr: %" STAT_COUNTER_F "\n\t", proto->opterr));
 	LWIP_STATS_DIAG(("err: %" STAT_COUNTER_F "\n\t", proto->err));
-	LWIP_STATS_DIAG(("cachehit: %" STAT_COUNTER_F "\n", proto->cachehit));
+	LWIP_STATS_DIAG(("cachehit: %" STAT_COUNTER_F "\n\t", proto->cachehit));
+	LWIP_STATS_DIAG(("txcoalesced: %" STAT_COUNTER_F "\n\t", proto->txcoalesced));
+	LWIP_STATS_DIAG(("rxcoalesced: %" STAT_COUNTER_F "\n", proto->rxcoalesced));
 }
 
 #if IGMP_STATS || MLD6_STATS
@@ -151,6 +153,19 @@ void stats_display_sys(struct stats_sys *sys)
 }
 #endif							/* SYS_STATS */
 
+#if DNS_STATS
+void stats_display_dns(struct stats_dns *dns)
+{
+	LWIP_STATS_DIAG(("\nDNS\n\t"));
+	LWIP_STATS_DIAG(("xmit: %" STAT_COUNTER_F "\n\t", dns->xmit));
+	LWIP_STATS_DIAG(("hit: %" STAT_COUNTER_F "\n\t", dns->hit));
+	LWIP_STATS_DIAG(("neghit: %" STAT_COUNTER_F "\n\t", dns->neghit));
+	LWIP_STATS_DIAG(("miss: %" STAT_COUNTER_F "\n\t", dns->miss));
+	LWIP_STATS_DIAG(("coalesced: %" STAT_COUNTER_F "\n\t", dns->coalesced));
+	LWIP_STATS_DIAG(("prefetch: %" STAT_COUNTER_F "\n", dns->prefetch));
+}
+#endif							/* DNS_STATS */
+
 int stats_display(int argc, char **argv)
 {
 	s16_t i;
@@ -168,6 +183,7 @@ int stats_display(int argc, char **argv)
 	ICMP6_STATS_DISPLAY();
 	UDP_STATS_DISPLAY();
 	TCP_STATS_DISPLAY();
+	DNS_STATS_DISPLAY();
 	MEM_STATS_DISPLAY();
 	for (i = 0; i < MEMP_MAX; i++) {
 		MEMP_STATS_DISPLAY(i);
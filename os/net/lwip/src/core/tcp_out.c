@@ -930,6 +930,11 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		IF__NETIF_CHECKSUM_ENABLED(netif, NETIF_CHECKSUM_GEN_TCP) {
 			tcphdr->chksum = ip_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len, &pcb->local_ip, &pcb->remote_ip);
 		}
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+		else if (NETIF_CHECKSUM_PARTIAL_ENABLED(netif, NETIF_CHECKSUM_PARTIAL_TCP)) {
+			tcphdr->chksum = ip_chksum_pseudo_hdr(IP_PROTO_TCP, p->tot_len, &pcb->local_ip, &pcb->remote_ip);
+		}
+#endif							/* LWIP_CHECKSUM_CTRL_PER_NETIF */
 #endif
 		NETIF_SET_HWADDRHINT(netif, &(pcb->addr_hint));
 		err = ip_output_if(p, &pcb->local_ip, &pcb->remote_ip, pcb->ttl, pcb->tos, IP_PROTO_TCP, netif);
@@ -948,6 +953,100 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 	return err;
 }
 
+#if TCP_COALESCE
+/**
+ * Merge the unsent segments that follow pcb->unsent into it, as long as
+ * the result fits in one MSS and in the send window. The data is copied
+ * into a single PBUF_RAM so the segment also leaves as one pbuf.
+ *
+ * @param pcb the tcp_pcb whose first unsent segment is about to be sent
+ * @param wnd the currently usable send window
+ * @return the (possibly new) first unsent segment
+ */
+static struct tcp_seg *tcp_coalesce_unsent(struct tcp_pcb *pcb, u32_t wnd)
+{
+	struct tcp_seg *seg = pcb->unsent;
+	struct tcp_seg *last;
+	struct tcp_seg *merged;
+	struct tcp_seg *next;
+	struct pbuf *p;
+	u16_t mss_local;
+	u16_t total;
+	u16_t offset;
+	u8_t optflags;
+	u8_t optlen;
+	u8_t flags;
+
+	if (seg->next == NULL || (TCPH_FLAGS(seg->tcphdr) & (TCP_SYN | TCP_FIN)) != 0) {
+		return seg;
+	}
+
+	mss_local = LWIP_MIN(pcb->mss, TCPWND_MIN16(pcb->snd_wnd_max / 2));
+	mss_local = mss_local ? mss_local : pcb->mss;
+	optflags = seg->flags & ~TF_SEG_DATA_CHECKSUMMED;
+	optlen = LWIP_TCP_OPT_LENGTH(optflags);
+	flags = TCPH_FLAGS(seg->tcphdr);
+	total = seg->len;
+
+	/* find the run of segments that can be sent as one */
+	for (last = seg; (next = last->next) != NULL; last = next) {
+		if ((TCPH_FLAGS(next->tcphdr) & (TCP_SYN | TCP_FIN)) != 0 || (next->flags & ~TF_SEG_DATA_CHECKSUMMED) != optflags) {
+			break;
+		}
+		if ((u32_t)total + next->len + optlen > mss_local || lwip_ntohl(seg->tcphdr->seqno) - pcb->lastack + total + next->len > wnd) {
+			break;
+		}
+		total += next->len;
+		flags |= TCPH_FLAGS(next->tcphdr);
+	}
+	if (last == seg) {
+		return seg;
+	}
+
+	if ((p = pbuf_alloc(PBUF_TRANSPORT, optlen + total, PBUF_RAM)) == NULL) {
+		/* not fatal: just send the segments as they are */
+		return seg;
+	}
+	offset = optlen;
+	for (next = seg; ; next = next->next) {
+		pbuf_copy_partial(next->p, (u8_t *)p->payload + offset, next->len, TCPH_HDRLEN(next->tcphdr) * 4);
+		offset += next->len;
+		if (next == last) {
+			break;
+		}
+	}
+
+	merged = tcp_create_segment(pcb, p, flags & ~TCP_ACK, lwip_ntohl(seg->tcphdr->seqno), optflags);
+	if (merged == NULL) {
+		return seg;
+	}
+#if TCP_CHECKSUM_ON_COPY
+	merged->chksum = (u16_t)~inet_chksum((u8_t *)merged->tcphdr + TCP_HLEN + optlen, total);
+	merged->flags |= TF_SEG_DATA_CHECKSUMMED;
+#endif							/* TCP_CHECKSUM_ON_COPY */
+
+	/* replace the run by the merged segment */
+	merged->next = last->next;
+	pcb->unsent = merged;
+	last->next = NULL;
+	while (seg != NULL) {
+		next = seg->next;
+		pcb->snd_queuelen -= pbuf_clen(seg->p);
+		tcp_seg_free(seg);
+		seg = next;
+	}
+	TCP_STATS_INC(tcp.txcoalesced);
+	pcb->snd_queuelen += pbuf_clen(merged->p);
+#if TCP_OVERSIZE
+	if (merged->next == NULL) {
+		/* the merged pbuf has no room to extend in place */
+		pcb->unsent_oversize = 0;
+	}
+#endif							/* TCP_OVERSIZE */
+	return merged;
+}
+#endif							/* TCP_COALESCE */
+
 /**
  * Find out what we can send and send it
  *
@@ -1051,6 +1150,9 @@ err_t tcp_output(struct tcp_pcb *pcb)
 		if ((tcp_do_output_nagle(pcb) == 0) && ((pcb->flags & (TF_NAGLEMEMERR | TF_FIN)) == 0)) {
 			break;
 		}
+#if TCP_COALESCE
+		seg = tcp_coalesce_unsent(pcb, wnd);
+#endif							/* TCP_COALESCE */
 #if TCP_CWND_DEBUG
 		LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %" TCPWNDSIZE_F ", cwnd %" TCPWNDSIZE_F ", wnd %" U32_F ", effwnd %" U32_F ", seq %" U32_F ", ack %" U32_F ", i %" S16_F "\n", pcb->snd_wnd, pcb->cwnd, wnd, lwip_ntohl(seg->tcphdr->seqno) + seg->len - pcb->lastack, lwip_ntohl(seg->tcphdr->seqno), pcb->lastack, i));
 		++i;
@@ -1247,6 +1349,12 @@ static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct
 		seg->tcphdr->chksum = ip_chksum_pseudo(seg->p, IP_PROTO_TCP, seg->p->tot_len, &pcb->local_ip, &pcb->remote_ip);
 #endif							/* TCP_CHECKSUM_ON_COPY */
 	}
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+	else if (NETIF_CHECKSUM_PARTIAL_ENABLED(netif, NETIF_CHECKSUM_PARTIAL_TCP)) {
+		/* hardware sums header and payload; seed it with the pseudo header */
+		seg->tcphdr->chksum = ip_chksum_pseudo_hdr(IP_PROTO_TCP, seg->p->tot_len, &pcb->local_ip, &pcb->remote_ip);
+	}
+#endif							/* LWIP_CHECKSUM_CTRL_PER_NETIF */
 #endif							/* CHECKSUM_GEN_TCP */
 	TCP_STATS_INC(tcp.xmit);
 
@@ -1311,6 +1419,11 @@ void tcp_rst(u32_t seqno, u32_t ackno, ip_addr_t *local_ip, const ip_addr_t *rem
 		IF__NETIF_CHECKSUM_ENABLED(netif, NETIF_CHECKSUM_GEN_TCP) {
 			tcphdr->chksum = ip_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len, local_ip, remote_ip);
 		}
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+		else if (NETIF_CHECKSUM_PARTIAL_ENABLED(netif, NETIF_CHECKSUM_PARTIAL_TCP)) {
+			tcphdr->chksum = ip_chksum_pseudo_hdr(IP_PROTO_TCP, p->tot_len, local_ip, remote_ip);
+		}
+#endif							/* LWIP_CHECKSUM_CTRL_PER_NETIF */
 #endif
 		/* Send output with hardcoded TTL/HL since we have no access to the pcb */
 		ip_output_if(p, local_ip, remote_ip, TCP_TTL, 0, IP_PROTO_TCP, netif);
@@ -1473,6 +1586,13 @@ err_t tcp_keepalive(struct tcp_pcb *pcb)
 
 			tcphdr->chksum = ip_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len, &pcb->local_ip, &pcb->remote_ip);
 		}
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+		else if (NETIF_CHECKSUM_PARTIAL_ENABLED(netif, NETIF_CHECKSUM_PARTIAL_TCP)) {
+			struct tcp_hdr *tcphdr = (struct tcp_hdr *)p->payload;
+
+			tcphdr->chksum = ip_chksum_pseudo_hdr(IP_PROTO_TCP, p->tot_len, &pcb->local_ip, &pcb->remote_ip);
+		}
+#endif							/* LWIP_CHECKSUM_CTRL_PER_NETIF */
 #endif							/* CHECKSUM_GEN_TCP */
 		TCP_STATS_INC(tcp.xmit);
 
@@ -1559,6 +1679,11 @@ err_t tcp_zero_window_probe(struct tcp_pcb *pcb)
 		IF__NETIF_CHECKSUM_ENABLED(netif, NETIF_CHECKSUM_GEN_TCP) {
 			tcphdr->chksum = ip_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len, &pcb->local_ip, &pcb->remote_ip);
 		}
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+		else if (NETIF_CHECKSUM_PARTIAL_ENABLED(netif, NETIF_CHECKSUM_PARTIAL_TCP)) {
+			tcphdr->chksum = ip_chksum_pseudo_hdr(IP_PROTO_TCP, p->tot_len, &pcb->local_ip, &pcb->remote_ip);
+		}
+#endif							/* LWIP_CHECKSUM_CTRL_PER_NETIF */
 #endif
 		TCP_STATS_INC(tcp.xmit);
 
@@ -127,6 +127,9 @@ const struct lwip_cyclic_timer lwip_cyclic_timers[] = {
 	{MLD6_TMR_INTERVAL, HANDLER(mld6_tmr)},
 #endif							/* LWIP_IPV6_MLD */
 #endif							/* LWIP_IPV6 */
+#if MEMP_GROW_FROM_HEAP && !MEMP_MEM_MALLOC
+	{MEMP_GROW_IDLE_MS, HANDLER(memp_tmr)},
+#endif							/* MEMP_GROW_FROM_HEAP && !MEMP_MEM_MALLOC */
 };
 
 #if LWIP_TIMERS && !LWIP_TIMERS_CUSTOM
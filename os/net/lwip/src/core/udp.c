@@ -806,6 +806,13 @@ err_t udp_sendto_if_src_chksum(struct udp_pcb *pcb, struct pbuf *p, const ip_add
 				udphdr->chksum = udpchksum;
 			}
 		}
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+		else if (NETIF_CHECKSUM_PARTIAL_ENABLED(netif, NETIF_CHECKSUM_PARTIAL_UDP)) {
+			if (IP_IS_V6(dst_ip) || (pcb->flags & UDP_FLAGS_NOCHKSUM) == 0) {
+				udphdr->chksum = ip_chksum_pseudo_hdr(IP_PROTO_UDP, q->tot_len, src_ip, dst_ip);
+			}
+		}
+#endif							/* LWIP_CHECKSUM_CTRL_PER_NETIF */
 #endif							/* CHECKSUM_GEN_UDP */
 		ip_proto = IP_PROTO_UDP;
 	}
@@ -0,0 +1,146 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_netconn.h"
+
+#include <net/lwip/api.h>
+#include <net/lwip/pbuf.h>
+#include <net/lwip/stats.h>
+#include <net/lwip/tcp.h>
+#include <net/lwip/tcpip.h>
+
+#include <string.h>
+
+/* The API layer needs a sys_arch: these tests are empty in NO_SYS builds */
+#if LWIP_NETCONN && LWIP_TCP && LWIP_NETCONN_RX_COALESCE
+
+static struct netconn *conn;
+
+/* Hand p to the netconn the way tcp_input() does */
+static err_t netconn_test_input(struct pbuf *p)
+{
+	struct tcp_pcb *pcb = conn->pcb.tcp;
+	err_t err;
+
+	LOCK_TCPIP_CORE();
+	err = pcb->recv(pcb->callback_arg, pcb, p, ERR_OK);
+	UNLOCK_TCPIP_CORE();
+	return err;
+}
+
+static struct pbuf *netconn_test_pbuf(u16_t len, u8_t fill)
+{
+	struct pbuf *p = pbuf_alloc(PBUF_RAW, len, PBUF_RAM);
+
+	fail_unless(p != NULL);
+	memset(p->payload, fill, len);
+	return p;
+}
+
+/* Setups/teardown functions */
+
+static void netconn_setup(void)
+{
+	conn = netconn_new(NETCONN_TCP);
+	fail_unless(conn != NULL);
+}
+
+static void netconn_teardown(void)
+{
+	netconn_delete(conn);
+	conn = NULL;
+}
+
+/* Test functions */
+
+/** Segments received before the application reads are handed out as one */
+START_TEST(test_netconn_rx_coalesce)
+{
+	STAT_COUNTER rxcoalesced = lwip_stats.tcp.rxcoalesced;
+	struct pbuf *p;
+	u8_t buf[300];
+	u16_t i;
+	LWIP_UNUSED_ARG(_i);
+
+	for (i = 0; i < 3; i++) {
+		fail_unless(netconn_test_input(netconn_test_pbuf(100, (u8_t)('a' + i))) == ERR_OK);
+	}
+	fail_unless(lwip_stats.tcp.rxcoalesced == rxcoalesced + 2);
+#if LWIP_SO_RCVBUF
+	fail_unless(conn->recv_avail == 300);
+#endif
+
+	fail_unless(netconn_recv_tcp_pbuf(conn, &p) == ERR_OK);
+	fail_unless(p->tot_len == 300);
+	fail_unless(pbuf_copy_partial(p, buf, sizeof(buf), 0) == sizeof(buf));
+	for (i = 0; i < sizeof(buf); i++) {
+		fail_unless(buf[i] == 'a' + i / 100);
+	}
+	pbuf_free(p);
+#if LWIP_SO_RCVBUF
+	fail_unless(conn->recv_avail == 0);
+#endif
+
+	/* the fetched entry is not extended any more */
+	fail_unless(netconn_test_input(netconn_test_pbuf(10, 'd')) == ERR_OK);
+	fail_unless(lwip_stats.tcp.rxcoalesced == rxcoalesced + 2);
+	fail_unless(netconn_recv_tcp_pbuf(conn, &p) == ERR_OK);
+	fail_unless(p->tot_len == 10);
+	pbuf_free(p);
+}
+
+END_TEST
+/** An entry does not grow beyond LWIP_NETCONN_RX_COALESCE_MAX */
+START_TEST(test_netconn_rx_coalesce_max)
+{
+	STAT_COUNTER rxcoalesced = lwip_stats.tcp.rxcoalesced;
+	struct pbuf *p;
+	LWIP_UNUSED_ARG(_i);
+
+	fail_unless(netconn_test_input(netconn_test_pbuf(LWIP_NETCONN_RX_COALESCE_MAX - 10, 'a')) == ERR_OK);
+	fail_unless(netconn_test_input(netconn_test_pbuf(10, 'b')) == ERR_OK);
+	fail_unless(netconn_test_input(netconn_test_pbuf(1, 'c')) == ERR_OK);
+	fail_unless(lwip_stats.tcp.rxcoalesced == rxcoalesced + 1);
+
+	fail_unless(netconn_recv_tcp_pbuf(conn, &p) == ERR_OK);
+	fail_unless(p->tot_len == LWIP_NETCONN_RX_COALESCE_MAX);
+	pbuf_free(p);
+	fail_unless(netconn_recv_tcp_pbuf(conn, &p) == ERR_OK);
+	fail_unless(p->tot_len == 1);
+	pbuf_free(p);
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *netconn_suite(void)
+{
+	TFun tests[] = {
+		test_netconn_rx_coalesce,
+		test_netconn_rx_coalesce_max
+	};
+	return create_suite("NETCONN", tests, sizeof(tests) / sizeof(TFun), netconn_setup, netconn_teardown);
+}
+
+#else							/* LWIP_NETCONN && LWIP_TCP && LWIP_NETCONN_RX_COALESCE */
+
+Suite *netconn_suite(void)
+{
+	return create_suite("NETCONN", NULL, 0, NULL, NULL);
+}
+
+#endif							/* LWIP_NETCONN && LWIP_TCP && LWIP_NETCONN_RX_COALESCE */
@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_chksum.h"
+
+#include <net/lwip/inet_chksum.h>
+#include <net/lwip/pbuf.h>
+
+#include <string.h>
+
+#ifndef LWIP_CHKSUM_ALGORITHM
+/* default picked by inet_chksum.c */
+#define LWIP_CHKSUM_ALGORITHM 2
+#endif
+
+#define CHKSUM_BUF_SIZE    1600
+#define CHKSUM_MAX_OFFSET  8
+#define CHKSUM_CHAIN_LEN   1460
+
+static u8_t chksum_src[CHKSUM_BUF_SIZE + CHKSUM_MAX_OFFSET];
+static u8_t chksum_dst[CHKSUM_BUF_SIZE + CHKSUM_MAX_OFFSET];
+
+/* Byte-wise RFC 1071 sum used as the reference */
+static u16_t chksum_reference(const u8_t *data, int len)
+{
+	u32_t acc = 0;
+	int i;
+
+	for (i = 0; i + 1 < len; i += 2) {
+		acc += ((u32_t)data[i] << 8) | data[i + 1];
+	}
+	if (len & 1) {
+		acc += (u32_t)data[len - 1] << 8;
+	}
+	while (acc >> 16) {
+		acc = (acc >> 16) + (acc & 0xffffUL);
+	}
+	return (u16_t) ~lwip_htons((u16_t)acc);
+}
+
+/* Setups/teardown functions */
+
+static void chksum_setup(void)
+{
+	int i;
+
+	srand(0x1071);
+	for (i = 0; i < (int)sizeof(chksum_src); i++) {
+		chksum_src[i] = (u8_t)rand();
+	}
+}
+
+static void chksum_teardown(void)
+{
+}
+
+/* Test functions */
+
+/** inet_chksum must match the reference for every length and alignment */
+START_TEST(test_chksum_alignment)
+{
+	int off;
+	int len;
+	LWIP_UNUSED_ARG(_i);
+
+	for (off = 0; off < CHKSUM_MAX_OFFSET; off++) {
+		for (len = 0; len < CHKSUM_BUF_SIZE; len++) {
+			fail_unless(inet_chksum(chksum_src + off, (u16_t)len) == chksum_reference(chksum_src + off, len));
+		}
+	}
+}
+
+END_TEST
+/** inet_chksum_pbuf must give the same result as one flat buffer */
+START_TEST(test_chksum_pbuf_chain)
+{
+	struct pbuf *p;
+	struct pbuf *q;
+	u16_t split;
+	LWIP_UNUSED_ARG(_i);
+
+	for (split = 1; split < 64; split++) {
+		p = pbuf_alloc(PBUF_RAW, split, PBUF_RAM);
+		q = pbuf_alloc(PBUF_RAW, (u16_t)(CHKSUM_CHAIN_LEN - split), PBUF_RAM);
+		fail_unless(p != NULL && q != NULL);
+		memcpy(p->payload, chksum_src, split);
+		memcpy(q->payload, chksum_src + split, CHKSUM_CHAIN_LEN - split);
+		pbuf_cat(p, q);
+		fail_unless(inet_chksum_pbuf(p) == chksum_reference(chksum_src, CHKSUM_CHAIN_LEN));
+		pbuf_free(p);
+	}
+}
+
+END_TEST
+/** Copy-and-checksum must copy exactly and return the plain sum, both on
+ * the single-pass path (same alignment) and on the copy-then-sum fallback
+ */
+START_TEST(test_chksum_copy)
+{
+#if LWIP_CHKSUM_COPY_ALGORITHM
+	int soff;
+	int doff;
+	int len;
+	u16_t sum;
+	LWIP_UNUSED_ARG(_i);
+
+	for (soff = 0; soff < 4; soff++) {
+		for (doff = 0; doff < 4; doff++) {
+			for (len = 0; len < CHKSUM_BUF_SIZE; len += (len < 300) ? 1 : 97) {
+				memset(chksum_dst, 0, sizeof(chksum_dst));
+				sum = lwip_chksum_copy(chksum_dst + doff, chksum_src + soff, (u16_t)len);
+				fail_unless(memcmp(chksum_dst + doff, chksum_src + soff, len) == 0);
+				fail_unless(chksum_dst[doff + len] == 0);
+				fail_unless((u16_t)~sum == chksum_reference(chksum_src + soff, len));
+			}
+		}
+	}
+#else
+	LWIP_UNUSED_ARG(_i);
+#endif
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *chksum_suite(void)
+{
+	TFun tests[] = {
+		test_chksum_alignment,
+		test_chksum_pbuf_chain,
+		test_chksum_copy
+	};
+	return create_suite("CHKSUM", tests, sizeof(tests) / sizeof(TFun), chksum_setup, chksum_teardown);
+}
@@ -0,0 +1,268 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_dns.h"
+
+#include <net/lwip/dns.h>
+#include <net/lwip/udp.h>
+#include <net/lwip/netif.h>
+#include <net/lwip/stats.h>
+#include <net/lwip/prot/dns.h>
+
+#include <string.h>
+
+#if !LWIP_DNS || !LWIP_HAVE_LOOPIF || !LWIP_STATS || !DNS_STATS
+#error "This tests needs DNS, the loop interface and DNS-statistics enabled"
+#endif
+#if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_NO_MULTIPLE_OUTSTANDING) == 0) || !DNS_NEG_MAX_TTL || !DNS_PREFETCH_TTL
+#error "This tests needs query coalescing, negative caching and prefetching enabled"
+#endif
+
+/* Stand-in DNS server on 127.0.0.1: remembers the last query and counts them */
+static struct udp_pcb *server_pcb;
+static u8_t query[128];
+static u16_t query_len;
+static ip_addr_t client_addr;
+static u16_t client_port;
+static int queries;
+
+/* Results seen by the found callback */
+static int found_calls;
+static int found_null;
+static ip_addr_t found_addr;
+
+/* Helper functions */
+static void server_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(pcb);
+
+	query_len = pbuf_copy_partial(p, query, sizeof(query), 0);
+	ip_addr_copy(client_addr, *addr);
+	client_port = port;
+	queries++;
+	pbuf_free(p);
+}
+
+static void found(const char *name, const ip_addr_t *ipaddr, void *arg)
+{
+	LWIP_UNUSED_ARG(name);
+	LWIP_UNUSED_ARG(arg);
+
+	found_calls++;
+	if (ipaddr == NULL) {
+		found_null++;
+	} else {
+		ip_addr_copy(found_addr, *ipaddr);
+	}
+}
+
+static void put16(u8_t *buf, u16_t *len, u16_t val)
+{
+	buf[(*len)++] = (u8_t)(val >> 8);
+	buf[(*len)++] = (u8_t)val;
+}
+
+static void put32(u8_t *buf, u16_t *len, u32_t val)
+{
+	put16(buf, len, (u16_t)(val >> 16));
+	put16(buf, len, (u16_t)val);
+}
+
+/* Answer the last query with an A record for addr (host order), or with
+ * NXDOMAIN and an SOA record if addr is 0 */
+static void server_reply(u32_t addr, u32_t ttl, u32_t soa_minimum)
+{
+	u8_t buf[sizeof(query) + 48];
+	u16_t len = query_len;
+	struct pbuf *p;
+
+	fail_unless(query_len > SIZEOF_DNS_HDR);
+	memcpy(buf, query, query_len);
+	buf[2] |= DNS_FLAG1_RESPONSE;
+	if (addr != 0) {
+		/* one answer: A record for the name of the question */
+		buf[7] = 1;
+		put16(buf, &len, 0xC000 | SIZEOF_DNS_HDR);
+		put16(buf, &len, DNS_RRTYPE_A);
+		put16(buf, &len, DNS_RRCLASS_IN);
+		put32(buf, &len, ttl);
+		put16(buf, &len, 4);
+		put32(buf, &len, addr);
+	} else {
+		/* name error: SOA of the root zone in the authority section */
+		buf[3] |= DNS_FLAG2_ERR_NAME;
+		buf[9] = 1;
+		buf[len++] = 0;
+		put16(buf, &len, DNS_RRTYPE_SOA);
+		put16(buf, &len, DNS_RRCLASS_IN);
+		put32(buf, &len, ttl);
+		put16(buf, &len, 2 + 2 + 5 * 4);
+		put16(buf, &len, 0xC000 | SIZEOF_DNS_HDR);
+		put16(buf, &len, 0xC000 | SIZEOF_DNS_HDR);
+		put32(buf, &len, 1);
+		put32(buf, &len, 1800);
+		put32(buf, &len, 900);
+		put32(buf, &len, 604800);
+		put32(buf, &len, soa_minimum);
+	}
+
+	p = pbuf_alloc(PBUF_TRANSPORT, len, PBUF_RAM);
+	fail_unless(p != NULL);
+	pbuf_take(p, buf, len);
+	fail_unless(udp_sendto(server_pcb, p, &client_addr, client_port) == ERR_OK);
+	pbuf_free(p);
+	/* deliver it to the resolver */
+	netif_poll_all();
+}
+
+/* Let DNS timer run for the given number of seconds */
+static void dns_run(int seconds)
+{
+	while (seconds-- > 0) {
+		dns_tmr();
+		netif_poll_all();
+	}
+}
+
+/* Setups/teardown functions */
+
+static void dns_setup(void)
+{
+	ip_addr_t server;
+
+	IP_ADDR4(&server, 127, 0, 0, 1);
+	server_pcb = udp_new();
+	fail_unless(server_pcb != NULL);
+	fail_unless(udp_bind(server_pcb, &server, DNS_SERVER_PORT) == ERR_OK);
+	udp_recv(server_pcb, server_recv, NULL);
+	dns_setserver(0, &server);
+
+	queries = 0;
+	query_len = 0;
+	found_calls = 0;
+	found_null = 0;
+	memset(&lwip_stats.dns, 0, sizeof(lwip_stats.dns));
+}
+
+static void dns_teardown(void)
+{
+	udp_remove(server_pcb);
+	server_pcb = NULL;
+}
+
+/* Test functions */
+
+/** Simultaneous lookups of one name share a query, later ones hit the cache */
+START_TEST(test_dns_coalesce_and_cache)
+{
+	ip_addr_t addr;
+	LWIP_UNUSED_ARG(_i);
+
+	fail_unless(dns_gethostbyname("one.example", &addr, found, NULL) == ERR_INPROGRESS);
+	fail_unless(dns_gethostbyname("ONE.example", &addr, found, NULL) == ERR_INPROGRESS);
+	netif_poll_all();
+	fail_unless(queries == 1);
+	fail_unless(lwip_stats.dns.coalesced == 1);
+
+	server_reply(0x0a000001UL, 60, 0);
+	fail_unless(found_calls == 2);
+	fail_unless(found_null == 0);
+	fail_unless(ip4_addr_get_u32(ip_2_ip4(&found_addr)) == PP_HTONL(0x0a000001UL));
+
+	/* answered synchronously, without a round trip to the server */
+	fail_unless(dns_gethostbyname("one.example", &addr, found, NULL) == ERR_OK);
+	fail_unless(ip4_addr_get_u32(ip_2_ip4(&addr)) == PP_HTONL(0x0a000001UL));
+	netif_poll_all();
+	fail_unless(queries == 1);
+	fail_unless(lwip_stats.dns.hit == 1);
+	fail_unless(lwip_stats.dns.xmit == 1);
+}
+END_TEST
+
+/** NXDOMAIN is cached for the SOA minimum and then asked for again */
+START_TEST(test_dns_negative)
+{
+	ip_addr_t addr;
+	LWIP_UNUSED_ARG(_i);
+
+	fail_unless(dns_gethostbyname("none.example", &addr, found, NULL) == ERR_INPROGRESS);
+	netif_poll_all();
+	fail_unless(queries == 1);
+
+	server_reply(0, 3600, 10);
+	fail_unless(found_calls == 1);
+	fail_unless(found_null == 1);
+
+	fail_unless(dns_gethostbyname("none.example", &addr, found, NULL) == ERR_VAL);
+	netif_poll_all();
+	fail_unless(queries == 1);
+	fail_unless(lwip_stats.dns.neghit == 1);
+
+	/* min(TTL, MINIMUM) = 10 seconds */
+	dns_run(9);
+	fail_unless(dns_gethostbyname("none.example", &addr, found, NULL) == ERR_VAL);
+	dns_run(1);
+	fail_unless(dns_gethostbyname("none.example", &addr, found, NULL) == ERR_INPROGRESS);
+	netif_poll_all();
+	fail_unless(queries == 2);
+}
+END_TEST
+
+/** A busy name is asked for again before it expires, and keeps resolving meanwhile */
+START_TEST(test_dns_prefetch)
+{
+	ip_addr_t addr;
+	LWIP_UNUSED_ARG(_i);
+
+	fail_unless(dns_gethostbyname("busy.example", &addr, found, NULL) == ERR_INPROGRESS);
+	netif_poll_all();
+	server_reply(0x0a000002UL, DNS_PREFETCH_TTL + 3, 0);
+	fail_unless(found_calls == 1);
+
+	fail_unless(dns_gethostbyname("busy.example", &addr, found, NULL) == ERR_OK);
+	fail_unless(dns_gethostbyname("busy.example", &addr, found, NULL) == ERR_OK);
+
+	dns_run(2);
+	fail_unless(queries == 1);
+	dns_run(1);
+	fail_unless(queries == 2);
+	fail_unless(lwip_stats.dns.prefetch == 1);
+
+	/* still served from the cache while the refresh is outstanding */
+	fail_unless(dns_gethostbyname("busy.example", &addr, found, NULL) == ERR_OK);
+	fail_unless(ip4_addr_get_u32(ip_2_ip4(&addr)) == PP_HTONL(0x0a000002UL));
+
+	server_reply(0x0a000003UL, 60, 0);
+	fail_unless(found_calls == 1);
+	fail_unless(dns_gethostbyname("busy.example", &addr, found, NULL) == ERR_OK);
+	fail_unless(ip4_addr_get_u32(ip_2_ip4(&addr)) == PP_HTONL(0x0a000003UL));
+	fail_unless(queries == 2);
+}
+END_TEST
+
+/** Create the suite including all tests for this module */
+Suite *dns_suite(void)
+{
+	TFun tests[] = {
+		test_dns_coalesce_and_cache,
+		test_dns_negative,
+		test_dns_prefetch,
+	};
+	return create_suite("DNS", tests, sizeof(tests) / sizeof(TFun), dns_setup, dns_teardown);
+}
@@ -0,0 +1,269 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_ip4.h"
+
+#include <net/lwip/ip4.h>
+#include <net/lwip/ip4_frag.h>
+#include <net/lwip/udp.h>
+#include <net/lwip/netif.h>
+#include <net/lwip/stats.h>
+
+#include <string.h>
+
+#if !LWIP_STATS || !MEM_STATS || !MEMP_STATS || !IPFRAG_STATS
+#error "This tests needs MEM-, MEMP- and IPFRAG-statistics enabled"
+#endif
+#if !IP_FRAG || !IP_REASSEMBLY || LWIP_NETIF_TX_SINGLE_PBUF
+#error "This tests needs IP_FRAG and IP_REASSEMBLY with pbuf references"
+#endif
+
+#define TEST_MTU      1500
+#define TEST_DGRAM    8192
+#define TEST_PORT     7000
+/* fragments of one 8 KB datagram: (8 + 8192) / 1480 rounded up */
+#define TEST_NFRAGS   6
+#define TEST_MAXFRAGS (2 * TEST_NFRAGS)
+
+static struct netif test_netif;
+static ip4_addr_t test_ipaddr, test_netmask;
+static ip_addr_t test_peer;
+static struct udp_pcb *test_pcb;
+
+/* Payload sent, and the frames the netif "transmitted" */
+static u8_t payload[TEST_DGRAM];
+static u8_t frames[TEST_MAXFRAGS][TEST_MTU];
+static u16_t frame_len[TEST_MAXFRAGS];
+static int nframes;
+static int ref_frames;
+
+/* Datagrams seen by the receive callback */
+static int recv_count;
+static int recv_ok;
+
+/* Helper functions */
+static err_t test_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+	LWIP_UNUSED_ARG(ipaddr);
+
+	fail_unless(netif == &test_netif);
+	fail_unless(p->tot_len <= TEST_MTU);
+	fail_unless(nframes < TEST_MAXFRAGS);
+	/* a fresh IP header followed by slices of the original datagram */
+	if ((p->next != NULL) && (p->next->type == PBUF_REF) && (lwip_stats.memp[MEMP_FRAG_PBUF]->used > 0)) {
+		ref_frames++;
+	}
+	frame_len[nframes] = pbuf_copy_partial(p, frames[nframes], TEST_MTU, 0);
+	nframes++;
+	return ERR_OK;
+}
+
+static err_t test_netif_init(struct netif *netif)
+{
+	fail_unless(netif != NULL);
+	netif->output = test_output;
+	netif->mtu = TEST_MTU;
+	netif->flags = NETIF_FLAG_LINK_UP;
+	return ERR_OK;
+}
+
+static void test_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+	struct pbuf *q;
+	int in_frames = 1;
+
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(addr);
+	LWIP_UNUSED_ARG(port);
+
+	recv_count++;
+	/* the datagram is the chain of received fragments, nothing was copied */
+	for (q = p; q != NULL; q = q->next) {
+		if (((u8_t *)q->payload < &frames[0][0]) || ((u8_t *)q->payload >= &frames[0][0] + sizeof(frames))) {
+			in_frames = 0;
+		}
+	}
+	if ((p->tot_len == TEST_DGRAM) && (pbuf_clen(p) == TEST_NFRAGS) && in_frames && (pbuf_memcmp(p, 0, payload, TEST_DGRAM) == 0)) {
+		recv_ok++;
+	}
+	pbuf_free(p);
+}
+
+/* Send one 8 KB datagram to the peer; the payload is referenced, not copied */
+static void send_datagram(void)
+{
+	struct pbuf *p;
+
+	p = pbuf_alloc(PBUF_TRANSPORT, TEST_DGRAM, PBUF_REF);
+	fail_unless(p != NULL);
+	p->payload = payload;
+	fail_unless(udp_sendto(test_pcb, p, &test_peer, TEST_PORT) == ERR_OK);
+	pbuf_free(p);
+}
+
+/* Hand a transmitted frame to the stack as if the peer had received it */
+static void input_frame(int i)
+{
+	struct pbuf *p;
+
+	p = pbuf_alloc(PBUF_RAW, frame_len[i], PBUF_REF);
+	fail_unless(p != NULL);
+	p->payload = frames[i];
+	ip4_input(p, &test_netif);
+}
+
+/* Become the peer the frames were sent to */
+static void become_peer(void)
+{
+	netif_set_ipaddr(&test_netif, ip_2_ip4(&test_peer));
+}
+
+static void check_nothing_held(void)
+{
+	fail_unless(lwip_stats.memp[MEMP_REASSDATA]->used == 0);
+	fail_unless(lwip_stats.memp[MEMP_FRAG_PBUF]->used == 0);
+	fail_unless(lwip_stats.memp[MEMP_PBUF]->used == 0);
+}
+
+/* Setups/teardown functions */
+
+static void ip4_setup(void)
+{
+	int i;
+
+	IP4_ADDR(&test_ipaddr, 10, 0, 0, 1);
+	IP_ADDR4(&test_peer, 10, 0, 0, 2);
+	IP4_ADDR(&test_netmask, 255, 255, 255, 0);
+	fail_unless(netif_add(&test_netif, &test_ipaddr, &test_netmask, IP4_ADDR_ANY4, NULL, test_netif_init, NULL) != NULL);
+	netif_set_up(&test_netif);
+
+	test_pcb = udp_new();
+	fail_unless(test_pcb != NULL);
+	fail_unless(udp_bind(test_pcb, IP_ADDR_ANY, TEST_PORT) == ERR_OK);
+	udp_recv(test_pcb, test_recv, NULL);
+
+	for (i = 0; i < TEST_DGRAM; i++) {
+		payload[i] = (u8_t)(i * 7);
+	}
+	nframes = 0;
+	ref_frames = 0;
+	recv_count = 0;
+	recv_ok = 0;
+}
+
+static void ip4_teardown(void)
+{
+	udp_remove(test_pcb);
+	test_pcb = NULL;
+	netif_remove(&test_netif);
+}
+
+/* Test functions */
+
+/** An 8 KB datagram leaves as PBUF_REF slices of the caller's payload */
+START_TEST(test_ip4_frag_zero_copy)
+{
+	mem_size_t mem_used = lwip_stats.mem.used;
+	LWIP_UNUSED_ARG(_i);
+
+	lwip_stats.mem.max = mem_used;
+	send_datagram();
+	fail_unless(nframes == TEST_NFRAGS);
+	fail_unless(ref_frames == TEST_NFRAGS);
+	check_nothing_held();
+	fail_unless(lwip_stats.mem.used == mem_used);
+	/* only headers were allocated from the heap, never the payload */
+	fail_unless(lwip_stats.mem.max - mem_used < TEST_MTU);
+}
+END_TEST
+
+/** Fragments arriving in order are chained without copying */
+START_TEST(test_ip4_reass_in_order)
+{
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	send_datagram();
+	become_peer();
+	for (i = 0; i < TEST_NFRAGS; i++) {
+		fail_unless(recv_count == 0);
+		input_frame(i);
+	}
+	fail_unless(recv_count == 1);
+	fail_unless(recv_ok == 1);
+	check_nothing_held();
+}
+END_TEST
+
+/** Two datagrams arriving reversed and interleaved, with a duplicate */
+START_TEST(test_ip4_reass_interleaved)
+{
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	send_datagram();
+	send_datagram();
+	fail_unless(nframes == 2 * TEST_NFRAGS);
+	become_peer();
+	for (i = TEST_NFRAGS - 1; i >= 0; i--) {
+		input_frame(TEST_NFRAGS + i);
+		input_frame(i);
+		if (i == 3) {
+			input_frame(i);
+		}
+	}
+	fail_unless(recv_count == 2);
+	fail_unless(recv_ok == 2);
+	check_nothing_held();
+}
+END_TEST
+
+/** A datagram with a hole times out and releases its fragments */
+START_TEST(test_ip4_reass_timeout)
+{
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	send_datagram();
+	become_peer();
+	/* without the first fragment, so no ICMP time exceeded is sent */
+	for (i = 1; i < TEST_NFRAGS; i++) {
+		input_frame(i);
+	}
+	fail_unless(lwip_stats.memp[MEMP_REASSDATA]->used == 1);
+	for (i = 0; i <= IP_REASS_MAXAGE; i++) {
+		ip_reass_tmr();
+	}
+	fail_unless(recv_count == 0);
+	fail_unless(nframes == TEST_NFRAGS);
+	check_nothing_held();
+}
+END_TEST
+
+/** Create the suite including all tests for this module */
+Suite *ip4_suite(void)
+{
+	TFun tests[] = {
+		test_ip4_frag_zero_copy,
+		test_ip4_reass_in_order,
+		test_ip4_reass_interleaved,
+		test_ip4_reass_timeout,
+	};
+	return create_suite("IP4", tests, sizeof(tests) / sizeof(TFun), ip4_setup, ip4_teardown);
+}
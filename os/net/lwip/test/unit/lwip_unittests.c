@@ -22,7 +22,11 @@
 #include "tcp/test_tcp.h"
 #include "tcp/test_tcp_oos.h"
 #include "core/test_mem.h"
+#include "core/test_chksum.h"
 #include "etharp/test_etharp.h"
+#include "dns/test_dns.h"
+#include "ip4/test_ip4.h"
+#include "api/test_netconn.h"
 
 #include <net/lwip/init.h>
 
@@ -36,7 +40,11 @@ int main()
 		tcp_suite,
 		tcp_oos_suite,
 		mem_suite,
-		etharp_suite
+		chksum_suite,
+		etharp_suite,
+		dns_suite,
+		ip4_suite,
+		netconn_suite
 	};
 	size_t num = sizeof(suites) / sizeof(void *);
 	LWIP_ASSERT("No suites defined", num > 0);
@@ -65,4 +65,28 @@
 /* Minimal changes to opt.h required for etharp unit tests: */
 #define ETHARP_SUPPORT_STATIC_ENTRIES   1
 
+/* Exercise the word-at-a-time and copy-and-checksum routines: */
+#define LWIP_CHKSUM_ALGORITHM           4
+#define LWIP_CHECKSUM_ON_COPY           1
+
+/* Merge small unsent segments before transmit: */
+#define TCP_COALESCE                    1
+
+/* Append to unread netconn receive entries (the NETCONN suite only runs
+ * with the API layers, i.e. NO_SYS 0 and a sys_arch port):
+ */
+#define LWIP_NETCONN_RX_COALESCE        1
+
+/* Resolver cache unit tests, with a stand-in DNS server on 127.0.0.1: */
+#define LWIP_DNS                        1
+#define LWIP_DNS_SECURE                 LWIP_DNS_SECURE_NO_MULTIPLE_OUTSTANDING
+#define DNS_NEG_MAX_TTL                 60
+#define DNS_PREFETCH_TTL                5
+#define DNS_PREFETCH_MIN_HITS           2
+#define LWIP_NETIF_LOOPBACK             1
+#define LWIP_HAVE_LOOPIF                1
+
+/* Reassembly unit tests, two 8 KB datagrams in flight: */
+#define IP_REASS_MAX_PBUFS              16
+
 #endif							/* __LWIPOPTS_H__ */
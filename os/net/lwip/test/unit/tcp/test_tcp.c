@@ -662,6 +662,69 @@ END_TEST START_TEST(test_tcp_tx_full_window_lost_from_unacked)
 }
 
 END_TEST
+#if TCP_COALESCE
+/** Send three small segments without nagle, let them time out and check
+ * that the retransmission leaves as one merged segment. */
+START_TEST(test_tcp_tx_coalesce_rexmit)
+{
+	struct netif netif;
+	struct test_tcp_txcounters txcounters;
+	struct test_tcp_counters counters;
+	struct tcp_pcb *pcb;
+	char data[] = { 1, 2, 3, 4 };
+	ip_addr_t remote_ip, local_ip, netmask;
+	u16_t remote_port = 0x100, local_port = 0x101;
+	STAT_COUNTER txcoalesced;
+	err_t err;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	/* initialize local vars */
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	memset(&counters, 0, sizeof(counters));
+	memset(&txcounters, 0, sizeof(txcounters));
+
+	/* create and initialize the pcb */
+	pcb = test_tcp_new_counters_pcb(&counters);
+	EXPECT_RET(pcb != NULL);
+	tcp_set_state(pcb, ESTABLISHED, &local_ip, &remote_ip, local_port, remote_port);
+	pcb->mss = TCP_MSS;
+	/* disable initial congestion window (we don't send a SYN here...) */
+	pcb->cwnd = pcb->snd_wnd;
+	tcp_nagle_disable(pcb);
+	txcoalesced = lwip_stats.tcp.txcoalesced;
+
+	/* three writes go out as three segments */
+	for (i = 0; i < 3; i++) {
+		err = tcp_write(pcb, data, sizeof(data), TCP_WRITE_FLAG_COPY);
+		EXPECT_RET(err == ERR_OK);
+		err = tcp_output(pcb);
+		EXPECT_RET(err == ERR_OK);
+	}
+	EXPECT_RET(txcounters.num_tx_calls == 3);
+	memset(&txcounters, 0, sizeof(txcounters));
+
+	/* RTO: all three are moved back to unsent and resent as one */
+	tcp_rexmit_rto(pcb);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	EXPECT_RET(txcounters.num_tx_bytes == 3 * sizeof(data) + 40U);
+	EXPECT_RET(pcb->unacked != NULL && pcb->unacked->next == NULL);
+	EXPECT_RET(pcb->unacked->len == 3 * sizeof(data));
+	EXPECT_RET(pcb->snd_queuelen == 1);
+	/* one merge, not one per merged segment */
+	EXPECT_RET(lwip_stats.tcp.txcoalesced == txcoalesced + 1);
+
+	/* make sure the pcb is freed */
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	tcp_abort(pcb);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+}
+
+END_TEST
+#endif							/* TCP_COALESCE */
 /** Create the suite including all tests for this module */
 Suite *tcp_suite(void)
 {
@@ -672,7 +735,10 @@ Suite *tcp_suite(void)
 		test_tcp_fast_rexmit_wraparound,
 		test_tcp_rto_rexmit_wraparound,
 		test_tcp_tx_full_window_lost_from_unacked,
-		test_tcp_tx_full_window_lost_from_unsent
+		test_tcp_tx_full_window_lost_from_unsent,
+#if TCP_COALESCE
+		test_tcp_tx_coalesce_rexmit,
+#endif							/* TCP_COALESCE */
 	};
 	return create_suite("TCP", tests, sizeof(tests) / sizeof(TFun), tcp_setup, tcp_teardown);
 }
@@ -82,6 +82,7 @@ SYSCALL_LOOKUP(sem_post,                  1, STUB_sem_post)
 SYSCALL_LOOKUP(sem_timedwait,             2, STUB_sem_timedwait)
 SYSCALL_LOOKUP(sem_trywait,               1, STUB_sem_trywait)
 SYSCALL_LOOKUP(sem_wait,                  1, STUB_sem_wait)
+SYSCALL_LOOKUP(sem_tickwait,              3, STUB_sem_tickwait)
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 SYSCALL_LOOKUP(sem_setprotocol,           2, STUB_sem_setprotocol)
@@ -207,7 +208,7 @@ SYSCALL_LOOKUP(dup2,                    2, STUB_dup2)
 SYSCALL_LOOKUP(fcntl,                   6, STUB_fcntl)
 SYSCALL_LOOKUP(lseek,                   3, STUB_lseek)
 SYSCALL_LOOKUP(mkfifo,                  2, STUB_mkfifo)
-SYSCALL_LOOKUP(mmap,                    6, NULL)
+SYSCALL_LOOKUP(mmap,                    6, STUB_mmap)
 SYSCALL_LOOKUP(open,                    6, STUB_open)
 SYSCALL_LOOKUP(opendir,                 1, STUB_opendir)
 SYSCALL_LOOKUP(pipe,                    1, STUB_pipe)
@@ -218,6 +219,14 @@ SYSCALL_LOOKUP(stat,                    2, STUB_stat)
 SYSCALL_LOOKUP(statfs,                  2, STUB_statfs)
 SYSCALL_LOOKUP(telldir,                 1, STUB_telldir)
 
+#  ifdef CONFIG_EVENT_FD
+SYSCALL_LOOKUP(eventfd,                 2, STUB_eventfd)
+#  endif
+
+#  ifdef CONFIG_FS_RAMMAP
+SYSCALL_LOOKUP(munmap,                  2, STUB_munmap)
+#  endif
+
 #  if CONFIG_NFILE_STREAMS > 0
 SYSCALL_LOOKUP(fdopen,                  3, STUB_fs_fdopen)
 SYSCALL_LOOKUP(sched_getstreams,        0, STUB_sched_getstreams)
@@ -288,6 +297,8 @@ SYSCALL_LOOKUP(mq_setattr,              3, STUB_mq_setattr)
 SYSCALL_LOOKUP(mq_timedreceive,         5, STUB_mq_timedreceive)
 SYSCALL_LOOKUP(mq_timedsend,            5, STUB_mq_timedsend)
 SYSCALL_LOOKUP(mq_unlink,               1, STUB_mq_unlink)
+SYSCALL_LOOKUP(mq_sendref,              4, STUB_mq_sendref)
+SYSCALL_LOOKUP(mq_receiveref,           3, STUB_mq_receiveref)
 #endif
 
 /* The following are defined only if environment variables are supported */
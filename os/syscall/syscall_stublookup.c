@@ -229,6 +229,8 @@ uintptr_t STUB_seekdir(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_stat(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_statfs(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_telldir(int nbr, uintptr_t parm1);
+uintptr_t STUB_eventfd(int nbr, uintptr_t parm1, uintptr_t parm2);
+uintptr_t STUB_munmap(int nbr, uintptr_t parm1, uintptr_t parm2);
 
 uintptr_t STUB_fs_fdopen(int nbr, uintptr_t parm1, uintptr_t parm2,
 						 uintptr_t parm3);
@@ -312,6 +314,10 @@ uintptr_t STUB_mq_timedreceive(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_mq_timedsend(int nbr, uintptr_t parm1, uintptr_t parm2,
 							uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
 uintptr_t STUB_mq_unlink(int nbr, uintptr_t parm1);
+uintptr_t STUB_mq_sendref(int nbr, uintptr_t parm1, uintptr_t parm2,
+						  uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_mq_receiveref(int nbr, uintptr_t parm1, uintptr_t parm2,
+							 uintptr_t parm3);
 
 /* The following are defined only if environment variables are supported */
 